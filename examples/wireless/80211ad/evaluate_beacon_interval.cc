@@ -16,7 +16,12 @@
  *
  * Network Topology:
  * Network topology is simple and consists of One Access Point + One Station. Each station has one antenna array with
- * eight virutal sectors to cover 360 in the 2D Domain.
+ * eight virutal sectors to cover 360 in the 2D Domain, the number of sectors of the DMG PCP/AP can be changed. The DMG STA transmits UDP traffic to the DMG PCP/AP in the
+ * CBAP allocated during the DTI.
+ *
+ * With the adaptive BHI, the DMG PCP/AP transmits DMG Beacons only through the sector used towards the associated
+ * DMG STA plus a rotating probe sector, and shortens the A-BFT once no beamforming activity is observed for a given
+ * number of BIs. The time saved in the BTI and in the A-BFT is given back to the CBAP at the end of the DTI.
  *
  *              DMG PCP/AP (0,0)                       DMG STA (-1,0)
  *
@@ -25,9 +30,14 @@
  * ./waf --run "evaluate_beacon_interval --beaconInterval=102400 --nextBeacon=1 --beaconRandomization=true
  *  --btiDuration=400 --nextAbft=0 --atiPresent=false --simulationTime=10"
  *
+ * To compare the throughput with and without the adaptive BHI using a larger codebook, run the following commands:
+ * ./waf --run "evaluate_beacon_interval --sectors=32 --adaptiveBhi=false --simulationTime=5"
+ * ./waf --run "evaluate_beacon_interval --sectors=32 --adaptiveBhi=true --simulationTime=5"
+ *
  * Simulation Output:
  * The simulation generates the following traces:
  * 1. PCAP traces for each station.
+ * 2. Summary for the total number of received packets and the average throughput.
  */
 
 NS_LOG_COMPONENT_DEFINE ("EvaluateBeaconInterval");
@@ -41,6 +51,21 @@ Ptr<Node> staWifiNode;
 Ptr<DmgApWifiMac> apWifiMac;
 Ptr<DmgStaWifiMac> staWifiMac;
 
+/**  Application Variables **/
+uint64_t totalRx = 0;
+double throughput = 0;
+Ptr<PacketSink> packetSink;
+
+void
+CalculateThroughput (void)
+{
+  double thr = (packetSink->GetTotalRx () - totalRx) * (double) 8/1e5;     /* Convert Application RX Packets to MBits. */
+  totalRx = packetSink->GetTotalRx ();
+  throughput += thr;
+  std::cout << Simulator::Now ().GetSeconds () << '\t' << thr << std::endl;
+  Simulator::Schedule (MilliSeconds (100), &CalculateThroughput);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -52,6 +77,11 @@ main(int argc, char *argv[])
   uint32_t sswPerSlot = 8;                /* The number of SSW Frames per Sector Sweep Slot. */
   bool atiPresent = false;                /* Whether the BI period contains ATI access period. */
   uint16_t atiDuration = 300;             /* The duration of the ATI access period. */
+  bool adaptiveBhi = false;               /* Whether to reduce the BTI and the A-BFT when no beamforming activity is observed. */
+  uint32_t bhiIdleBIs = 10;               /* The number of BIs without beamforming activity before reducing the BHI. */
+  uint32_t sectors = 8;                   /* The number of sectors of the antenna array of the DMG PCP/AP. */
+  uint32_t payloadSize = 1472;            /* Application payload size in bytes. */
+  string dataRate = "1500Mbps";           /* Application data rate. */
   bool verbose = false;                   /* Print Logging Information. */
   double simulationTime = 4;              /* Simulation time in seconds. */
   bool pcapTracing = true;                /* PCAP Tracing is enabled or not. */
@@ -68,6 +98,11 @@ main(int argc, char *argv[])
   cmd.AddValue ("sswPerSlot", "The number of SSW Frames per Sector Sweep Slot", sswPerSlot);
   cmd.AddValue ("atiPresent", "Flag to indicate if the BI period contains ATI access period", atiPresent);
   cmd.AddValue ("atiDuration", "The duration of the ATI access period", atiDuration);
+  cmd.AddValue ("adaptiveBhi", "Whether to reduce the BTI and the A-BFT when no beamforming activity is observed", adaptiveBhi);
+  cmd.AddValue ("bhiIdleBIs", "The number of BIs without beamforming activity before reducing the BHI", bhiIdleBIs);
+  cmd.AddValue ("sectors", "The number of sectors of the antenna array of the DMG PCP/AP", sectors);
+  cmd.AddValue ("payloadSize", "Application payload size in bytes", payloadSize);
+  cmd.AddValue ("dataRate", "Application data rate", dataRate);
   cmd.AddValue ("verbose", "turn on all WifiNetDevice log components", verbose);
   cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
   cmd.AddValue ("pcap", "Enable PCAP Tracing", pcapTracing);
@@ -126,13 +161,15 @@ main(int argc, char *argv[])
                    "SSSlotsPerABFT", UintegerValue (slotsPerABFT),
                    "SSFramesPerSlot", UintegerValue (sswPerSlot),
                    "ATIPresent", BooleanValue (atiPresent),
-                   "ATIDuration", TimeValue (MicroSeconds (atiDuration)));
+                   "ATIDuration", TimeValue (MicroSeconds (atiDuration)),
+                   "AdaptiveBhi", BooleanValue (adaptiveBhi),
+                   "AdaptiveBhiIdleBIs", UintegerValue (bhiIdleBIs));
 
-  /* Set Analytical Codebook for the DMG Devices */
+  /* Set Analytical Codebook for the DMG PCP/AP */
   wifi.SetCodebook ("ns3::CodebookAnalytical",
                     "CodebookType", EnumValue (SIMPLE_CODEBOOK),
                     "Antennas", UintegerValue (1),
-                    "Sectors", UintegerValue (8));
+                    "Sectors", UintegerValue (sectors));
 
   /* Create Wifi Network Devices (WifiNetDevice) */
   NetDeviceContainer apDevice;
@@ -142,6 +179,12 @@ main(int argc, char *argv[])
                    "Ssid", SsidValue (ssid),
                    "ActiveProbing", BooleanValue (false));
 
+  /* Set Analytical Codebook for the DMG STA */
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (SIMPLE_CODEBOOK),
+                    "Antennas", UintegerValue (1),
+                    "Sectors", UintegerValue (8));
+
   NetDeviceContainer staDevice;
   staDevice = wifi.Install (wifiPhy, wifiMac, staWifiNode);
 
@@ -172,6 +215,23 @@ main(int argc, char *argv[])
   /* We do not want any ARP packets */
   PopulateArpCache ();
 
+  /* Install Simple UDP Server on the DMG AP */
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9999));
+  ApplicationContainer sinkApp = sinkHelper.Install (apWifiNode);
+  packetSink = StaticCast<PacketSink> (sinkApp.Get (0));
+  sinkApp.Start (Seconds (0.0));
+
+  /* Install UDP Transmitter on the DMG STA */
+  OnOffHelper src ("ns3::UdpSocketFactory", InetSocketAddress (apInterface.GetAddress (0), 9999));
+  src.SetAttribute ("MaxBytes", UintegerValue (0));
+  src.SetAttribute ("PacketSize", UintegerValue (payloadSize));
+  src.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1e6]"));
+  src.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+  src.SetAttribute ("DataRate", DataRateValue (DataRate (dataRate)));
+  ApplicationContainer srcApp = src.Install (staWifiNode);
+  srcApp.Start (Seconds (1.0));
+  srcApp.Stop (Seconds (simulationTime));
+
   /* Enable Traces */
   if (pcapTracing)
     {
@@ -180,8 +240,23 @@ main(int argc, char *argv[])
       wifiPhy.EnablePcap ("Traces/Station", staDevice, false);
     }
 
-  Simulator::Stop (Seconds (simulationTime));
+  apWifiMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+
+  /* Print Output*/
+  std::cout << "Time [s]" << '\t' << "Throughput [Mbps]" << std::endl;
+
+  /* Schedule Throughput Calulcations */
+  Simulator::Schedule (Seconds (1.1), &CalculateThroughput);
+
+  Simulator::Stop (Seconds (simulationTime + 0.1));
   Simulator::Run ();
+
+  /* Print Results Summary */
+  std::cout << "Total number of received packets = " << packetSink->GetTotalReceivedPackets () << std::endl;
+  std::cout << "Total throughput [Mbps] = " << throughput/((simulationTime - 1) * 10) << std::endl;
+  std::cout << "DTI time reclaimed from the BHI in the last BI [us] = "
+            << apWifiMac->GetReclaimedBhiDuration ().GetMicroSeconds () << std::endl;
+
   Simulator::Destroy ();
 
   return 0;
@@ -0,0 +1,301 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "common-functions.h"
+#include <iomanip>
+
+/**
+ * Simulation Objective:
+ * This script is used to compare a flat Transmit Sector Sweep (TxSS) with a hierarchical TxSS in IEEE 802.11ad.
+ * Both DMG devices use an analytical codebook made of wide sectors and of narrow sectors which split each
+ * wide sector. In the flat mode, the wide sectors are used in the BHI only and every SLS sweeps all the narrow
+ * sectors. In the hierarchical mode, the narrow sectors are declared as the children of their wide sector, so
+ * an SLS sweeps the wide sectors first and a second SLS refines within the children of the best wide sector.
+ * The next trainings only sweep the siblings of the best narrow sector, unless the SNR degrades.
+ *
+ * Network Topology:
+ * Network topology is simple and consists of a single access point and one station.
+ *
+ *
+ *                      DMG AP (0,0)                    DMG STA (X,Y)
+ *
+ *
+ * Simulation Description:
+ * Once the DMG STA has associated with the DMG PCP/AP, it initiates a TxSS in CBAP every 100 ms. At the end of
+ * the simulation, the number of SLS, the number of sectors swept by the DMG STA and the beamforming time are
+ * printed for each mode together with the best transmit sector of the DMG STA.
+ *
+ * Running the Simulation:
+ * ./waf --run "evaluate_hierarchical_beamforming --hierarchical=false"
+ * ./waf --run "evaluate_hierarchical_beamforming --hierarchical=true"
+ * ./waf --run "evaluate_hierarchical_beamforming --hierarchical=true --wideSectors=4 --childSectors=14"
+ *
+ * Simulation Output:
+ * The simulation prints the completed SLS and the beamforming statistics of the DMG STA.
+ */
+
+NS_LOG_COMPONENT_DEFINE ("HierarchicalBeamforming");
+
+using namespace ns3;
+using namespace std;
+
+Ptr<DmgApWifiMac> apWifiMac;
+Ptr<DmgStaWifiMac> staWifiMac;
+std::map<SectorID, double> staSteeringAngles;   /* The steering angle of each sector of the DMG STA */
+
+/*** Beamforming Statistics ***/
+uint32_t beamformingTrainings = 0;              /* Number of TxSS initiated by the DMG STA */
+uint32_t completedTrainings = 0;                /* Number of TxSS which reached a sector without children */
+uint32_t slsCount = 0;                          /* Number of completed SLS */
+uint32_t sweptSectors = 0;                      /* Number of sectors swept by the DMG STA */
+Time beamformingTime;                           /* Total duration of the SLS */
+
+void
+BuildCodebook (Ptr<CodebookAnalytical> codebook, uint8_t wideSectors, uint8_t childSectors, bool hierarchical,
+               std::map<SectorID, double> *steeringAngles)
+{
+  double wideWidth = 360.0 / wideSectors;
+  double narrowWidth = wideWidth / childSectors;
+  codebook->AppendAntenna (1, 0, 0);
+  /* The wide sectors are swept in the BHI, and at the first level of the hierarchy */
+  for (uint8_t i = 0; i < wideSectors; i++)
+    {
+      SectorID parentID = i + 1;
+      double steeringAngle = i * wideWidth;
+      codebook->AppendSector (1, parentID, steeringAngle, wideWidth, TX_RX_SECTOR,
+                              hierarchical ? BHI_SLS_SECTOR : BHI_SECTOR);
+      if (steeringAngles != 0)
+        {
+          (*steeringAngles)[parentID] = steeringAngle;
+        }
+    }
+  /* The narrow sectors split each wide sector */
+  for (uint8_t i = 0; i < wideSectors; i++)
+    {
+      SectorID parentID = i + 1;
+      for (uint8_t j = 0; j < childSectors; j++)
+        {
+          SectorID childID = wideSectors + i * childSectors + j + 1;
+          double steeringAngle = fmod (i * wideWidth - wideWidth / 2 + (j + 0.5) * narrowWidth + 360.0, 360.0);
+          codebook->AppendSector (1, childID, steeringAngle, narrowWidth, TX_RX_SECTOR, SLS_SECTOR);
+          if (hierarchical)
+            {
+              codebook->AppendChildSector (1, parentID, childID);
+            }
+          if (steeringAngles != 0)
+            {
+              (*steeringAngles)[childID] = steeringAngle;
+            }
+        }
+    }
+}
+
+void
+InitiateBeamforming (Time interval)
+{
+  beamformingTrainings++;
+  staWifiMac->InitiateTxssCbap (apWifiMac->GetAddress ());
+  Simulator::Schedule (interval, &InitiateBeamforming, interval);
+}
+
+void
+StationAssoicated (Mac48Address address, uint16_t aid)
+{
+  std::cout << "DMG STA " << staWifiMac->GetAddress () << " associated with DMG AP " << address << std::endl;
+  Simulator::Schedule (MilliSeconds (10), &InitiateBeamforming, MilliSeconds (100));
+}
+
+void
+BeamTrainingCompleted (Mac48Address address, bool partial, uint8_t sectors, Time duration)
+{
+  slsCount++;
+  sweptSectors += sectors;
+  beamformingTime += duration;
+}
+
+void
+SLSCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+              BeamformingDirection beamformingDirection, bool isInitiatorTxss, bool isResponderTxss,
+              SECTOR_ID sectorId, ANTENNA_ID antennaId)
+{
+  if ((accessPeriod == CHANNEL_ACCESS_DTI) && (beamformingDirection == BeamformingInitiator))
+    {
+      std::cout << std::left << std::setw (12) << Simulator::Now ().GetSeconds ()
+                << "DMG STA best Tx SectorID=" << std::setw (4) << uint32_t (sectorId)
+                << "Steering Angle=" << staSteeringAngles[sectorId] << std::endl;
+      if (staWifiMac->GetCodebook ()->GetChildSectors (antennaId, sectorId).empty ())
+        {
+          completedTrainings++;
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  string phyMode = "DMG_MCS12";                 /* Type of the Physical Layer. */
+  double x_pos = 2.0;                           /* The X position of the DMG STA. */
+  double y_pos = 1.0;                           /* The Y position of the DMG STA. */
+  uint32_t wideSectors = 8;                     /* The number of wide sectors per codebook. */
+  uint32_t childSectors = 6;                    /* The number of narrow sectors per wide sector. */
+  bool hierarchical = true;                     /* Whether the narrow sectors are the children of the wide sectors. */
+  bool verbose = false;                         /* Print Logging Information. */
+  double simulationTime = 2;                    /* Simulation time in seconds. */
+  bool pcapTracing = false;                     /* PCAP Tracing is enabled or not. */
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("phyMode", "802.11ad PHY Mode", phyMode);
+  cmd.AddValue ("x_pos", "The X position of the DMG STA", x_pos);
+  cmd.AddValue ("y_pos", "The Y position of the DMG STA", y_pos);
+  cmd.AddValue ("wideSectors", "The number of wide sectors per codebook", wideSectors);
+  cmd.AddValue ("childSectors", "The number of narrow sectors per wide sector", childSectors);
+  cmd.AddValue ("hierarchical", "Sweep the wide sectors first and refine within the best one", hierarchical);
+  cmd.AddValue ("verbose", "Turn on all WifiNetDevice log components", verbose);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.AddValue ("pcap", "Enable PCAP Tracing", pcapTracing);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF ((wideSectors == 0) || (childSectors == 0), "The number of sectors should be larger than zero.");
+  NS_ABORT_MSG_IF (wideSectors * (childSectors + 1) > 63,
+                   "The DMG Capabilities are limited to 63 transmit sectors.");
+  NS_ABORT_MSG_IF (wideSectors > 16, "The wide sectors should fit in an A-BFT slot.");
+
+  /* Global params: no fragmentation, no RTS/CTS, fixed rate for all packets */
+  Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("999999"));
+  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("999999"));
+
+  /**** DmgWifiHelper is a meta-helper ****/
+  DmgWifiHelper wifi;
+
+  /* Turn on logging */
+  if (verbose)
+    {
+      wifi.EnableLogComponents ();
+      LogComponentEnable ("HierarchicalBeamforming", LOG_LEVEL_ALL);
+    }
+
+  /**** Set up Channel ****/
+  DmgWifiChannelHelper wifiChannel ;
+  /* Simple propagation delay model */
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  /* Friis model with standard-specific wavelength */
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  /**** SETUP ALL NODES ****/
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  /* Nodes will be added to the channel we set up earlier */
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  /* All nodes transmit at 10 dBm == 10 mW, no adaptation */
+  wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  /* Set operating channel */
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  /* Sensitivity model includes implementation loss and noise figure */
+  wifiPhy.Set ("CcaMode1Threshold", DoubleValue (-79));
+  wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue (-79 + 3));
+  /* Set default algorithm for all nodes to be constant rate */
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue (phyMode),
+                                                                "DataMode", StringValue (phyMode));
+
+  /* Make two nodes and set them up with the phy and the mac */
+  NodeContainer wifiNodes;
+  wifiNodes.Create (2);
+  Ptr<Node> apWifiNode = wifiNodes.Get (0);
+  Ptr<Node> staWifiNode = wifiNodes.Get (1);
+
+  /**** Allocate DMG Wifi MAC ****/
+  DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+
+  Ssid ssid = Ssid ("Hierarchical");
+  wifiMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (16),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                   "ATIPresent", BooleanValue (false));
+
+  /* Set Analytical Codebook for the DMG Devices */
+  wifi.SetCodebook ("ns3::CodebookAnalytical",
+                    "CodebookType", EnumValue (EMPTY_CODEBOOK));
+
+  NetDeviceContainer apDevice;
+  apDevice = wifi.Install (wifiPhy, wifiMac, apWifiNode);
+
+  wifiMac.SetType ("ns3::DmgStaWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "ActiveProbing", BooleanValue (false));
+
+  NetDeviceContainer staDevice;
+  staDevice = wifi.Install (wifiPhy, wifiMac, staWifiNode);
+
+  /** Build the codebooks of the DMG devices **/
+  Ptr<WifiNetDevice> apWifiNetDevice = StaticCast<WifiNetDevice> (apDevice.Get (0));
+  Ptr<WifiNetDevice> staWifiNetDevice = StaticCast<WifiNetDevice> (staDevice.Get (0));
+  apWifiMac = StaticCast<DmgApWifiMac> (apWifiNetDevice->GetMac ());
+  staWifiMac = StaticCast<DmgStaWifiMac> (staWifiNetDevice->GetMac ());
+  BuildCodebook (StaticCast<CodebookAnalytical> (apWifiMac->GetCodebook ()), wideSectors, childSectors, hierarchical, 0);
+  BuildCodebook (StaticCast<CodebookAnalytical> (staWifiMac->GetCodebook ()), wideSectors, childSectors, hierarchical,
+                 &staSteeringAngles);
+
+  /* Setting mobility model */
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (x_pos, y_pos, 0.0));
+
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiNodes);
+
+  /* Enable Traces */
+  if (pcapTracing)
+    {
+      wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11_RADIO);
+      wifiPhy.EnablePcap ("Traces/AccessPoint", apDevice, false);
+      wifiPhy.EnablePcap ("Traces/Station", staDevice, false);
+    }
+
+  /* Connect Traces */
+  staWifiMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&StationAssoicated));
+  staWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&SLSCompleted));
+  staWifiMac->TraceConnectWithoutContext ("BeamTrainingCompleted", MakeCallback (&BeamTrainingCompleted));
+
+  Simulator::Stop (Seconds (simulationTime));
+  Simulator::Run ();
+
+  /* Print Beamforming Statistics */
+  double staAngle = fmod (RadiansToDegrees (atan2 (y_pos, x_pos)) + 360.0, 360.0);
+  std::cout << "Beamforming Mode: " << (hierarchical ? "Hierarchical" : "Flat")
+            << " (" << wideSectors << " wide sectors x " << childSectors << " narrow sectors)" << std::endl;
+  std::cout << "  Direction of the DMG AP from the DMG STA: " << fmod (staAngle + 180.0, 360.0) << " degrees" << std::endl;
+  std::cout << "  Beamforming Trainings: " << beamformingTrainings << std::endl;
+  std::cout << "  Completed Trainings:   " << completedTrainings << std::endl;
+  std::cout << "  Completed SLS:         " << slsCount << std::endl;
+  if (completedTrainings > 0)
+    {
+      std::cout << "  Sectors per Training:  " << double (sweptSectors) / completedTrainings << std::endl;
+      std::cout << "  Time per Training:     " << beamformingTime.GetMicroSeconds () / completedTrainings << " us" << std::endl;
+    }
+
+  Simulator::Destroy ();
+
+  return 0;
+}
@@ -12,33 +12,43 @@
 
 /**
  * Simulation Objective:
- * This script is used to evaluate allocation of Static Service Periods in IEEE 802.11ad.
+ * This script is used to evaluate the spatial sharing of Service Periods in IEEE 802.11ad.
  *
  * Network Topology:
- * The scenario consists of 4 DMG STAs (West + East + North + South) and one PCP/AP as following:
+ * The scenario consists of one PCP/AP and a number of parallel links between two DMG STAs,
+ * spaced by a given distance:
  *
- *                            North DMG STA2(0.0, +5.0)
+ *     DMG STA (Dst 1)     DMG STA (Dst 2)     ...     DMG STA (Dst N)
+ *           ^                   ^                           ^
+ *           |                   |                           |
+ *     DMG STA (Src 1)     DMG STA (Src 2)     ...     DMG STA (Src N)
  *
  *
+ *                             DMG AP
  *
- * West DMG STA (-10.0, 0.0)        DMG AP (0.0, 0.0)          East DMG STA (+10.0, 0.0)
+ * Simulation Description:
+ * Once all the stations have associated successfully with the PCP/AP, the PCP/AP allocates one SP
+ * per link to perform TxSS between the two DMG STAs of the link. Once the links are trained, each
+ * source DMG STA requests an SP towards its destination with an ADDTS request. The PCP/AP uses the
+ * spatial sharing scheduler, which requests Directional Channel Quality measurements from the DMG STAs
+ * and schedules the SPs of the links which do not interfere with each other at the same time.
  *
+ * The beamforming state of the DMG STAs can be kept in a cache file across the runs of the scenario. On
+ * the first run, the state reached at the end of the simulation is saved in the cache file. On the next
+ * runs with the same topology, seed and run number, the DMG STAs start with the saved best antenna
+ * configurations and request their SPs as soon as they are associated, without any beamforming SP.
+ * The runs with other seeds or run numbers can share the saved state with --cacheAcrossRuns=true.
  *
+ * Running the Simulation:
+ * ./waf --run "evaluate_spatial_sharing --numLinks=3"
  *
- *                            South DMG STA (-0.0,-5.0)
- *
- * Simulation: Description:
- * Once all the stations have assoicated successfully with the PCP/AP. The PCP/AP allocates two SPs
- * to perform TxSS between all the stations. Once West DMG STA has completed TxSS phase with East and
- * South DMG STAs. The PCP/AP will allocate two static service periods at the time (Spatial Sharing)
- * for communication as following:
- *
- * SP1: West DMG STA -----> North DMG STA (SP Length = 3.2ms)
- * SP2: South DMG STA -----> East DMG STA (SP Length = 3.2ms)
+ * To skip the beamforming training of the links in the next runs of the scenario:
+ * ./waf --run "evaluate_spatial_sharing --numLinks=3 --beamformingCache=beamforming.cache"
  *
  * Output:
- * From the PCAP files, we can see that data transmission takes place during its SP. In addition, we can
- * notice in the announcement of the two Static Allocation Periods inside each DMG Beacon.
+ * The aggregate throughput of the links every 100 ms, followed by the average throughput of each
+ * link after the warmup time. The aggregate throughput grows with the number of links which do not
+ * interfere with each other, while the throughput of a single link is limited by its maximum allocation.
  */
 
 NS_LOG_COMPONENT_DEFINE ("EvaluateSpatialSharing");
@@ -47,41 +57,67 @@ using namespace ns3;
 using namespace std;
 
 /* Network Nodes */
-Ptr<WifiNetDevice> apWifiNetDevice;
-Ptr<WifiNetDevice> westWifiNetDevice, northWifiNetDevice, southWifiNetDevice, eastWifiNetDevice;
-NetDeviceContainer staDevices;
-
 Ptr<DmgApWifiMac> apWifiMac;
-Ptr<DmgStaWifiMac> westWifiMac, northWifiMac, southWifiMac, eastWifiMac;
+std::vector<Ptr<DmgStaWifiMac> > srcWifiMacs, dstWifiMacs;
+NetDeviceContainer staDevices;
+ApplicationContainer sinks;
 
 /*** Access Point Variables ***/
-uint8_t assoicatedStations = 0;           /* Total number of assoicated stations with the AP */
-uint8_t stationsTrained = 0;              /* Number of BF trained stations */
-bool scheduledStaticPeriods = false;      /* Flag to indicate whether we scheduled Static Service Periods or not */
+uint32_t associatedStations = 0;          /* Total number of associated stations with the AP */
+uint32_t linksTrained = 0;                /* Number of BF trained links */
+bool beamformingRestored = false;         /* Flag to indicate whether the links start beamformed */
 
 /*** Service Period ***/
-uint16_t servicePeriodDuration = 3200;    /* The duration of the allocated service periods in MicroSeconds */
-uint16_t offsetDuration = 3200;           /* The offset between the start of the two service periods in MicroSeconds */
+uint32_t minAllocation = 4000;            /* The minimum allocation of each link in MicroSeconds */
+uint32_t maxAllocation = 32000;           /* The maximum allocation of each link in MicroSeconds */
+
+DmgTspecElement
+GetDmgTspecElement (uint8_t allocId, uint8_t destAid)
+{
+  DmgTspecElement element;
+  DmgAllocationInfo info;
+  info.SetAllocationID (allocId);
+  info.SetAllocationType (SERVICE_PERIOD_ALLOCATION);
+  info.SetAllocationFormat (ISOCHRONOUS);
+  info.SetAsPseudoStatic (true);
+  info.SetDestinationAid (destAid);
+  element.SetDmgAllocationInfo (info);
+  element.SetMinimumAllocation (minAllocation);
+  element.SetMaximumAllocation (maxAllocation);
+  element.SetMinimumDuration (minAllocation);
+  return element;
+}
 
 void
-CalculateThroughput (Ptr<PacketSink> sink, uint64_t lastTotalRx, double averageThroughput)
+CalculateThroughput (uint64_t lastTotalRx)
 {
-  Time now = Simulator::Now ();                                         /* Return the simulator's virtual time. */
-  double cur = (sink->GetTotalRx() - lastTotalRx) * (double) 8/1e5;     /* Convert Application RX Packets to MBits. */
-  std::cout << now.GetSeconds () << '\t' << cur << std::endl;
-  lastTotalRx = sink->GetTotalRx ();
-  averageThroughput += cur;
-  Simulator::Schedule (MilliSeconds (100), &CalculateThroughput, sink, lastTotalRx, averageThroughput);
+  uint64_t totalRx = 0;
+  for (ApplicationContainer::Iterator it = sinks.Begin (); it != sinks.End (); ++it)
+    {
+      totalRx += StaticCast<PacketSink> (*it)->GetTotalRx ();
+    }
+  double cur = (totalRx - lastTotalRx) * (double) 8/1e5;              /* Convert Application RX Packets to MBits. */
+  std::cout << Simulator::Now ().GetSeconds () << '\t' << cur << std::endl;
+  Simulator::Schedule (MilliSeconds (100), &CalculateThroughput, totalRx);
+}
+
+void
+RequestServicePeriods (void)
+{
+  for (uint32_t i = 0; i < srcWifiMacs.size (); i++)
+    {
+      srcWifiMacs[i]->CreateAllocation (GetDmgTspecElement (i + 1, dstWifiMacs[i]->GetAssociationID ()));
+    }
 }
 
 void
-StationAssoicated (Ptr<DmgStaWifiMac> staWifiMac, Mac48Address address)
+StationAssociated (Ptr<DmgStaWifiMac> staWifiMac, Mac48Address address, uint16_t aid)
 {
-  std::cout << "DMG STA " << staWifiMac->GetAddress () << " associated with DMG AP " << address << std::endl;
-  std::cout << "Association ID (AID) = " << staWifiMac->GetAssociationID () << std::endl;
-  assoicatedStations++;
+  std::cout << "DMG STA " << staWifiMac->GetAddress () << " associated with DMG PCP/AP " << address
+            << ", Association ID (AID) = " << aid << std::endl;
+  associatedStations++;
   /* Check if all stations have associated with the AP */
-  if (assoicatedStations == 4)
+  if (associatedStations == staDevices.GetN ())
     {
       std::cout << "All stations got associated with " << address << std::endl;
       /* Map AID to MAC Addresses in each node instead of requesting information */
@@ -98,71 +134,115 @@ StationAssoicated (Ptr<DmgStaWifiMac> staWifiMac, Mac48Address address)
                 }
             }
         }
-      /* Schedule SP for Beamforming Training */
-      apWifiMac->AllocateBeamformingServicePeriod (westWifiMac->GetAssociationID (), northWifiMac->GetAssociationID (), 0, true);
-      apWifiMac->AllocateBeamformingServicePeriod (southWifiMac->GetAssociationID (), eastWifiMac->GetAssociationID (), 3000, true);
+      /* Add manually DMG Capabilities and schedule one SP for Beamforming Training per link not yet beamformed */
+      uint32_t startTime = 0;
+      for (uint32_t i = 0; i < srcWifiMacs.size (); i++)
+        {
+          srcWifiMacs[i]->StorePeerDmgCapabilities (dstWifiMacs[i]);
+          dstWifiMacs[i]->StorePeerDmgCapabilities (srcWifiMacs[i]);
+          if (!beamformingRestored)
+            {
+              startTime = apWifiMac->GetScheduler ()->AllocateBeamformingServicePeriod (srcWifiMacs[i]->GetAssociationID (),
+                                                                                       dstWifiMacs[i]->GetAssociationID (),
+                                                                                       startTime, true);
+            }
+        }
+      if (beamformingRestored)
+        {
+          std::cout << "All links are beamformed, request the Service Periods" << std::endl;
+          RequestServicePeriods ();
+        }
     }
 }
 
 void
-SLSCompleted (Ptr<DmgWifiMac> staWifiMac, Mac48Address address, ChannelAccessPeriod accessPeriod,
+SLSCompleted (Ptr<DmgStaWifiMac> staWifiMac, Mac48Address address, ChannelAccessPeriod accessPeriod,
               BeamformingDirection beamformingDirection, bool isInitiatorTxss, bool isResponderTxss,
               SECTOR_ID sectorId, ANTENNA_ID antennaId)
 {
-  if (accessPeriod == CHANNEL_ACCESS_DTI)
+  if ((accessPeriod != CHANNEL_ACCESS_DTI) || (address == apWifiMac->GetAddress ()))
     {
-      std::cout << "DMG STA " << staWifiMac->GetAddress () << " completed SLS phase with DMG STA " << address << std::endl;
-      std::cout << "The best antenna configuration is SectorID=" << uint32_t (sectorId)
-                << ", AntennaID=" << uint32_t (antennaId) << std::endl;
-      if ((westWifiMac->GetAddress () == staWifiMac->GetAddress ()) || (southWifiMac->GetAddress () == staWifiMac->GetAddress ()))
-        {
-          stationsTrained++;
-        }
-      if ((stationsTrained == 2) & !scheduledStaticPeriods)
-        {
-          std::cout << "Schedule Static Periods" << std::endl;
-          scheduledStaticPeriods = true;
-          /* Schedule Static Periods */
-          apWifiMac->AllocateSingleContiguousBlock (1, SERVICE_PERIOD_ALLOCATION, true, westWifiMac->GetAssociationID (),
-                                                    northWifiMac->GetAssociationID (), 0, servicePeriodDuration);
-          apWifiMac->AllocateSingleContiguousBlock (2, SERVICE_PERIOD_ALLOCATION, true, southWifiMac->GetAssociationID (),
-                                                    eastWifiMac->GetAssociationID (), offsetDuration, servicePeriodDuration);
-        }
+      return;
+    }
+  std::cout << "DMG STA " << staWifiMac->GetAddress () << " completed SLS phase with DMG STA " << address
+            << ", the best antenna configuration is SectorID=" << uint32_t (sectorId)
+            << ", AntennaID=" << uint32_t (antennaId) << std::endl;
+  if (beamformingDirection != BeamformingInitiator)
+    {
+      return;
+    }
+  linksTrained++;
+  if (linksTrained == srcWifiMacs.size ())
+    {
+      std::cout << "All links are trained, request the Service Periods" << std::endl;
+      RequestServicePeriods ();
+    }
+}
+
+void
+ADDTSResponseReceived (Mac48Address address, StatusCode status, DmgTspecElement element)
+{
+  std::cout << "DMG STA " << address << " received ADDTS response for allocation ID "
+            << uint32_t (element.GetDmgAllocationInfo ().GetAllocationID ())
+            << " with status " << (status.IsSuccess () ? "success" : "failure") << std::endl;
+}
+
+void
+StoreTotalRx (std::vector<uint64_t> *totalRx)
+{
+  for (uint32_t i = 0; i < sinks.GetN (); i++)
+    {
+      (*totalRx)[i] = StaticCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
     }
 }
 
 int
 main (int argc, char *argv[])
 {
+  uint32_t numLinks = 2;                        /* Number of parallel links. */
+  double linkLength = 1.0;                      /* The distance between the two DMG STAs of a link in meters. */
+  double linkSpacing = 4.0;                     /* The distance between two neighbouring links in meters. */
   uint32_t payloadSize = 1472;                  /* Transport Layer Payload size in bytes. */
-  string dataRate = "300Mbps";                  /* Application Layer Data Rate. */
+  string dataRate = "4Gbps";                    /* Application Layer Data Rate of each link. */
   uint32_t msduAggregationSize = 7935;          /* The maximum aggregation size for A-MSDU in Bytes. */
   uint32_t queueSize = 10000;                   /* Wifi Mac Queue Size. */
-  string phyMode = "DMG_MCS24";                 /* Type of the Physical Layer. */
-  string path = "";                             /* The path of the antenna radiation pattern. */
+  string phyMode = "DMG_MCS12";                 /* Type of the Physical Layer. */
+  double interferenceThreshold = -68;           /* The highest ANIPI in dBm for two SPs to be concurrent. */
   bool verbose = false;                         /* Print Logging Information. */
-  double simulationTime = 10;                   /* Simulation time in seconds. */
+  double warmupTime = 3;                        /* The time after which the average throughput is computed. */
+  double simulationTime = 6;                    /* Simulation time in seconds. */
   bool pcapTracing = false;                     /* PCAP Tracing is enabled or not. */
+  string beamformingCache = "";                 /* The beamforming cache file, disabled if empty. */
+  bool cacheAcrossRuns = false;                 /* Share the beamforming cache between the runs with other seeds. */
 
   /* Command line argument parser setup. */
   CommandLine cmd;
+  cmd.AddValue ("numLinks", "Number of parallel links between two DMG STAs", numLinks);
+  cmd.AddValue ("linkLength", "The distance between the two DMG STAs of a link in meters", linkLength);
+  cmd.AddValue ("linkSpacing", "The distance between two neighbouring links in meters", linkSpacing);
   cmd.AddValue ("payloadSize", "Payload size in bytes", payloadSize);
-  cmd.AddValue ("dataRate", "Payload size in bytes", dataRate);
+  cmd.AddValue ("dataRate", "Application data rate of each link", dataRate);
   cmd.AddValue ("msduAggregation", "The maximum aggregation size for A-MSDU in Bytes", msduAggregationSize);
   cmd.AddValue ("queueSize", "The size of the Wifi Mac Queue", queueSize);
-  cmd.AddValue ("duration", "The duration of service period in MicroSeconds", servicePeriodDuration);
-  cmd.AddValue ("offset", "The offset between the start of the two service periods", offsetDuration);
+  cmd.AddValue ("minAllocation", "The minimum allocation of each link in MicroSeconds", minAllocation);
+  cmd.AddValue ("maxAllocation", "The maximum allocation of each link in MicroSeconds", maxAllocation);
+  cmd.AddValue ("interferenceThreshold", "The highest ANIPI in dBm for two SPs to be concurrent", interferenceThreshold);
   cmd.AddValue ("phyMode", "802.11ad PHY Mode", phyMode);
-  cmd.AddValue ("antennaPattern", "The path of the antenna radiation pattern generated by Matlab", path);
   cmd.AddValue ("verbose", "turn on all WifiNetDevice log components", verbose);
+  cmd.AddValue ("warmupTime", "The time after which the average throughput is computed in seconds", warmupTime);
   cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
   cmd.AddValue ("pcap", "Enable PCAP Tracing", pcapTracing);
+  cmd.AddValue ("beamformingCache", "The file keeping the beamforming state across the runs of the scenario", beamformingCache);
+  cmd.AddValue ("cacheAcrossRuns", "Share the beamforming cache between the runs with other seeds or run numbers", cacheAcrossRuns);
   cmd.Parse (argc, argv);
 
+  NS_ABORT_MSG_IF ((numLinks == 0) || (numLinks > 4), "The number of links must be between 1 and 4");
+
   /* Global params: no fragmentation, no RTS/CTS, fixed rate for all packets */
   Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("999999"));
   Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("999999"));
-  Config::SetDefault ("ns3::WifiMacQueue::MaxPacketNumber", UintegerValue (queueSize));
+  Config::SetDefault ("ns3::QueueBase::MaxPackets", UintegerValue (queueSize));
+  Config::SetDefault ("ns3::SpatialSharingDmgWifiScheduler::InterferenceThreshold", DoubleValue (interferenceThreshold));
 
   /**** WifiHelper is a meta-helper: it helps creates helpers ****/
   DmgWifiHelper wifi;
@@ -199,17 +279,14 @@ main (int argc, char *argv[])
   wifiPhy.Set ("CcaMode1Threshold", DoubleValue (-79));
   wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue (-79 + 3));
   /* Set default algorithm for all nodes to be constant rate */
-  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue (phyMode),
-                                                                "DataMode", StringValue (phyMode));
-
-  /* Make four nodes and set them up with the phy and the mac */
-  NodeContainer wifiNodes;
-  wifiNodes.Create (5);
-  Ptr<Node> apNode = wifiNodes.Get (0);
-  Ptr<Node> westNode = wifiNodes.Get (1);
-  Ptr<Node> northNode = wifiNodes.Get (2);
-  Ptr<Node> southNode = wifiNodes.Get (3);
-  Ptr<Node> eastNode = wifiNodes.Get (4);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue (phyMode));
+
+  /* Make the nodes and set them up with the phy and the mac */
+  NodeContainer apNode;
+  apNode.Create (1);
+  NodeContainer srcNodes, dstNodes;
+  srcNodes.Create (numLinks);
+  dstNodes.Create (numLinks);
 
   /* Add a DMG upper mac */
   DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
@@ -221,8 +298,8 @@ main (int argc, char *argv[])
                    "BE_MaxAmpduSize", UintegerValue (0),
                    "BE_MaxAmsduSize", UintegerValue (msduAggregationSize),
                    "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
-                   "BeaconInterval", TimeValue (MilliSeconds (100)),
-                   "ATIDuration", TimeValue (MicroSeconds (1000)));
+                   "BeaconInterval", TimeValue (MicroSeconds (40960)),
+                   "ATIPresent", BooleanValue (false));
 
   /* Set Analytical Codebook for the DMG Devices */
   wifi.SetCodebook ("ns3::CodebookAnalytical",
@@ -230,6 +307,9 @@ main (int argc, char *argv[])
                     "Antennas", UintegerValue (1),
                     "Sectors", UintegerValue (8));
 
+  /* Schedule the SPs of the links which do not interfere with each other at the same time */
+  wifi.SetDmgScheduler ("ns3::SpatialSharingDmgWifiScheduler");
+
   NetDeviceContainer apDevice;
   apDevice = wifi.Install (wifiPhy, wifiMac, apNode);
 
@@ -239,31 +319,55 @@ main (int argc, char *argv[])
                    "BE_MaxAmpduSize", UintegerValue (0),
                    "BE_MaxAmsduSize", UintegerValue (msduAggregationSize));
 
-  staDevices = wifi.Install (wifiPhy, wifiMac, NodeContainer (westNode, northNode, southNode, eastNode));
+  NetDeviceContainer srcDevices = wifi.Install (wifiPhy, wifiMac, srcNodes);
+  NetDeviceContainer dstDevices = wifi.Install (wifiPhy, wifiMac, dstNodes);
+  staDevices.Add (srcDevices);
+  staDevices.Add (dstDevices);
 
   /* Setting mobility model */
   MobilityHelper mobility;
   Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
-  positionAlloc->Add (Vector (0.0, 0.0, 0.0));     /* PCP/AP */
-  positionAlloc->Add (Vector (-2.0, 0.0, 0.0));    /* West DMG STA */
-  positionAlloc->Add (Vector (0.0, +1.0, 0.0));    /* North DMG STA 2 */
-  positionAlloc->Add (Vector (0.0, -1.0, 0.0));    /* South DMG STA 3 */
-  positionAlloc->Add (Vector (+2.0, 0.0, 0.0));    /* East DMG STA 4 */
-
+  positionAlloc->Add (Vector (0.0, -linkSpacing, 0.0));       /* PCP/AP */
+  for (uint32_t i = 0; i < numLinks; i++)
+    {
+      positionAlloc->Add (Vector ((i - (numLinks - 1) / 2.0) * linkSpacing, 0.0, 0.0));
+    }
+  for (uint32_t i = 0; i < numLinks; i++)
+    {
+      positionAlloc->Add (Vector ((i - (numLinks - 1) / 2.0) * linkSpacing, linkLength, 0.0));
+    }
   mobility.SetPositionAllocator (positionAlloc);
   mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
-  mobility.Install (wifiNodes);
+  mobility.Install (apNode);
+  mobility.Install (srcNodes);
+  mobility.Install (dstNodes);
+
+  /* Restore the beamforming state saved by a previous run of the same scenario */
+  NetDeviceContainer dmgDevices;
+  dmgDevices.Add (apDevice);
+  dmgDevices.Add (staDevices);
+  DmgBeamformingCacheHelper cache (beamformingCache, "evaluate_spatial_sharing");
+  cache.SetIgnoreSeedAndRun (cacheAcrossRuns);
+  if (!beamformingCache.empty ())
+    {
+      beamformingRestored = cache.Load (dmgDevices);
+      std::cout << (beamformingRestored ? "Restored" : "No") << " beamforming state in " << beamformingCache << std::endl;
+    }
 
   /* Internet stack*/
   InternetStackHelper stack;
-  stack.Install (wifiNodes);
+  stack.Install (apNode);
+  stack.Install (srcNodes);
+  stack.Install (dstNodes);
 
   Ipv4AddressHelper address;
   address.SetBase ("10.0.0.0", "255.255.255.0");
-  Ipv4InterfaceContainer ApInterface;
-  ApInterface = address.Assign (apDevice);
-  Ipv4InterfaceContainer staInterfaces;
-  staInterfaces = address.Assign (staDevices);
+  Ipv4InterfaceContainer apInterface;
+  apInterface = address.Assign (apDevice);
+  Ipv4InterfaceContainer srcInterfaces;
+  srcInterfaces = address.Assign (srcDevices);
+  Ipv4InterfaceContainer dstInterfaces;
+  dstInterfaces = address.Assign (dstDevices);
 
   /* Populate routing table */
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
@@ -273,86 +377,73 @@ main (int argc, char *argv[])
 
   /*** Install Applications ***/
 
-  /* Install Simple UDP Server on North and East Nodes */
+  /* Install Simple UDP Server on the destination nodes */
   PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9999));
-  ApplicationContainer sinks = sinkHelper.Install (NodeContainer (northNode, eastNode));
-
-  /** North Node Variables **/
-  uint64_t northNodeLastTotalRx = 0;
-  double northNodeAverageThroughput = 0;
-
-  /* Install Simple UDP Transmiter on the West Node (Transmit to the North Node) */
-  ApplicationContainer srcApp1;
-  OnOffHelper src1 ("ns3::UdpSocketFactory", InetSocketAddress (staInterfaces.GetAddress (1), 9999));
-  src1.SetAttribute ("MaxBytes", UintegerValue (0));
-  src1.SetAttribute ("PacketSize", UintegerValue (payloadSize));
-  src1.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1e6]"));
-  src1.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
-  src1.SetAttribute ("DataRate", DataRateValue (DataRate (dataRate)));
-  srcApp1 = src1.Install (westNode);
-  srcApp1.Start (Seconds (3.0));
-
-  /** Node 4 Variables **/
-  uint64_t eastNodeLastTotalRx = 0;
-  double eastNodeAverageThroughput = 0;
-
-  /* Install Simple UDP Transmiter on the South Node (Transmit to the East Node) */
-  ApplicationContainer srcApp2;
-  OnOffHelper src2 ("ns3::UdpSocketFactory", InetSocketAddress (staInterfaces.GetAddress (3), 9999));
-  src2.SetAttribute ("MaxBytes", UintegerValue (0));
-  src2.SetAttribute ("PacketSize", UintegerValue (payloadSize));
-  src2.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1e6]"));
-  src2.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
-  src2.SetAttribute ("DataRate", DataRateValue (DataRate (dataRate)));
-  srcApp2 = src2.Install (southNode);
-  srcApp2.Start (Seconds (3.0));
+  sinks = sinkHelper.Install (dstNodes);
 
-  /* Schedule Throughput Calulcations */
-  Simulator::Schedule (Seconds (3.1), &CalculateThroughput, StaticCast<PacketSink> (sinks.Get (0)),
-                       northNodeLastTotalRx, northNodeAverageThroughput);
+  /* Install Simple UDP Transmiter on the source nodes */
+  for (uint32_t i = 0; i < numLinks; i++)
+    {
+      OnOffHelper src ("ns3::UdpSocketFactory", InetSocketAddress (dstInterfaces.GetAddress (i), 9999));
+      src.SetAttribute ("MaxBytes", UintegerValue (0));
+      src.SetAttribute ("PacketSize", UintegerValue (payloadSize));
+      src.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1e6]"));
+      src.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      src.SetAttribute ("DataRate", DataRateValue (DataRate (dataRate)));
+      ApplicationContainer srcApp = src.Install (srcNodes.Get (i));
+      srcApp.Start (Seconds (1.0));
+    }
 
-  Simulator::Schedule (Seconds (3.1), &CalculateThroughput, StaticCast<PacketSink> (sinks.Get (1)),
-                       eastNodeLastTotalRx, eastNodeAverageThroughput);
+  /* Schedule Throughput Calulcations */
+  Simulator::Schedule (Seconds (1.1), &CalculateThroughput, 0);
+  std::vector<uint64_t> warmupTotalRx (numLinks, 0);
+  Simulator::Schedule (Seconds (warmupTime), &StoreTotalRx, &warmupTotalRx);
 
   /* Enable Traces */
   if (pcapTracing)
     {
       wifiPhy.SetPcapDataLinkType (WifiPhyHelper::DLT_IEEE802_11_RADIO);
       wifiPhy.EnablePcap ("Traces/AccessPoint", apDevice, false);
-      wifiPhy.EnablePcap ("Traces/West_STA", staDevices.Get (0), false);
-      wifiPhy.EnablePcap ("Traces/North_STA", staDevices.Get (1), false);
-      wifiPhy.EnablePcap ("Traces/South_STA", staDevices.Get (2), false);
-      wifiPhy.EnablePcap ("Traces/East_STA", staDevices.Get (3), false);
+      wifiPhy.EnablePcap ("Traces/STA", staDevices, false);
     }
 
   /* DMG Stations */
-  apWifiNetDevice = StaticCast<WifiNetDevice> (apDevice.Get (0));
-  westWifiNetDevice = StaticCast<WifiNetDevice> (staDevices.Get (0));
-  northWifiNetDevice = StaticCast<WifiNetDevice> (staDevices.Get (1));
-  southWifiNetDevice = StaticCast<WifiNetDevice> (staDevices.Get (2));
-  eastWifiNetDevice = StaticCast<WifiNetDevice> (staDevices.Get (3));
-
-  apWifiMac = StaticCast<DmgApWifiMac> (apWifiNetDevice->GetMac ());
-  westWifiMac = StaticCast<DmgStaWifiMac> (westWifiNetDevice->GetMac ());
-  northWifiMac = StaticCast<DmgStaWifiMac> (northWifiNetDevice->GetMac ());
-  southWifiMac = StaticCast<DmgStaWifiMac> (southWifiNetDevice->GetMac ());
-  eastWifiMac = StaticCast<DmgStaWifiMac> (eastWifiNetDevice->GetMac ());
+  apWifiMac = StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  for (uint32_t i = 0; i < numLinks; i++)
+    {
+      srcWifiMacs.push_back (StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (srcDevices.Get (i))->GetMac ()));
+      dstWifiMacs.push_back (StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (dstDevices.Get (i))->GetMac ()));
+    }
 
   /** Connect Traces **/
-  westWifiMac->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&StationAssoicated, westWifiMac));
-  northWifiMac->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&StationAssoicated, northWifiMac));
-  southWifiMac->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&StationAssoicated, southWifiMac));
-  eastWifiMac->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&StationAssoicated, eastWifiMac));
-
-  westWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeBoundCallback (&SLSCompleted, westWifiMac));
-  northWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeBoundCallback (&SLSCompleted, northWifiMac));
-  southWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeBoundCallback (&SLSCompleted, southWifiMac));
-  eastWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeBoundCallback (&SLSCompleted, eastWifiMac));
+  for (NetDeviceContainer::Iterator i = staDevices.Begin (); i != staDevices.End (); ++i)
+    {
+      Ptr<DmgStaWifiMac> staWifiMac = StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (*i)->GetMac ());
+      staWifiMac->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&StationAssociated, staWifiMac));
+      staWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeBoundCallback (&SLSCompleted, staWifiMac));
+      staWifiMac->TraceConnectWithoutContext ("ADDTSResponse", MakeCallback (&ADDTSResponseReceived));
+    }
 
   Simulator::Stop (Seconds (simulationTime));
   Simulator::Run ();
+
+  if (!beamformingCache.empty () && !beamformingRestored)
+    {
+      cache.Save (dmgDevices);
+    }
+
+  /* Print the average throughput of each link after the warmup time */
+  double aggregateThroughput = 0;
+  for (uint32_t i = 0; i < numLinks; i++)
+    {
+      uint64_t totalRx = StaticCast<PacketSink> (sinks.Get (i))->GetTotalRx () - warmupTotalRx[i];
+      double throughput = totalRx * 8.0 / ((simulationTime - warmupTime) * 1e6);
+      std::cout << "Link " << i + 1 << " throughput = " << throughput << " Mbps" << std::endl;
+      aggregateThroughput += throughput;
+    }
+  std::cout << "Aggregate throughput = " << aggregateThroughput << " Mbps" << std::endl;
+
   Simulator::Destroy ();
 
   return 0;
 }
-
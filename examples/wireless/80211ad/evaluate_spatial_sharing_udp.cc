@@ -95,6 +95,7 @@ ReportMap m_reportsStatus;
 bool reportsReceived = false;             /* Initial quality reports received */
 uint8_t periodicity = 4;                  /* Periodicity of spatial sharing check-up */
 uint8_t currentPeriod;                    /* The remaining Beacon Intervals for the check-up */
+Time lastDtiStartTime;                    /* The start time of the last DTI of the PCP/AP */
 
 double
 CalculateSingleStreamThroughput (Ptr<PacketSink> sink, uint64_t &lastTotalRx, uint64_t &lastTotalPacket, double &averageThroughput)
@@ -187,16 +188,31 @@ SLSCompleted (Ptr<DmgWifiMac> staWifiMac, Mac48Address address, ChannelAccessPer
     }
 }
 
+void
+DataTransferIntervalStarted (Mac48Address address, Time dtiDuration)
+{
+  lastDtiStartTime = Simulator::Now ();
+}
+
+/* The Measurement Start Time is a TSF time: the start time of the SP relative to
+ * the DTI is converted to the DTI that follows the next one, which leaves a whole
+ * BI to deliver the request before the measurement starts. */
+uint64_t
+GetMeasurementStartTime (uint32_t spStartTime)
+{
+  return (lastDtiStartTime + apWifiMac->GetBeaconInterval () * 2).GetMicroSeconds () + spStartTime;
+}
+
 void
 AssesstInterference (Mac48Address address, uint8_t peerAid, MeasurementMethod method,
-                     uint32_t startTime, uint16_t spDuration, uint8_t blocks)
+                     uint32_t spStartTime, uint16_t spDuration, uint8_t blocks)
 {
   Ptr<DirectionalChannelQualityRequestElement> element = Create<DirectionalChannelQualityRequestElement> ();
   element->SetOperatingClass (0);
   element->SetChannelNumber (0);
   element->SetAid (peerAid);
   element->SetMeasurementMethod (method);
-  element->SetMeasurementStartTime (startTime);
+  element->SetMeasurementStartTime (GetMeasurementStartTime (spStartTime));
   element->SetMeasurementDuration (spDuration);
   element->SetNumberOfTimeBlocks (blocks);
   apWifiMac->SendDirectionalChannelQualityRequest (address, 1, element);
@@ -496,6 +512,7 @@ main (int argc, char *argv[])
   wifiMac4->TraceConnectWithoutContext ("SLSCompleted", MakeBoundCallback (&SLSCompleted, wifiMac4));
 
   apWifiMac->TraceConnectWithoutContext ("BIStarted", MakeCallback (&BeaconIntervalStarted));
+  apWifiMac->TraceConnectWithoutContext ("DTIStarted", MakeCallback (&DataTransferIntervalStarted));
   apWifiMac->TraceConnectWithoutContext ("ChannelQualityReportReceived", MakeCallback (&ChannelQualityReportReceived));
 
   /*** Interference Assessment ***/
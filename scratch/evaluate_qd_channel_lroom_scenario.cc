@@ -99,6 +99,11 @@ uint64_t macTxDataFailed = 0;
 uint64_t transmittedPackets = 0;
 uint64_t droppedPackets = 0;
 uint64_t receivedPackets = 0;
+uint32_t fullBeamTrainings = 0;
+uint32_t trackingBeamTrainings = 0;
+Time beamTrainingTime = Seconds (0);
+uint32_t beamLinkOutages = 0;
+Time beamLinkOutageTime = Seconds (0);
 bool csv = false;                         /* Enable CSV output. */
 
 /* Tracing */
@@ -196,6 +201,27 @@ SLSCompleted (Ptr<OutputStreamWrapper> stream, Ptr<Parameters> parameters, Mac48
     }
 }
 
+void
+BeamTrainingCompleted (Mac48Address address, bool partial, uint8_t sectors, Time duration)
+{
+  if (partial)
+    {
+      trackingBeamTrainings++;
+    }
+  else
+    {
+      fullBeamTrainings++;
+    }
+  beamTrainingTime += duration;
+}
+
+void
+BeamLinkRecovered (Mac48Address address, Time outage)
+{
+  beamLinkOutages++;
+  beamLinkOutageTime += outage;
+}
+
 void
 MacRxOk (Ptr<DmgWifiMac> WifiMac, Ptr<OutputStreamWrapper> stream,
          WifiMacType type, Mac48Address address, double snrValue)
@@ -343,6 +369,7 @@ main (int argc, char *argv[])
   bool verbose = false;                         /* Print Logging Information. */
   double simulationTime = 10;                   /* Simulation time [s]. */
   bool pcapTracing = false;                     /* PCAP Tracing is enabled or not. */
+  bool beamTracking = false;                    /* Restrict the TxSS around the predicted sector. */
   uint32_t interAllocDistance = 10;              /* Duration of a broadcast CBAP between two ADDTS allocations [us] */
   std::map<std::string, std::string> tcpVariants; /* List of the tcp Variants */
   uint16_t ac = 0;                              /* Select AC_BE as default AC */
@@ -380,6 +407,7 @@ main (int argc, char *argv[])
   cmd.AddValue ("phyMode", "802.11ad PHY Mode", phyMode);
   cmd.AddValue ("startDistance", "Starting distance in the trace file [0-260 m]", startDistance);
   cmd.AddValue ("biThreshold", "BI Threshold to trigger beamforming training", biThreshold);
+  cmd.AddValue ("beamTracking", "Restrict the beamforming training around the sector predicted from the previous ones", beamTracking);
   cmd.AddValue ("enableMobility", "Whether to enable mobility or simulate static scenario", enableMobility);
   cmd.AddValue ("verbose", "Turn on all WifiNetDevice log components", verbose);
   cmd.AddValue ("simulationTime", "Simulation time [s]", simulationTime);
@@ -398,6 +426,7 @@ main (int argc, char *argv[])
   Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("999999"));
   Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("999999"));
   Config::SetDefault ("ns3::QueueBase::MaxPackets", UintegerValue (queueSize));
+  Config::SetDefault ("ns3::DmgWifiMac::BeamTracking", BooleanValue (beamTracking));
   Config::SetDefault ("ns3::BasicDmgWifiScheduler::InterAllocationDistance", UintegerValue (interAllocDistance));
 
   std::vector<std::string> logComponents = SplitString (logComponentsStr, ':');
@@ -620,6 +649,8 @@ main (int argc, char *argv[])
   parametersSta->wifiMac = staWifiMac;
   staWifiMac->TraceConnectWithoutContext ("Assoc", MakeBoundCallback (&StationAssociated, staWifiMac));
   staWifiMac->TraceConnectWithoutContext ("SLSCompleted", MakeBoundCallback (&SLSCompleted, outputSlsPhase, parametersSta));
+  staWifiMac->TraceConnectWithoutContext ("BeamTrainingCompleted", MakeCallback (&BeamTrainingCompleted));
+  staWifiMac->TraceConnectWithoutContext ("BeamLinkRecovered", MakeCallback (&BeamLinkRecovered));
   staWifiMac->TraceConnectWithoutContext ("ADDTSResponse", MakeCallback (&ADDTSResponseReceived));
   staWifiPhy->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&PhyTxEnd));
   staRemoteStationManager->TraceConnectWithoutContext ("MacTxDataFailed", MakeCallback (&MacTxDataFailed));
@@ -691,6 +722,11 @@ main (int argc, char *argv[])
       /* Print MAC Layer Statistics */
       std::cout << "\nMAC Layer Statistics:" << std::endl;
       std::cout << "  Number of Failed Tx Data Packets:  " << macTxDataFailed << std::endl;
+      std::cout << "  Number of Full SLS:                " << fullBeamTrainings << std::endl;
+      std::cout << "  Number of Beam Tracking SLS:       " << trackingBeamTrainings << std::endl;
+      std::cout << "  Beamforming Training Time:         " << beamTrainingTime.GetMicroSeconds () << " us" << std::endl;
+      std::cout << "  Number of Beamformed Link Outages: " << beamLinkOutages << std::endl;
+      std::cout << "  Beamformed Link Outage Time:       " << beamLinkOutageTime.GetMicroSeconds () << " us" << std::endl;
 
       /* Print PHY Layer Statistics */
       std::cout << "\nPHY Layer Statistics:" << std::endl;
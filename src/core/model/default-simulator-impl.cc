@@ -277,6 +277,46 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
     }
 }
 
+void
+DefaultSimulatorImpl::ScheduleWithContextBatch (const std::vector<Simulator::ContextEvent> &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+
+  if (SystemThread::Equals (m_main))
+    {
+      std::vector<Scheduler::Event> batch (events.size ());
+      for (uint32_t i = 0; i < events.size (); i++)
+        {
+          Time tAbsolute = events[i].delay + TimeStep (m_currentTs);
+          batch[i].impl = events[i].event;
+          batch[i].key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+          batch[i].key.m_context = events[i].context;
+          batch[i].key.m_uid = m_uid;
+          m_uid++;
+        }
+      m_unscheduledEvents += events.size ();
+      m_events->InsertBatch (batch);
+    }
+  else
+    {
+      EventsWithContext batch;
+      for (std::vector<Simulator::ContextEvent>::const_iterator i = events.begin (); i != events.end (); ++i)
+        {
+          EventWithContext ev;
+          ev.context = i->context;
+          // Current time added in ProcessEventsWithContext()
+          ev.timestamp = i->delay.GetTimeStep ();
+          ev.event = i->event;
+          batch.push_back (ev);
+        }
+      {
+        CriticalSection cs (m_eventsWithContextMutex);
+        m_eventsWithContext.splice (m_eventsWithContext.end (), batch);
+        m_eventsWithContextEmpty = m_eventsWithContext.empty ();
+      }
+    }
+}
+
 EventId
 DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
 {
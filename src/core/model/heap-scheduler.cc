@@ -206,6 +206,30 @@ HeapScheduler::Insert (const Event &ev)
   BottomUp ();
 }
 
+void
+HeapScheduler::InsertBatch (const std::vector<Event> &evs)
+{
+  NS_LOG_FUNCTION (this << evs.size ());
+  uint32_t size = Last ();
+  m_heap.reserve (m_heap.size () + evs.size ());
+  if (evs.size () <= size)
+    {
+      for (std::vector<Event>::const_iterator i = evs.begin (); i != evs.end (); ++i)
+        {
+          m_heap.push_back (*i);
+          BottomUp ();
+        }
+      return;
+    }
+  /* The batch outnumbers the events already in the heap: append it
+   * and rebuild the heap bottom-up, which is linear in its size. */
+  m_heap.insert (m_heap.end (), evs.begin (), evs.end ());
+  for (uint32_t index = Parent (Last ()); index >= Root (); index--)
+    {
+      TopDown (index);
+    }
+}
+
 Scheduler::Event
 HeapScheduler::PeekNext (void) const
 {
@@ -24,6 +24,7 @@
 #include "assert.h"
 #include "log.h"
 #include <string>
+#include <algorithm>
 
 /**
  * \file
@@ -66,6 +67,24 @@ MapScheduler::Insert (const Event &ev)
   NS_ASSERT (result.second);
 }
 
+void
+MapScheduler::InsertBatch (const std::vector<Event> &evs)
+{
+  NS_LOG_FUNCTION (this << evs.size ());
+  /* Insert the events in increasing order so that each one can be
+   * placed right after the previous one in amortized constant time
+   * when no other event lies between them. */
+  std::vector<Event> sorted (evs);
+  std::sort (sorted.begin (), sorted.end ());
+  EventMapI hint = m_list.end ();
+  for (std::vector<Event>::const_iterator i = sorted.begin (); i != sorted.end (); ++i)
+    {
+      hint = m_list.insert (hint, std::make_pair (i->key, i->impl));
+      NS_ASSERT (hint->second == i->impl);
+      ++hint;
+    }
+}
+
 bool
 MapScheduler::IsEmpty (void) const
 {
@@ -39,6 +39,16 @@ Scheduler::~Scheduler ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+Scheduler::InsertBatch (const std::vector<Event> &evs)
+{
+  NS_LOG_FUNCTION (this << evs.size ());
+  for (std::vector<Event>::const_iterator i = evs.begin (); i != evs.end (); ++i)
+    {
+      Insert (*i);
+    }
+}
+
 TypeId
 Scheduler::GetTypeId (void)
 {
@@ -42,4 +42,14 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+void
+SimulatorImpl::ScheduleWithContextBatch (const std::vector<Simulator::ContextEvent> &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  for (std::vector<Simulator::ContextEvent>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      ScheduleWithContext (i->context, i->delay, i->event);
+    }
+}
+
 } // namespace ns3
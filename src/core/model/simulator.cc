@@ -280,6 +280,17 @@ Simulator::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *
 #endif
   return GetImpl ()->ScheduleWithContext (context, delay, impl);
 }
+void
+Simulator::ScheduleWithContextBatch (const std::vector<ContextEvent> &events)
+{
+#ifdef ENABLE_DES_METRICS
+  for (std::vector<ContextEvent>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      DesMetrics::Get ()->TraceWithContext (i->context, Now (), i->delay);
+    }
+#endif
+  return GetImpl ()->ScheduleWithContextBatch (events);
+}
 EventId
 Simulator::ScheduleDestroy (const Ptr<EventImpl> &ev)
 {
@@ -30,6 +30,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 /**
  * @file
@@ -1290,6 +1291,28 @@ public:
    */
   static void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
 
+  /**
+   * An event to be scheduled in a given context, see ScheduleWithContextBatch().
+   */
+  struct ContextEvent
+  {
+    uint32_t context;      //!< Event context.
+    Time delay;            //!< Delay until the event expires.
+    EventImpl *event;      //!< The event to schedule.
+  };
+
+  /**
+   * Schedule a batch of future event executions (in different contexts).
+   * This is equivalent to calling ScheduleWithContext() for each element
+   * of the batch in order, but lets the simulator implementation insert
+   * the whole batch at once, e.g. when a channel delivers the same
+   * transmission to all of its receivers.
+   * This method is thread-safe: it can be called from any thread.
+   *
+   * @param [in] events The events to schedule, with their context and delay.
+   */
+  static void ScheduleWithContextBatch (const std::vector<ContextEvent> &events);
+
   /**
    * Schedule an event to run at the end of the simulation, after
    * the Stop() time or condition has been reached.
@@ -168,6 +168,76 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorBatchTestCase : public TestCase
+{
+public:
+  SimulatorBatchTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Event (uint32_t id);
+  void ScheduleBatch (uint32_t first, uint32_t n);
+  std::vector<uint32_t> m_order;
+  bool m_contextOk;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorBatchTestCase::SimulatorBatchTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that batches of events are scheduled like single events with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorBatchTestCase::Event (uint32_t id)
+{
+  m_order.push_back (id);
+  if (id >= 100 && Simulator::GetContext () != id)
+    {
+      m_contextOk = false;
+    }
+}
+
+void
+SimulatorBatchTestCase::ScheduleBatch (uint32_t first, uint32_t n)
+{
+  /* Later events of the batch expire first, pairs of events expire together */
+  std::vector<Simulator::ContextEvent> events;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Simulator::ContextEvent ev = {first + i, MicroSeconds ((n - i) / 2 + 1),
+                                    MakeEvent (&SimulatorBatchTestCase::Event, this, first + i)};
+      events.push_back (ev);
+    }
+  Simulator::ScheduleWithContextBatch (events);
+}
+
+void
+SimulatorBatchTestCase::DoRun (void)
+{
+  m_contextOk = true;
+  Simulator::SetScheduler (m_schedulerFactory);
+
+  /* A batch smaller than the event list, then a batch larger than it */
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorBatchTestCase::Event, this, i);
+    }
+  ScheduleBatch (100, 4);
+  Simulator::Schedule (MicroSeconds (30), &SimulatorBatchTestCase::ScheduleBatch, this, 200, 9);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  uint32_t expected[] = {0, 1, 103, 2, 101, 102, 3, 100, 4, 5,
+                         208, 206, 207, 204, 205, 202, 203, 200, 201};
+  uint32_t size = sizeof (expected) / sizeof (expected[0]);
+  NS_TEST_ASSERT_MSG_EQ (m_order.size (), size, "Unexpected number of events");
+  for (uint32_t i = 0; i < size; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_order[i], expected[i], "Unexpected order of events");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_contextOk, true, "Events of the batch did not run in their context");
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -475,5 +545,14 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (ListScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SimulatorBatchTestCase (factory), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
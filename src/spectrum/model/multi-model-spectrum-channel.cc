@@ -34,6 +34,13 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <ns3/uinteger.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#include <pthread.h>
+#endif
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include "multi-model-spectrum-channel.h"
@@ -81,7 +88,141 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 }
 
 
+#ifdef HAVE_PTHREAD_H
+/**
+ * Persistent pool of worker threads running the pending propagation jobs of
+ * the signals of a channel. The threads are started once and wait for the
+ * next batch of jobs between two transmissions.
+ */
+class MultiModelSpectrumChannel::PropagationWorkerPool
+{
+public:
+  /**
+   * Start the worker threads.
+   *
+   * \param nThreads the number of worker threads
+   */
+  PropagationWorkerPool (uint32_t nThreads)
+    : m_jobs (0),
+      m_next (0),
+      m_done (0),
+      m_batch (0),
+      m_stop (false)
+  {
+    pthread_mutex_init (&m_mutex, 0);
+    pthread_cond_init (&m_batchReady, 0);
+    pthread_cond_init (&m_batchDone, 0);
+    for (uint32_t i = 0; i < nThreads; i++)
+      {
+        Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&PropagationWorkerPool::Work, this));
+        thread->Start ();
+        m_threads.push_back (thread);
+      }
+  }
+  /**
+   * Stop and join the worker threads.
+   */
+  ~PropagationWorkerPool ()
+  {
+    pthread_mutex_lock (&m_mutex);
+    m_stop = true;
+    pthread_cond_broadcast (&m_batchReady);
+    pthread_mutex_unlock (&m_mutex);
+    for (std::vector<Ptr<SystemThread> >::iterator it = m_threads.begin (); it != m_threads.end (); ++it)
+      {
+        (*it)->Join ();
+      }
+    pthread_cond_destroy (&m_batchDone);
+    pthread_cond_destroy (&m_batchReady);
+    pthread_mutex_destroy (&m_mutex);
+  }
+  /**
+   * \return the number of worker threads
+   */
+  uint32_t GetNThreads (void) const
+  {
+    return m_threads.size ();
+  }
+  /**
+   * Run a batch of jobs on the worker threads and on the calling thread,
+   * and return once all of them have been run.
+   *
+   * \param jobs the jobs to be run
+   */
+  void Run (const std::vector<SpectrumPropagationLossJob *> &jobs)
+  {
+    pthread_mutex_lock (&m_mutex);
+    m_jobs = &jobs;
+    m_next = 0;
+    m_done = 0;
+    m_batch++;
+    pthread_cond_broadcast (&m_batchReady);
+    RunJobs ();
+    while (m_done < jobs.size ())
+      {
+        pthread_cond_wait (&m_batchDone, &m_mutex);
+      }
+    m_jobs = 0;
+    pthread_mutex_unlock (&m_mutex);
+  }
+
+private:
+  /**
+   * Run the jobs of the current batch until none is left. Called with
+   * m_mutex held, which is released while a job is running.
+   */
+  void RunJobs (void)
+  {
+    while (m_jobs != 0 && m_next < m_jobs->size ())
+      {
+        SpectrumPropagationLossJob *job = (*m_jobs)[m_next++];
+        pthread_mutex_unlock (&m_mutex);
+        job->Run ();
+        pthread_mutex_lock (&m_mutex);
+        if (++m_done == m_jobs->size ())
+          {
+            pthread_cond_signal (&m_batchDone);
+          }
+      }
+  }
+  /**
+   * Body of the worker threads.
+   */
+  void Work (void)
+  {
+    uint64_t batch = 0;
+    pthread_mutex_lock (&m_mutex);
+    while (true)
+      {
+        while (!m_stop && m_batch == batch)
+          {
+            pthread_cond_wait (&m_batchReady, &m_mutex);
+          }
+        if (m_stop)
+          {
+            break;
+          }
+        batch = m_batch;
+        RunJobs ();
+      }
+    pthread_mutex_unlock (&m_mutex);
+  }
+
+  std::vector<Ptr<SystemThread> > m_threads;                 //!< the worker threads
+  const std::vector<SpectrumPropagationLossJob *> *m_jobs;  //!< the jobs of the current batch
+  std::size_t m_next;                                        //!< index of the next job to be run
+  std::size_t m_done;                                        //!< number of jobs of the batch already run
+  uint64_t m_batch;                                          //!< sequence number of the current batch
+  bool m_stop;                                               //!< whether the worker threads have to exit
+  pthread_mutex_t m_mutex;                                   //!< protects the state of the pool
+  pthread_cond_t m_batchReady;                               //!< signaled when a batch is submitted
+  pthread_cond_t m_batchDone;                                //!< signaled when a batch is complete
+};
+#endif /* HAVE_PTHREAD_H */
+
+
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_workerPool (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -95,6 +236,10 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+#ifdef HAVE_PTHREAD_H
+  delete m_workerPool;
+  m_workerPool = 0;
+#endif /* HAVE_PTHREAD_H */
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +264,17 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("PropagationThreads",
+                   "The number of worker threads used to evaluate the "
+                   "SpectrumPropagationLossModel of the receivers of a "
+                   "signal in parallel. The received signals are scheduled "
+                   "on the simulator thread in the same order as in serial "
+                   "mode, so that the results do not depend on this value. "
+                   "A value of 0 disables parallel evaluation. This has no "
+                   "effect if ns-3 has been built without threading support.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultiModelSpectrumChannel::m_propagationThreads),
+                   MakeUintegerChecker<uint32_t> ())
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -267,8 +423,11 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
-  Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
-  m_txSigParamsTrace (txParamsTrace);
+  if (!m_txSigParamsTrace.IsEmpty ())
+    {
+      Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
+      m_txSigParamsTrace (txParamsTrace);
+    }
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
@@ -282,6 +441,21 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // The propagation towards each receiver is evaluated in three steps: the
+  // receivers are first visited on the simulator thread, the pending
+  // spectrum propagation loss jobs are then run (possibly in parallel), and
+  // the receptions are finally scheduled on the simulator thread in the
+  // order in which the receivers have been visited.
+  struct PendingRx
+  {
+    Ptr<SpectrumSignalParameters> rxParams;
+    Ptr<SpectrumPhy> rxPhy;
+    Ptr<SpectrumPropagationLossJob> job;
+    Time delay;
+  };
+  std::vector<PendingRx> pendingRxList;
+  std::vector<SpectrumPropagationLossJob *> pendingJobs;
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -318,19 +492,23 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           if ((*rxPhyIterator) != txParams->txPhy)
             {
               NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
+              PendingRx pendingRx;
+              pendingRx.rxPhy = *rxPhyIterator;
+              pendingRx.rxParams = txParams->Copy ();
+              // the PSD is shared among all receivers and treated as read-only;
+              // a private copy is made only if a gain has to be applied to it
+              pendingRx.rxParams->psd = convertedTxPowerSpectrum;
+              pendingRx.delay = MicroSeconds (0);
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
               if (txMobility && receiverMobility)
                 {
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  if (pendingRx.rxParams->txAntenna != 0)
                     {
                       Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      double txAntennaGain = pendingRx.rxParams->txAntenna->GetGainDb (txAngles);
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
@@ -347,47 +525,94 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
                       NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
                       pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
+                    }
+                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
                   m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
                   if ( pathLossDb > m_maxLossDb)
                     {
                       // beyond range
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
+                  if (pathLossDb != 0)
+                    {
+                      double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                      pendingRx.rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+                      *(pendingRx.rxParams->psd) *= pathGainLinear;
+                    }
 
                   if (m_spectrumPropagationLoss)
                     {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+                      pendingRx.job = m_spectrumPropagationLoss->PrepareRxPowerSpectralDensity (pendingRx.rxParams->psd,
+                                                                                               txMobility, receiverMobility);
+                      if (pendingRx.job->IsPending ())
+                        {
+                          pendingJobs.push_back (PeekPointer (pendingRx.job));
+                        }
                     }
 
                   if (m_propagationDelay)
                     {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+                      pendingRx.delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
                     }
                 }
 
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
-                {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
-                }
-              else
-                {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
-                }
+              pendingRxList.push_back (pendingRx);
             }
         }
 
     }
 
+  RunPropagationJobs (pendingJobs);
+
+  std::vector<Simulator::ContextEvent> events;
+  events.reserve (pendingRxList.size ());
+  for (std::vector<PendingRx>::iterator it = pendingRxList.begin (); it != pendingRxList.end (); ++it)
+    {
+      if (it->job)
+        {
+          it->rxParams->psd = it->job->Finish ();
+        }
+
+      Simulator::ContextEvent ev = {Simulator::GetContext (), it->delay,
+                                    MakeEvent (&MultiModelSpectrumChannel::StartRx, this, it->rxParams, it->rxPhy)};
+      Ptr<NetDevice> netDev = it->rxPhy->GetDevice ();
+      if (netDev)
+        {
+          // the receiver has a NetDevice, so we expect that it is attached to a Node
+          ev.context = netDev->GetNode ()->GetId ();
+        }
+      // otherwise the receiver is not attached to a NetDevice, so we cannot assume
+      // that it is attached to a node and the event keeps the current context
+      events.push_back (ev);
+    }
+  Simulator::ScheduleWithContextBatch (events);
+}
+
+void
+MultiModelSpectrumChannel::RunPropagationJobs (const std::vector<SpectrumPropagationLossJob *> &jobs)
+{
+  NS_LOG_FUNCTION (this << jobs.size ());
+#ifdef HAVE_PTHREAD_H
+  if (m_propagationThreads > 0 && jobs.size () > 1)
+    {
+      if (m_workerPool != 0 && m_workerPool->GetNThreads () != m_propagationThreads)
+        {
+          delete m_workerPool;
+          m_workerPool = 0;
+        }
+      if (m_workerPool == 0)
+        {
+          m_workerPool = new PropagationWorkerPool (m_propagationThreads);
+        }
+      // the simulator thread works on the jobs as well
+      m_workerPool->Run (jobs);
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  for (std::vector<SpectrumPropagationLossJob *>::const_iterator it = jobs.begin (); it != jobs.end (); ++it)
+    {
+      (*it)->Run ();
+    }
 }
 
 void
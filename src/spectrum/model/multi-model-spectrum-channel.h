@@ -29,6 +29,7 @@
 #include <ns3/propagation-delay-model.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -164,6 +165,14 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Run the pending spectrum propagation loss jobs of a signal, either
+   * inline or on the m_propagationThreads threads of the worker pool.
+   *
+   * @param jobs the jobs to be run.
+   */
+  void RunPropagationJobs (const std::vector<SpectrumPropagationLossJob *> &jobs);
+
   /**
    * Propagation delay model to be used with this channel.
    */
@@ -207,6 +216,19 @@ private:
    */
   double m_maxLossDb;
 
+  /**
+   * Number of worker threads used to evaluate the spectrum propagation
+   * loss of the receivers of a signal in parallel (0 means serial).
+   */
+  uint32_t m_propagationThreads;
+
+  class PropagationWorkerPool;
+  /**
+   * Worker threads evaluating the spectrum propagation loss, started on
+   * the first signal evaluated in parallel.
+   */
+  PropagationWorkerPool *m_workerPool;
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
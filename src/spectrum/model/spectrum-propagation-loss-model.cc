@@ -28,6 +28,33 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumPropagationLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (SpectrumPropagationLossModel);
 
+SpectrumPropagationLossJob::SpectrumPropagationLossJob (Ptr<SpectrumValue> rxPsd)
+  : m_rxPsd (rxPsd)
+{
+}
+
+SpectrumPropagationLossJob::~SpectrumPropagationLossJob ()
+{
+}
+
+bool
+SpectrumPropagationLossJob::IsPending (void) const
+{
+  return false;
+}
+
+void
+SpectrumPropagationLossJob::Run (void)
+{
+}
+
+Ptr<SpectrumValue>
+SpectrumPropagationLossJob::Finish (void)
+{
+  return m_rxPsd;
+}
+
+
 SpectrumPropagationLossModel::SpectrumPropagationLossModel ()
   : m_next (0)
 {
@@ -73,4 +100,24 @@ SpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const SpectrumValu
   return rxPsd;
 }
 
+Ptr<SpectrumPropagationLossJob>
+SpectrumPropagationLossModel::PrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                             Ptr<const MobilityModel> a,
+                                                             Ptr<const MobilityModel> b) const
+{
+  if (m_next != 0)
+    {
+      return Create<SpectrumPropagationLossJob> (CalcRxPowerSpectralDensity (txPsd, a, b));
+    }
+  return DoPrepareRxPowerSpectralDensity (txPsd, a, b);
+}
+
+Ptr<SpectrumPropagationLossJob>
+SpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                               Ptr<const MobilityModel> a,
+                                                               Ptr<const MobilityModel> b) const
+{
+  return Create<SpectrumPropagationLossJob> (DoCalcRxPowerSpectralDensity (txPsd, a, b));
+}
+
 } // namespace ns3
@@ -23,12 +23,55 @@
 
 
 #include <ns3/object.h>
+#include <ns3/simple-ref-count.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-value.h>
 
 namespace ns3 {
 
 
+/**
+ * \ingroup spectrum
+ *
+ * \brief deferred computation of a received power spectral density
+ *
+ * A job is returned by SpectrumPropagationLossModel::PrepareRxPowerSpectralDensity.
+ * The job is created and finished on the simulator thread, while Run () may
+ * be executed on a worker thread concurrently with the jobs of the other
+ * receivers of the same signal. Since ns-3 reference counts are not
+ * thread-safe, Run () must only access data captured by the job itself and
+ * must neither create, copy nor release any Ptr to objects which might be
+ * shared with other jobs.
+ *
+ * The base class represents a job whose result is already available.
+ */
+class SpectrumPropagationLossJob : public SimpleRefCount<SpectrumPropagationLossJob>
+{
+public:
+  /**
+   * \param rxPsd the received PSD, or 0 if it will be computed by Run ()
+   */
+  SpectrumPropagationLossJob (Ptr<SpectrumValue> rxPsd);
+  virtual ~SpectrumPropagationLossJob ();
+
+  /**
+   * \return true if Run () has to be called before Finish ()
+   */
+  virtual bool IsPending (void) const;
+  /**
+   * Perform the computation. It may be executed on a worker thread.
+   */
+  virtual void Run (void);
+  /**
+   * Complete the computation on the simulator thread.
+   *
+   * \return set of values Vs frequency representing the received power.
+   */
+  virtual Ptr<SpectrumValue> Finish (void);
+
+protected:
+  Ptr<SpectrumValue> m_rxPsd; //!< the received PSD
+};
 
 
 /**
@@ -78,6 +121,26 @@ public:
                                                  Ptr<const MobilityModel> a,
                                                  Ptr<const MobilityModel> b) const;
 
+  /**
+   * Same as CalcRxPowerSpectralDensity, but split in a part executed on the
+   * simulator thread (this method and SpectrumPropagationLossJob::Finish)
+   * and a part which can be executed on a worker thread
+   * (SpectrumPropagationLossJob::Run). The result is identical to the one
+   * of CalcRxPowerSpectralDensity.
+   *
+   * Chained models are always evaluated by this method.
+   *
+   * @param txPsd the SpectrumValue representing the power spectral
+   * density of the transmission.
+   * @param a sender mobility
+   * @param b receiver mobility
+   *
+   * @return the job computing the received power spectral density.
+   */
+  Ptr<SpectrumPropagationLossJob> PrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                 Ptr<const MobilityModel> a,
+                                                                 Ptr<const MobilityModel> b) const;
+
 protected:
   virtual void DoDispose ();
 
@@ -96,6 +159,21 @@ private:
   virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
                                                            Ptr<const MobilityModel> a,
                                                            Ptr<const MobilityModel> b) const = 0;
+  /**
+   * Subclasses supporting concurrent evaluation should override this
+   * method. The default implementation computes the result immediately
+   * through DoCalcRxPowerSpectralDensity.
+   *
+   * @param txPsd set of values Vs frequency representing the
+   * transmission power. See SpectrumChannel for details.
+   * @param a sender mobility
+   * @param b receiver mobility
+   *
+   * @return the job computing the received power spectral density.
+   */
+  virtual Ptr<SpectrumPropagationLossJob> DoPrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                           Ptr<const MobilityModel> a,
+                                                                           Ptr<const MobilityModel> b) const;
 
   Ptr<SpectrumPropagationLossModel> m_next; //!< SpectrumPropagationLossModel chained to this one.
 };
@@ -90,6 +90,11 @@ struct SpectrumSignalParameters : public SimpleRefCount<SpectrumSignalParameters
    * be defined.
    *
    * \note when SpectrumSignalParameters is copied, only the pointer to the PSD will be copied. This is because SpectrumChannel objects normally overwrite the psd anyway, so there is no point in making a copy.
+   *
+   * \note the PSD delivered to a receiver may be shared with the transmitter
+   * and with the other receivers of the same signal, hence it must be
+   * treated as read-only. A SpectrumPhy that needs to modify it has to make
+   * its own copy first.
    */
   Ptr <SpectrumValue> psd;
 
@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-value.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MultiModelSpectrumChannelThreadsTest");
+
+/**
+ * Frequency selective loss whose evaluation is deferred to
+ * SpectrumPropagationLossJob::Run (), so that it is executed by the
+ * worker threads of the channel.
+ */
+class DeferredTestSpectrumPropagationLossModel : public SpectrumPropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param psd the PSD to be attenuated in place
+   * \param distance the distance between the transmitter and the receiver
+   */
+  static void Attenuate (SpectrumValue &psd, double distance);
+
+private:
+  /// Job attenuating a private copy of the transmitted PSD.
+  class Job : public SpectrumPropagationLossJob
+  {
+  public:
+    Job (Ptr<SpectrumValue> rxPsd, double distance)
+      : SpectrumPropagationLossJob (rxPsd),
+        m_distance (distance)
+    {
+    }
+    virtual bool IsPending (void) const
+    {
+      return true;
+    }
+    virtual void Run (void)
+    {
+      Attenuate (*m_rxPsd, m_distance);
+    }
+
+  private:
+    double m_distance; //!< distance between the transmitter and the receiver
+  };
+
+  virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                           Ptr<const MobilityModel> a,
+                                                           Ptr<const MobilityModel> b) const;
+  virtual Ptr<SpectrumPropagationLossJob> DoPrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                           Ptr<const MobilityModel> a,
+                                                                           Ptr<const MobilityModel> b) const;
+};
+
+TypeId
+DeferredTestSpectrumPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DeferredTestSpectrumPropagationLossModel")
+    .SetParent<SpectrumPropagationLossModel> ()
+    .SetGroupName ("Spectrum")
+    .AddConstructor<DeferredTestSpectrumPropagationLossModel> ()
+  ;
+  return tid;
+}
+
+void
+DeferredTestSpectrumPropagationLossModel::Attenuate (SpectrumValue &psd, double distance)
+{
+  uint32_t band = 0;
+  for (Values::iterator it = psd.ValuesBegin (); it != psd.ValuesEnd (); ++it, ++band)
+    {
+      // some work per band, so that the jobs of the receivers overlap in time
+      double gain = 1.0;
+      for (uint32_t i = 0; i < 1000; i++)
+        {
+          gain *= 1.0 / (1.0 + 1e-4 * distance * (band + 1));
+        }
+      *it *= gain;
+    }
+}
+
+Ptr<SpectrumValue>
+DeferredTestSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                         Ptr<const MobilityModel> a,
+                                                                         Ptr<const MobilityModel> b) const
+{
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
+  Attenuate (*rxPsd, a->GetDistanceFrom (b));
+  return rxPsd;
+}
+
+Ptr<SpectrumPropagationLossJob>
+DeferredTestSpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                           Ptr<const MobilityModel> a,
+                                                                           Ptr<const MobilityModel> b) const
+{
+  return Create<Job> (Copy<SpectrumValue> (txPsd), a->GetDistanceFrom (b));
+}
+
+/**
+ * SpectrumPhy recording the total power of the last signal it received.
+ */
+class ThreadsTestSpectrumPhy : public SpectrumPhy
+{
+public:
+  ThreadsTestSpectrumPhy (Ptr<const SpectrumModel> model, Ptr<MobilityModel> mobility)
+    : m_model (model),
+      m_mobility (mobility),
+      m_rxPower (0)
+  {
+  }
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return m_model;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_rxPower = Integral (*params->psd);
+  }
+  double GetRxPower (void) const
+  {
+    return m_rxPower;
+  }
+
+private:
+  Ptr<const SpectrumModel> m_model;
+  Ptr<MobilityModel> m_mobility;
+  double m_rxPower;
+};
+
+/**
+ * Check that the power received through a MultiModelSpectrumChannel does not
+ * depend on the number of threads evaluating the spectrum propagation loss.
+ */
+class MultiModelSpectrumChannelThreadsTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelThreadsTestCase ();
+  virtual ~MultiModelSpectrumChannelThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send a few signals from each node to all the other ones.
+   * \param threads the value of the PropagationThreads attribute
+   * \return the power received by each node after each signal
+   */
+  std::vector<double> GetRxPowers (uint32_t threads);
+};
+
+MultiModelSpectrumChannelThreadsTestCase::MultiModelSpectrumChannelThreadsTestCase ()
+  : TestCase ("Check that serial and parallel propagation give the same received power")
+{
+}
+
+MultiModelSpectrumChannelThreadsTestCase::~MultiModelSpectrumChannelThreadsTestCase ()
+{
+}
+
+std::vector<double>
+MultiModelSpectrumChannelThreadsTestCase::GetRxPowers (uint32_t threads)
+{
+  const uint32_t nNodes = 8;
+  const uint32_t nSignals = 3;
+
+  Bands bands;
+  for (uint32_t i = 0; i < 64; i++)
+    {
+      BandInfo band;
+      band.fl = 60e9 + i * 1e6;
+      band.fc = band.fl + 0.5e6;
+      band.fh = band.fl + 1e6;
+      bands.push_back (band);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (bands);
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (model);
+  (*txPsd) = 1e-9;
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("PropagationThreads", UintegerValue (threads));
+  channel->AddSpectrumPropagationLossModel (CreateObject<DeferredTestSpectrumPropagationLossModel> ());
+
+  std::vector<Ptr<ThreadsTestSpectrumPhy> > phys;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (i * 3.0, (i % 3) * 2.0, 0.0));
+      Ptr<ThreadsTestSpectrumPhy> phy = Create<ThreadsTestSpectrumPhy> (model, mobility);
+      channel->AddRx (phy);
+      phys.push_back (phy);
+    }
+
+  std::vector<double> rxPowers;
+  for (uint32_t signal = 0; signal < nSignals; signal++)
+    {
+      for (uint32_t tx = 0; tx < nNodes; tx++)
+        {
+          Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+          params->psd = txPsd;
+          params->duration = MicroSeconds (10);
+          params->txPhy = phys[tx];
+          Simulator::ScheduleNow (&MultiModelSpectrumChannel::StartTx, channel, params);
+          Simulator::Run ();
+          for (uint32_t rx = 0; rx < nNodes; rx++)
+            {
+              if (rx != tx)
+                {
+                  rxPowers.push_back (phys[rx]->GetRxPower ());
+                }
+            }
+        }
+    }
+  channel->Dispose ();
+  Simulator::Destroy ();
+  return rxPowers;
+}
+
+void
+MultiModelSpectrumChannelThreadsTestCase::DoRun (void)
+{
+  std::vector<double> serial = GetRxPowers (0);
+  for (uint32_t threads = 1; threads <= 4; threads++)
+    {
+      std::vector<double> parallel = GetRxPowers (threads);
+      NS_TEST_ASSERT_MSG_EQ (parallel.size (), serial.size (), "Different number of received signals");
+      for (uint32_t i = 0; i < serial.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_GT (serial[i], 0, "No power received");
+          // the computation is identical whatever the thread, hence the results are bit-identical
+          NS_TEST_ASSERT_MSG_EQ (parallel[i], serial[i], "Different received power with " << threads << " threads");
+        }
+    }
+}
+
+/**
+ * Test suite for the parallel evaluation of the spectrum propagation loss.
+ */
+class MultiModelSpectrumChannelThreadsTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelThreadsTestSuite ();
+};
+
+MultiModelSpectrumChannelThreadsTestSuite::MultiModelSpectrumChannelThreadsTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel-threads", UNIT)
+{
+  AddTestCase (new MultiModelSpectrumChannelThreadsTestCase, TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelThreadsTestSuite multiModelSpectrumChannelThreadsTestSuite;
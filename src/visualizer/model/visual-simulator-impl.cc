@@ -162,6 +162,12 @@ VisualSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, E
   m_simulator->ScheduleWithContext (context, delay, event);
 }
 
+void
+VisualSimulatorImpl::ScheduleWithContextBatch (const std::vector<Simulator::ContextEvent> &events)
+{
+  m_simulator->ScheduleWithContextBatch (events);
+}
+
 EventId
 VisualSimulatorImpl::ScheduleNow (EventImpl *event)
 {
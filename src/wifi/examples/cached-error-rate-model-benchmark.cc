@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+#include <iomanip>
+
+//
+// This program compares the accuracy and the speed of the CachedErrorRateModel
+// against the error rate model it wraps, either the DmgErrorModel or the
+// SensitivityModel60GHz (--model option).
+//
+// For every MCS, chunks of random sizes (up to the
+// size of the largest DMG A-MPDU) are evaluated at random SNRs by both models.
+// The program reports the largest absolute difference of the chunk success
+// rates and the time spent by each model.
+//
+// The tables file is looked up relative to the working directory, so the
+// program is normally run from the top of the repository:
+//
+// ./waf --run "cached-error-rate-model-benchmark --iterations=200000"
+//
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string model = "ns3::DmgErrorModel";
+  std::string fileName = "DmgFiles/ErrorModel/LookupTable_1458.txt";
+  uint32_t numMcs = 25;
+  uint32_t iterations = 100000;
+  uint32_t maxPayloadSize = 262143;
+  double minSnr = -10.0;
+  double maxSnr = 25.0;
+
+  CommandLine cmd;
+  cmd.AddValue ("model", "The error rate model to cache [ns3::DmgErrorModel, ns3::SensitivityModel60GHz]", model);
+  cmd.AddValue ("fileName", "The name of the file that contains SNR to BER tables", fileName);
+  cmd.AddValue ("numMcs", "The number of MCSs (starting from MCS0) to evaluate", numMcs);
+  cmd.AddValue ("iterations", "The number of chunks evaluated per MCS", iterations);
+  cmd.AddValue ("maxPayloadSize", "The largest chunk size in bytes", maxPayloadSize);
+  cmd.AddValue ("minSnr", "The lowest SNR of the chunks in dB", minSnr);
+  cmd.AddValue ("maxSnr", "The highest SNR of the chunks in dB", maxSnr);
+  cmd.Parse (argc, argv);
+
+  ObjectFactory factory;
+  factory.SetTypeId (model);
+  if (model == "ns3::DmgErrorModel")
+    {
+      factory.Set ("FileName", StringValue (fileName));
+    }
+  Ptr<ErrorRateModel> reference = factory.Create<ErrorRateModel> ();
+  Ptr<CachedErrorRateModel> cached = CreateObject<CachedErrorRateModel> ();
+  cached->SetErrorRateModel (reference);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  std::vector<double> snrs (iterations);
+  std::vector<uint64_t> sizes (iterations);
+
+  std::cout << std::setw (10) << "MCS"
+            << std::setw (16) << "MaxError"
+            << std::setw (16) << "Reference[ms]"
+            << std::setw (16) << "Cached[ms]" << std::endl;
+
+  double maxError = 0;
+  int64_t referenceTime = 0;
+  int64_t cachedTime = 0;
+  for (uint32_t mcs = 0; mcs < numMcs; mcs++)
+    {
+      std::ostringstream name;
+      name << "DMG_MCS" << mcs;
+      WifiMode mode (name.str ());
+      WifiTxVector txVector;
+      txVector.SetMode (mode);
+      txVector.SetChannelWidth (2160);
+      for (uint32_t i = 0; i < iterations; i++)
+        {
+          snrs[i] = DbToRatio (random->GetValue (minSnr, maxSnr));
+          sizes[i] = random->GetInteger (1, maxPayloadSize * 8);
+        }
+
+      std::vector<double> referencePsrs (iterations);
+      std::vector<double> cachedPsrs (iterations);
+      /* Fill the tables before measuring the cached model */
+      cached->GetChunkSuccessRate (mode, txVector, snrs[0], sizes[0]);
+
+      SystemWallClockMs clock;
+      clock.Start ();
+      for (uint32_t i = 0; i < iterations; i++)
+        {
+          referencePsrs[i] = reference->GetChunkSuccessRate (mode, txVector, snrs[i], sizes[i]);
+        }
+      int64_t mcsReferenceTime = clock.End ();
+
+      clock.Start ();
+      for (uint32_t i = 0; i < iterations; i++)
+        {
+          cachedPsrs[i] = cached->GetChunkSuccessRate (mode, txVector, snrs[i], sizes[i]);
+        }
+      int64_t mcsCachedTime = clock.End ();
+
+      double mcsMaxError = 0;
+      for (uint32_t i = 0; i < iterations; i++)
+        {
+          mcsMaxError = std::max (mcsMaxError, std::abs (referencePsrs[i] - cachedPsrs[i]));
+        }
+
+      std::cout << std::setw (10) << mcs
+                << std::setw (16) << mcsMaxError
+                << std::setw (16) << mcsReferenceTime
+                << std::setw (16) << mcsCachedTime << std::endl;
+      maxError = std::max (maxError, mcsMaxError);
+      referenceTime += mcsReferenceTime;
+      cachedTime += mcsCachedTime;
+    }
+
+  std::cout << std::setw (10) << "All"
+            << std::setw (16) << maxError
+            << std::setw (16) << referenceTime
+            << std::setw (16) << cachedTime << std::endl;
+
+  return 0;
+}
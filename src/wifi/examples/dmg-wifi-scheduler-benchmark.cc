@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+#include <iomanip>
+
+//
+// This program measures the cost of the admission control of the DMG schedulers
+// under ADDTS storms.
+//
+// In every beacon interval, each of the stations requests a new non-static SP
+// allocation, then asks for a shorter allocation. At the end of the beacon
+// interval, the allocations are announced and the next DTI is planned, as done
+// by the PCP/AP. The requests are fed directly to the admission policy of the
+// scheduler, so that the program measures the scheduler alone. The program
+// reports the average time per beacon interval and the number of accepted
+// requests.
+//
+// ./waf --run "dmg-wifi-scheduler-benchmark --maxStations=256"
+//
+
+using namespace ns3;
+
+/**
+ * Expose the admission policy of a DMG scheduler to the benchmark.
+ */
+template <typename Scheduler>
+class SchedulerUnderTest : public Scheduler
+{
+public:
+  /**
+   * Start a new beacon interval.
+   * \param biDuration The duration of the BI.
+   * \param dtiDuration The duration of the DTI.
+   */
+  void StartBeaconInterval (Time biDuration, Time dtiDuration)
+  {
+    this->m_biDuration = biDuration;
+    this->m_dtiDuration = dtiDuration;
+    this->UpdateStartAndRemainingTime ();
+  }
+  /**
+   * \param sourceAid The AID of the requesting STA.
+   * \param dmgTspec The DMG TSPEC of the request.
+   * \param modify Whether the request modifies an existing allocation.
+   * \return whether the request has been accepted.
+   */
+  bool Request (uint8_t sourceAid, const DmgTspecElement &dmgTspec, bool modify)
+  {
+    DmgAllocationInfo info = dmgTspec.GetDmgAllocationInfo ();
+    if (modify)
+      {
+        return this->ModifyExistingAllocation (sourceAid, dmgTspec, info).IsSuccess ();
+      }
+    return this->AddNewAllocation (sourceAid, dmgTspec, info).IsSuccess ();
+  }
+  /**
+   * End the current beacon interval.
+   */
+  void EndBeaconInterval (void)
+  {
+    this->SetAllocationsAnnounced ();
+    this->BeaconIntervalEnded ();
+  }
+};
+
+static DmgTspecElement
+GetDmgTspecElement (uint16_t allocationPeriod, uint16_t minAllocation, uint16_t maxAllocation)
+{
+  DmgTspecElement element;
+  DmgAllocationInfo info;
+  info.SetAllocationID (1);
+  info.SetAllocationType (SERVICE_PERIOD_ALLOCATION);
+  info.SetAllocationFormat (ISOCHRONOUS);
+  info.SetAsPseudoStatic (false);
+  info.SetDestinationAid (AID_AP);
+  element.SetDmgAllocationInfo (info);
+  element.SetAllocationPeriod (allocationPeriod, false);
+  element.SetMinimumAllocation (minAllocation);
+  element.SetMaximumAllocation (maxAllocation);
+  element.SetMinimumDuration (minAllocation);
+  return element;
+}
+
+template <typename Scheduler>
+static void
+RunStorm (std::string name, uint32_t numStations, uint32_t beaconIntervals, uint16_t allocationPeriod)
+{
+  Ptr<SchedulerUnderTest<Scheduler> > scheduler = CreateObject<SchedulerUnderTest<Scheduler> > ();
+  Time biDuration = MilliSeconds (100);
+  Time dtiDuration = MilliSeconds (99);
+  DmgTspecElement request = GetDmgTspecElement (allocationPeriod, 20, 40);
+  DmgTspecElement modification = GetDmgTspecElement (allocationPeriod, 20, 20);
+
+  uint32_t accepted = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t bi = 0; bi < beaconIntervals; bi++)
+    {
+      scheduler->StartBeaconInterval (biDuration, dtiDuration);
+      std::vector<uint8_t> admitted;
+      for (uint32_t aid = 1; aid <= numStations; aid++)
+        {
+          if (scheduler->Request (aid, request, false))
+            {
+              admitted.push_back (aid);
+            }
+        }
+      for (uint32_t i = 0; i < admitted.size (); i++)
+        {
+          scheduler->Request (admitted[i], modification, true);
+        }
+      accepted += admitted.size ();
+      scheduler->EndBeaconInterval ();
+    }
+  int64_t elapsed = clock.End ();
+
+  std::cout << std::setw (12) << name
+            << std::setw (10) << numStations
+            << std::setw (12) << accepted / beaconIntervals
+            << std::setw (16) << elapsed * 1e3 / beaconIntervals << std::endl;
+  scheduler->Dispose ();
+}
+
+static void
+Run (uint32_t maxStations, uint32_t beaconIntervals, uint16_t allocationPeriod)
+{
+  std::cout << std::setw (12) << "Scheduler"
+            << std::setw (10) << "Stations"
+            << std::setw (12) << "Accepted"
+            << std::setw (16) << "Time[us/BI]" << std::endl;
+  for (uint32_t numStations = 8; numStations <= maxStations; numStations *= 2)
+    {
+      RunStorm<BasicDmgWifiScheduler> ("Basic", numStations, beaconIntervals, 0);
+      RunStorm<PeriodicDmgWifiScheduler> ("Periodic", numStations, beaconIntervals, allocationPeriod);
+      RunStorm<EdfDmgWifiScheduler> ("Edf", numStations, beaconIntervals, allocationPeriod);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t maxStations = 128;
+  uint32_t beaconIntervals = 100;
+  uint16_t allocationPeriod = 8;
+
+  CommandLine cmd;
+  cmd.AddValue ("maxStations", "The largest number of stations (doubled from 8)", maxStations);
+  cmd.AddValue ("beaconIntervals", "The number of beacon intervals per number of stations", beaconIntervals);
+  cmd.AddValue ("allocationPeriod", "The number of SPs per BI requested from the periodic and EDF schedulers", allocationPeriod);
+  cmd.Parse (argc, argv);
+
+  /* Time values are cheaper to build once the simulation has started */
+  Simulator::Schedule (Seconds (0), &Run, maxStations, beaconIntervals, allocationPeriod);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return 0;
+}
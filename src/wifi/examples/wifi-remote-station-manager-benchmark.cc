@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+#include <iomanip>
+
+//
+// This program measures the cost of looking up the per-station state of a
+// WifiRemoteStationManager as the number of known stations grows.
+//
+// For each number of stations, the manager first learns every station with
+// each of the eight TIDs, then performs random lookups through the public
+// API: IsAssociated () looks up the station state by address, and
+// NeedDataRetransmission () looks up the station by address and TID.
+// The program reports the average time per lookup.
+//
+// ./waf --run "wifi-remote-station-manager-benchmark --lookups=1000000"
+//
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t maxStations = 1024;
+  uint32_t lookups = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("maxStations", "The largest number of stations (doubled from 1)", maxStations);
+  cmd.AddValue ("lookups", "The number of lookups per number of stations", lookups);
+  cmd.Parse (argc, argv);
+
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  Ptr<Packet> packet = Create<Packet> (1000);
+
+  std::cout << std::setw (10) << "Stations"
+            << std::setw (20) << "State[ns/lookup]"
+            << std::setw (20) << "Station[ns/lookup]" << std::endl;
+
+  for (uint32_t numStations = 1; numStations <= maxStations; numStations *= 2)
+    {
+      Ptr<ConstantRateWifiManager> manager = CreateObject<ConstantRateWifiManager> ();
+      manager->SetupPhy (phy);
+
+      std::vector<Mac48Address> addresses;
+      std::vector<WifiMacHeader> headers (8);
+      for (uint8_t tid = 0; tid < 8; tid++)
+        {
+          headers[tid].SetType (WIFI_MAC_QOSDATA);
+          headers[tid].SetQosTid (tid);
+        }
+      for (uint32_t i = 0; i < numStations; i++)
+        {
+          addresses.push_back (Mac48Address::Allocate ());
+          for (uint8_t tid = 0; tid < 8; tid++)
+            {
+              manager->NeedDataRetransmission (addresses.back (), &headers[tid], packet);
+            }
+        }
+
+      std::vector<uint32_t> stations (lookups);
+      for (uint32_t i = 0; i < lookups; i++)
+        {
+          stations[i] = random->GetInteger (0, numStations - 1);
+        }
+
+      SystemWallClockMs clock;
+      clock.Start ();
+      uint32_t associated = 0;
+      for (uint32_t i = 0; i < lookups; i++)
+        {
+          associated += manager->IsAssociated (addresses[stations[i]]);
+        }
+      int64_t stateTime = clock.End ();
+
+      clock.Start ();
+      uint32_t retransmissions = 0;
+      for (uint32_t i = 0; i < lookups; i++)
+        {
+          retransmissions += manager->NeedDataRetransmission (addresses[stations[i]], &headers[i % 8], packet);
+        }
+      int64_t stationTime = clock.End ();
+      NS_ASSERT (associated == 0 && retransmissions == lookups);
+
+      std::cout << std::setw (10) << numStations
+                << std::setw (20) << stateTime * 1e6 / lookups
+                << std::setw (20) << stationTime * 1e6 / lookups << std::endl;
+      manager->Dispose ();
+    }
+
+  return 0;
+}
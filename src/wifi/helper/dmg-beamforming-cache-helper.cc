@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dmg-beamforming-cache-helper.h"
+#include "ns3/abort.h"
+#include "ns3/codebook.h"
+#include "ns3/dmg-wifi-mac.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/wifi-net-device.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DmgBeamformingCacheHelper");
+
+/**
+ * \param device A network device.
+ * \return The DMG MAC of the device.
+ */
+static Ptr<DmgWifiMac>
+GetDmgWifiMac (Ptr<NetDevice> device)
+{
+  Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (device);
+  NS_ABORT_MSG_IF (wifiDevice == 0, "The beamforming cache supports only WifiNetDevice");
+  Ptr<DmgWifiMac> mac = DynamicCast<DmgWifiMac> (wifiDevice->GetMac ());
+  NS_ABORT_MSG_IF (mac == 0, "The beamforming cache supports only DMG devices");
+  return mac;
+}
+
+DmgBeamformingCacheHelper::DmgBeamformingCacheHelper (std::string fileName, std::string scenario)
+  : m_fileName (fileName),
+    m_scenario (scenario),
+    m_ignoreSeedAndRun (false)
+{
+}
+
+void
+DmgBeamformingCacheHelper::SetIgnoreSeedAndRun (bool ignore)
+{
+  m_ignoreSeedAndRun = ignore;
+}
+
+std::string
+DmgBeamformingCacheHelper::GetKey (NetDeviceContainer devices) const
+{
+  std::ostringstream key;
+  key << m_scenario;
+  if (!m_ignoreSeedAndRun)
+    {
+      key << ";" << RngSeedManager::GetSeed () << ":" << RngSeedManager::GetRun ();
+    }
+  key << std::fixed << std::setprecision (3);
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+    {
+      Ptr<DmgWifiMac> mac = GetDmgWifiMac (*i);
+      key << ";" << mac->GetAddress ();
+      Ptr<MobilityModel> mobility = (*i)->GetNode ()->GetObject<MobilityModel> ();
+      if (mobility != 0)
+        {
+          Vector position = mobility->GetPosition ();
+          key << "@" << position.x << "," << position.y << "," << position.z;
+        }
+      Ptr<Codebook> codebook = mac->GetCodebook ();
+      key << "/" << codebook->GetInstanceTypeId ().GetName () << ":" << codebook->GetCodebookFileName ()
+          << ":" << static_cast<uint16_t> (codebook->GetTotalNumberOfSectors ());
+    }
+  return key.str ();
+}
+
+bool
+DmgBeamformingCacheHelper::Load (NetDeviceContainer devices) const
+{
+  std::ifstream file (m_fileName.c_str ());
+  if (!file.is_open ())
+    {
+      NS_LOG_INFO ("Beamforming cache " << m_fileName << " does not exist");
+      return false;
+    }
+
+  std::string key = "KEY " + GetKey (devices);
+  std::string line;
+  bool found = false;
+  while (!found && std::getline (file, line))
+    {
+      found = (line == key);
+    }
+  if (!found)
+    {
+      NS_LOG_INFO ("Beamforming cache " << m_fileName << " has no entry for " << m_scenario);
+      return false;
+    }
+
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      std::ostringstream device;
+      device << "DEVICE " << i;
+      NS_ABORT_MSG_IF (!std::getline (file, line) || (line != device.str ()),
+                       "Corrupted beamforming cache " << m_fileName);
+      NS_ABORT_MSG_IF (!GetDmgWifiMac (devices.Get (i))->LoadBeamformingState (file),
+                       "Corrupted beamforming cache " << m_fileName);
+    }
+  NS_LOG_INFO ("Restored the beamforming state of " << m_scenario << " from " << m_fileName);
+  return true;
+}
+
+void
+DmgBeamformingCacheHelper::Save (NetDeviceContainer devices) const
+{
+  std::string key = "KEY " + GetKey (devices);
+
+  /* Keep the entries of the other scenarios */
+  std::vector<std::string> lines;
+  std::ifstream inputFile (m_fileName.c_str ());
+  std::string line;
+  bool skip = false;
+  while (std::getline (inputFile, line))
+    {
+      if (line.compare (0, 4, "KEY ") == 0)
+        {
+          skip = (line == key);
+        }
+      if (!skip)
+        {
+          lines.push_back (line);
+        }
+    }
+  inputFile.close ();
+
+  /* Write a temporary file next to the cache file and rename it over the cache file, so that a run
+   * which stops while saving, or another run reading the cache file, never sees a truncated file */
+  std::ostringstream tmpFileName;
+  tmpFileName << m_fileName << "." << getpid () << ".tmp";
+  std::ofstream file (tmpFileName.str ().c_str (), std::ios::out | std::ios::trunc);
+  NS_ABORT_MSG_IF (!file.is_open (), "Cannot write the beamforming cache " << tmpFileName.str ());
+  for (std::vector<std::string>::const_iterator iter = lines.begin (); iter != lines.end (); iter++)
+    {
+      file << *iter << std::endl;
+    }
+  file << key << std::endl;
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      file << "DEVICE " << i << std::endl;
+      GetDmgWifiMac (devices.Get (i))->SaveBeamformingState (file);
+    }
+  file.close ();
+  NS_ABORT_MSG_IF (file.fail (), "Cannot write the beamforming cache " << tmpFileName.str ());
+  NS_ABORT_MSG_IF (std::rename (tmpFileName.str ().c_str (), m_fileName.c_str ()) != 0,
+                   "Cannot replace the beamforming cache " << m_fileName);
+  NS_LOG_INFO ("Saved the beamforming state of " << m_scenario << " in " << m_fileName);
+}
+
+} // namespace ns3
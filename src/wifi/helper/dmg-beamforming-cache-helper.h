@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_BEAMFORMING_CACHE_HELPER_H
+#define DMG_BEAMFORMING_CACHE_HELPER_H
+
+#include "ns3/net-device-container.h"
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \brief Store the beamforming state of DMG devices across simulation runs.
+ *
+ * The helper saves the best antenna configurations and the SNR tables of the
+ * DMG devices of a scenario in a cache file, and restores them at the beginning
+ * of the next runs of the same scenario, so that the links start beamformed and
+ * the warm-up sector sweeps can be skipped. The entries of the cache file are
+ * identified by the name of the scenario, the seed and the run number of the
+ * random number generators, and for each device by its MAC address, the position
+ * of its node and its codebook. Several scenarios can share the same cache file.
+ *
+ * The sector sweeps of static devices usually converge to the same state whatever
+ * the seed, but a state restored from another run changes the random streams of
+ * the current run. The runs of a scenario with other seeds can share the same
+ * entry only when this is explicitly allowed with SetIgnoreSeedAndRun.
+ */
+class DmgBeamformingCacheHelper
+{
+public:
+  /**
+   * Create a beamforming cache helper.
+   * \param fileName The name of the cache file.
+   * \param scenario The name of the scenario, including any parameter which changes the beamforming state.
+   */
+  DmgBeamformingCacheHelper (std::string fileName, std::string scenario);
+
+  /**
+   * Restore the beamforming state of the devices if the cache file has an entry for them.
+   * \param devices The DMG devices of the scenario, in the order used to save them.
+   * \return True if the beamforming state has been restored.
+   */
+  bool Load (NetDeviceContainer devices) const;
+  /**
+   * Save the beamforming state of the devices in the cache file, replacing any previous
+   * entry for the same devices. The cache file is replaced at once by a complete new file.
+   * \param devices The DMG devices of the scenario.
+   */
+  void Save (NetDeviceContainer devices) const;
+  /**
+   * Share the entries of the cache file between the runs of a scenario with other
+   * seeds or run numbers. Disabled by default.
+   * \param ignore Whether the seed and the run number are left out of the entries.
+   */
+  void SetIgnoreSeedAndRun (bool ignore);
+
+private:
+  /**
+   * \param devices The DMG devices of the scenario.
+   * \return The key identifying the entry of the devices in the cache file.
+   */
+  std::string GetKey (NetDeviceContainer devices) const;
+
+  std::string m_fileName;   //!< The name of the cache file.
+  std::string m_scenario;   //!< The name of the scenario.
+  bool m_ignoreSeedAndRun;  //!< Whether the seed and the run number are left out of the entries.
+};
+
+} // namespace ns3
+
+#endif /* DMG_BEAMFORMING_CACHE_HELPER_H */
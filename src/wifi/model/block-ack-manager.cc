@@ -315,6 +315,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr, bool removePacket)
                 {
                   //Standard says the originator should not send a packet with seqnum < winstart
                   NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
+                  agreement->second.first.m_retryScoreboard.Reset ((*it)->hdr.GetSequenceNumber ());
                   agreement->second.second.erase ((*it));
                   it = m_retryPackets.erase (it);
                   continue;
@@ -361,6 +362,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr, bool removePacket)
           if (removePacket)
             {
               NS_LOG_INFO ("Retry packet seq = " << hdr.GetSequenceNumber ());
+              agreement->second.first.m_retryScoreboard.Reset (hdr.GetSequenceNumber ());
               it = m_retryPackets.erase (it);
               NS_LOG_DEBUG ("Removed one packet, retry buffer size = " << m_retryPackets.size ());
             }
@@ -391,6 +393,7 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
             {
               //standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
+              agreement->second.first.m_retryScoreboard.Reset ((*it)->hdr.GetSequenceNumber ());
               agreement->second.second.erase ((*it));
               it = m_retryPackets.erase (it);
               it--;
@@ -433,6 +436,11 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
 bool
 BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber)
 {
+  AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
+  if (i == m_agreements.end () || !i->second.first.m_retryScoreboard.IsSet (seqnumber))
+    {
+      return false;
+    }
 
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
@@ -444,7 +452,7 @@ BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seq
       if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid && (*it)->hdr.GetSequenceNumber () == seqnumber)
         {
           WifiMacHeader hdr = (*it)->hdr;
-          AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
+          i->second.first.m_retryScoreboard.Reset (seqnumber);
           i->second.second.erase ((*it));
           m_retryPackets.erase (it);
           NS_LOG_DEBUG ("Removed Packet from retry queue = " << hdr.GetSequenceNumber () << " " << +tid << " " << recipient << " Buffer Size = " << m_retryPackets.size ());
@@ -502,35 +510,14 @@ uint32_t
 BlockAckManager::GetNRetryNeededPackets (Mac48Address recipient, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << recipient << +tid);
-  uint32_t nPackets = 0;
-  uint16_t currentSeq = 0;
-  if (ExistsAgreement (recipient, tid))
+  AgreementsCI it = m_agreements.find (std::make_pair (recipient, tid));
+  if (it == m_agreements.end ())
     {
-      std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-      while (it != m_retryPackets.end ())
-        {
-          if (!(*it)->hdr.IsQosData ())
-            {
-              NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-            }
-          if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid)
-            {
-              currentSeq = (*it)->hdr.GetSequenceNumber ();
-              nPackets++;
-              /* a fragmented packet must be counted as one packet */
-              while (it != m_retryPackets.end () && (*it)->hdr.GetSequenceNumber () == currentSeq)
-                {
-                  it++;
-                }
-            }
-          //go to next packet
-          else
-            {
-              it++;
-            }
-        }
+      return 0;
     }
-  return nPackets;
+  /* a fragmented packet is counted as one packet, since a sequence number
+     is never queued twice for retransmission */
+  return it->second.first.m_retryScoreboard.GetCount ();
 }
 
 void
@@ -550,21 +537,9 @@ BlockAckManager::SetWifiRemoteStationManager (const Ptr<WifiRemoteStationManager
 bool
 BlockAckManager::AlreadyExists (uint16_t currentSeq, Mac48Address recipient, uint8_t tid) const
 {
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-  while (it != m_retryPackets.end ())
-    {
-      NS_LOG_FUNCTION (this << (*it)->hdr.GetType ());
-      if (!(*it)->hdr.IsQosData ())
-        {
-          NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-        }
-      if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid && currentSeq == (*it)->hdr.GetSequenceNumber ())
-        {
-          return true;
-        }
-      it++;
-    }
-  return false;
+  NS_LOG_FUNCTION (this << currentSeq << recipient << +tid);
+  AgreementsCI it = m_agreements.find (std::make_pair (recipient, tid));
+  return (it != m_agreements.end () && it->second.first.m_retryScoreboard.IsSet (currentSeq));
 }
 
 void
@@ -625,10 +600,17 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
             }
           else if (blockAck->IsCompressed ())
             {
+              /* The MPDUs acknowledged while waiting for retransmission are found by ANDing the bitmap
+                 with the window of the scoreboard, and leave the retransmission queue together */
+              uint16_t startingSeq = blockAck->GetStartingSequence ();
+              uint64_t received = blockAck->GetCompressedBitmap ();
+              RemoveFromRetryQueue (recipient, tid, startingSeq,
+                                    received & it->second.first.m_retryScoreboard.GetWindow (startingSeq));
               for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd; )
                 {
                   uint16_t currentSeq = (*queueIt).hdr.GetSequenceNumber ();
-                  if (blockAck->IsPacketReceived (currentSeq))
+                  uint16_t offset = (currentSeq - startingSeq + 4096) % 4096;
+                  if ((offset < 64) && ((received >> offset) & 1))
                     {
                       while (queueIt != queueEnd
                              && (*queueIt).hdr.GetSequenceNumber () == currentSeq)
@@ -638,7 +620,6 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                             {
                               m_txOkCallback ((*queueIt).hdr);
                             }
-                          RemoveFromRetryQueue (recipient, tid, currentSeq);
                           queueIt = it->second.second.erase (queueIt);
                         }
                     }
@@ -843,6 +824,12 @@ void
 BlockAckManager::RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t seq)
 {
   /* remove retry packet iterator if it's present in retry queue */
+  AgreementsI agreement = m_agreements.find (std::make_pair (address, tid));
+  if (agreement == m_agreements.end () || !agreement->second.first.m_retryScoreboard.IsSet (seq))
+    {
+      return;
+    }
+  agreement->second.first.m_retryScoreboard.Reset (seq);
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   while (it != m_retryPackets.end ())
     {
@@ -859,6 +846,33 @@ BlockAckManager::RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16
     }
 }
 
+void
+BlockAckManager::RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t startingSeq, uint64_t bitmap)
+{
+  NS_LOG_FUNCTION (this << address << +tid << startingSeq << bitmap);
+  AgreementsI agreement = m_agreements.find (std::make_pair (address, tid));
+  if (agreement == m_agreements.end () || bitmap == 0)
+    {
+      return;
+    }
+  agreement->second.first.m_retryScoreboard.ResetWindow (startingSeq, bitmap);
+  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
+  while (it != m_retryPackets.end ())
+    {
+      uint16_t offset = ((*it)->hdr.GetSequenceNumber () - startingSeq + 4096) % 4096;
+      if ((*it)->hdr.GetAddr1 () == address
+          && (*it)->hdr.GetQosTid () == tid
+          && (offset < 64) && ((bitmap >> offset) & 1))
+        {
+          it = m_retryPackets.erase (it);
+        }
+      else
+        {
+          it++;
+        }
+    }
+}
+
 void
 BlockAckManager::CleanupBuffers (void)
 {
@@ -961,6 +975,9 @@ void
 BlockAckManager::InsertInRetryQueue (PacketQueueI item)
 {
   NS_LOG_INFO ("Adding to retry queue " << (*item).hdr.GetSequenceNumber ());
+  AgreementsI agreement = m_agreements.find (std::make_pair (item->hdr.GetAddr1 (), item->hdr.GetQosTid ()));
+  NS_ASSERT (agreement != m_agreements.end ());
+  agreement->second.first.m_retryScoreboard.Set (item->hdr.GetSequenceNumber ());
   if (m_retryPackets.size () == 0)
     {
       m_retryPackets.push_back (item);
@@ -480,6 +480,16 @@ private:
    * \param seq sequence number of the packet to be removed
    */
   void RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t seq);
+  /**
+   * Remove the MPDUs of a window from the retransmission queue, in a single pass over the queue.
+   * This method should be called when packets are acknowledged by a compressed block ack.
+   *
+   * \param address recipient mac address of the packets to be removed
+   * \param tid Traffic ID of the packets to be removed
+   * \param startingSeq the first sequence number of the window
+   * \param bitmap bit i is set to remove the MPDU with sequence number (startingSeq + i) % 4096
+   */
+  void RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t startingSeq, uint64_t bitmap);
 
   /**
    * This data structure contains, for each block ack agreement (recipient, tid), a set of packets
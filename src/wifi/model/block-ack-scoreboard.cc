@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "block-ack-scoreboard.h"
+#include "ns3/assert.h"
+#include <cstring>
+
+namespace ns3 {
+
+/**
+ * \param word a word of the bitmap
+ * \return the number of bits set in the word
+ */
+static uint16_t
+CountBits (uint64_t word)
+{
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (word * 0x0101010101010101ULL) >> 56;
+}
+
+BlockAckScoreboard::BlockAckScoreboard ()
+{
+  Clear ();
+}
+
+void
+BlockAckScoreboard::Set (uint16_t seq)
+{
+  NS_ASSERT (seq < 4096);
+  uint64_t mask = uint64_t (1) << (seq % 64);
+  if ((m_bitmap[seq / 64] & mask) == 0)
+    {
+      m_bitmap[seq / 64] |= mask;
+      m_count++;
+    }
+}
+
+void
+BlockAckScoreboard::Reset (uint16_t seq)
+{
+  NS_ASSERT (seq < 4096);
+  uint64_t mask = uint64_t (1) << (seq % 64);
+  if ((m_bitmap[seq / 64] & mask) != 0)
+    {
+      m_bitmap[seq / 64] &= ~mask;
+      m_count--;
+    }
+}
+
+bool
+BlockAckScoreboard::IsSet (uint16_t seq) const
+{
+  NS_ASSERT (seq < 4096);
+  return ((m_bitmap[seq / 64] >> (seq % 64)) & 1) == 1;
+}
+
+uint16_t
+BlockAckScoreboard::GetCount (void) const
+{
+  return m_count;
+}
+
+void
+BlockAckScoreboard::Clear (void)
+{
+  memset (m_bitmap, 0, sizeof (m_bitmap));
+  m_count = 0;
+}
+
+uint64_t
+BlockAckScoreboard::GetWindow (uint16_t start) const
+{
+  NS_ASSERT (start < 4096);
+  uint16_t word = start / 64;
+  uint16_t shift = start % 64;
+  uint64_t window = m_bitmap[word] >> shift;
+  if (shift != 0)
+    {
+      window |= m_bitmap[(word + 1) % N_WORDS] << (64 - shift);
+    }
+  return window;
+}
+
+void
+BlockAckScoreboard::ResetWindow (uint16_t start, uint64_t window)
+{
+  NS_ASSERT (start < 4096);
+  uint16_t word = start / 64;
+  uint16_t shift = start % 64;
+  uint64_t mask = window << shift;
+  m_count -= CountBits (m_bitmap[word] & mask);
+  m_bitmap[word] &= ~mask;
+  if (shift != 0)
+    {
+      uint16_t next = (word + 1) % N_WORDS;
+      mask = window >> (64 - shift);
+      m_count -= CountBits (m_bitmap[next] & mask);
+      m_bitmap[next] &= ~mask;
+    }
+}
+
+} //namespace ns3
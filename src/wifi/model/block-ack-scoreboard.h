@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BLOCK_ACK_SCOREBOARD_H
+#define BLOCK_ACK_SCOREBOARD_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Circular bitmap over the sequence number space
+ *
+ * The scoreboard holds one bit per sequence number (modulo 4096) and is used
+ * by the originator of a block ack agreement to track the MPDUs waiting in the
+ * retransmission queue. Sequence numbers are tested and updated in constant
+ * time, and the number of marked sequence numbers is kept up-to-date.
+ */
+class BlockAckScoreboard
+{
+public:
+  BlockAckScoreboard ();
+
+  /**
+   * Mark a sequence number.
+   * \param seq the sequence number
+   */
+  void Set (uint16_t seq);
+  /**
+   * Unmark a sequence number.
+   * \param seq the sequence number
+   */
+  void Reset (uint16_t seq);
+  /**
+   * \param seq the sequence number
+   * \return true if the sequence number is marked
+   */
+  bool IsSet (uint16_t seq) const;
+  /**
+   * \return the number of marked sequence numbers
+   */
+  uint16_t GetCount (void) const;
+  /**
+   * Unmark all the sequence numbers.
+   */
+  void Clear (void);
+  /**
+   * \param start the first sequence number of the window
+   * \return the 64 sequence numbers from start, bit i being set if (start + i) % 4096 is marked
+   */
+  uint64_t GetWindow (uint16_t start) const;
+  /**
+   * Unmark the sequence numbers of a window, a whole word at a time.
+   * \param start the first sequence number of the window
+   * \param window bit i is set to unmark (start + i) % 4096
+   */
+  void ResetWindow (uint16_t start, uint64_t window);
+
+
+private:
+  static const uint16_t N_WORDS = 4096 / 64; ///< number of words of the bitmap
+
+  uint64_t m_bitmap[N_WORDS]; ///< bitmap, bit (seq % 64) of word (seq / 64) is for seq
+  uint16_t m_count; ///< number of marked sequence numbers
+};
+
+} //namespace ns3
+
+#endif /* BLOCK_ACK_SCOREBOARD_H */
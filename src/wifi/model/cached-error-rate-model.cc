@@ -0,0 +1,217 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "cached-error-rate-model.h"
+#include "dmg-error-model.h"
+#include "wifi-utils.h"
+#include "wifi-tx-vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedErrorRateModel);
+
+TypeId
+CachedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CachedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model whose chunk success rates are cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedErrorRateModel::SetErrorRateModel,
+                                        &CachedErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("FileName",
+                   "Shortcut to cache a DmgErrorModel that loads its SNR to BER tables from this file.",
+                   StringValue (""),
+                   MakeStringAccessor (&CachedErrorRateModel::SetErrorRateTablesFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("MinSnr",
+                   "The SNR of the first bin of the tables (dB).",
+                   DoubleValue (-50.0),
+                   MakeDoubleAccessor (&CachedErrorRateModel::SetMinSnr,
+                                       &CachedErrorRateModel::GetMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The SNR of the last bin of the tables (dB).",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&CachedErrorRateModel::SetMaxSnr,
+                                       &CachedErrorRateModel::GetMaxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrResolution",
+                   "The spacing of the SNR bins of the tables (dB).",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&CachedErrorRateModel::SetSnrResolution,
+                                       &CachedErrorRateModel::GetSnrResolution),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+CachedErrorRateModel::CachedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedErrorRateModel::~CachedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_errorRateModel = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+CachedErrorRateModel::SetErrorRateModel (const Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_errorRateModel = model;
+  ClearTables ();
+}
+
+Ptr<ErrorRateModel>
+CachedErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_errorRateModel;
+}
+
+void
+CachedErrorRateModel::SetErrorRateTablesFileName (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  if (fileName != "")
+    {
+      Ptr<DmgErrorModel> model = CreateObject<DmgErrorModel> ();
+      model->SetAttribute ("FileName", StringValue (fileName));
+      SetErrorRateModel (model);
+    }
+}
+
+void
+CachedErrorRateModel::SetMinSnr (double snr)
+{
+  NS_LOG_FUNCTION (this << snr);
+  m_minSnr = snr;
+  ClearTables ();
+}
+
+double
+CachedErrorRateModel::GetMinSnr (void) const
+{
+  return m_minSnr;
+}
+
+void
+CachedErrorRateModel::SetMaxSnr (double snr)
+{
+  NS_LOG_FUNCTION (this << snr);
+  m_maxSnr = snr;
+  ClearTables ();
+}
+
+double
+CachedErrorRateModel::GetMaxSnr (void) const
+{
+  return m_maxSnr;
+}
+
+void
+CachedErrorRateModel::SetSnrResolution (double resolution)
+{
+  NS_LOG_FUNCTION (this << resolution);
+  m_snrResolution = resolution;
+  ClearTables ();
+}
+
+double
+CachedErrorRateModel::GetSnrResolution (void) const
+{
+  return m_snrResolution;
+}
+
+void
+CachedErrorRateModel::ClearTables (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_tables.clear ();
+}
+
+std::vector<double>
+CachedErrorRateModel::BuildTable (WifiMode mode, WifiTxVector txVector) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetChannelWidth ());
+  NS_ASSERT_MSG (m_maxSnr > m_minSnr, "The SNR range of the tables is empty");
+  uint32_t numBins = std::ceil ((m_maxSnr - m_minSnr) / m_snrResolution) + 1;
+  std::vector<double> table (numBins);
+  for (uint32_t bin = 0; bin < numBins; bin++)
+    {
+      double snr = DbToRatio (m_minSnr + bin * m_snrResolution);
+      double psr = m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, 1);
+      /* Keep the logarithm finite so that the interpolation stays well defined */
+      table[bin] = std::log (std::max (psr, std::numeric_limits<double>::min ()));
+    }
+  return table;
+}
+
+double
+CachedErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << snr << nbits);
+  NS_ASSERT_MSG (m_errorRateModel != 0, "No error rate model to cache");
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+
+  std::vector<double> &table = m_tables[std::make_pair (mode.GetUid (), txVector.GetChannelWidth ())];
+  if (table.empty ())
+    {
+      table = BuildTable (mode, txVector);
+    }
+
+  /* Fractional position of the SNR in the grid, saturated at both ends */
+  double lastBin = table.size () - 1.0;
+  double position = std::min (std::max ((RatioToDb (snr) - m_minSnr) / m_snrResolution, 0.0), lastBin);
+  uint32_t index = std::min<uint32_t> (position, table.size () - 2);
+  double fraction = position - index;
+  double logPsr = table[index] + fraction * (table[index + 1] - table[index]);
+
+  /* Bit errors are independent, so the success rate of the chunk is that of a bit to the power of its size */
+  double psr = std::exp (logPsr * nbits);
+  NS_LOG_DEBUG ("PSR=" << psr);
+
+  return psr;
+}
+
+} //namespace ns3
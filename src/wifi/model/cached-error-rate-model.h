@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_ERROR_RATE_MODEL_H
+#define CACHED_ERROR_RATE_MODEL_H
+
+#include "error-rate-model.h"
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Error rate model that caches the chunk success rates of another model
+ *
+ * The success rate of a single bit of the wrapped model is sampled on a uniform
+ * SNR grid for every (WifiMode, channel width) pair. The table of a pair is
+ * built the first time the pair is requested, so evaluating a chunk afterwards
+ * is a table read: the logarithm of the success rate of a bit is interpolated
+ * between the two closest SNR bins and multiplied by the number of bits.
+ *
+ * Raising the success rate of a bit to the number of bits is exact for models
+ * in which bit errors are independent, such as DmgErrorModel and
+ * SensitivityModel60GHz. The interpolation between the SNR bins is not: the
+ * wrapped models interpolate the BER on their own grid, which does not line up
+ * with the grid of the cache. With the default 0.1 dB resolution, the chunk
+ * success rate of SensitivityModel60GHz deviates by up to about 5e-3 on the
+ * steep part of its curves. A finer resolution reduces the deviation at the
+ * cost of larger tables. SNRs outside of [MinSnr, MaxSnr] saturate at the
+ * first or last bin. Changing the SNR grid
+ * drops the tables computed so far.
+ *
+ * The wrapped model is assumed to depend on the TXVECTOR only through the mode
+ * and the channel width.
+ */
+class CachedErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedErrorRateModel ();
+  virtual ~CachedErrorRateModel ();
+
+  virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+  /**
+   * Set the error rate model whose success rates are cached.
+   * \param model the wrapped error rate model.
+   */
+  void SetErrorRateModel (const Ptr<ErrorRateModel> model);
+  /**
+   * \return the error rate model whose success rates are cached.
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Wrap a DmgErrorModel that loads its tables from the given file.
+   * \param fileName the name of the file that contains SNR to BER tables.
+   */
+  void SetErrorRateTablesFileName (std::string fileName);
+  /**
+   * \param snr the SNR of the first bin of the tables (dB).
+   */
+  void SetMinSnr (double snr);
+  /**
+   * \return the SNR of the first bin of the tables (dB).
+   */
+  double GetMinSnr (void) const;
+  /**
+   * \param snr the SNR of the last bin of the tables (dB).
+   */
+  void SetMaxSnr (double snr);
+  /**
+   * \return the SNR of the last bin of the tables (dB).
+   */
+  double GetMaxSnr (void) const;
+  /**
+   * \param resolution the spacing of the SNR bins of the tables (dB).
+   */
+  void SetSnrResolution (double resolution);
+  /**
+   * \return the spacing of the SNR bins of the tables (dB).
+   */
+  double GetSnrResolution (void) const;
+  /**
+   * Drop the tables computed so far, e.g. after a change of the SNR grid.
+   */
+  void ClearTables (void);
+  /**
+   * Sample the success rate of a bit of the wrapped model over the SNR grid.
+   * \param mode the Wi-Fi mode of the chunk.
+   * \param txVector TXVECTOR of the overall transmission.
+   * \return the logarithm of the success rate of a bit in each SNR bin.
+   */
+  std::vector<double> BuildTable (WifiMode mode, WifiTxVector txVector) const;
+
+  typedef std::pair<uint32_t, uint16_t> TableKey;   //!< WifiMode UID and channel width (MHz) of a table.
+
+  Ptr<ErrorRateModel> m_errorRateModel;   //!< The wrapped error rate model.
+  double m_minSnr;                        //!< SNR of the first bin (dB).
+  double m_maxSnr;                        //!< SNR of the last bin (dB).
+  double m_snrResolution;                 //!< Spacing of the SNR bins (dB).
+  mutable std::map<TableKey, std::vector<double> > m_tables;   //!< Cached per-bit log success rate tables.
+
+};
+
+} //namespace ns3
+
+#endif /* CACHED_ERROR_RATE_MODEL_H */
@@ -99,6 +99,12 @@ Codebook::SetBeaconingSectors (Antenna2SectorList sectors)
   m_bhiAntennasList = sectors;
 }
 
+Antenna2SectorList
+Codebook::GetBeaconingSectors (void) const
+{
+  return m_bhiAntennasList;
+}
+
 void
 Codebook::AppendToSectorList (Antenna2SectorList &globalList, AntennaID antennaID, SectorID sectorID)
 {
@@ -314,9 +320,11 @@ Codebook::StartBTIAccessPeriod (void)
   NS_LOG_FUNCTION (this);
   SectorID sector;
   m_currentBFPhase = BHI_PHASE;
+  /* A sector sweep in the DTI replaces the sector list, which can differ from the beaconing sectors */
+  m_beamformingSectorList = m_bhiAntennaI->second;
   if (m_beaconRandomization)
     {
-      if (m_btiSectorOffset == m_bhiAntennasList.size ())
+      if ((m_btiSectorOffset == m_bhiAntennasList.size ()) || (m_btiSectorOffset >= m_beamformingSectorList.size ()))
         {
           m_btiSectorOffset = 0;
         }
@@ -333,6 +341,21 @@ Codebook::StartBTIAccessPeriod (void)
   m_remainingSectors = m_beamformingSectorList.size () - 1;
 }
 
+void
+Codebook::ChangeBeaconingSectors (const Antenna2SectorList &sectors)
+{
+  NS_LOG_FUNCTION (this);
+  AntennaID btiAntenna = m_bhiAntennaI->first;
+  m_bhiAntennasList = sectors;
+  m_bhiAntennaI = m_bhiAntennasList.lower_bound (btiAntenna);
+  if (m_bhiAntennaI == m_bhiAntennasList.end ())
+    {
+      m_bhiAntennaI = m_bhiAntennasList.begin ();
+    }
+  m_beamformingSectorList = m_bhiAntennaI->second;
+  m_quasiAntennaIter = m_bhiAntennasList.begin ();
+}
+
 bool
 Codebook::GetNextSectorInBTI (void)
 {
@@ -427,8 +450,12 @@ Codebook::StartSectorSweeping (Mac48Address address, SectorSweepType type, uint8
   BeamformingSectorListCI iter;
   if (type == TransmitSectorSweep)
     {
-      iter = m_txCustomSectors.find (address);
-      if (iter != m_txCustomSectors.end ())
+      iter = m_txSweepSectors.find (address);
+      if (iter != m_txSweepSectors.end ())
+        {
+          m_currentSectorList = (Antenna2SectorList *) &iter->second;
+        }
+      else if ((iter = m_txCustomSectors.find (address)) != m_txCustomSectors.end ())
         {
           m_currentSectorList = (Antenna2SectorList *) &iter->second;
         }
@@ -462,6 +489,116 @@ Codebook::StartSectorSweeping (Mac48Address address, SectorSweepType type, uint8
   m_remainingSectors = CountNumberOfSectors (m_currentSectorList) * peerAntennas - 1;
 }
 
+void
+Codebook::SetSweepSectorList (Mac48Address address, const Antenna2SectorList &sectorList)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_txSweepSectors[address] = sectorList;
+}
+
+void
+Codebook::RemoveSweepSectorList (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_txSweepSectors.erase (address);
+}
+
+Antenna2SectorList
+Codebook::GetTransmitSectorList (Mac48Address address) const
+{
+  BeamformingSectorListCI iter = m_txCustomSectors.find (address);
+  if (iter != m_txCustomSectors.end ())
+    {
+      return iter->second;
+    }
+  else
+    {
+      return m_txBeamformingSectors;
+    }
+}
+
+BeamformingSectorList
+Codebook::GetBeamformingSectorLists (SectorSweepType type) const
+{
+  if (type == TransmitSectorSweep)
+    {
+      return m_txCustomSectors;
+    }
+  else
+    {
+      return m_rxCustomSectors;
+    }
+}
+
+Antenna2SectorList
+Codebook::GetRootSectorList (Mac48Address address) const
+{
+  Antenna2SectorList sectorList = GetTransmitSectorList (address);
+  Antenna2SectorList rootList;
+  for (Antenna2SectorListCI antennaIt = sectorList.begin (); antennaIt != sectorList.end (); antennaIt++)
+    {
+      for (SectorIDList::const_iterator sectorIt = antennaIt->second.begin (); sectorIt != antennaIt->second.end (); sectorIt++)
+        {
+          bool isChild = false;
+          for (SectorHierarchyCI parentIt = m_sectorHierarchy.begin (); parentIt != m_sectorHierarchy.end (); parentIt++)
+            {
+              if ((parentIt->first.first == antennaIt->first)
+                  && (std::find (parentIt->second.begin (), parentIt->second.end (), *sectorIt) != parentIt->second.end ()))
+                {
+                  isChild = true;
+                  break;
+                }
+            }
+          if (!isChild)
+            {
+              rootList[antennaIt->first].push_back (*sectorIt);
+            }
+        }
+    }
+  return rootList;
+}
+
+Antenna2SectorList
+Codebook::GetChildSectorList (Mac48Address address, AntennaID antennaID, SectorID sectorID) const
+{
+  Antenna2SectorList childList;
+  SectorHierarchyCI parentIt = m_sectorHierarchy.find (std::make_pair (antennaID, sectorID));
+  if (parentIt == m_sectorHierarchy.end ())
+    {
+      return childList;
+    }
+  /* Only the children which can be used for transmit beamforming with the station are swept */
+  Antenna2SectorList sectorList = GetTransmitSectorList (address);
+  Antenna2SectorListCI antennaIt = sectorList.find (antennaID);
+  if (antennaIt == sectorList.end ())
+    {
+      return childList;
+    }
+  for (SectorIDList::const_iterator sectorIt = antennaIt->second.begin (); sectorIt != antennaIt->second.end (); sectorIt++)
+    {
+      if (std::find (parentIt->second.begin (), parentIt->second.end (), *sectorIt) != parentIt->second.end ())
+        {
+          childList[antennaID].push_back (*sectorIt);
+        }
+    }
+  return childList;
+}
+
+Antenna2SectorList
+Codebook::GetSiblingSectorList (Mac48Address address, AntennaID antennaID, SectorID sectorID) const
+{
+  /* The siblings are the children of the parent sector, including the sector itself */
+  for (SectorHierarchyCI parentIt = m_sectorHierarchy.begin (); parentIt != m_sectorHierarchy.end (); parentIt++)
+    {
+      if ((parentIt->first.first == antennaID)
+          && (std::find (parentIt->second.begin (), parentIt->second.end (), sectorID) != parentIt->second.end ()))
+        {
+          return GetChildSectorList (address, antennaID, parentIt->first.second);
+        }
+    }
+  return Antenna2SectorList ();
+}
+
 bool
 Codebook::GetNextSector (bool &changeAntenna)
 {
@@ -571,6 +708,7 @@ Codebook::CopyCodebook (const Ptr<Codebook> codebook)
   m_txCustomSectors = codebook->m_txCustomSectors;
   m_rxCustomSectors = codebook->m_rxCustomSectors;
   m_bhiAntennasList = codebook->m_bhiAntennasList;
+  m_sectorHierarchy = codebook->m_sectorHierarchy;
 }
 
 void
@@ -597,6 +735,39 @@ Codebook::AppendAWV (AntennaID antennaID, SectorID sectorID, Ptr<AWV_Config> awv
     }
 }
 
+void
+Codebook::AppendChildSector (AntennaID antennaID, SectorID parentID, SectorID childID)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint16_t> (antennaID) << static_cast<uint16_t> (parentID)
+                   << static_cast<uint16_t> (childID));
+  NS_ASSERT_MSG (parentID != childID, "A sector cannot be its own child.");
+  SectorIDList &children = m_sectorHierarchy[std::make_pair (antennaID, parentID)];
+  if (std::find (children.begin (), children.end (), childID) == children.end ())
+    {
+      children.push_back (childID);
+    }
+}
+
+SectorIDList
+Codebook::GetChildSectors (AntennaID antennaID, SectorID sectorID) const
+{
+  SectorHierarchyCI iter = m_sectorHierarchy.find (std::make_pair (antennaID, sectorID));
+  if (iter != m_sectorHierarchy.end ())
+    {
+      return iter->second;
+    }
+  else
+    {
+      return SectorIDList ();
+    }
+}
+
+bool
+Codebook::IsHierarchical (void) const
+{
+  return !m_sectorHierarchy.empty ();
+}
+
 void
 Codebook::ChangeAntennaOrientation (AntennaID antennaID, double azimuthOrientation, double elevationOrientation)
 {
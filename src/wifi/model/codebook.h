@@ -103,6 +103,8 @@ typedef AntennaArrayList::const_iterator AntennaArrayListCI;
 typedef std::map<Mac48Address, Antenna2SectorList> BeamformingSectorList;
 typedef BeamformingSectorList::iterator BeamformingSectorListI;
 typedef BeamformingSectorList::const_iterator BeamformingSectorListCI;
+typedef std::map<std::pair<AntennaID, SectorID>, SectorIDList> SectorHierarchy;
+typedef SectorHierarchy::const_iterator SectorHierarchyCI;
 
 struct RFChain : public SimpleRefCount<RFChain> {
   AntennaArrayList antennaArrayList;
@@ -133,6 +135,7 @@ public:
   virtual uint8_t GetNumberSectorsPerAntenna (AntennaID antennaID) const = 0;
   uint8_t GetTotalNumberOfAntennas (void) const;
   void SetBeaconingSectors (Antenna2SectorList sectors);
+  Antenna2SectorList GetBeaconingSectors (void) const;
   void AppendBeaconingSector (AntennaID antennaID, SectorID sectorID);
   void RemoveBeaconingSector (AntennaID antennaID, SectorID sectorID);
   uint8_t GetNumberOfSectorsInBHI (void);
@@ -146,6 +149,9 @@ public:
   void CopyCodebook (const Ptr<Codebook> codebook);
   virtual void ChangeAntennaOrientation (AntennaID antennaID, double azimuthOrientation, double elevationOrientation);
   void AppendAWV (AntennaID antennaID, SectorID sectorID, Ptr<AWV_Config> awvConfig);
+  void AppendChildSector (AntennaID antennaID, SectorID parentID, SectorID childID);
+  SectorIDList GetChildSectors (AntennaID antennaID, SectorID sectorID) const;
+  bool IsHierarchical (void) const;
 
 protected:
   friend class DmgWifiMac;
@@ -173,12 +179,20 @@ protected:
 
   void InitializeCodebook (void);
   void StartBTIAccessPeriod (void);
+  void ChangeBeaconingSectors (const Antenna2SectorList &sectors);
   bool GetNextSectorInBTI (void);
   uint8_t GetNumberOfBIs (void) const;
   uint8_t GetRemaingSectorCount (void) const;
   void InitiateABFT (Mac48Address address);
   bool GetNextSectorInABFT (void);
   void StartSectorSweeping (Mac48Address address, SectorSweepType type, uint8_t peerAntennas);
+  void SetSweepSectorList (Mac48Address address, const Antenna2SectorList &sectorList);
+  void RemoveSweepSectorList (Mac48Address address);
+  Antenna2SectorList GetTransmitSectorList (Mac48Address address) const;
+  BeamformingSectorList GetBeamformingSectorLists (SectorSweepType type) const;
+  Antenna2SectorList GetRootSectorList (Mac48Address address) const;
+  Antenna2SectorList GetChildSectorList (Mac48Address address, AntennaID antennaID, SectorID sectorID) const;
+  Antenna2SectorList GetSiblingSectorList (Mac48Address address, AntennaID antennaID, SectorID sectorID) const;
   bool GetNextSector (bool &changeAntenna);
   bool GetReceivingMode (void) const;
   uint8_t GetTotalNumberOfElements (void) const;
@@ -214,6 +228,8 @@ protected:
   uint8_t m_totalAntennas;
   BeamformingSectorList m_txCustomSectors;
   BeamformingSectorList m_rxCustomSectors;
+  BeamformingSectorList m_txSweepSectors;
+  SectorHierarchy m_sectorHierarchy;
 
   Antenna2SectorList m_bhiAntennasList;
   bool m_beaconRandomization;
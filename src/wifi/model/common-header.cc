@@ -31,11 +31,13 @@ void
 MgtFrame::AddWifiInformationElement (Ptr<WifiInformationElement> element)
 {
   m_map[element->ElementId ()] = element;
+  m_rawIndex.erase (element->ElementId ());
 }
 
 Ptr<WifiInformationElement>
 MgtFrame::GetInformationElement (WifiInformationElementId id)
 {
+  DecodeInformationElement (id);
   WifiInformationElementMap::const_iterator it = m_map.find (id);
   if (it != m_map.end())
     {
@@ -50,6 +52,7 @@ MgtFrame::GetInformationElement (WifiInformationElementId id)
 uint32_t
 MgtFrame::GetInformationElementsSerializedSize (void) const
 {
+  DecodeInformationElements ();
   Ptr<WifiInformationElement> element;
   uint32_t size = 0;
   for (WifiInformationElementMap::const_iterator elem = m_map.begin (); elem != m_map.end (); elem++)
@@ -63,6 +66,7 @@ MgtFrame::GetInformationElementsSerializedSize (void) const
 WifiInformationElementMap
 MgtFrame::GetListOfInformationElement (void) const
 {
+  DecodeInformationElements ();
   return m_map;
 }
 
@@ -75,6 +79,7 @@ MgtFrame::PrintInformationElements (std::ostream &os) const
 Buffer::Iterator
 MgtFrame::SerializeInformationElements (Buffer::Iterator start) const
 {
+  DecodeInformationElements ();
   Buffer::Iterator i = start;
   Ptr<WifiInformationElement> element;
   for (WifiInformationElementMap::const_iterator elem = m_map.begin (); elem != m_map.end (); elem++)
@@ -89,100 +94,156 @@ Buffer::Iterator
 MgtFrame::DeserializeInformationElements (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
-  Ptr<WifiInformationElement> element;
   uint8_t id, length;
   while (!i.IsEnd ())
     {
       i = DeserializeElementID (i, id, length);
-      switch (id)
-        {
-          case IE_SUPPORTED_RATES:
-            {
-              element = Create<SupportedRates> ();
-              break;
-            }
-          case IE_EXTENDED_SUPPORTED_RATES:
-            {
-              element = Create<ExtendedSupportedRatesIE> ();
-              break;
-            }
-          case IE_HT_CAPABILITIES:
-            {
-              element = Create<HtCapabilities> ();
-              break;
-            }
-          case IE_VHT_CAPABILITIES:
-            {
-              element = Create<VhtCapabilities> ();
-              break;
-            }
-          case IE_HT_OPERATION:
-            {
-              element = Create<HtOperation> ();
-              break;
-            }
-        case IE_VHT_OPERATION:
-          {
-            element = Create<VhtOperation> ();
-            break;
-          }
-          case IE_ERP_INFORMATION:
-            {
-              element = Create<ErpInformation> ();
-              break;
-            }
-          case IE_EDCA_PARAMETER_SET:
-            {
-              element = Create<EdcaParameterSet> ();
-              break;
-            }
-          case IE_DSSS_PARAMETER_SET:
-            {
-              element = Create<DsssParameterSet> ();
-              break;
-            }
-          case IE_DMG_CAPABILITIES:
-            {
-              element = Create<DmgCapabilities> ();
-              break;
-            }
-          case IE_MULTI_BAND:
-            {
-              element = Create<MultiBandElement> ();
-              break;
-            }
-          case IE_DMG_OPERATION:
-            {
-              element = Create<DmgOperationElement> ();
-              break;
-            }
-          case IE_NEXT_DMG_ATI:
-            {
-              element = Create<NextDmgAti> ();
-              break;
-            }
-          case IE_RELAY_CAPABILITIES:
-            {
-              element = Create<RelayCapabilitiesElement> ();
-              break;
-            }
-          case IE_EXTENDED_SCHEDULE:
-            {
-              element = Create<ExtendedScheduleElement> ();
-              break;
-            }
-          case IE_STA_AVAILABILITY:
-            {
-              element = Create<StaAvailabilityElement> ();
-              break;
-            }
-        }
-
-      i = element->DeserializeElementBody (i, length);
-      m_map[id] = element;
+      /* Only keep the body of the element, it is decoded when accessed */
+      uint32_t offset = m_rawElements.size ();
+      m_rawElements.resize (offset + length);
+      i.Read (m_rawElements.data () + offset, length);
+      m_rawIndex[id] = std::make_pair (offset, length);
     }
 
   return i;
 }
 
+Ptr<WifiInformationElement>
+MgtFrame::CreateInformationElement (WifiInformationElementId id)
+{
+  Ptr<WifiInformationElement> element;
+  switch (id)
+    {
+    case IE_SUPPORTED_RATES:
+      {
+        element = Create<SupportedRates> ();
+        break;
+      }
+    case IE_EXTENDED_SUPPORTED_RATES:
+      {
+        element = Create<ExtendedSupportedRatesIE> ();
+        break;
+      }
+    case IE_HT_CAPABILITIES:
+      {
+        element = Create<HtCapabilities> ();
+        break;
+      }
+    case IE_VHT_CAPABILITIES:
+      {
+        element = Create<VhtCapabilities> ();
+        break;
+      }
+    case IE_HT_OPERATION:
+      {
+        element = Create<HtOperation> ();
+        break;
+      }
+    case IE_VHT_OPERATION:
+      {
+        element = Create<VhtOperation> ();
+        break;
+      }
+    case IE_ERP_INFORMATION:
+      {
+        element = Create<ErpInformation> ();
+        break;
+      }
+    case IE_EDCA_PARAMETER_SET:
+      {
+        element = Create<EdcaParameterSet> ();
+        break;
+      }
+    case IE_DSSS_PARAMETER_SET:
+      {
+        element = Create<DsssParameterSet> ();
+        break;
+      }
+    case IE_DMG_CAPABILITIES:
+      {
+        element = Create<DmgCapabilities> ();
+        break;
+      }
+    case IE_MULTI_BAND:
+      {
+        element = Create<MultiBandElement> ();
+        break;
+      }
+    case IE_DMG_OPERATION:
+      {
+        element = Create<DmgOperationElement> ();
+        break;
+      }
+    case IE_NEXT_DMG_ATI:
+      {
+        element = Create<NextDmgAti> ();
+        break;
+      }
+    case IE_RELAY_CAPABILITIES:
+      {
+        element = Create<RelayCapabilitiesElement> ();
+        break;
+      }
+    case IE_EXTENDED_SCHEDULE:
+      {
+        element = Create<ExtendedScheduleElement> ();
+        break;
+      }
+    case IE_STA_AVAILABILITY:
+      {
+        element = Create<StaAvailabilityElement> ();
+        break;
+      }
+    default:
+      {
+        NS_LOG_DEBUG ("Unsupported information element " << +id);
+        break;
+      }
+    }
+  return element;
+}
+
+void
+MgtFrame::DecodeInformationElement (WifiInformationElementId id) const
+{
+  std::map<WifiInformationElementId, RawElement>::const_iterator raw = m_rawIndex.find (id);
+  if (raw == m_rawIndex.end () || m_map.find (id) != m_map.end ())
+    {
+      return;
+    }
+  Ptr<WifiInformationElement> element = CreateInformationElement (id);
+  if (element != 0)
+    {
+      uint8_t length = raw->second.second;
+      Buffer buffer;
+      buffer.AddAtStart (length);
+      buffer.Begin ().Write (m_rawElements.data () + raw->second.first, length);
+      element->DeserializeElementBody (buffer.Begin (), length);
+      m_map[id] = element;
+    }
+}
+
+void
+MgtFrame::DecodeInformationElements (void) const
+{
+  for (std::map<WifiInformationElementId, RawElement>::const_iterator raw = m_rawIndex.begin ();
+       raw != m_rawIndex.end (); raw++)
+    {
+      DecodeInformationElement (raw->first);
+    }
+}
+
+bool
+MgtFrame::GetRawInformationElement (WifiInformationElementId id, std::vector<uint8_t> &body) const
+{
+  std::map<WifiInformationElementId, RawElement>::const_iterator raw = m_rawIndex.find (id);
+  if (raw == m_rawIndex.end ())
+    {
+      return false;
+    }
+  std::vector<uint8_t>::const_iterator start = m_rawElements.begin () + raw->second.first;
+  body.assign (start, start + raw->second.second);
+  return true;
+}
+
 }
@@ -7,12 +7,18 @@
 #define COMMON_HEADER_H
 
 #include "wifi-information-element.h"
+#include <vector>
 
 namespace ns3 {
 
 /**
  * \ingroup wifi
  * Implemention for generic Management Frame.
+ *
+ * The information elements of a deserialized frame are decoded lazily: the
+ * deserialization only copies their bytes and indexes their IDs, and an element
+ * is decoded the first time it is accessed. Frames that are dropped or only
+ * inspected for their fixed fields never build the element objects.
  */
 class MgtFrame {
 public:
@@ -32,6 +38,14 @@ public:
    * \return
    */
   WifiInformationElementMap GetListOfInformationElement (void) const;
+  /**
+   * Get the encoded body of an information element of a deserialized frame
+   * without decoding it.
+   * \param id The ID of the Wifi Information Element.
+   * \param body The vector filled with the body of the element.
+   * \return true if the frame was deserialized with this element, false otherwise.
+   */
+  bool GetRawInformationElement (WifiInformationElementId id, std::vector<uint8_t> &body) const;
 
 protected:
   void PrintInformationElements (std::ostream &os) const;
@@ -40,7 +54,28 @@ protected:
   Buffer::Iterator DeserializeInformationElements (Buffer::Iterator start);
 
 private:
-  WifiInformationElementMap m_map;                 //!< Map of Wifi Information Element.
+  /**
+   * Create an empty information element of the given type.
+   * \param id The ID of the Wifi Information Element.
+   * \return the element, or 0 if the element is not supported.
+   */
+  static Ptr<WifiInformationElement> CreateInformationElement (WifiInformationElementId id);
+  /**
+   * Decode a deserialized information element if it has not been accessed yet.
+   * \param id The ID of the Wifi Information Element.
+   */
+  void DecodeInformationElement (WifiInformationElementId id) const;
+  /**
+   * Decode all the deserialized information elements that have not been accessed yet.
+   */
+  void DecodeInformationElements (void) const;
+
+  /// Offset and length of the body of an information element in m_rawElements.
+  typedef std::pair<uint32_t, uint8_t> RawElement;
+
+  mutable WifiInformationElementMap m_map;                 //!< Map of Wifi Information Element.
+  std::vector<uint8_t> m_rawElements;                      //!< Bodies of the deserialized information elements.
+  std::map<WifiInformationElementId, RawElement> m_rawIndex;  //!< Location of the deserialized information elements.
 
 };
 
@@ -3,6 +3,9 @@
  * Copyright (c) 2015-2019 IMDEA Networks Institute
  * Author: Hany Assasa <hany.assasa@gmail.com>
  */
+#include <algorithm>
+#include <set>
+
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -86,6 +89,21 @@ DmgApWifiMac::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&DmgApWifiMac::m_isABFTResponderTXSS),
                    MakeBooleanChecker ())
+    .AddAttribute ("AdaptiveBhi", "Whether to reduce the beaconing sectors and the A-BFT slots of the BHI while no DMG STA"
+                   " attempts to associate and no beamformed link fails.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DmgApWifiMac::m_adaptiveBhi),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AdaptiveBhiIdleBIs", "The number of BIs without association attempts or beamformed link failures"
+                   " after which the BHI is reduced.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&DmgApWifiMac::m_bhiIdleThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("AdaptiveBhiProbeSectors", "The number of sectors per DMG antenna swept in a reduced BTI in addition"
+                   " to the sectors towards the associated DMG STAs, so that new DMG STAs can still discover the PCP/AP.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&DmgApWifiMac::m_bhiProbeSectors),
+                   MakeUintegerChecker<uint8_t> (1))
 
     .AddAttribute ("AnnounceCapabilities", "Whether to include DMG Capabilities in DMG Beacons.",
                    BooleanValue (true),
@@ -185,7 +203,9 @@ DmgApWifiMac::GetTypeId (void)
 }
 
 DmgApWifiMac::DmgApWifiMac ()
-  : m_sswFbckEvent ()
+  : m_beaconTemplateValid (false),
+    m_extendedScheduleVersion (0),
+    m_sswFbckEvent ()
 {
   NS_LOG_FUNCTION (this);
   /* DMG Beacon DCF Manager */
@@ -202,6 +222,9 @@ DmgApWifiMac::DmgApWifiMac ()
   m_btiPeriodicity = 0;
   m_initiateDynamicAllocation = false;
   m_monitoringChannel = false;
+  m_bhiIdleBIs = 0;
+  m_bhiActivity = false;
+  m_probeSectorOffset = 0;
   // Let the lower layers know that we are acting as an AP.
   SetTypeOfStation (DMG_AP);
 }
@@ -217,6 +240,7 @@ DmgApWifiMac::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_beaconDca = 0;
   m_beaconEvent.Cancel ();
+  m_extendedSchedule = 0;
   DmgWifiMac::DoDispose ();
 }
 
@@ -225,6 +249,7 @@ DmgApWifiMac::SetScheduler (Ptr<DmgWifiScheduler> dmgScheduler)
 {
   NS_LOG_FUNCTION (this);
   m_dmgScheduler = dmgScheduler;
+  m_extendedSchedule = 0;
 }
 
 Ptr<DmgWifiScheduler>
@@ -451,6 +476,15 @@ DmgApWifiMac::SendAssocResp (Mac48Address to, bool success)
   return aid;
 }
 
+void
+DmgApWifiMac::BeamLinkMaintenanceTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  /* The beamformed link with the peer DMG STA is lost, restore the full BHI so that it can train again */
+  NotifyBhiActivity ();
+  DmgWifiMac::BeamLinkMaintenanceTimeout ();
+}
+
 Ptr<DmgCapabilities>
 DmgApWifiMac::GetDmgCapabilities (void) const
 {
@@ -507,9 +541,17 @@ DmgApWifiMac::GetNextDmgAtiElement (void) const
 Ptr<ExtendedScheduleElement>
 DmgApWifiMac::GetExtendedScheduleElement (void) const
 {
-  Ptr<ExtendedScheduleElement> scheduleElement = Create<ExtendedScheduleElement> ();
-  scheduleElement->SetAllocationFieldList (m_dmgScheduler->GetAllocationList ());
-  return scheduleElement;
+  uint32_t version = m_dmgScheduler->GetAllocationListVersion ();
+  if (m_extendedSchedule == 0 || m_extendedScheduleVersion != version
+      || m_extendedScheduleReclaimed != m_reclaimedBhiDuration)
+    {
+      NS_LOG_DEBUG ("Build Extended Schedule element for allocation list version " << version);
+      m_extendedSchedule = Create<ExtendedScheduleElement> ();
+      m_extendedSchedule->SetAllocationFieldList (GetDtiAllocationList ());
+      m_extendedScheduleVersion = version;
+      m_extendedScheduleReclaimed = m_reclaimedBhiDuration;
+    }
+  return m_extendedSchedule;
 }
 
 void
@@ -567,19 +609,182 @@ DmgApWifiMac::CalculateBTIVariables (void)
   /* Calculate Beacon Transmission Interval Length */
   m_btiDuration = m_dmgBeaconDurationUs * m_codebook->GetNumberOfSectorsInBHI () +
                   GetSbifs () * (m_codebook->GetNumberOfSectorsInBHI () - 1);
+  /* BHI time saved compared to a BHI with all the beaconing sectors and A-BFT slots */
+  if (m_adaptiveBhi)
+    {
+      uint32_t fullSectors = 0;
+      for (Antenna2SectorListCI iter = m_fullBeaconingSectors.begin (); iter != m_fullBeaconingSectors.end (); iter++)
+        {
+          fullSectors += iter->second.size ();
+        }
+      m_reclaimedBhiDuration = (m_dmgBeaconDurationUs + GetSbifs ()) * (fullSectors - m_codebook->GetNumberOfSectorsInBHI ());
+      if (m_nextAbft == 0)
+        {
+          m_reclaimedBhiDuration += GetSectorSweepSlotTime (m_ssFramesPerSlot) * (m_fullSsSlotsPerAbft - m_ssSlotsPerABFT);
+        }
+    }
 }
 
 void
-DmgApWifiMac::SendOneDMGBeacon (void)
+DmgApWifiMac::AdaptBeaconHeaderInterval (void)
 {
   NS_LOG_FUNCTION (this);
-  WifiMacHeader hdr;
-  hdr.SetType (WIFI_MAC_EXTENSION_DMG_BEACON);
-  hdr.SetAddr1 (GetBssid ());     /* BSSID */
-  hdr.SetNoMoreFragments ();
-  hdr.SetNoRetry ();
+  if (m_bhiActivity)
+    {
+      m_bhiIdleBIs = 0;
+      m_bhiActivity = false;
+    }
+  else if (m_bhiIdleBIs < m_bhiIdleThreshold)
+    {
+      m_bhiIdleBIs++;
+    }
 
-  ExtDMGBeacon beacon;
+  Antenna2SectorList sectors;
+  /* The BHI time saved must be announced in the Extended Schedule element, so the BHI is not
+   * reduced when the allocation list is full and its last allocation cannot be extended */
+  AllocationFieldList allocationList = m_dmgScheduler->GetAllocationList ();
+  bool canAnnounce = (allocationList.size () < DmgWifiScheduler::MAX_ALLOCATION_FIELDS)
+                     || IsBroadcastCbapBlock (*GetLastAllocation (allocationList));
+  if ((m_bhiIdleBIs == m_bhiIdleThreshold) && canAnnounce && GetReducedBeaconingSectors (sectors))
+    {
+      /* A DMG STA joining the BSS through a probe sector needs a single A-BFT slot */
+      m_ssSlotsPerABFT = aMinSSSlotsPerABFT;
+    }
+  else
+    {
+      sectors = m_fullBeaconingSectors;
+      m_ssSlotsPerABFT = m_fullSsSlotsPerAbft;
+    }
+  if (sectors != m_codebook->GetBeaconingSectors ())
+    {
+      m_codebook->ChangeBeaconingSectors (sectors);
+    }
+  m_abftDuration = m_ssSlotsPerABFT * GetSectorSweepSlotTime (m_ssFramesPerSlot);
+  NS_LOG_DEBUG ("BHI with " << uint16_t (m_codebook->GetNumberOfSectorsInBHI ()) << " beaconing sectors and "
+                << uint16_t (m_ssSlotsPerABFT) << " A-BFT slots after " << m_bhiIdleBIs << " idle BIs");
+}
+
+bool
+DmgApWifiMac::GetReducedBeaconingSectors (Antenna2SectorList &sectors)
+{
+  NS_LOG_FUNCTION (this);
+  std::set<ANTENNA_CONFIGURATION> selected;
+  /* The best transmit sector towards each associated DMG STA */
+  for (std::map<uint16_t, Mac48Address>::const_iterator iter = m_staList.begin (); iter != m_staList.end (); iter++)
+    {
+      STATION_ANTENNA_CONFIG_MAP::const_iterator config = m_bestAntennaConfig.find (iter->second);
+      if (config == m_bestAntennaConfig.end ())
+        {
+          return false;
+        }
+      ANTENNA_CONFIGURATION_TX antennaConfig = config->second.first;
+      Antenna2SectorListCI antenna = m_fullBeaconingSectors.find (antennaConfig.second);
+      if ((antenna == m_fullBeaconingSectors.end ())
+          || (std::find (antenna->second.begin (), antenna->second.end (), antennaConfig.first) == antenna->second.end ()))
+        {
+          return false;
+        }
+      selected.insert (antennaConfig);
+    }
+  /* The probe sectors of this BI */
+  for (Antenna2SectorListCI iter = m_fullBeaconingSectors.begin (); iter != m_fullBeaconingSectors.end (); iter++)
+    {
+      for (uint8_t i = 0; i < m_bhiProbeSectors; i++)
+        {
+          SectorID sector = iter->second.at ((m_probeSectorOffset + i) % iter->second.size ());
+          selected.insert (std::make_pair (sector, iter->first));
+        }
+    }
+  m_probeSectorOffset += m_bhiProbeSectors;
+  /* Sweep the selected sectors in the order of the full list */
+  sectors.clear ();
+  for (Antenna2SectorListCI iter = m_fullBeaconingSectors.begin (); iter != m_fullBeaconingSectors.end (); iter++)
+    {
+      for (SectorIDList::const_iterator sector = iter->second.begin (); sector != iter->second.end (); sector++)
+        {
+          if (selected.find (std::make_pair (*sector, iter->first)) != selected.end ())
+            {
+              sectors[iter->first].push_back (*sector);
+            }
+        }
+    }
+  return true;
+}
+
+void
+DmgApWifiMac::NotifyBhiActivity (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_bhiActivity = true;
+}
+
+AllocationFieldList
+DmgApWifiMac::GetDtiAllocationList (void) const
+{
+  AllocationFieldList allocationList = m_dmgScheduler->GetAllocationList ();
+  if (!m_reclaimedBhiDuration.IsStrictlyPositive () || allocationList.empty ())
+    {
+      return allocationList;
+    }
+  uint32_t reclaimed = m_reclaimedBhiDuration.GetMicroSeconds ();
+  AllocationFieldListI last = GetLastAllocation (allocationList);
+  if (IsBroadcastCbapBlock (*last) && (last->GetAllocationBlockDuration () + reclaimed <= MAX_CBAP_BLOCK_DURATION))
+    {
+      last->SetAllocationBlockDuration (last->GetAllocationBlockDuration () + reclaimed);
+    }
+  else if (allocationList.size () < DmgWifiScheduler::MAX_ALLOCATION_FIELDS)
+    {
+      AllocationField field;
+      field.SetAllocationID (BROADCAST_CBAP);
+      field.SetAllocationType (CBAP_ALLOCATION);
+      field.SetAsPseudoStatic (true);
+      field.SetSourceAid (AID_BROADCAST);
+      field.SetDestinationAid (AID_BROADCAST);
+      field.SetAllocationStart ((GetDTIDuration () - m_reclaimedBhiDuration).GetMicroSeconds ());
+      field.SetAllocationBlockDuration (reclaimed);
+      field.SetAllocationBlockPeriod (0);
+      field.SetNumberOfBlocks (1);
+      allocationList.push_back (field);
+    }
+  else
+    {
+      NS_LOG_WARN ("The BHI time saved (" << m_reclaimedBhiDuration << ") does not fit in the allocation list"
+                   " and is left unallocated");
+    }
+  return allocationList;
+}
+
+AllocationFieldListI
+DmgApWifiMac::GetLastAllocation (AllocationFieldList &allocationList) const
+{
+  AllocationFieldListI last = allocationList.begin ();
+  uint32_t lastEnd = 0;
+  for (AllocationFieldListI iter = allocationList.begin (); iter != allocationList.end (); iter++)
+    {
+      uint32_t allocEnd = iter->GetAllocationStart () + (iter->GetNumberOfBlocks () - 1) * iter->GetAllocationBlockPeriod ()
+                          + iter->GetAllocationBlockDuration ();
+      if (allocEnd >= lastEnd)
+        {
+          last = iter;
+          lastEnd = allocEnd;
+        }
+    }
+  return last;
+}
+
+bool
+DmgApWifiMac::IsBroadcastCbapBlock (const AllocationField &field) const
+{
+  return (field.GetAllocationType () == CBAP_ALLOCATION) && (field.GetSourceAid () == AID_BROADCAST)
+          && (field.GetNumberOfBlocks () == 1);
+}
+
+void
+DmgApWifiMac::BuildDmgBeaconTemplate (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_beaconTemplate = ExtDMGBeacon ();
+  ExtDMGBeacon &beacon = m_beaconTemplate;
 
   /* Timestamp */
   /**
@@ -590,14 +795,6 @@ DmgApWifiMac::SendOneDMGBeacon (void)
    */
   beacon.SetTimestamp (m_biStartTime.GetMicroSeconds ());
 
-  /* Sector Sweep Field */
-  DMG_SSW_Field ssw;
-  ssw.SetDirection (BeamformingInitiator);
-  ssw.SetCountDown (m_codebook->GetRemaingSectorCount ());
-  ssw.SetSectorID (m_codebook->GetActiveTxSectorID ());
-  ssw.SetDMGAntennaID (m_codebook->GetActiveAntennaID ());
-  beacon.SetSSWField (ssw);
-
   /* Beacon Interval */
   beacon.SetBeaconIntervalUs (m_beaconInterval.GetMicroSeconds ());
 
@@ -691,12 +888,47 @@ DmgApWifiMac::SendOneDMGBeacon (void)
       beacon.AddWifiInformationElement (GetExtendedScheduleElement ());
     }
 
+  m_beaconTemplateValid = true;
+}
+
+
+void
+DmgApWifiMac::InvalidateDmgBeaconTemplate (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_beaconTemplateValid = false;
+}
+
+void
+DmgApWifiMac::SendOneDMGBeacon (void)
+{
+  NS_LOG_FUNCTION (this);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_EXTENSION_DMG_BEACON);
+  hdr.SetAddr1 (GetBssid ());     /* BSSID */
+  hdr.SetNoMoreFragments ();
+  hdr.SetNoRetry ();
+
+  /* All the DMG Beacons of a BTI share the same content except for the SSW field */
+  if (!m_beaconTemplateValid)
+    {
+      BuildDmgBeaconTemplate ();
+    }
+
+  /* Sector Sweep Field */
+  DMG_SSW_Field ssw;
+  ssw.SetDirection (BeamformingInitiator);
+  ssw.SetCountDown (m_codebook->GetRemaingSectorCount ());
+  ssw.SetSectorID (m_codebook->GetActiveTxSectorID ());
+  ssw.SetDMGAntennaID (m_codebook->GetActiveAntennaID ());
+  m_beaconTemplate.SetSSWField (ssw);
+
   Time btiRemaining = GetBTIRemainingTime ();
   NS_LOG_DEBUG ("BTI Remaining Time=" << btiRemaining);
   NS_ASSERT_MSG (btiRemaining.IsStrictlyPositive (), "Remaining BTI Period should not be negative.");
 
   /* The DMG beacon has it's own special queue, so we load it in there */
-  m_beaconDca->TransmitDmgBeacon (beacon, hdr, btiRemaining - m_dmgBeaconDurationUs);
+  m_beaconDca->TransmitDmgBeacon (m_beaconTemplate, hdr, btiRemaining - m_dmgBeaconDurationUs);
 }
 
 void
@@ -772,7 +1004,9 @@ DmgApWifiMac::GetStationAddress (uint8_t aid) const
 Time
 DmgApWifiMac::GetBHIDuration (void) const
 {
-  return m_btiDuration + m_abftDuration + m_atiDuration + 2 * GetMbifs ();
+  /* The ATI duration is announced only if the ATI is present, see the ATI element */
+  Time atiDuration = m_atiPresent ? m_atiDuration : Seconds (0);
+  return m_btiDuration + m_abftDuration + atiDuration + 2 * GetMbifs ();
 }
 
 Time
@@ -787,6 +1021,12 @@ DmgApWifiMac::GetDTIRemainingTime (void) const
   return GetDTIDuration () - (Simulator::Now () - m_dtiStartTime);
 }
 
+Time
+DmgApWifiMac::GetReclaimedBhiDuration (void) const
+{
+  return m_reclaimedBhiDuration;
+}
+
 Time
 DmgApWifiMac::GetBTIRemainingTime (void) const
 {
@@ -980,6 +1220,7 @@ DmgApWifiMac::FrameTxOk (const WifiMacHeader &hdr)
         }
       m_slsCompleted (address, CHANNEL_ACCESS_DTI, BeamformingResponder, m_isInitiatorTXSS, m_isResponderTXSS,
                       antennaConfig.first, antennaConfig.second);
+      NotifyBeamLinkRecovered (address);
     }
 }
 
@@ -997,9 +1238,13 @@ DmgApWifiMac::StartBeaconInterval (void)
   NS_LOG_DEBUG ("Next BI will start at " << Simulator::Now () + m_beaconInterval);
 
   /* Timing variables */
+  if (m_adaptiveBhi)
+    {
+      AdaptBeaconHeaderInterval ();
+    }
   CalculateBTIVariables ();
   /* Invoke callback */
-  m_biStarted (GetAddress (), m_beaconInterval, GetBHIDuration (), m_atiDuration);
+  m_biStarted (GetAddress (), m_beaconInterval, GetBHIDuration (), m_atiPresent ? m_atiDuration : Seconds (0));
 
 //  if (m_enableDecentralizedClustering)
 //    {
@@ -1073,6 +1318,7 @@ DmgApWifiMac::StartBeaconTransmissionInterval (void)
   m_codebook->StartBTIAccessPeriod ();
 
   m_btiStarted = Simulator::Now ();
+  InvalidateDmgBeaconTemplate ();
   m_beaconEvent = Simulator::ScheduleNow (&DmgApWifiMac::SendOneDMGBeacon, this);
 }
 
@@ -1221,7 +1467,7 @@ DmgApWifiMac::StartDataTransmissionInterval (void)
     }
   else
     {
-      m_allocationList = m_dmgScheduler->GetAllocationList ();
+      m_allocationList = GetDtiAllocationList ();
       for (AllocationFieldListI it = m_allocationList.begin (); it != m_allocationList.end (); ++it)
         {
           NS_LOG_DEBUG ("AP, Allocation Id: " << +it->GetAllocationID () << "\n"
@@ -1814,6 +2060,7 @@ DmgApWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
       if (m_accessPeriod == CHANNEL_ACCESS_ABFT)
         {
           NS_LOG_INFO ("Received SSW frame during A-BFT from=" << hdr->GetAddr2 ());
+          NotifyBhiActivity ();
 
           /* Check if we have received any SSW frame during the current SSW-Slot */
           if (!m_receivedOneSSW)
@@ -2026,6 +2273,7 @@ DmgApWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
         {
           if (hdr->IsAssocReq ())
             {
+              NotifyBhiActivity ();
               // First, verify that the the station's supported
               // rate set is compatible with our Basic Rate set
               MgtAssocRequestHeader assocReq;
@@ -2350,6 +2598,10 @@ DmgApWifiMac::DoInitialize (void)
   /* Initialzie Codebook */
   m_codebook->InitializeCodebook ();
 
+  /* The adaptive BHI starts with all the beaconing sectors and A-BFT slots */
+  m_fullBeaconingSectors = m_codebook->GetBeaconingSectors ();
+  m_fullSsSlotsPerAbft = m_ssSlotsPerABFT;
+
   /* Decentralzied Clustering */
   if (m_enableDecentralizedClustering)
     {
@@ -13,6 +13,8 @@
 #include "dmg-wifi-mac.h"
 #include "dmg-wifi-scheduler.h"
 
+class AdaptiveBhiTest;
+
 namespace ns3 {
 
 #define TU                      MicroSeconds (1024)     /* Time Unit defined in 802.11 std */
@@ -32,6 +34,9 @@ namespace ns3 {
 class DmgApWifiMac : public DmgWifiMac
 {
 public:
+  /// Allow test cases to access private members
+  friend class ::AdaptiveBhiTest;
+
   static TypeId GetTypeId (void);
 
   DmgApWifiMac ();
@@ -103,6 +108,12 @@ public:
    * \return The remaining time in the DTI.
    */
   Time GetDTIRemainingTime (void) const;
+  /**
+   * Get the BHI time saved in the current BI by the adaptive BHI. This time extends the last
+   * broadcast CBAP of the DTI planned by the DMG scheduler.
+   * \return The duration saved compared to a BHI with all the beaconing sectors and A-BFT slots.
+   */
+  Time GetReclaimedBhiDuration (void) const;
   /**
    * \param interval the interval.
    */
@@ -181,6 +192,12 @@ public:
    * Start DMG AP Operation by transmitting Beaconing.
    */
   void StartAccessPoint (void);
+  /**
+   * Invalidate the DMG Beacon template so that it is rebuilt before the next DMG Beacon.
+   * The template is rebuilt at the start of every BTI, this method is only needed when
+   * the schedule or the capabilities announced by the PCP/AP change during a BTI.
+   */
+  void InvalidateDmgBeaconTemplate (void);
 
 protected:
   friend class DmgBeaconDca;
@@ -210,6 +227,10 @@ protected:
    * \return the DMG capabilities the PCP/AP supports.
    */
   Ptr<DmgCapabilities> GetDmgCapabilities (void) const;
+  /**
+   * BeamLink Maintenance Timeout.
+   */
+  virtual void BeamLinkMaintenanceTimeout (void);
   /**
    * Dmg Scheduler to be used by the PCP/AP.
    */
@@ -234,6 +255,41 @@ private:
    * Start Beacon Header Interval (BHI).
    */
   void StartBeaconHeaderInterval (void);
+  /**
+   * Adapt the beaconing sectors and the number of A-BFT slots of the next BHI. Both are reduced
+   * after a number of BIs without association attempts or beamformed link failures, and restored
+   * as soon as one of them occurs.
+   */
+  void AdaptBeaconHeaderInterval (void);
+  /**
+   * Get the reduced list of beaconing sectors: the best transmit sector towards each associated
+   * DMG STA plus, for each DMG antenna, probe sectors which rotate over the full list every BI.
+   * \param sectors The reduced list of beaconing sectors.
+   * \return Whether the best transmit sector towards every associated DMG STA is known.
+   */
+  bool GetReducedBeaconingSectors (Antenna2SectorList &sectors);
+  /**
+   * Signal an association attempt or a beamformed link failure to the adaptive BHI.
+   */
+  void NotifyBhiActivity (void);
+  /**
+   * Get the allocations of the current DTI. The DMG scheduler plans the DTI left by the full BHI,
+   * so the BHI time saved by the adaptive BHI is given to the last broadcast CBAP of the DTI, or to
+   * an additional broadcast CBAP when the allocation list is not full.
+   * \return The allocation list of the current DTI.
+   */
+  AllocationFieldList GetDtiAllocationList (void) const;
+  /**
+   * Get the allocation which ends last in a DTI.
+   * \param allocationList The allocation list of the DTI, which must not be empty.
+   * \return The allocation which ends last.
+   */
+  AllocationFieldListI GetLastAllocation (AllocationFieldList &allocationList) const;
+  /**
+   * \param field The allocation field.
+   * \return Whether the allocation is a broadcast CBAP made of a single block, which can be extended.
+   */
+  bool IsBroadcastCbapBlock (const AllocationField &field) const;
   /**
    * The packet we sent was successfully received by the receiver
    * (i.e. we received an ACK from the receiver). If the packet
@@ -386,7 +442,8 @@ private:
    */
   Ptr<NextDmgAti> GetNextDmgAtiElement (void) const;
   /**
-   * Get Extended Schedule element.
+   * Get Extended Schedule element. The element is only rebuilt when the version of the
+   * allocation list of the scheduler changes.
    * \return The extended schedule element.
    */
   Ptr<ExtendedScheduleElement> GetExtendedScheduleElement (void) const;
@@ -394,6 +451,11 @@ private:
    * Calculate BTI access period variables.
    */
   void CalculateBTIVariables (void);
+  /**
+   * Build the DMG Beacon template, i.e., all the fields of the DMG Beacons sent during the
+   * current BTI except for the SSW field.
+   */
+  void BuildDmgBeaconTemplate (void);
   /**
    * Send One DMG Beacon frame with the provided arguments.
    */
@@ -418,6 +480,11 @@ private:
   /** BTI Period Variables **/
   Ptr<DmgBeaconDca> m_beaconDca;        //!< Dedicated DcaTxop for DMG Beacons.
   EventId m_beaconEvent;		//!< Event to generate one DMG Beacon.
+  ExtDMGBeacon m_beaconTemplate;        //!< DMG Beacon sent in every sector of the BTI, only the SSW field is updated.
+  bool m_beaconTemplateValid;           //!< Flag to indicate whether the DMG Beacon template is up-to-date.
+  mutable Ptr<ExtendedScheduleElement> m_extendedSchedule; //!< Extended Schedule element of the current allocation list.
+  mutable uint32_t m_extendedScheduleVersion;             //!< Version of the allocation list in the Extended Schedule element.
+  mutable Time m_extendedScheduleReclaimed;               //!< BHI time saved in the Extended Schedule element.
   Time m_btiStarted;                    //!< The time at which we started BTI access period.
   Time m_dmgBeaconDuration;             //!< Exact DMG beacon duration.
   Time m_dmgBeaconDurationUs;           //!< DMG BEacon Duration in Microseconds.
@@ -433,6 +500,17 @@ private:
   bool m_isABFTResponderTXSS;           //!< Flag to indicate whether the responder in A-BFT is TxSS or RxSS.
   std::vector<Mac48Address> m_beamformingInDTI; //!< List of the stations to train in DTI because beamforming is not completed in BTI.
 
+  /** Adaptive BHI **/
+  bool m_adaptiveBhi;                   //!< Flag to indicate whether the BHI is adapted to the activity of the DMG STAs.
+  uint32_t m_bhiIdleThreshold;          //!< The number of BIs without activity after which the BHI is reduced.
+  uint8_t m_bhiProbeSectors;            //!< The number of probe sectors per DMG antenna in a reduced BTI.
+  uint32_t m_bhiIdleBIs;                //!< The number of consecutive BIs without activity.
+  bool m_bhiActivity;                   //!< Flag to indicate whether an activity occurred during the current BI.
+  uint32_t m_probeSectorOffset;         //!< The offset of the probe sectors in the full list of beaconing sectors.
+  Antenna2SectorList m_fullBeaconingSectors; //!< The beaconing sectors of the codebook.
+  uint8_t m_fullSsSlotsPerAbft;         //!< The number of A-BFT slots of a full BHI.
+  Time m_reclaimedBhiDuration;          //!< The BHI time saved in the current BI.
+
   /** DMG PCP/AP Clustering **/
   bool m_enableDecentralizedClustering; //!< Flag to inidicate if decentralized clustering is enabled.
   bool m_enableCentralizedClustering;   //!< Flag to indicate if centralized clustering is enabled.
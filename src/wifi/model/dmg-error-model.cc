@@ -27,6 +27,7 @@
 #include "wifi-utils.h"
 #include "wifi-tx-vector.h"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 
@@ -37,160 +38,41 @@ NS_LOG_COMPONENT_DEFINE ("DmgErrorModel");
 NS_OBJECT_ENSURE_REGISTERED (DmgErrorModel);
 
 void
-SNR2BER_STRUCT::DetermineSnrOffset (void)
+SNR2BER_STRUCT::SetDatapoints (const std::vector<double> &bers)
 {
-  NS_LOG_FUNCTION (this);
-  double snr = snrMin;
-  double toleranceForAssumingZero = 0.0001;
-  for (int i = 0; i < numSnrDecPlaces; i++)
-    {
-      toleranceForAssumingZero /= 10;
-    }
-  if (snrMin < 0)
-    {
-      for (; snr <= 2 * snrSpacing; snr += snrSpacing)
-        {
-          if (snr >= 0)
-            {
-              snrOffset = snr;
-              break;
-            }
-        }
-      if (std::abs (snr) <= toleranceForAssumingZero) //if less than tolerance assume 0
-        {
-          snrOffset = 0;
-        }
-    }
-  else if (snrMin > 0)
-    {
-      for (; snr >= -2 * snrSpacing; snr -= snrSpacing)
-        {
-          if (snr <= 0)
-            {
-              snrOffset = snr;
-              break;
-            }
-        }
-      if (std::abs (snr) <= toleranceForAssumingZero) //if less than tolerance assume 0
-        {
-          snrOffset = 0;
-        }
-    }
-  else //if m_snrMin == 0
+  NS_LOG_FUNCTION (this << bers.size ());
+  NS_ASSERT_MSG (bers.size () >= 2, "At least two datapoints are needed to interpolate the BER");
+  numDataPoints = bers.size ();
+  bitErrorRateTable = bers;
+  logBitSuccessRateTable.resize (numDataPoints);
+  for (uint16_t n = 0; n < numDataPoints; n++)
     {
-      snrOffset = 0;
+      logBitSuccessRateTable[n] = log1p (-bers[n]);
     }
 }
 
 double
-SNR2BER_STRUCT::GetBitErrorRate (double snr)
+SNR2BER_STRUCT::GetBitErrorRate (double snr) const
 {
   NS_LOG_FUNCTION (this << snr);
-  if (snr <= snrMin)
-    {
-      NS_LOG_DEBUG ("SNR is lower than the minimum datapoint; No interpolation needed--direct table lookup for bit error rate.");
-      return berMin;
-    }
-  else if (snr >= snrMax)
-    {
-      NS_LOG_DEBUG ("SNR is higher than the maximum datapoint; No interpolation needed--direct table lookup for bit error rate.");
-      return berMax;
-    }
-  else
-    {
-      NS_LOG_DEBUG ("Performing linear interpolation on snr for bit error rate lookup.");
-      InterpolParams iParams;
-      double ber;
-      iParams = FindDatapointBounds (snr);
-      ber = InterpolateAndRetrieveData (snr, iParams.snrLoBound, iParams.snrHiBound);
-      return ber;
-    }
-}
-
-int
-SNR2BER_STRUCT::RoundDoubleToInt (double val)
-{
-  NS_LOG_FUNCTION (this << val);
-  if (val > 0.0)
-    {
-      return val + 0.5;
-    }
-  else
-    {
-      return val - 0.5;
-    }
+  return Interpolate (bitErrorRateTable, snr);
 }
 
 double
-SNR2BER_STRUCT::RoundToNearestDataMidpoint (double value)
+SNR2BER_STRUCT::GetLogBitSuccessRate (double snr) const
 {
-  NS_LOG_FUNCTION (this << value);
-  double newOffset = (snrSpacing / 2) + snrOffset;
-  return (RoundDoubleToInt ((value - newOffset) / snrSpacing) * snrSpacing) + newOffset;
-}
-
-SNR2BER_STRUCT::InterpolParams
-SNR2BER_STRUCT::FindDatapointBounds (double snr)
-{
-  InterpolParams iParams;
-  double snrRatio = snr / snrSpacing;
-  double snrLoBoundNoOffset = floor (snrRatio) * snrSpacing;
-  double snrHiBoundNoOffset = ceil (snrRatio) * snrSpacing;
-  double nearestMidSnrPoint = RoundToNearestDataMidpoint (snr);
-  if (snr > nearestMidSnrPoint)
-    {
-      iParams.snrLoBound = snrLoBoundNoOffset - snrOffset;
-      iParams.snrHiBound = snrHiBoundNoOffset - snrOffset;
-    }
-  else
-    {
-      iParams.snrLoBound = snrLoBoundNoOffset + snrOffset;
-      iParams.snrHiBound = snrHiBoundNoOffset + snrOffset;
-    }
-  return iParams;
-}
-
-int
-SNR2BER_STRUCT::DoubleToHashKeyInt (double val)
-{
-  NS_LOG_FUNCTION (this << val);
-  for (uint8_t i = 0; i < numSnrDecPlaces; i++)
-    {
-      val = val * 10;
-    }
-  return (int)(round (val));
+  NS_LOG_FUNCTION (this << snr);
+  return Interpolate (logBitSuccessRateTable, snr);
 }
 
 double
-SNR2BER_STRUCT::InterpolateAndRetrieveData (double xd, double x1d, double x2d)
+SNR2BER_STRUCT::Interpolate (const std::vector<double> &table, double snr) const
 {
-  NS_LOG_FUNCTION (this << xd << x1d << x2d);
-  int x1 = DoubleToHashKeyInt (x1d);
-  int x2 = DoubleToHashKeyInt (x2d);
-  std::map<int, double>::iterator elemIter;
-  double fp;
-  double fq1, fq2;
-  elemIter = bitErrorRateTable.find (x1);
-  if (elemIter == bitErrorRateTable.end ())
-    {
-      NS_FATAL_ERROR ("No bit error rate data stored for snr key = " << x1);
-    }
-  else
-    {
-      fq1 = (*elemIter).second;
-    }
-  elemIter = bitErrorRateTable.find (x2);
-  if (elemIter == bitErrorRateTable.end ())
-    {
-      NS_FATAL_ERROR ("No bit error rate data stored for snr key = " << x2);
-    }
-  else
-    {
-      fq2 = (*elemIter).second;
-    }
-  fp = (((x2d - xd) / (x2d - x1d)) * fq1) + (((xd - x1d) / (x2d - x1d)) * fq2);
-  NS_LOG_DEBUG ("BER1=" << fq1 << ", BER2=" << fq2 << ", BER=" << fp);
-  return fp;
+  /* Fractional position of the SNR in the grid, saturated at both ends */
+  double position = std::min (std::max ((snr - snrMin) / snrSpacing, 0.0), numDataPoints - 1.0);
+  uint16_t index = std::min<uint16_t> (position, numDataPoints - 2);
+  double fraction = position - index;
+  return table[index] + fraction * (table[index + 1] - table[index]);
 }
 
 TypeId
@@ -230,9 +112,11 @@ DmgErrorModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double
     mode.GetModulationClass() == WIFI_MOD_CLASS_DMG_SC ||
     mode.GetModulationClass() == WIFI_MOD_CLASS_DMG_OFDM, "Expecting 802.11ad DMG CTRL, SC or OFDM modulation");
 
-  Ptr<SNR2BER_STRUCT> snr2ber = m_snr2berList.find (mode.GetMcsValue ())->second;
-  double ber = snr2ber->GetBitErrorRate (RatioToDb (snr));
-  double psr = pow (1 - ber, nbits);
+  NS_ASSERT_MSG (mode.GetMcsValue () < m_snr2berList.size () && m_snr2berList[mode.GetMcsValue ()] != 0,
+                 "No SNR to BER table loaded for MCS " << uint16_t (mode.GetMcsValue ()));
+  const SNR2BER_STRUCT *snr2ber = PeekPointer (m_snr2berList[mode.GetMcsValue ()]);
+  /* (1 - BER)^nbits computed from the precomputed log (1 - BER) */
+  double psr = std::exp (nbits * snr2ber->GetLogBitSuccessRate (RatioToDb (snr)));
   NS_LOG_DEBUG ("PSR=" << psr);
 
   return psr;
@@ -254,7 +138,6 @@ DmgErrorModel::LoadErrorRateTables (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT_MSG (!m_errorRateTablesLoaded, "bit error rate table has already been loaded");
-  std::pair<std::map<int, double>::iterator, bool> ret;
 
   std::ifstream file;
   file.open (m_fileName, std::ifstream::in);
@@ -263,7 +146,6 @@ DmgErrorModel::LoadErrorRateTables (void)
 
   MCS_IDX idx;
   std::string value;
-  int snrInt;
 
   std::getline (file, line);
   m_numMCSs = std::stod (line);
@@ -318,14 +200,15 @@ DmgErrorModel::LoadErrorRateTables (void)
 
       for (uint16_t n = 0; n < snr2berStruct->numDataPoints; n++)
         {
-          snrInt = snr2berStruct->DoubleToHashKeyInt (snrs[n]);
-          ret = snr2berStruct->bitErrorRateTable.insert (std::pair<int, double> (snrInt, bers[n]));
-          NS_ASSERT_MSG (ret.second, "element with SNR hash of " << snrInt <<
-                                     " already exists in bit error table hash map with value of " << ret.first->second);
+          NS_ASSERT_MSG (std::abs (snrs[n] - (snr2berStruct->snrMin + n * m_snrSpacing)) < m_snrSpacing / 100,
+                         "SNR datapoint " << snrs[n] << " of MCS " << uint16_t (idx) << " is not on a uniform grid");
         }
+      snr2berStruct->SetDatapoints (bers);
 
-      snr2berStruct->DetermineSnrOffset ();
-
+      if (idx >= m_snr2berList.size ())
+        {
+          m_snr2berList.resize (idx + 1);
+        }
       m_snr2berList[idx] = snr2berStruct;
     }
 
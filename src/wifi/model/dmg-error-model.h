@@ -25,42 +25,54 @@
 
 #include "error-rate-model.h"
 #include "wifi-mode.h"
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
+/**
+ * SNR to BER table of a single MCS. The datapoints lie on a uniform SNR
+ * grid, so they are stored in dense arrays indexed by the SNR.
+ */
 struct SNR2BER_STRUCT : public SimpleRefCount<SNR2BER_STRUCT> {
-  void DetermineSnrOffset (void);
-
-  double GetBitErrorRate (double snr);
-
-  struct InterpolParams
-  {
-    double snrLoBound;
-    double snrHiBound;
-  };
-
-  double RoundToNearestDataMidpoint (double value);
-  InterpolParams FindDatapointBounds (double snr);
-  int RoundDoubleToInt (double val);
-  int DoubleToHashKeyInt (double val);
-  double InterpolateAndRetrieveData (double xd, double x1d, double x2d);
+  /**
+   * Store the BER datapoints of the table and precompute the
+   * logarithm of the bit success rate for each of them.
+   * \param bers the BERs of the datapoints in increasing order of SNR.
+   */
+  void SetDatapoints (const std::vector<double> &bers);
+
+  /**
+   * \param snr the SNR in dB.
+   * \return the BER linearly interpolated between the two closest datapoints.
+   */
+  double GetBitErrorRate (double snr) const;
+  /**
+   * \param snr the SNR in dB.
+   * \return log (1 - BER) linearly interpolated between the two closest datapoints.
+   */
+  double GetLogBitSuccessRate (double snr) const;
+  /**
+   * Interpolate a table at the given SNR, saturating at its first and last datapoints.
+   * \param table the table to interpolate.
+   * \param snr the SNR in dB.
+   * \return the interpolated value.
+   */
+  double Interpolate (const std::vector<double> &table, double snr) const;
 
   uint16_t numDataPoints;
   double snrMin;
   double snrMax;
   double berMin;
   double berMax;
-  std::map<int, double> bitErrorRateTable;
-  double snrOffset;
+  std::vector<double> bitErrorRateTable;        //!< BER of each datapoint.
+  std::vector<double> logBitSuccessRateTable;   //!< log1p (-BER) of each datapoint.
   uint8_t numSnrDecPlaces;
   double snrSpacing;
 
 };
 
 typedef uint8_t MCS_IDX;
-typedef std::map<MCS_IDX, Ptr<SNR2BER_STRUCT> > SNR2BER_LIST;
-typedef SNR2BER_LIST::iterator SNR2BER_LIST_I;
+typedef std::vector<Ptr<SNR2BER_STRUCT> > SNR2BER_LIST;   //!< SNR to BER tables indexed by MCS.
 
 class DmgErrorModel : public ErrorRateModel
 {
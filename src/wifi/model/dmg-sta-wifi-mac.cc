@@ -1108,7 +1108,14 @@ DmgStaWifiMac::StartAbftResponderSectorSweep (Mac48Address address)
       if (m_isResponderTXSS)
         {
           m_codebook->InitiateABFT (address);
-          SendRespodnerTransmitSectorSweepFrame (address);
+          if (m_fastSectorSweep)
+            {
+              StartFastTransmitSectorSweep (address, BeamformingResponder);
+            }
+          else
+            {
+              SendRespodnerTransmitSectorSweepFrame (address);
+            }
         }
       else
         {
@@ -1971,6 +1978,7 @@ DmgStaWifiMac::ReportChannelQualityMeasurement (TimeBlockMeasurementList list)
   reportElem->SetChannelNumber (m_reqElem->GetChannelNumber ());
   reportElem->SetMeasurementDuration (m_reqElem->GetMeasurementDuration ());
   reportElem->SetMeasurementMethod (m_reqElem->GetMeasurementMethod ());
+  reportElem->SetMeasurementStartTime (m_reqElem->GetMeasurementStartTime ());
   reportElem->SetNumberOfTimeBlocks(m_reqElem->GetNumberOfTimeBlocks ());
   /* Add obtained measurement results to the report */
   for (TimeBlockMeasurementListCI it = list.begin (); it != list.end (); it++)
@@ -2560,6 +2568,7 @@ DmgStaWifiMac::FrameTxOk (const WifiMacHeader &hdr)
         }
       m_slsCompleted (hdr.GetAddr1 (), CHANNEL_ACCESS_DTI, BeamformingResponder, m_isInitiatorTXSS, m_isResponderTXSS,
                       antennaConfig.first, antennaConfig.second);
+      NotifyBeamLinkRecovered (hdr.GetAddr1 ());
     }
 }
 
@@ -2639,8 +2648,14 @@ DmgStaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
                 packet->RemoveHeader (requestHdr);
                 Ptr<DirectionalChannelQualityRequestElement> elem =
                     DynamicCast<DirectionalChannelQualityRequestElement> (requestHdr.GetListOfMeasurementRequestElement ().at (0));
-                /* Schedule the start of the requested measurement */
-                Simulator::Schedule (MicroSeconds (elem->GetMeasurementStartTime ()),
+                /* Schedule the start of the requested measurement, given as a TSF time */
+                Time measurementStart = MicroSeconds (elem->GetMeasurementStartTime ());
+                if (measurementStart < Simulator::Now ())
+                  {
+                    NS_LOG_DEBUG ("Ignore measurement request received after its start time " << measurementStart);
+                    return;
+                  }
+                Simulator::Schedule (measurementStart - Simulator::Now (),
                                      &DmgStaWifiMac::StartChannelQualityMeasurement, this, elem);
                 return;
               }
@@ -3147,10 +3162,21 @@ DmgStaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
               /** Check the existance of other Information Element Fields **/
 
               /* Extended Scheudle Element */
-              Ptr<ExtendedScheduleElement> scheduleElement =
-                  StaticCast<ExtendedScheduleElement> (beacon.GetInformationElement (IE_EXTENDED_SCHEDULE));
+              Ptr<ExtendedScheduleElement> scheduleElement;
+              std::vector<uint8_t> scheduleBody;
+              if (beacon.GetRawInformationElement (IE_EXTENDED_SCHEDULE, scheduleBody)
+                  && scheduleBody == m_extendedScheduleBody)
+                {
+                  /* The PCP/AP announces the same schedule as in the previous BI, keep the allocation list */
+                  NS_LOG_DEBUG ("Extended Schedule element unchanged, " << m_allocationList.size () << " allocations");
+                }
+              else
+                {
+                  scheduleElement = StaticCast<ExtendedScheduleElement> (beacon.GetInformationElement (IE_EXTENDED_SCHEDULE));
+                }
               if (scheduleElement != 0)
                 {
+                  m_extendedScheduleBody.swap (scheduleBody);
                   m_allocationList = scheduleElement->GetAllocationFieldList ();
                   /* Printing allocation list at STA */
                   for (AllocationFieldListI it = m_allocationList.begin (); it != m_allocationList.end (); ++it)
@@ -590,6 +590,7 @@ private:
 
   /** BTI Beamforming **/
   bool m_receivedDmgBeacon;
+  std::vector<uint8_t> m_extendedScheduleBody;  //!< Body of the last Extended Schedule element decoded into the allocation list.
   EventId m_sswFbckTimeout;                     //!< Timeout Event for receiving SSW FBCK Frame.
   Ptr<UniformRandomVariable> a_bftSlot;         //!< Random variable for A-BFT slot.
   uint8_t m_remainingSlotsPerABFT;              //!< Remaining Slots in the current A-BFT.
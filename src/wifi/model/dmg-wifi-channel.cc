@@ -163,6 +163,8 @@ DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const Packet> packet, double t
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
+  std::vector<Simulator::ContextEvent> events;
+  events.reserve (2 * m_phyList.size ());
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
     {
       if (sender != (*i))
@@ -182,40 +184,12 @@ DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const Packet> packet, double t
                 }
             }
 
-          Vector sender_pos = senderMobility->GetPosition ();
           Ptr<Codebook> senderCodebook = sender->GetCodebook ();
           Ptr<MobilityModel> receiverMobility= (*i)->GetMobility ()->GetObject<MobilityModel> ();
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm;
-          double azimuthTx = CalculateAzimuthAngle (sender_pos, receiverMobility->GetPosition ());
-          double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), sender_pos);
+          double azimuthTx = CalculateAzimuthAngle (senderMobility->GetPosition (), receiverMobility->GetPosition ());
           double gtx = senderCodebook->GetTxGainDbi (azimuthTx);        // Sender's antenna gain in dBi.
-          double grx = (*i)->GetCodebook ()->GetRxGainDbi (azimuthRx);  // Receiver's antenna gain in dBi.
-
-          NS_LOG_DEBUG ("POWER: azimuthTx=" << azimuthTx
-                        << ", azimuthRx=" << azimuthRx
-                        << ", txPowerDbm=" << txPowerDbm
-                        << ", RxPower=" << m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility)
-                        << ", Gtx=" << gtx
-                        << ", Grx=" << grx);
-
-          if (m_experimentalMode)
-            {
-              rxPowerDbm = m_receivedSignalStrength[m_currentSignalStrengthIndex];
-            }
-          else
-            {
-              rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) + gtx + grx;
-            }
-
-          /* External Attenuator */
-          if ((m_blockage != 0) &&
-              (((m_srcWifiPhy == sender) && (m_dstWifiPhy == (*i))) ||
-               ((m_srcWifiPhy == (*i)) && (m_dstWifiPhy == sender))))
-            {
-              NS_LOG_DEBUG ("Blockage is inserted");
-              rxPowerDbm += m_blockage ();
-            }
+          double rxPowerDbm = CalculateRxPowerDbm (sender, *i, txPowerDbm);
 
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
@@ -231,17 +205,60 @@ DmgWifiChannel::Send (Ptr<DmgWifiPhy> sender, Ptr<const Packet> packet, double t
               dstNode = dstNetDevice->GetNode ()->GetId ();
             }
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &DmgWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm, duration);
+          Simulator::ContextEvent rx = {dstNode, delay, MakeEvent (&DmgWifiChannel::Receive,
+                                                                   (*i), copy, rxPowerDbm, duration)};
+          events.push_back (rx);
 
           /* PHY Activity Monitor */
           uint32_t srcNode = sender->GetDevice ()->GetNode ()->GetId ();
           RecordPhyActivity (srcNode, dstNode, duration, txPowerDbm + gtx, PLCP_80211AD_PREAMBLE_HDR_DATA, TX_ACTIVITY);
-          Simulator::Schedule (delay, &DmgWifiChannel::RecordPhyActivity, this,
-                               srcNode, dstNode, duration, rxPowerDbm, PLCP_80211AD_PREAMBLE_HDR_DATA, RX_ACTIVITY);
+          Simulator::ContextEvent activity = {Simulator::GetContext (), delay,
+                                              MakeEvent (&DmgWifiChannel::RecordPhyActivity, this, srcNode, dstNode, duration,
+                                                         rxPowerDbm, PLCP_80211AD_PREAMBLE_HDR_DATA, RX_ACTIVITY)};
+          events.push_back (activity);
         }
     }
+  /* Deliver the signal to all the receivers at once */
+  Simulator::ScheduleWithContextBatch (events);
+}
+
+double
+DmgWifiChannel::CalculateRxPowerDbm (Ptr<DmgWifiPhy> sender, Ptr<DmgWifiPhy> receiver, double txPowerDbm) const
+{
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  Vector sender_pos = senderMobility->GetPosition ();
+  double rxPowerDbm;
+  double azimuthTx = CalculateAzimuthAngle (sender_pos, receiverMobility->GetPosition ());
+  double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), sender_pos);
+  double gtx = sender->GetCodebook ()->GetTxGainDbi (azimuthTx);     // Sender's antenna gain in dBi.
+  double grx = receiver->GetCodebook ()->GetRxGainDbi (azimuthRx);   // Receiver's antenna gain in dBi.
+
+  NS_LOG_DEBUG ("POWER: azimuthTx=" << azimuthTx
+                << ", azimuthRx=" << azimuthRx
+                << ", txPowerDbm=" << txPowerDbm
+                << ", RxPower=" << m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility)
+                << ", Gtx=" << gtx
+                << ", Grx=" << grx);
+
+  if (m_experimentalMode)
+    {
+      rxPowerDbm = m_receivedSignalStrength[m_currentSignalStrengthIndex];
+    }
+  else
+    {
+      rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) + gtx + grx;
+    }
+
+  /* External Attenuator */
+  if ((m_blockage != 0) &&
+      (((m_srcWifiPhy == sender) && (m_dstWifiPhy == receiver)) ||
+       ((m_srcWifiPhy == receiver) && (m_dstWifiPhy == sender))))
+    {
+      NS_LOG_DEBUG ("Blockage is inserted");
+      rxPowerDbm += m_blockage ();
+    }
+  return rxPowerDbm;
 }
 
 void
@@ -253,6 +270,7 @@ DmgWifiChannel::SendAgcSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wifi
   Ptr<MobilityModel> receiverMobility;
   uint32_t j = 0; /* Phy ID */
   Time delay; /* Propagation delay of the signal */
+  std::vector<Simulator::ContextEvent> events;
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
     {
       if (sender != (*i))
@@ -283,10 +301,12 @@ DmgWifiChannel::SendAgcSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wifi
           /* PHY Activity Monitor */
           RecordPhyActivity (sender->GetDevice ()->GetNode ()->GetId (), dstNode,
                              AGC_SF_DURATION, txPowerDbm + gtx, PLCP_80211AD_AGC_SF, TX_ACTIVITY);
-          Simulator::ScheduleWithContext (dstNode, delay, &DmgWifiChannel::ReceiveAgcSubfield, this, j,
-                                          sender, txVector, txPowerDbm, gtx);
+          Simulator::ContextEvent rx = {dstNode, delay, MakeEvent (&DmgWifiChannel::ReceiveAgcSubfield, this, j,
+                                                                   sender, txVector, txPowerDbm, gtx)};
+          events.push_back (rx);
         }
     }
+  Simulator::ScheduleWithContextBatch (events);
 }
 
 void
@@ -298,6 +318,7 @@ DmgWifiChannel::SendTrnCeSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wi
   Ptr<MobilityModel> receiverMobility;
   uint32_t j = 0; /* Phy ID */
   Time delay; /* Propagation delay of the signal */
+  std::vector<Simulator::ContextEvent> events;
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
     {
       if (sender != (*i))
@@ -328,10 +349,12 @@ DmgWifiChannel::SendTrnCeSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wi
           /* PHY Activity Monitor */
           RecordPhyActivity (sender->GetDevice ()->GetNode ()->GetId (), dstNode,
                              TRN_CE_DURATION, txPowerDbm + gtx, PLCP_80211AD_TRN_CE_SF, TX_ACTIVITY);
-          Simulator::ScheduleWithContext (dstNode, delay, &DmgWifiChannel::ReceiveTrnCeSubfield, this, j,
-                                          sender, txVector, txPowerDbm, gtx);
+          Simulator::ContextEvent rx = {dstNode, delay, MakeEvent (&DmgWifiChannel::ReceiveTrnCeSubfield, this, j,
+                                                                   sender, txVector, txPowerDbm, gtx)};
+          events.push_back (rx);
         }
     }
+  Simulator::ScheduleWithContextBatch (events);
 }
 
 void
@@ -343,6 +366,7 @@ DmgWifiChannel::SendTrnSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wifi
   Ptr<MobilityModel> receiverMobility;
   uint32_t j = 0; /* Phy ID */
   Time delay; /* Propagation delay of the signal */
+  std::vector<Simulator::ContextEvent> events;
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
     {
       if (sender != (*i))
@@ -373,10 +397,12 @@ DmgWifiChannel::SendTrnSubfield (Ptr<DmgWifiPhy> sender, double txPowerDbm, Wifi
           /* PHY Activity Monitor */
           RecordPhyActivity (sender->GetDevice ()->GetNode ()->GetId (), dstNode,
                              TRN_SUBFIELD_DURATION, txPowerDbm + gtx, PLCP_80211AD_TRN_SF, TX_ACTIVITY);
-          Simulator::ScheduleWithContext (dstNode, delay, &DmgWifiChannel::ReceiveTrnSubfield, this, j,
-                                          sender, txVector, txPowerDbm, gtx);
+          Simulator::ContextEvent rx = {dstNode, delay, MakeEvent (&DmgWifiChannel::ReceiveTrnSubfield, this, j,
+                                                                   sender, txVector, txPowerDbm, gtx)};
+          events.push_back (rx);
         }
     }
+  Simulator::ScheduleWithContextBatch (events);
 }
 
 void
@@ -87,6 +87,15 @@ public:
    * on the channel (except for the sender).
    */
   void Send (Ptr<DmgWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
+  /**
+   * Calculate the power received by a PHY attached to this channel for a transmission with the current
+   * antenna configurations of the sender and the receiver.
+   * \param sender the PHY transmitting.
+   * \param receiver the PHY receiving.
+   * \param txPowerDbm the tx power before antenna gains (dBm).
+   * \return the received power before the receiver gain (dBm).
+   */
+  double CalculateRxPowerDbm (Ptr<DmgWifiPhy> sender, Ptr<DmgWifiPhy> receiver, double txPowerDbm) const;
   /**
    * Send AGC Subfield
    * \param sender
@@ -9,8 +9,10 @@
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
 
 #include "dmg-wifi-mac.h"
+#include "dmg-wifi-channel.h"
 #include "dmg-wifi-phy.h"
 
 #include "mac-low.h"
@@ -20,9 +22,14 @@
 #include "mpdu-aggregator.h"
 #include "mac-tx-middle.h"
 #include "wifi-mac-queue.h"
+#include "wifi-mac-trailer.h"
+#include "wifi-net-device.h"
 #include "wifi-utils.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
 
 namespace ns3 {
 
@@ -30,6 +37,139 @@ NS_LOG_COMPONENT_DEFINE ("DmgWifiMac");
 
 NS_OBJECT_ENSURE_REGISTERED (DmgWifiMac);
 
+/**
+ * Encode an SNR in the SNR Report subfield of the SSW Feedback field, as a two's complement
+ * value of 4 x (SNR - 19) in dB, which covers -13 dB to 50.75 dB in 0.25 dB steps
+ * (IEEE 802.11-2016 9.5.3).
+ * \param snr The SNR (linear).
+ * \return The SNR Report subfield.
+ */
+static uint8_t
+EncodeSnrReport (double snr)
+{
+  double value = std::floor (4 * (RatioToDb (snr) - 19) + 0.5);
+  return static_cast<uint8_t> (static_cast<int8_t> (std::max (-128.0, std::min (127.0, value))));
+}
+
+/**
+ * \param report The SNR Report subfield of the SSW Feedback field.
+ * \return The SNR it encodes (linear).
+ */
+static double
+DecodeSnrReport (uint8_t report)
+{
+  return DbToRatio (static_cast<int8_t> (report) / 4.0 + 19);
+}
+
+AntennaConfigurationSnrTable::AntennaConfigurationSnrTable ()
+  : m_numMeasurements (0),
+    m_bestConfig (NO_ANTENNA_CONFIG, NO_ANTENNA_CONFIG),
+    m_bestSnr (0)
+{
+}
+
+void
+AntennaConfigurationSnrTable::SetSnr (ANTENNA_CONFIGURATION config, double snr)
+{
+  SectorID sectorID = config.first;
+  AntennaID antennaID = config.second;
+  if (antennaID >= m_snr.size ())
+    {
+      m_snr.resize (antennaID + 1);
+    }
+  std::vector<double> &sectors = m_snr[antennaID];
+  if (sectorID >= sectors.size ())
+    {
+      sectors.resize (sectorID + 1, std::numeric_limits<double>::quiet_NaN ());
+    }
+  if (std::isnan (sectors[sectorID]))
+    {
+      m_numMeasurements++;
+    }
+  sectors[sectorID] = snr;
+
+  if (m_numMeasurements == 1)
+    {
+      m_bestConfig = config;
+      m_bestSnr = snr;
+    }
+  else if (config == m_bestConfig)
+    {
+      if (snr >= m_bestSnr)
+        {
+          m_bestSnr = snr;
+        }
+      else
+        {
+          /* The best configuration got worse, another one may be better now */
+          FindBestConfiguration ();
+        }
+    }
+  else if (snr > m_bestSnr || (snr == m_bestSnr && config < m_bestConfig))
+    {
+      m_bestConfig = config;
+      m_bestSnr = snr;
+    }
+}
+
+bool
+AntennaConfigurationSnrTable::IsEmpty (void) const
+{
+  return (m_numMeasurements == 0);
+}
+
+ANTENNA_CONFIGURATION
+AntennaConfigurationSnrTable::GetBestConfiguration (void) const
+{
+  return m_bestConfig;
+}
+
+double
+AntennaConfigurationSnrTable::GetBestSnr (void) const
+{
+  return m_bestSnr;
+}
+
+std::vector<std::pair<ANTENNA_CONFIGURATION, double> >
+AntennaConfigurationSnrTable::GetMeasurements (void) const
+{
+  std::vector<std::pair<ANTENNA_CONFIGURATION, double> > measurements;
+  measurements.reserve (m_numMeasurements);
+  for (uint32_t antennaID = 0; antennaID < m_snr.size (); antennaID++)
+    {
+      for (uint32_t sectorID = 0; sectorID < m_snr[antennaID].size (); sectorID++)
+        {
+          if (!std::isnan (m_snr[antennaID][sectorID]))
+            {
+              measurements.push_back (std::make_pair (std::make_pair (sectorID, antennaID), m_snr[antennaID][sectorID]));
+            }
+        }
+    }
+  std::sort (measurements.begin (), measurements.end ());
+  return measurements;
+}
+
+void
+AntennaConfigurationSnrTable::FindBestConfiguration (void)
+{
+  bool found = false;
+  for (uint32_t antennaID = 0; antennaID < m_snr.size (); antennaID++)
+    {
+      for (uint32_t sectorID = 0; sectorID < m_snr[antennaID].size (); sectorID++)
+        {
+          double snr = m_snr[antennaID][sectorID];
+          ANTENNA_CONFIGURATION config = std::make_pair (sectorID, antennaID);
+          if (!std::isnan (snr)
+              && (!found || snr > m_bestSnr || (snr == m_bestSnr && config < m_bestConfig)))
+            {
+              m_bestConfig = config;
+              m_bestSnr = snr;
+              found = true;
+            }
+        }
+    }
+}
+
 TypeId
 DmgWifiMac::GetTypeId (void)
 {
@@ -99,6 +239,32 @@ DmgWifiMac::GetTypeId (void)
                    MakeBooleanAccessor (&DmgWifiMac::m_accessCbapIfAllocated),
                    MakeBooleanChecker ())
 
+    /* Beamforming */
+    .AddAttribute ("FastSectorSweep", "Whether to resolve Transmit Sector Sweeps analytically instead of simulating"
+                   " each SSW frame. The power of every SSW frame is computed when the sweep starts and the frames"
+                   " received despite the interference during the sweep are delivered when it ends."
+                   " Only supported between DMG STAs attached to the same DmgWifiChannel.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DmgWifiMac::m_fastSectorSweep),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BeamTracking", "Whether to restrict the Transmit Sector Sweeps with a peer station around"
+                   " the sector predicted from the sector drift observed between the previous sweeps. A full"
+                   " sweep is performed when no history is available or when the SNR degrades.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DmgWifiMac::m_beamTracking),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BeamTrackingSectors", "The number of sectors swept on each side of the predicted sector"
+                   " during a beam tracking Transmit Sector Sweep.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&DmgWifiMac::m_beamTrackingNeighbours),
+                   MakeUintegerChecker<uint8_t> (1, 63))
+    .AddAttribute ("BeamTrackingSnrLoss", "The loss in dB of the best SNR measured after a beam tracking SLS,"
+                   " compared to the one measured after the last full SLS, which triggers a full SLS. It also"
+                   " applies to the sibling sweeps at the last level of a hierarchical codebook.",
+                   DoubleValue (3.0),
+                   MakeDoubleAccessor (&DmgWifiMac::m_beamTrackingSnrLoss),
+                   MakeDoubleChecker<double> (0))
+
     /* Beacon Interval Traces */
     .AddTraceSource ("DTIStarted", "The Data Transmission Interval access period started.",
                      MakeTraceSourceAccessor (&DmgWifiMac::m_dtiStarted),
@@ -122,6 +288,15 @@ DmgWifiMac::GetTypeId (void)
     .AddTraceSource ("BRPCompleted", "BRP for transmit/recieve beam refinement is completed",
                      MakeTraceSourceAccessor (&DmgWifiMac::m_brpCompleted),
                      "ns3::DmgWifiMac::BRPCompletedTracedCallback")
+    .AddTraceSource ("BeamTrainingCompleted",
+                     "An SLS initiated by this DMG STA is completed, with or without beam tracking.",
+                     MakeTraceSourceAccessor (&DmgWifiMac::m_beamTrainingCompleted),
+                     "ns3::DmgWifiMac::BeamTrainingCompletedCallback")
+    .AddTraceSource ("BeamLinkRecovered",
+                     "An SLS recovered the beamformed link with a peer station, which was lost after an SNR loss"
+                     " of a beam tracking SLS or after the expiration of the beamlink maintenance time.",
+                     MakeTraceSourceAccessor (&DmgWifiMac::m_beamLinkRecovered),
+                     "ns3::DmgWifiMac::BeamLinkRecoveredCallback")
     .AddTraceSource ("RlsCompleted",
                      "The Relay Link Setup (RLS) procedure is completed",
                      MakeTraceSourceAccessor (&DmgWifiMac::m_rlsCompleted),
@@ -166,6 +341,8 @@ void
 DmgWifiMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_fastSweepEvent.Cancel ();
+  m_fastSweep.peer = 0;
   m_dmgAtiDca = 0;
   m_codebook->Dispose ();
   m_codebook = 0;
@@ -417,6 +594,7 @@ void
 DmgWifiMac::BeamLinkMaintenanceTimeout (void)
 {
   NS_LOG_FUNCTION (this);
+  NotifyBeamLinkLost (m_peerStationAddress);
   m_beamLinkMaintenanceTimerExpired (m_peerStationAid, m_peerStationAddress, GetRemainingAllocationTime ());
 }
 
@@ -722,9 +900,20 @@ DmgWifiMac::StartBeamformingInitiatorPhase (void)
       /** We are the Initiator of the Beamforming Phase **/
       /* Reset variables */
       m_bfRetryTimes = 0;
+      m_beamTrainingStarted = Simulator::Now ();
+      m_partialSweeps.erase (PartialSweepKey (m_peerStationAddress, BeamformingInitiator));
+      if (m_codebook->IsHierarchical () && m_isInitiatorTXSS)
+        {
+          SelectHierarchicalSectors (m_peerStationAddress, BeamformingInitiator);
+        }
+      else if (m_beamTracking && m_isInitiatorTXSS)
+        {
+          BeamTrackingMap::const_iterator info = m_beamTrackingMap.find (m_peerStationAddress);
+          SelectTransmitSectors (m_peerStationAddress, BeamformingInitiator,
+                                 (info != m_beamTrackingMap.end ()) && !info->second.fullSweepRequired);
+        }
       /* Schedule Beamforming Responder Phase */
-      Time rssTime = CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
-                                                   m_codebook->GetTotalNumberOfTransmitSectors ()) + GetMbifs ();
+      Time rssTime = CalculateTransmitSectorSweepDuration (m_peerStationAddress, BeamformingInitiator) + GetMbifs ();
       m_rssEvent = Simulator::Schedule (rssTime, &DmgWifiMac::StartBeamformingResponderPhase, this, m_peerStationAddress);
       if (m_isInitiatorTXSS)
         {
@@ -804,6 +993,16 @@ DmgWifiMac::StartBeamformingResponderPhase (Mac48Address address)
       /* Now start doing the specified sweeping in the Responder Phase */
       if (m_isResponderTXSS)
         {
+          m_partialSweeps.erase (PartialSweepKey (address, BeamformingResponder));
+          if (m_codebook->IsHierarchical ())
+            {
+              SelectHierarchicalSectors (address, BeamformingResponder);
+            }
+          else if (m_beamTracking)
+            {
+              /* Track the beam only if the initiator did, since a full initiator TxSS indicates a lost link */
+              SelectTransmitSectors (address, BeamformingResponder, m_peerBeamTracking[address]);
+            }
           StartTransmitSectorSweep (address, BeamformingResponder);
         }
       else
@@ -846,12 +1045,26 @@ DmgWifiMac::StartTransmitSectorSweep (Mac48Address address, BeamformingDirection
 {
   NS_LOG_FUNCTION (this << address << direction);
   NS_LOG_INFO ("DMG STA Starting TxSS at " << Simulator::Now ());
+  /* Restrict the sweep of the codebook as selected for this peer station and role */
+  PartialSweepMap::const_iterator partial = m_partialSweeps.find (PartialSweepKey (address, direction));
+  if (partial != m_partialSweeps.end ())
+    {
+      m_codebook->SetSweepSectorList (address, partial->second.sectorList);
+    }
+  else
+    {
+      m_codebook->RemoveSweepSectorList (address);
+    }
   /* Inform the codebook to Initiate SLS phase */
   m_codebook->StartSectorSweeping (address, TransmitSectorSweep, m_peerAntennas);
   /* Calculate the correct duration for the sector sweep frame */
-  m_sectorSweepDuration = CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
-                                                        m_codebook->GetTotalNumberOfTransmitSectors ());
-  if (direction == BeamformingInitiator)
+  m_sectorSweepDuration = CalculateTransmitSectorSweepDuration (address, direction);
+  if (m_fastSectorSweep)
+    {
+      /* Let the peer station configure its receive antenna for the sweep starting now */
+      Simulator::ScheduleNow (&DmgWifiMac::StartFastTransmitSectorSweep, this, address, direction);
+    }
+  else if (direction == BeamformingInitiator)
     {
       SendInitiatorTransmitSectorSweepFrame (address);
     }
@@ -861,10 +1074,249 @@ DmgWifiMac::StartTransmitSectorSweep (Mac48Address address, BeamformingDirection
     }
 }
 
+Time
+DmgWifiMac::CalculateTransmitSectorSweepDuration (Mac48Address address, BeamformingDirection direction)
+{
+  PartialSweepMap::const_iterator partial = m_partialSweeps.find (PartialSweepKey (address, direction));
+  if (partial != m_partialSweeps.end ())
+    {
+      return CalculateSectorSweepDuration (m_peerAntennas, partial->second.antennas, partial->second.sectors);
+    }
+  else
+    {
+      return CalculateSectorSweepDuration (m_peerAntennas, m_codebook->GetTotalNumberOfAntennas (),
+                                           m_codebook->GetTotalNumberOfTransmitSectors ());
+    }
+}
+
+uint8_t
+DmgWifiMac::GetTransmitSectorSweepSectors (Mac48Address address, BeamformingDirection direction) const
+{
+  PartialSweepMap::const_iterator partial = m_partialSweeps.find (PartialSweepKey (address, direction));
+  if (partial != m_partialSweeps.end ())
+    {
+      return partial->second.sectors;
+    }
+  else
+    {
+      return m_codebook->GetTotalNumberOfTransmitSectors ();
+    }
+}
+
+bool
+DmgWifiMac::IsPartialSweep (Mac48Address address, BeamformingDirection direction) const
+{
+  return m_partialSweeps.find (PartialSweepKey (address, direction)) != m_partialSweeps.end ();
+}
+
 void
-DmgWifiMac::SendInitiatorTransmitSectorSweepFrame (Mac48Address address)
+DmgWifiMac::SelectTransmitSectors (Mac48Address address, BeamformingDirection direction, bool tracking)
+{
+  NS_LOG_FUNCTION (this << address << direction << tracking);
+  m_partialSweeps.erase (PartialSweepKey (address, direction));
+
+  /* The prediction starts from the best transmit sector found by the last SLS */
+  STATION_ANTENNA_CONFIG_MAP_CI bestConfig = m_bestAntennaConfig.find (address);
+  if (bestConfig == m_bestAntennaConfig.end ())
+    {
+      return;
+    }
+  ANTENNA_CONFIGURATION_TX current = bestConfig->second.first;
+  Antenna2SectorList sectorList = m_codebook->GetTransmitSectorList (address);
+  Antenna2SectorListCI antenna = sectorList.find (current.second);
+  if (antenna == sectorList.end ())
+    {
+      return;
+    }
+  const SectorIDList &sectors = antenna->second;
+  int32_t size = sectors.size ();
+  int32_t position = std::find (sectors.begin (), sectors.end (), current.first) - sectors.begin ();
+  if (position == size)
+    {
+      return;
+    }
+
+  /* Update the sector drift observed since the last TxSS with this station */
+  BeamTrackingMap::iterator info = m_beamTrackingMap.find (address);
+  if (info == m_beamTrackingMap.end ())
+    {
+      BeamTrackingInfo newInfo;
+      newInfo.drift = 0;
+      newInfo.referenceSnr = 0;
+      newInfo.fullSweepRequired = true;
+      info = m_beamTrackingMap.insert (std::make_pair (address, newInfo)).first;
+    }
+  else
+    {
+      int32_t last = std::find (sectors.begin (), sectors.end (), info->second.lastConfig.first) - sectors.begin ();
+      if ((info->second.lastConfig.second == current.second) && (last != size))
+        {
+          /* The sectors of the antenna cover it circularly, so take the shortest way between the two sectors */
+          int32_t drift = position - last;
+          if (drift > size / 2)
+            {
+              drift -= size;
+            }
+          else if (drift < -size / 2)
+            {
+              drift += size;
+            }
+          info->second.drift = drift;
+        }
+      else
+        {
+          info->second.drift = 0;
+        }
+    }
+  info->second.lastConfig = current;
+
+  if (!tracking)
+    {
+      return;
+    }
+
+  /* Sweep the current sector and the neighbourhood of the predicted sector */
+  std::vector<bool> selected (size, false);
+  selected[position] = true;
+  int32_t predicted = position + info->second.drift;
+  for (int32_t i = -m_beamTrackingNeighbours; i <= m_beamTrackingNeighbours; i++)
+    {
+      selected[((predicted + i) % size + size) % size] = true;
+    }
+  SectorIDList trackingSectors;
+  for (int32_t i = 0; i < size; i++)
+    {
+      if (selected[i])
+        {
+          trackingSectors.push_back (sectors[i]);
+        }
+    }
+  if (trackingSectors.size () >= m_codebook->GetTotalNumberOfTransmitSectors ())
+    {
+      return;
+    }
+
+  PartialSweep &partial = m_partialSweeps[PartialSweepKey (address, direction)];
+  partial.sectorList[current.second] = trackingSectors;
+  partial.sectors = trackingSectors.size ();
+  partial.antennas = 1;
+  partial.tracking = true;
+  NS_LOG_INFO ("Beam tracking TxSS with " << address << " over " << static_cast<uint16_t> (partial.sectors)
+               << " sectors, drift=" << info->second.drift);
+}
+
+void
+DmgWifiMac::UpdateBeamTracking (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  /* The SNR of our best transmit sector is the one reported by the responder, since the SNRs we
+   * measured ourselves are those of the transmit sectors swept by the responder */
+  std::map<Mac48Address, double>::const_iterator report = m_snrReports.find (address);
+  if (report == m_snrReports.end ())
+    {
+      return;
+    }
+  BeamTrackingMap::iterator info = m_beamTrackingMap.find (address);
+  if (info == m_beamTrackingMap.end ())
+    {
+      /* The hierarchical TxSS does not go through SelectTransmitSectors */
+      BeamTrackingInfo newInfo;
+      newInfo.lastConfig = m_bestAntennaConfig[address].first;
+      newInfo.drift = 0;
+      newInfo.referenceSnr = 0;
+      newInfo.fullSweepRequired = true;
+      info = m_beamTrackingMap.insert (std::make_pair (address, newInfo)).first;
+    }
+  double snr = report->second;
+  PartialSweepMap::const_iterator sweep = m_partialSweeps.find (PartialSweepKey (address, BeamformingInitiator));
+  if ((sweep == m_partialSweeps.end ()) || !sweep->second.tracking)
+    {
+      info->second.referenceSnr = snr;
+      info->second.fullSweepRequired = false;
+    }
+  else if (RatioToDb (snr) < RatioToDb (info->second.referenceSnr) - m_beamTrackingSnrLoss)
+    {
+      NS_LOG_INFO ("Beam tracking with " << address << " lost " << RatioToDb (info->second.referenceSnr) - RatioToDb (snr)
+                   << " dB, a full TxSS is required");
+      info->second.fullSweepRequired = true;
+      NotifyBeamLinkLost (address);
+      if (m_currentAllocation == CBAP_ALLOCATION)
+        {
+          Simulator::Schedule (GetSifs (), &DmgWifiMac::InitiateTxssCbap, this, address);
+        }
+    }
+}
+
+void
+DmgWifiMac::NotifyBeamLinkLost (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_beamLinkLost.insert (std::make_pair (address, Simulator::Now ()));
+}
+
+void
+DmgWifiMac::NotifyBeamLinkRecovered (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  std::map<Mac48Address, Time>::iterator lost = m_beamLinkLost.find (address);
+  if (lost != m_beamLinkLost.end ())
+    {
+      NS_LOG_INFO ("Beamformed link with " << address << " recovered after " << Simulator::Now () - lost->second);
+      m_beamLinkRecovered (address, Simulator::Now () - lost->second);
+      m_beamLinkLost.erase (lost);
+    }
+}
+
+void
+DmgWifiMac::SelectHierarchicalSectors (Mac48Address address, BeamformingDirection direction)
+{
+  NS_LOG_FUNCTION (this << address << direction);
+  m_partialSweeps.erase (PartialSweepKey (address, direction));
+
+  /* Refine within the children of the best transmit sector found by the last SLS */
+  Antenna2SectorList sweepList;
+  bool tracking = false;
+  STATION_ANTENNA_CONFIG_MAP_CI bestConfig = m_bestAntennaConfig.find (address);
+  if (bestConfig != m_bestAntennaConfig.end ())
+    {
+      ANTENNA_CONFIGURATION_TX current = bestConfig->second.first;
+      sweepList = m_codebook->GetChildSectorList (address, current.second, current.first);
+      /* Once the last level is reached, track the best sector among its siblings while the SNR holds */
+      BeamTrackingMap::const_iterator info = m_beamTrackingMap.find (address);
+      if (sweepList.empty () && (info != m_beamTrackingMap.end ()) && !info->second.fullSweepRequired)
+        {
+          sweepList = m_codebook->GetSiblingSectorList (address, current.second, current.first);
+          tracking = !sweepList.empty ();
+        }
+    }
+  /* The search starts again from the root level without a best sector or once the link is lost */
+  if (sweepList.empty ())
+    {
+      sweepList = m_codebook->GetRootSectorList (address);
+    }
+
+  uint16_t sectors = 0;
+  for (Antenna2SectorListCI iter = sweepList.begin (); iter != sweepList.end (); iter++)
+    {
+      sectors += iter->second.size ();
+    }
+  if ((sectors == 0) || (sectors >= m_codebook->GetTotalNumberOfTransmitSectors ()))
+    {
+      return;
+    }
+
+  PartialSweep &partial = m_partialSweeps[PartialSweepKey (address, direction)];
+  partial.sectorList = sweepList;
+  partial.sectors = sectors;
+  partial.antennas = sweepList.size ();
+  partial.tracking = tracking;
+  NS_LOG_INFO ("Hierarchical TxSS with " << address << " over " << static_cast<uint16_t> (partial.sectors)
+               << " sectors of " << static_cast<uint16_t> (partial.antennas) << " antennas");
+}
+
+Ptr<Packet>
+DmgWifiMac::CreateTransmitSectorSweepFrame (Mac48Address address, BeamformingDirection direction, WifiMacHeader &hdr)
 {
-  WifiMacHeader hdr;
   hdr.SetType (WIFI_MAC_CTL_DMG_SSW);
 
   /* Other Fields */
@@ -877,15 +1329,29 @@ DmgWifiMac::SendInitiatorTransmitSectorSweepFrame (Mac48Address address)
   CtrlDMG_SSW sswFrame;
 
   DMG_SSW_Field ssw;
-  ssw.SetDirection (BeamformingInitiator);
+  ssw.SetDirection (direction);
   ssw.SetCountDown (m_codebook->GetRemaingSectorCount ());
   ssw.SetSectorID (m_codebook->GetActiveTxSectorID ());
   ssw.SetDMGAntennaID (m_codebook->GetActiveAntennaID ());
 
   DMG_SSW_FBCK_Field sswFeedback;
-  sswFeedback.IsPartOfISS (true);
-  sswFeedback.SetSector (m_codebook->GetTotalNumberOfTransmitSectors ());
-  sswFeedback.SetDMGAntenna (m_codebook->GetTotalNumberOfAntennas ());
+  if (direction == BeamformingInitiator)
+    {
+      sswFeedback.IsPartOfISS (true);
+      sswFeedback.SetSector (GetTransmitSectorSweepSectors (address, BeamformingInitiator));
+      sswFeedback.SetDMGAntenna (m_codebook->GetTotalNumberOfAntennas ());
+    }
+  else
+    {
+      sswFeedback.IsPartOfISS (false);
+      sswFeedback.SetSector (m_feedbackAntennaConfig.first);
+      sswFeedback.SetDMGAntenna (m_feedbackAntennaConfig.second);
+      STATION_SNR_PAIR_MAP_CI snrTable = m_stationSnrMap.find (address);
+      if ((snrTable != m_stationSnrMap.end ()) && !snrTable->second.first.IsEmpty ())
+        {
+          sswFeedback.SetSNRReport (EncodeSnrReport (snrTable->second.first.GetBestSnr ()));
+        }
+    }
   sswFeedback.SetPollRequired (false);
 
   /* Set the fields in SSW Frame */
@@ -896,6 +1362,14 @@ DmgWifiMac::SendInitiatorTransmitSectorSweepFrame (Mac48Address address)
   NS_LOG_INFO ("Sending SSW Frame " << Simulator::Now () << " with "
                << static_cast<uint16_t> (ssw.GetSectorID ()) << " " << static_cast<uint16_t> (ssw.GetDMGAntennaID ()));
 
+  return packet;
+}
+
+void
+DmgWifiMac::SendInitiatorTransmitSectorSweepFrame (Mac48Address address)
+{
+  WifiMacHeader hdr;
+  Ptr<Packet> packet = CreateTransmitSectorSweepFrame (address, BeamformingInitiator, hdr);
   /* Transmit control frames directly without DCA + DCF Manager */
   TransmitControlFrame (packet, hdr, GetRemainingSectorSweepTime ());
 }
@@ -904,39 +1378,182 @@ void
 DmgWifiMac::SendRespodnerTransmitSectorSweepFrame (Mac48Address address)
 {
   WifiMacHeader hdr;
-  hdr.SetType (WIFI_MAC_CTL_DMG_SSW);
+  Ptr<Packet> packet = CreateTransmitSectorSweepFrame (address, BeamformingResponder, hdr);
+  /* Transmit control frames directly without DCA + DCF Manager */
+  TransmitControlFrame (packet, hdr, GetRemainingSectorSweepTime ());
+}
 
-  /* Other Fields */
-  hdr.SetAddr1 (address);           // MAC address of the STA that is the intended receiver of the sector sweep.
-  hdr.SetAddr2 (GetAddress ());     // MAC address of the transmitter STA of the sector sweep frame.
-  hdr.SetNoMoreFragments ();
-  hdr.SetNoRetry ();
+void
+DmgWifiMac::StartFastTransmitSectorSweep (Mac48Address address, BeamformingDirection direction)
+{
+  NS_LOG_FUNCTION (this << address << direction);
+  Ptr<DmgWifiPhy> phy = StaticCast<DmgWifiPhy> (m_phy);
+  Ptr<DmgWifiChannel> channel = DynamicCast<DmgWifiChannel> (m_phy->GetChannel ());
 
-  Ptr<Packet> packet = Create<Packet> ();
-  CtrlDMG_SSW sswFrame;
+  /* Find the peer station and the other PHYs receiving the energy of the sweep */
+  Ptr<DmgWifiMac> peer;
+  std::vector<Ptr<DmgWifiPhy> > others;
+  for (uint32_t i = 0; (channel != 0) && (i < channel->GetNDevices ()); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (channel->GetDevice (i));
+      if ((device == 0) || (device->GetPhy () == m_phy) || (device->GetPhy ()->GetChannelNumber () != m_phy->GetChannelNumber ()))
+        {
+          continue;
+        }
+      Ptr<DmgWifiMac> mac = DynamicCast<DmgWifiMac> (device->GetMac ());
+      if ((mac != 0) && (mac->GetAddress () == address))
+        {
+          peer = mac;
+        }
+      else
+        {
+          others.push_back (StaticCast<DmgWifiPhy> (device->GetPhy ()));
+        }
+    }
 
-  DMG_SSW_Field ssw;
-  ssw.SetDirection (BeamformingResponder);
-  ssw.SetCountDown (m_codebook->GetRemaingSectorCount ());
-  ssw.SetSectorID (m_codebook->GetActiveTxSectorID ());
-  ssw.SetDMGAntennaID (m_codebook->GetActiveAntennaID ());
+  WifiMacHeader hdr;
+  Ptr<Packet> packet = CreateTransmitSectorSweepFrame (address, direction, hdr);
+  WifiTxVector txVector = m_stationManager->GetDmgTxVector (address, &hdr, packet);
+  uint32_t frameSize = hdr.GetSize () + packet->GetSize () + WIFI_MAC_FCS_LENGTH;
+  Time frameDuration = m_phy->CalculateTxDuration (frameSize, txVector, m_phy->GetFrequency ());
+  if ((peer == 0) || m_phy->IsStateSleep () || m_phy->IsStateOff ()
+      || m_phy->IsStateTx () || m_phy->IsStateSwitching ())
+    {
+      NS_LOG_DEBUG ("Cannot resolve the sector sweep with " << address << " analytically");
+      if (direction == BeamformingInitiator)
+        {
+          SendInitiatorTransmitSectorSweepFrame (address);
+        }
+      else
+        {
+          SendRespodnerTransmitSectorSweepFrame (address);
+        }
+      return;
+    }
 
-  DMG_SSW_FBCK_Field sswFeedback;
-  sswFeedback.IsPartOfISS (false);
-  sswFeedback.SetSector (m_feedbackAntennaConfig.first);
-  sswFeedback.SetDMGAntenna (m_feedbackAntennaConfig.second);
-  sswFeedback.SetPollRequired (false);
+  /* Walk through the sectors of the sweep, build each SSW frame and compute the power it is received with */
+  m_fastSweep.peer = peer;
+  m_fastSweep.txVector = txVector;
+  m_fastSweep.frames.clear ();
+  m_fastSweep.sectors.clear ();
+  Ptr<DmgWifiPhy> peerPhy = StaticCast<DmgWifiPhy> (peer->GetWifiPhy ());
+  std::vector<double> peerPowerW;
+  std::vector<double> othersEnergy (others.size (), 0);
+  std::vector<std::pair<Time, Time> > frames;
+  Time start = Simulator::Now ();
+  while (true)
+    {
+      if (!frames.empty ())
+        {
+          hdr = WifiMacHeader ();
+          packet = CreateTransmitSectorSweepFrame (address, direction, hdr);
+        }
+      hdr.SetDuration (std::max (m_sectorSweepDuration - sswTxTime - (start - m_sectorSweepStarted), Seconds (0)));
+      packet->AddHeader (hdr);
+      WifiMacTrailer fcs;
+      packet->AddTrailer (fcs);
+      m_fastSweep.frames.push_back (packet);
+      m_fastSweep.sectors.push_back (std::make_pair (m_codebook->GetActiveTxSectorID (), m_codebook->GetActiveAntennaID ()));
+      peerPowerW.push_back (phy->CalculateRxPowerW (peerPhy, txVector));
+      for (uint32_t i = 0; i < others.size (); i++)
+        {
+          othersEnergy[i] += phy->CalculateRxPowerW (others[i], txVector) * frameDuration.GetSeconds ();
+        }
+      frames.push_back (std::make_pair (start, start + frameDuration));
+      if (m_codebook->GetRemaingSectorCount () == 0)
+        {
+          break;
+        }
+      bool changeAntenna = false;
+      if (m_accessPeriod == CHANNEL_ACCESS_ABFT)
+        {
+          m_codebook->GetNextSectorInABFT ();
+        }
+      else
+        {
+          m_codebook->GetNextSector (changeAntenna);
+        }
+      start += frameDuration + (changeAntenna ? GetLbifs () : GetSbifs ());
+    }
+  /* The codebook stays on the last sector of the sweep, as at the end of a simulated sweep */
+  Time duration = frames.back ().second - Simulator::Now ();
+  phy->StartSectorSweepTx (m_fastSweep.frames.front (), txVector, duration);
 
-  /* Set the fields in SSW Frame */
-  sswFrame.SetSswField (ssw);
-  sswFrame.SetSswFeedbackField (sswFeedback);
-  packet->AddHeader (sswFrame);
+  /* Each receiver gets the sweep once, in its own context, rather than each of its SSW frames: the peer observes
+   * the interference during every SSW frame and the other PHYs get the mean power of the sweep */
+  Simulator::ScheduleWithContext (peerPhy->GetDevice ()->GetNode ()->GetId (), Seconds (0),
+                                  &DmgWifiPhy::StartReceiveSectorSweep, peerPhy, GetAddress (), frames, peerPowerW);
+  for (uint32_t i = 0; i < others.size (); i++)
+    {
+      Simulator::ScheduleWithContext (others[i]->GetDevice ()->GetNode ()->GetId (), Seconds (0),
+                                      &DmgWifiPhy::ReceiveSectorSweepEnergy, others[i],
+                                      othersEnergy[i] / duration.GetSeconds (), duration);
+    }
+  m_fastSweepEvent = Simulator::Schedule (duration, &DmgWifiMac::EndFastTransmitSectorSweep, this);
+}
 
-  NS_LOG_INFO ("Sending SSW Frame " << Simulator::Now () << " with "
-               << static_cast<uint16_t> (ssw.GetSectorID ()) << " " << static_cast<uint16_t> (ssw.GetDMGAntennaID ()));
+void
+DmgWifiMac::EndFastTransmitSectorSweep (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time remaining = std::max (m_sectorSweepDuration - (Simulator::Now () - m_sectorSweepStarted), Seconds (0));
+  Simulator::ScheduleWithContext (m_fastSweep.peer->GetWifiPhy ()->GetDevice ()->GetNode ()->GetId (), Seconds (0),
+                                  &DmgWifiMac::EndReceiveFastTransmitSectorSweep, m_fastSweep.peer,
+                                  GetAddress (), m_fastSweep.frames, m_fastSweep.sectors, m_fastSweep.txVector, remaining);
+  WifiMacHeader hdr;
+  m_fastSweep.frames.back ()->PeekHeader (hdr);
+  m_fastSweep.peer = 0;
+  m_fastSweep.frames.clear ();
+  m_fastSweep.sectors.clear ();
+  FrameTxOk (hdr);
+}
 
-  /* Transmit control frames directly without DCA + DCF Manager */
-  TransmitControlFrame (packet, hdr, GetRemainingSectorSweepTime ());
+void
+DmgWifiMac::EndReceiveFastTransmitSectorSweep (Mac48Address from, std::vector<Ptr<Packet> > frames,
+                                               std::vector<ANTENNA_CONFIGURATION> sectors, WifiTxVector txVector,
+                                               Time remaining)
+{
+  NS_LOG_FUNCTION (this << from << frames.size () << remaining);
+  Ptr<DmgWifiPhy> phy = StaticCast<DmgWifiPhy> (m_phy);
+  std::vector<double> snr = phy->EndReceiveSectorSweep (from, frames, txVector);
+  uint32_t last = snr.size ();
+  for (uint32_t i = 0; i < snr.size (); i++)
+    {
+      if (snr[i] != 0)
+        {
+          last = i;
+        }
+    }
+  if (last == snr.size ())
+    {
+      return;
+    }
+
+  /* Only the last received SSW frame goes up the stack, as if it closed the sweep: its Duration field is the
+   * remaining sweep time and its CDOWN is zero. The SNR of the other received SSW frames is stored afterwards,
+   * since the first SSW frame of a TxSS in a CBAP clears the SNRs stored for the peer. */
+  Ptr<Packet> packet = frames[last]->Copy ();
+  WifiMacHeader hdr;
+  packet->RemoveHeader (hdr);
+  WifiMacTrailer fcs;
+  packet->RemoveTrailer (fcs);
+  CtrlDMG_SSW sswFrame;
+  packet->RemoveHeader (sswFrame);
+  DMG_SSW_Field ssw = sswFrame.GetSswField ();
+  ssw.SetCountDown (0);
+  sswFrame.SetSswField (ssw);
+  packet->AddHeader (sswFrame);
+  hdr.SetDuration (remaining);
+  packet->AddHeader (hdr);
+  packet->AddTrailer (fcs);
+  m_low->ReceiveOk (packet, snr[last], txVector, false);
+  for (uint32_t i = 0; i < last; i++)
+    {
+      if (snr[i] != 0)
+        {
+          MapTxSnr (from, sectors[i].first, sectors[i].second, snr[i]);
+        }
+    }
 }
 
 void
@@ -1209,15 +1826,16 @@ DmgWifiMac::SendSswAckFrame (Mac48Address receiver, Time sswFbckDuration)
 }
 
 void
-DmgWifiMac::PrintSnrConfiguration (SNR_MAP snrMap)
+DmgWifiMac::PrintSnrConfiguration (const SNR_MAP &snrMap)
 {
-  if (snrMap.begin () == snrMap.end ())
+  if (snrMap.IsEmpty ())
     {
       std::cout << "No SNR Information Availalbe" << std::endl;
     }
   else
     {
-      for (SNR_MAP::iterator it = snrMap.begin (); it != snrMap.end (); it++)
+      std::vector<std::pair<ANTENNA_CONFIGURATION, SNR> > measurements = snrMap.GetMeasurements ();
+      for (auto it = measurements.begin (); it != measurements.end (); it++)
         {
           ANTENNA_CONFIGURATION config = it->first;
           printf ("AntennaID: %d, SectorID: %2d, SNR: %+2.2f dB\n",
@@ -1234,7 +1852,7 @@ DmgWifiMac::PrintSnrTable (void)
   std::cout << "****************************************************************" << std::endl;
   for (STATION_SNR_PAIR_MAP_CI it = m_stationSnrMap.begin (); it != m_stationSnrMap.end (); it++)
     {
-      SNR_PAIR snrPair = it->second;
+      const SNR_PAIR &snrPair = it->second;
       std::cout << "Peer DMG STA: " << it->first << std::endl;
       std::cout << "***********************************************" << std::endl;
       std::cout << "Tansmit Sector Sweep (TxSS) SNRs: " << std::endl;
@@ -1266,49 +1884,142 @@ DmgWifiMac::PrintBeamRefinementMeasurements (void)
 }
 
 void
-DmgWifiMac::MapTxSnr (Mac48Address address, SectorID sectorID, AntennaID antennaID, double snr)
+DmgWifiMac::SaveBeamformingState (std::ostream &os) const
 {
-  NS_LOG_FUNCTION (this << address << uint16_t (sectorID) << uint16_t (antennaID) << RatioToDb (snr));
-  STATION_SNR_PAIR_MAP_I it = m_stationSnrMap.find (address);
-  if (it != m_stationSnrMap.end ())
+  NS_LOG_FUNCTION (this);
+  std::streamsize precision = os.precision (std::numeric_limits<double>::max_digits10);
+  for (STATION_ANTENNA_CONFIG_MAP_CI it = m_bestAntennaConfig.begin (); it != m_bestAntennaConfig.end (); it++)
     {
-      SNR_PAIR *snrPair = (SNR_PAIR *) (&it->second);
-      SNR_MAP_TX *snrMap = (SNR_MAP_TX *) (&snrPair->first);
-      ANTENNA_CONFIGURATION config = std::make_pair (sectorID, antennaID);
-      (*snrMap)[config] = snr;
+      os << "CONFIG " << it->first
+         << " " << static_cast<uint16_t> (it->second.first.first) << " " << static_cast<uint16_t> (it->second.first.second)
+         << " " << static_cast<uint16_t> (it->second.second.first) << " " << static_cast<uint16_t> (it->second.second.second)
+         << std::endl;
     }
-  else
+  for (STATION_SNR_PAIR_MAP_CI it = m_stationSnrMap.begin (); it != m_stationSnrMap.end (); it++)
+    {
+      for (uint8_t direction = 0; direction < 2; direction++)
+        {
+          std::vector<std::pair<ANTENNA_CONFIGURATION, double> > measurements
+            = (direction == 0) ? it->second.first.GetMeasurements () : it->second.second.GetMeasurements ();
+          for (uint32_t i = 0; i < measurements.size (); i++)
+            {
+              os << ((direction == 0) ? "TXSNR " : "RXSNR ") << it->first
+                 << " " << static_cast<uint16_t> (measurements[i].first.first)
+                 << " " << static_cast<uint16_t> (measurements[i].first.second)
+                 << " " << measurements[i].second << std::endl;
+            }
+        }
+    }
+  for (uint8_t direction = 0; direction < 2; direction++)
     {
-      ANTENNA_CONFIGURATION config = std::make_pair (sectorID, antennaID);
-      SNR_MAP_TX snrTx;
-      SNR_MAP_RX snrRx;
-      snrTx[config] = snr;
-      SNR_PAIR snrPair = std::make_pair (snrTx, snrRx);
-      m_stationSnrMap[address] = snrPair;
+      BeamformingSectorList sectorLists
+        = m_codebook->GetBeamformingSectorLists ((direction == 0) ? TransmitSectorSweep : ReceiveSectorSweep);
+      for (BeamformingSectorListCI it = sectorLists.begin (); it != sectorLists.end (); it++)
+        {
+          for (Antenna2SectorListCI antennaIt = it->second.begin (); antennaIt != it->second.end (); antennaIt++)
+            {
+              os << ((direction == 0) ? "TXSECTORS " : "RXSECTORS ") << it->first
+                 << " " << static_cast<uint16_t> (antennaIt->first);
+              for (SectorIDList::const_iterator sectorIt = antennaIt->second.begin (); sectorIt != antennaIt->second.end (); sectorIt++)
+                {
+                  os << " " << static_cast<uint16_t> (*sectorIt);
+                }
+              os << std::endl;
+            }
+        }
     }
+  os << "END" << std::endl;
+  os.precision (precision);
+}
+
+bool
+DmgWifiMac::LoadBeamformingState (std::istream &is)
+{
+  NS_LOG_FUNCTION (this);
+  std::string line;
+  /* The sector lists replace the ones of the codebook only once the whole state has been read */
+  BeamformingSectorList txSectorLists, rxSectorLists;
+  while (std::getline (is, line))
+    {
+      std::istringstream record (line);
+      std::string type;
+      Mac48Address address;
+      uint16_t sector, antenna;
+      record >> type;
+      if (type == "END")
+        {
+          for (BeamformingSectorListI it = txSectorLists.begin (); it != txSectorLists.end (); it++)
+            {
+              m_codebook->SetBeamformingSectorList (TransmitSectorSweep, it->first, it->second);
+            }
+          for (BeamformingSectorListI it = rxSectorLists.begin (); it != rxSectorLists.end (); it++)
+            {
+              m_codebook->SetBeamformingSectorList (ReceiveSectorSweep, it->first, it->second);
+            }
+          return true;
+        }
+      record >> address;
+      if (type == "CONFIG")
+        {
+          uint16_t rxSector, rxAntenna;
+          record >> sector >> antenna >> rxSector >> rxAntenna;
+          if (record.fail ())
+            {
+              return false;
+            }
+          UpdateBestAntennaConfiguration (address, std::make_pair (sector, antenna), std::make_pair (rxSector, rxAntenna));
+          /* The station can be reached directly once the link is beamformed */
+          AddForwardingEntry (address);
+        }
+      else if ((type == "TXSNR") || (type == "RXSNR"))
+        {
+          double snr;
+          record >> sector >> antenna >> snr;
+          if (record.fail ())
+            {
+              return false;
+            }
+          SNR_PAIR &snrPair = m_stationSnrMap[address];
+          SNR_MAP &snrMap = (type == "TXSNR") ? snrPair.first : snrPair.second;
+          snrMap.SetSnr (std::make_pair (sector, antenna), snr);
+        }
+      else if ((type == "TXSECTORS") || (type == "RXSECTORS"))
+        {
+          record >> antenna;
+          if (record.fail ())
+            {
+              return false;
+            }
+          SectorIDList &sectors = ((type == "TXSECTORS") ? txSectorLists : rxSectorLists)[address][antenna];
+          while (record >> sector)
+            {
+              sectors.push_back (sector);
+            }
+          if (sectors.empty () || !record.eof ())
+            {
+              return false;
+            }
+        }
+      else
+        {
+          return false;
+        }
+    }
+  return false;
+}
+
+void
+DmgWifiMac::MapTxSnr (Mac48Address address, SectorID sectorID, AntennaID antennaID, double snr)
+{
+  NS_LOG_FUNCTION (this << address << uint16_t (sectorID) << uint16_t (antennaID) << RatioToDb (snr));
+  m_stationSnrMap[address].first.SetSnr (std::make_pair (sectorID, antennaID), snr);
 }
 
 void
 DmgWifiMac::MapRxSnr (Mac48Address address, SectorID sectorID, AntennaID antennaID, double snr)
 {
   NS_LOG_FUNCTION (this << address << uint16_t (sectorID) << uint16_t (antennaID) << snr);
-  STATION_SNR_PAIR_MAP::iterator it = m_stationSnrMap.find (address);
-  if (it != m_stationSnrMap.end ())
-    {
-      SNR_PAIR *snrPair = (SNR_PAIR *) (&it->second);
-      SNR_MAP_RX *snrMap = (SNR_MAP_RX *) (&snrPair->second);
-      ANTENNA_CONFIGURATION config = std::make_pair (sectorID, antennaID);
-      (*snrMap)[config] = snr;
-    }
-  else
-    {
-      ANTENNA_CONFIGURATION config = std::make_pair (sectorID, antennaID);
-      SNR_MAP_TX snrTx;
-      SNR_MAP_RX snrRx;
-      snrRx[config] = snr;
-      SNR_PAIR snrPair = std::make_pair (snrTx, snrRx);
-      m_stationSnrMap[address] = snrPair;
-    }
+  m_stationSnrMap[address].second.SetSnr (std::make_pair (sectorID, antennaID), snr);
 }
 
 /* Information Request and Response Exchange */
@@ -1906,29 +2617,20 @@ DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool
 ANTENNA_CONFIGURATION
 DmgWifiMac::GetBestAntennaConfiguration (const Mac48Address stationAddress, bool isTxConfiguration, double &maxSnr)
 {
-  SNR_PAIR snrPair = m_stationSnrMap [stationAddress];
-  SNR_MAP snrMap;
-  if (isTxConfiguration)
+  STATION_SNR_PAIR_MAP_CI it = m_stationSnrMap.find (stationAddress);
+  if (it == m_stationSnrMap.end ())
     {
-      snrMap = snrPair.first;
+      NS_LOG_DEBUG ("No SNR measurement with " << stationAddress);
+      return std::make_pair (NO_ANTENNA_CONFIG, NO_ANTENNA_CONFIG);
     }
-  else
+  const SNR_MAP &snrMap = isTxConfiguration ? it->second.first : it->second.second;
+  if (snrMap.IsEmpty ())
     {
-      snrMap = snrPair.second;
+      NS_LOG_DEBUG ("No SNR measurement with " << stationAddress);
+      return std::make_pair (NO_ANTENNA_CONFIG, NO_ANTENNA_CONFIG);
     }
-
-  SNR_MAP::iterator highIter = snrMap.begin ();
-  SNR snr = highIter->second;
-  for (SNR_MAP::iterator iter = snrMap.begin (); iter != snrMap.end (); iter++)
-    {
-      if (snr < iter->second)
-        {
-          highIter = iter;
-          snr = highIter->second;
-          maxSnr = snr;
-        }
-    }
-  return highIter->first;
+  maxSnr = snrMap.GetBestSnr ();
+  return snrMap.GetBestConfiguration ();
 }
 
 void
@@ -1979,6 +2681,11 @@ DmgWifiMac::ReceiveSectorSweepFrame (Ptr<Packet> packet, const WifiMacHeader *hd
       NS_LOG_LOGIC ("Responder: Received SSW frame as part of ISS from Initiator=" << hdr->GetAddr2 ());
       if (m_rssEvent.IsExpired ())
         {
+          /* The initiator sweeps less sectors than announced in its capabilities when tracking the beam */
+          Ptr<DmgCapabilities> peerCapabilities = GetPeerStationDmgCapabilities (hdr->GetAddr2 ());
+          m_peerBeamTracking[hdr->GetAddr2 ()] = (peerCapabilities != 0)
+            && (sswFeedback.GetSector () < peerCapabilities->GetNumberOfSectors ());
+
           Time rssTime = hdr->GetDuration () + GetMbifs ();
           if ((m_currentAllocation == CBAP_ALLOCATION) && (ssw.GetRXSSLength () == 0))
             {
@@ -2036,6 +2743,7 @@ DmgWifiMac::ReceiveSectorSweepFrame (Ptr<Packet> packet, const WifiMacHeader *hd
               /* The Sector Sweep Frame contains feedback about the the best Tx Sector used by the initiator */
               ANTENNA_CONFIGURATION_TX antennaConfigTx = std::make_pair (sswFeedback.GetSector (), sswFeedback.GetDMGAntenna ());
               UpdateBestTxAntennaConfiguration (hdr->GetAddr2 (), antennaConfigTx);
+              m_snrReports[hdr->GetAddr2 ()] = DecodeSnrReport (sswFeedback.GetSNRReport ());
               NS_LOG_LOGIC ("Best TX Antenna Sector Config by this DMG STA to DMG STA=" << hdr->GetAddr2 ()
                             << ": SectorID=" << static_cast<uint16_t> (antennaConfigTx.first)
                             << ", AntennaID=" << static_cast<uint16_t> (antennaConfigTx.second));
@@ -2105,6 +2813,28 @@ DmgWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
       ANTENNA_CONFIGURATION_TX antennaConfigTx = m_bestAntennaConfig[hdr->GetAddr2 ()].first;
       m_slsCompleted (hdr->GetAddr2 (), CHANNEL_ACCESS_DTI, BeamformingInitiator, m_isInitiatorTXSS, m_isResponderTXSS,
                       antennaConfigTx.first, antennaConfigTx.second);
+      m_beamTrainingCompleted (hdr->GetAddr2 (), IsPartialSweep (hdr->GetAddr2 (), BeamformingInitiator),
+                               GetTransmitSectorSweepSectors (hdr->GetAddr2 (), BeamformingInitiator),
+                               Simulator::Now () - m_beamTrainingStarted);
+      NotifyBeamLinkRecovered (hdr->GetAddr2 ());
+      if (m_codebook->IsHierarchical () && m_isInitiatorTXSS)
+        {
+          /* Continue with the next level of the hierarchy below the new best sector */
+          Antenna2SectorList childList = m_codebook->GetChildSectorList (hdr->GetAddr2 (), antennaConfigTx.second,
+                                                                         antennaConfigTx.first);
+          if (childList.empty ())
+            {
+              UpdateBeamTracking (hdr->GetAddr2 ());
+            }
+          else if (m_currentAllocation == CBAP_ALLOCATION)
+            {
+              Simulator::Schedule (GetSifs (), &DmgWifiMac::InitiateTxssCbap, this, hdr->GetAddr2 ());
+            }
+        }
+      else if (m_beamTracking && m_isInitiatorTXSS)
+        {
+          UpdateBeamTracking (hdr->GetAddr2 ());
+        }
 
       /* Check if we need to start BRP phase following SLS phase */
       BRP_Request_Field brpRequest = sswAck.GetBrpRequestField ();
@@ -62,6 +62,51 @@ typedef std::list<AllocationData> AllocationDataList;
 typedef AllocationDataList::const_iterator AllocationDataListCI;
 typedef std::pair<SectorID, AntennaID>        ANTENNA_CONFIGURATION;            /* Typedef for antenna Config (SectorID, AntennaID) */
 
+/**
+ * SNRs measured with a peer station for each antenna configuration. The SNRs
+ * are stored densely by (AntennaID, SectorID) and the best configuration is
+ * kept up to date as measurements are added, so it is obtained in constant time.
+ * Ties are resolved in favour of the lowest (SectorID, AntennaID).
+ */
+class AntennaConfigurationSnrTable
+{
+public:
+  AntennaConfigurationSnrTable ();
+  /**
+   * Record the SNR measured with an antenna configuration, replacing any previous measurement.
+   * \param config The antenna configuration.
+   * \param snr The measured SNR (linear).
+   */
+  void SetSnr (ANTENNA_CONFIGURATION config, double snr);
+  /**
+   * \return True if no SNR has been measured yet.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \return The antenna configuration with the highest SNR.
+   */
+  ANTENNA_CONFIGURATION GetBestConfiguration (void) const;
+  /**
+   * \return The highest SNR (linear).
+   */
+  double GetBestSnr (void) const;
+  /**
+   * \return The measured SNRs ordered by (SectorID, AntennaID).
+   */
+  std::vector<std::pair<ANTENNA_CONFIGURATION, double> > GetMeasurements (void) const;
+
+private:
+  /**
+   * Look for the best antenna configuration among all the measurements.
+   */
+  void FindBestConfiguration (void);
+
+  std::vector<std::vector<double> > m_snr;  //!< SNR indexed by AntennaID then SectorID, NaN if not measured.
+  uint32_t m_numMeasurements;               //!< Number of antenna configurations measured.
+  ANTENNA_CONFIGURATION m_bestConfig;       //!< Antenna configuration with the highest SNR.
+  double m_bestSnr;                         //!< Highest SNR.
+};
+
 class BeamRefinementElement;
 
 enum SLS_INITIATOR_STATE_MACHINE {
@@ -139,6 +184,20 @@ public:
    * Print Beam Refinement Measurements for each device.
    */
   void PrintBeamRefinementMeasurements (void);
+  /**
+   * Write the best antenna configurations and the SNR tables of the peer stations, and the beamforming
+   * sector lists of the codebook set for specific peer stations, terminated by an END line.
+   * \param os The output stream.
+   */
+  void SaveBeamformingState (std::ostream &os) const;
+  /**
+   * Restore the best antenna configurations, the SNR tables and the beamforming sector lists of the
+   * codebook written by SaveBeamformingState, so that the links with the peer stations are beamformed
+   * without any sector sweep and the next sector sweeps use the same sectors.
+   * \param is The input stream.
+   * \return True if the beamforming state has been read up to its END line.
+   */
+  bool LoadBeamformingState (std::istream &is);
   /**
    * Calculate the duration of a single sweep based on the number of sectors.
    * \param sectors The number of sectors.
@@ -423,6 +482,61 @@ protected:
    * \param direction Indicate whether we are initiator or responder.
    */
   void StartTransmitSectorSweep (Mac48Address address, BeamformingDirection direction);
+  /**
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   * \return The duration of our Transmit Sector Sweep (TxSS), restricted or not to part of the sectors.
+   */
+  Time CalculateTransmitSectorSweepDuration (Mac48Address address, BeamformingDirection direction);
+  /**
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   * \return The number of sectors of our Transmit Sector Sweep (TxSS), restricted or not to part of the sectors.
+   */
+  uint8_t GetTransmitSectorSweepSectors (Mac48Address address, BeamformingDirection direction) const;
+  /**
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   * \return true if our Transmit Sector Sweep (TxSS) sweeps only part of the sectors.
+   */
+  bool IsPartialSweep (Mac48Address address, BeamformingDirection direction) const;
+  /**
+   * Select the transmit sectors of the next Transmit Sector Sweep (TxSS) with a peer station when beam
+   * tracking is enabled. The sector drift observed between the last two TxSS is used to predict the
+   * best sector, and the TxSS is restricted to the current best sector and to the predicted sector with
+   * its neighbours in the beamforming sector list of the antenna.
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   * \param tracking Whether to restrict the TxSS or to sweep all the sectors.
+   */
+  void SelectTransmitSectors (Mac48Address address, BeamformingDirection direction, bool tracking);
+  /**
+   * Check the SNR measured at the end of an SLS initiated with beam tracking, or at the last level of
+   * a sector hierarchy. A full TxSS is required once the best SNR drops by more than BeamTrackingSnrLoss
+   * below the one measured after the last TxSS which did not track the current best sector.
+   * \param address The MAC address of the responder.
+   */
+  void UpdateBeamTracking (Mac48Address address);
+  /**
+   * Record that the beamformed link with a peer station is lost, unless it was already lost.
+   * \param address The MAC address of the peer station.
+   */
+  void NotifyBeamLinkLost (Mac48Address address);
+  /**
+   * Report the outage of the beamformed link with a peer station once an SLS with it is completed.
+   * \param address The MAC address of the peer station.
+   */
+  void NotifyBeamLinkRecovered (Mac48Address address);
+  /**
+   * Select the transmit sectors of the next Transmit Sector Sweep (TxSS) with a peer station when the
+   * codebook defines a sector hierarchy. The TxSS is restricted to the children of the current best
+   * sector. Once the last level is reached, the TxSS tracks the best sector among its siblings until
+   * the SNR degrades. The root level is swept when the best sector is unknown, when it is a root sector
+   * without children, or when the link with the siblings is lost.
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   */
+  void SelectHierarchicalSectors (Mac48Address address, BeamformingDirection direction);
   /**
    * Start Receive Sector Sweep (RxSS) with specific station.
    * \param address The MAC address of the peer DMG STA.
@@ -446,6 +560,40 @@ protected:
    * \param address The MAC address of the initiator.
    */
   void SendRespodnerTransmitSectorSweepFrame (Mac48Address address);
+  /**
+   * Create a Transmit Sector Sweep Frame for the current sector of the codebook.
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   * \param hdr The MAC header of the frame to fill.
+   * \return The SSW frame without its MAC header.
+   */
+  Ptr<Packet> CreateTransmitSectorSweepFrame (Mac48Address address, BeamformingDirection direction, WifiMacHeader &hdr);
+  /**
+   * Resolve the Transmit Sector Sweep (TxSS) analytically when FastSectorSweep is enabled: every SSW frame is
+   * built and its power at each receiver is computed at the start of the sweep, and the SNR of the frames that
+   * survive the interference observed during the sweep is stored by the peer at its end. Only one event is
+   * scheduled per receiver rather than per SSW frame. If the peer station is not attached to the same
+   * DmgWifiChannel, each SSW frame is simulated instead.
+   * \param address The MAC address of the peer DMG STA.
+   * \param direction Indicate whether we are initiator or responder.
+   */
+  void StartFastTransmitSectorSweep (Mac48Address address, BeamformingDirection direction);
+  /**
+   * End the fast Transmit Sector Sweep (TxSS) by handing its SSW frames to the peer station.
+   */
+  void EndFastTransmitSectorSweep (void);
+  /**
+   * End receiving a fast Transmit Sector Sweep (TxSS) from another DMG STA: the PHY decides which SSW frames are
+   * received, the last of them is delivered to the MAC and the SNR of the others is stored directly.
+   * \param from The MAC address of the DMG STA sweeping its sectors.
+   * \param frames The SSW frames of the sweep, with their MAC header and trailer.
+   * \param sectors The transmit antenna configuration of each SSW frame.
+   * \param txVector The TXVECTOR of the SSW frames.
+   * \param remaining The remaining time of the sector sweep.
+   */
+  void EndReceiveFastTransmitSectorSweep (Mac48Address from, std::vector<Ptr<Packet> > frames,
+                                          std::vector<ANTENNA_CONFIGURATION> sectors, WifiTxVector txVector,
+                                          Time remaining);
   /**
    * Send SSW FBCK Frame for SLS phase in a scheduled service period or after SSW-Slot in A-BFT.
    * \param receiver The MAC address of the responding station.
@@ -491,7 +639,7 @@ protected:
 
   /* Typedefs for Recording SNR Value per Antenna Configuration */
   typedef double SNR;                                                   /* Typedef for SNR value. */
-  typedef std::map<ANTENNA_CONFIGURATION, SNR>  SNR_MAP;                /* Typedef for Map between Antenna Config and SNR. */
+  typedef AntennaConfigurationSnrTable          SNR_MAP;                /* Typedef for Table between Antenna Config and SNR. */
   typedef SNR_MAP                               SNR_MAP_TX;             /* Typedef for SNR TX for each antenna configuration. */
   typedef SNR_MAP                               SNR_MAP_RX;             /* Typedef for SNR RX for each antenna configuration. */
   typedef std::pair<SNR_MAP_TX, SNR_MAP_RX>     SNR_PAIR;               /* Typedef for SNR RX for each antenna configuration. */
@@ -531,7 +679,7 @@ protected:
    * Print SNR for either Tx/Rx Antenna Configurations.
    * \param snrMap The SNR Map
    */
-  void PrintSnrConfiguration (SNR_MAP snrMap);
+  void PrintSnrConfiguration (const SNR_MAP &snrMap);
   /**
    * Obtain antenna configuration for the highest received SNR to feed it back
    * \param stationAddress The MAC address of the station.
@@ -810,6 +958,50 @@ protected:
   Time m_sectorSweepStarted;
   Time m_sectorSweepDuration;
   EventId m_rssEvent;                           //!< Event related to scheduling RSS.
+  bool m_fastSectorSweep;                       //!< Flag to indicate whether TxSS is resolved analytically.
+  /**
+   * State of an ongoing fast Transmit Sector Sweep.
+   */
+  struct FastSectorSweep
+  {
+    Ptr<DmgWifiMac> peer;                       //!< The MAC of the peer DMG STA.
+    WifiTxVector txVector;                      //!< The TXVECTOR of the SSW frames.
+    std::vector<Ptr<Packet> > frames;           //!< Each SSW frame, with its MAC header and trailer.
+    std::vector<ANTENNA_CONFIGURATION> sectors; //!< The transmit antenna configuration of each SSW frame.
+  };
+  FastSectorSweep m_fastSweep;                  //!< The ongoing fast Transmit Sector Sweep.
+  EventId m_fastSweepEvent;                     //!< Event related to the end of the fast Transmit Sector Sweep.
+  bool m_beamTracking;                          //!< Flag to indicate whether TxSS are restricted around the predicted sector.
+  uint8_t m_beamTrackingNeighbours;             //!< The number of sectors swept on each side of the predicted sector.
+  double m_beamTrackingSnrLoss;                 //!< The SNR loss in dB triggering a full TxSS.
+  /**
+   * Beam tracking state with a peer station.
+   */
+  struct BeamTrackingInfo
+  {
+    ANTENNA_CONFIGURATION_TX lastConfig;        //!< The best transmit antenna configuration at the start of the last TxSS.
+    int32_t drift;                              //!< The sector drift observed between the last two TxSS.
+    double referenceSnr;                        //!< The best SNR measured after the last full TxSS (linear).
+    bool fullSweepRequired;                     //!< Flag to indicate whether the next TxSS as initiator must not track the best sector.
+  };
+  typedef std::map<Mac48Address, BeamTrackingInfo> BeamTrackingMap;
+  BeamTrackingMap m_beamTrackingMap;            //!< Beam tracking state per peer station.
+  /**
+   * Restriction of our TxSS with a peer station.
+   */
+  struct PartialSweep
+  {
+    Antenna2SectorList sectorList;              //!< The sectors to sweep per antenna.
+    uint8_t sectors;                            //!< The number of sectors of the TxSS.
+    uint8_t antennas;                           //!< The number of antennas of the TxSS.
+    bool tracking;                              //!< Flag to indicate whether the TxSS tracks the current best sector.
+  };
+  typedef std::pair<Mac48Address, BeamformingDirection> PartialSweepKey;
+  typedef std::map<PartialSweepKey, PartialSweep> PartialSweepMap;
+  PartialSweepMap m_partialSweeps;              //!< The restriction of our next or last TxSS per peer station and role, if any.
+  std::map<Mac48Address, bool> m_peerBeamTracking;  //!< Flag per initiator to indicate whether its last ISS was restricted.
+  std::map<Mac48Address, double> m_snrReports;      //!< SNR of our best transmit sector reported by each responder in its last RSS (linear).
+  Time m_beamTrainingStarted;                   //!< The start time of the current SLS as initiator.
   /**
    * Trace callback for SLS phase completion.
    * \param Mac48Address The MAC address of the peer station.
@@ -831,6 +1023,25 @@ protected:
    * \param AWV_ID The ID of the selected custom AWV.
    */
   TracedCallback<Mac48Address, BeamRefinementType, AntennaID, SectorID, AWV_ID> m_brpCompleted;
+  /**
+   * TracedCallback signature for the completion of an SLS as initiator.
+   *
+   * \param address The MAC address of the responder.
+   * \param partial Whether our TxSS swept only part of the sectors.
+   * \param sectors The number of sectors of our TxSS.
+   * \param duration The time from the start of the SLS to the reception of the SSW-ACK.
+   */
+  typedef void (* BeamTrainingCompletedCallback)(Mac48Address address, bool partial, uint8_t sectors, Time duration);
+  TracedCallback<Mac48Address, bool, uint8_t, Time> m_beamTrainingCompleted;
+  /**
+   * TracedCallback signature for the recovery of a lost beamformed link.
+   *
+   * \param address The MAC address of the peer station.
+   * \param outage The time from the detection of the loss to the end of the SLS which recovered the link.
+   */
+  typedef void (* BeamLinkRecoveredCallback)(Mac48Address address, Time outage);
+  TracedCallback<Mac48Address, Time> m_beamLinkRecovered;
+  std::map<Mac48Address, Time> m_beamLinkLost;  //!< Time at which the beamformed link with each peer station was found lost.
 
   /** Link Maintenance Variabeles **/
   BeamLinkMaintenanceUnitIndex m_beamlinkMaintenanceUnit;   //!< Link maintenance Unit according to std 802.11ad-2012.
@@ -26,6 +26,7 @@
 #include "wifi-phy-tag.h"
 #include "frame-capture-model.h"
 #include "wifi-radio-energy-model.h"
+#include "error-rate-model.h"
 
 #include "ns3/boolean.h"
 #include "ns3/log.h"
@@ -133,28 +134,35 @@ DmgWifiPhy::GetCodebook (void) const
 void
 DmgWifiPhy::StartMeasurement (uint16_t measurementDuration, uint8_t blocks)
 {
-  m_measurementBlocks = blocks;
-  m_measurementUnit = floor (measurementDuration/blocks);
-  Simulator::Schedule (MicroSeconds (measurementDuration), &DmgWifiPhy::EndMeasurement, this);
-}
-
-void
-DmgWifiPhy::MeasurementUnitEnded (void)
-{
-  /* Add measurement to the list of measurements */
-  m_measurementList.push_back (m_measurementBlocks);
-  m_measurementBlocks--;
-  if (m_measurementBlocks > 0)
+  NS_LOG_FUNCTION (this << measurementDuration << +blocks);
+  /* The measurement duration is divided in time blocks of equal duration */
+  blocks = std::max<uint8_t> (blocks, 1);
+  Time unit = MicroSeconds (measurementDuration / blocks);
+  std::vector<std::pair<Time, Time> > windows;
+  Time start = Simulator::Now ();
+  for (uint8_t i = 0; i < blocks; i++)
     {
-      /* Schedule new measurement Unit */
-      Simulator::Schedule (MicroSeconds (m_measurementUnit), &DmgWifiPhy::EndMeasurement, this);
+      windows.push_back (std::make_pair (start, start + unit));
+      start += unit;
     }
+  uint32_t measurementId = m_interference.StartObservation (windows);
+  Simulator::Schedule (start - Simulator::Now (), &DmgWifiPhy::EndMeasurement, this, measurementId);
 }
 
 void
-DmgWifiPhy::EndMeasurement (void)
-{
-  m_reportMeasurementCallback (m_measurementList);
+DmgWifiPhy::EndMeasurement (uint32_t measurementId)
+{
+  NS_LOG_FUNCTION (this << measurementId);
+  std::vector<double> interferenceW = m_interference.EndObservation (measurementId);
+  /* The ANIPI includes the thermal noise of the receiver */
+  static const double BOLTZMANN = 1.3803e-23;
+  double noiseW = m_interference.GetNoiseFigure () * BOLTZMANN * 290 * GetChannelWidth () * 1e6;
+  TimeBlockMeasurementList list;
+  for (uint32_t i = 0; i < interferenceW.size (); i++)
+    {
+      list.push_back (DbmToAnipi (WToDbm (noiseW + interferenceW[i])));
+    }
+  m_reportMeasurementCallback (list);
 }
 
 void
@@ -238,6 +246,7 @@ DmgWifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, Time fr
       m_endRxEvent.Cancel ();
       m_interference.NotifyRxEnd ();
     }
+  AbortSectorSweepReceptions (txDuration);
   NotifyTxBegin (packet);
   if ((mpdutype == MPDU_IN_AGGREGATE) && (txVector.GetPreambleType () != WIFI_PREAMBLE_NONE))
     {
@@ -528,6 +537,165 @@ DmgWifiPhy::EndReceiveTrnField (void)
     }
 }
 
+double
+DmgWifiPhy::CalculateRxPowerW (Ptr<DmgWifiPhy> receiver, WifiTxVector txVector)
+{
+  NS_LOG_FUNCTION (this << receiver << txVector);
+  double rxPowerDbm = m_channel->CalculateRxPowerDbm (this, receiver, GetPowerDbm (txVector.GetTxPowerLevel ()) + GetTxGain ());
+  return DbmToW (rxPowerDbm + receiver->GetRxGain ());
+}
+
+bool
+DmgWifiPhy::StartSectorSweepTx (Ptr<const Packet> packet, WifiTxVector txVector, Time duration)
+{
+  NS_LOG_FUNCTION (this << packet << txVector << duration);
+  NS_ASSERT (!m_state->IsStateTx () && !m_state->IsStateSwitching ());
+  if (m_state->IsStateSleep () || m_state->IsStateOff ())
+    {
+      NS_LOG_DEBUG ("Cannot start the sector sweep because in sleep mode");
+      return false;
+    }
+  if (m_state->IsStateRx ())
+    {
+      NS_LOG_DEBUG ("Cancel current reception");
+      m_endPlcpRxEvent.Cancel ();
+      m_endRxEvent.Cancel ();
+      m_interference.NotifyRxEnd ();
+    }
+  AbortSectorSweepReceptions (duration);
+  m_state->SwitchToTx (duration, packet, GetPowerDbm (txVector.GetTxPowerLevel ()), txVector);
+  m_lastTxDuration = duration;
+  return true;
+}
+
+void
+DmgWifiPhy::ReceiveSectorSweepEnergy (double rxPowerW, Time duration)
+{
+  NS_LOG_FUNCTION (this << WToDbm (rxPowerW) << duration);
+  if (m_state->GetState () == WifiPhyState::OFF)
+    {
+      return;
+    }
+  m_interference.AddForeignSignal (duration, rxPowerW);
+  MaybeCcaBusyDuration ();
+}
+
+void
+DmgWifiPhy::StartReceiveSectorSweep (Mac48Address from, const std::vector<std::pair<Time, Time> > &frames,
+                                     const std::vector<double> &rxPowerW)
+{
+  NS_LOG_FUNCTION (this << from << frames.size ());
+  SectorSweepReception &reception = m_sectorSweepReceptions[from];
+  reception.frames = frames;
+  reception.rxPowerW = rxPowerW;
+  reception.lost.assign (frames.size (), false);
+  if (m_state->GetState () == WifiPhyState::OFF)
+    {
+      NS_LOG_DEBUG ("Cannot receive the sector sweep because device is OFF");
+      reception.lost.assign (frames.size (), true);
+      reception.meanPowerW = 0;
+      return;
+    }
+
+  /* The energy of the sweep is spread evenly over its duration */
+  Time duration = frames.back ().second - Simulator::Now ();
+  double energy = 0;
+  for (uint32_t i = 0; i < frames.size (); i++)
+    {
+      energy += rxPowerW[i] * (frames[i].second - frames[i].first).GetSeconds ();
+    }
+  reception.meanPowerW = energy / duration.GetSeconds ();
+  reception.observation = m_interference.StartObservation (frames);
+  ReceiveSectorSweepEnergy (reception.meanPowerW, duration);
+
+  if (m_state->IsStateSleep ())
+    {
+      NS_LOG_DEBUG ("Drop the sector sweep because the PHY is sleeping");
+      reception.lost.assign (frames.size (), true);
+    }
+  else if (m_state->IsStateTx () || m_state->IsStateSwitching ())
+    {
+      Time busyEnd = Simulator::Now () + m_state->GetDelayUntilIdle ();
+      for (uint32_t i = 0; (i < frames.size ()) && (frames[i].first < busyEnd); i++)
+        {
+          NS_LOG_DEBUG ("Drop SSW frame " << i << " because the PHY is " << m_state->GetState ());
+          reception.lost[i] = true;
+        }
+    }
+}
+
+void
+DmgWifiPhy::AbortSectorSweepReceptions (Time duration)
+{
+  NS_LOG_FUNCTION (this << duration);
+  Time start = Simulator::Now ();
+  Time end = start + duration;
+  for (std::map<Mac48Address, SectorSweepReception>::iterator it = m_sectorSweepReceptions.begin ();
+       it != m_sectorSweepReceptions.end (); ++it)
+    {
+      SectorSweepReception &reception = it->second;
+      for (uint32_t i = 0; (i < reception.frames.size ()) && (reception.frames[i].first < end); i++)
+        {
+          if (reception.frames[i].second > start)
+            {
+              NS_LOG_DEBUG ("Drop SSW frame " << i << " from " << it->first << " because the PHY transmits");
+              reception.lost[i] = true;
+            }
+        }
+    }
+}
+
+std::vector<double>
+DmgWifiPhy::EndReceiveSectorSweep (Mac48Address from, const std::vector<Ptr<Packet> > &frames, WifiTxVector txVector)
+{
+  NS_LOG_FUNCTION (this << from << frames.size () << txVector);
+  std::map<Mac48Address, SectorSweepReception>::iterator it = m_sectorSweepReceptions.find (from);
+  NS_ASSERT (it != m_sectorSweepReceptions.end ());
+  SectorSweepReception reception = it->second;
+  m_sectorSweepReceptions.erase (it);
+  std::vector<double> snr (frames.size (), 0);
+  if (reception.meanPowerW == 0)
+    {
+      /* The PHY was OFF when the sweep started, so nothing has been observed */
+      return snr;
+    }
+  std::vector<double> noiseInterferenceW = m_interference.EndObservation (reception.observation);
+  if (m_state->GetState () == WifiPhyState::OFF)
+    {
+      return snr;
+    }
+  for (uint32_t i = 0; i < frames.size (); i++)
+    {
+      if (reception.lost[i])
+        {
+          NotifyRxDrop (frames[i]);
+          continue;
+        }
+      if (reception.rxPowerW[i] < GetEdThresholdW ())
+        {
+          NS_LOG_DEBUG ("drop SSW frame " << i << " because signal power too Small (" << WToDbm (reception.rxPowerW[i]) << ")");
+          NotifyRxDrop (frames[i]);
+          continue;
+        }
+      /* The signal of the sweep itself was observed during the window of the frame as well */
+      double interferenceW = std::max (0.0, noiseInterferenceW[i] - reception.meanPowerW);
+      double sinr = m_interference.CalculateSnr (reception.rxPowerW[i], interferenceW, txVector.GetChannelWidth ());
+      double psr = m_interference.GetErrorRateModel ()->GetChunkSuccessRate (txVector.GetMode (), txVector,
+                                                                            sinr, frames[i]->GetSize () * 8);
+      if (m_random->GetValue () < psr)
+        {
+          snr[i] = sinr;
+          NotifyRxEnd (frames[i]);
+        }
+      else
+        {
+          NS_LOG_DEBUG ("drop SSW frame " << i << " with snr(dB)=" << RatioToDb (sinr));
+          NotifyRxDrop (frames[i]);
+        }
+    }
+  return snr;
+}
+
 void
 DmgWifiPhy::StartRx (Ptr<Packet> packet, WifiTxVector txVector, MpduType mpdutype, double rxPowerW,
                      Time rxDuration, Time totalDuration,
@@ -942,8 +1110,46 @@ DmgWifiPhy::GetPlcpPreambleDuration (WifiTxVector txVector)
     }
 }
 
+DmgWifiPhy::DurationCache DmgWifiPhy::m_payloadDurations;
+DmgWifiPhy::DurationCache DmgWifiPhy::m_plcpDurations;
+
+Time
+DmgWifiPhy::CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector)
+{
+  uint64_t key = (uint64_t (txVector.GetMode ().GetUid ()) << 16)
+    | (uint64_t (txVector.GetPreambleType ()) << 8) | txVector.GetNss ();
+  DurationCache::const_iterator it = m_plcpDurations.find (key);
+  if (it != m_plcpDurations.end ())
+    {
+      return it->second;
+    }
+  Time duration = WifiPhy::CalculatePlcpPreambleAndHeaderDuration (txVector);
+  m_plcpDurations.insert (std::make_pair (key, duration));
+  return duration;
+}
+
 Time
 DmgWifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
+{
+  NS_LOG_FUNCTION (size << txVector.GetMode ());
+  bool trn = (txVector.GetTrainngFieldLength () != 0);
+  uint64_t key = (uint64_t (txVector.GetMode ().GetUid ()) << 33) | (uint64_t (trn) << 32) | size;
+  DurationCache::const_iterator it = m_payloadDurations.find (key);
+  if (it != m_payloadDurations.end ())
+    {
+      return it->second;
+    }
+  if (m_payloadDurations.size () >= MAX_PAYLOAD_DURATIONS)
+    {
+      m_payloadDurations.clear ();
+    }
+  Time duration = ComputePayloadDuration (size, txVector);
+  m_payloadDurations.insert (std::make_pair (key, duration));
+  return duration;
+}
+
+Time
+DmgWifiPhy::ComputePayloadDuration (uint32_t size, WifiTxVector txVector)
 {
   WifiMode payloadMode = txVector.GetMode ();
   NS_LOG_FUNCTION (size << payloadMode);
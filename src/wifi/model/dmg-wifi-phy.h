@@ -23,6 +23,8 @@
 
 #include "wifi-phy.h"
 #include "codebook.h"
+#include "ns3/mac48-address.h"
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -184,6 +186,51 @@ public:
    * This method is called once all the TRN Units are received.
    */
   void EndReceiveTrnField (void);
+
+  /**
+   * Calculate the power received by another PHY attached to the same DmgWifiChannel for a transmission
+   * with the current antenna configurations of both PHYs.
+   * \param receiver The receiving PHY.
+   * \param txVector The TXVECTOR of the transmission.
+   * \return The received power in W.
+   */
+  double CalculateRxPowerW (Ptr<DmgWifiPhy> receiver, WifiTxVector txVector);
+  /**
+   * Start transmitting an abstracted sector sweep, the PHY stays in TX state for its whole duration.
+   * \param packet The first SSW frame of the sweep.
+   * \param txVector The TXVECTOR of the SSW frames.
+   * \param duration The duration of the sector sweep.
+   * \return True if the transmission has started, false if the PHY is sleeping.
+   */
+  bool StartSectorSweepTx (Ptr<const Packet> packet, WifiTxVector txVector, Time duration);
+  /**
+   * Add the energy of an abstracted sector sweep addressed to another PHY, as a single signal carrying the mean
+   * power of its SSW frames over the whole sweep.
+   * \param rxPowerW The mean power of the sweep in W.
+   * \param duration The duration of the sweep.
+   */
+  void ReceiveSectorSweepEnergy (double rxPowerW, Time duration);
+  /**
+   * Start receiving an abstracted sector sweep addressed to this PHY. The SSW frames of the sweep are not received
+   * one by one: the sweep adds a single signal carrying their mean power over its whole duration, and the noise and
+   * interference seen during each of its SSW frames is observed until EndReceiveSectorSweep is called. As for any
+   * other frame, an SSW frame is dropped if the PHY is transmitting, switching channel or sleeping when the sweep
+   * starts, or if it starts transmitting during the frame.
+   * \param from The MAC address of the station sweeping its sectors.
+   * \param frames The start and end time of each SSW frame of the sweep.
+   * \param rxPowerW The power of each SSW frame in W.
+   */
+  void StartReceiveSectorSweep (Mac48Address from, const std::vector<std::pair<Time, Time> > &frames,
+                                const std::vector<double> &rxPowerW);
+  /**
+   * End receiving an abstracted sector sweep and decide which of its SSW frames are successfully received.
+   * \param from The MAC address of the station sweeping its sectors.
+   * \param frames The SSW frames of the sweep.
+   * \param txVector The TXVECTOR of the SSW frames.
+   * \return The SNR of each SSW frame, or zero if the frame is lost.
+   */
+  std::vector<double> EndReceiveSectorSweep (Mac48Address from, const std::vector<Ptr<Packet> > &frames,
+                                             WifiTxVector txVector);
   /**
    * Get pointer to the current DMG Wifi Channel.
    * \return A pointer to the current DMG Wifi Channel.
@@ -228,9 +275,11 @@ public:
    */
   typedef Callback<void, TimeBlockMeasurementList> ReportMeasurementCallback;
   /**
-   * Start Measurement.
-   * \param measurementDuration The duration of the measurement block.
-   * \param blocks The number of time blocks to do measurement.
+   * Start measuring the average noise plus interference power (ANIPI) received
+   * with the current antenna configuration. The results are reported as one
+   * ANIPI level per time block at the end of the measurement.
+   * \param measurementDuration The duration of the measurement in microseconds.
+   * \param blocks The number of time blocks the measurement is divided in.
    */
   void StartMeasurement (uint16_t measurementDuration, uint8_t blocks);
   /**
@@ -276,6 +325,12 @@ public:
    * \return the duration of the payload
    */
   virtual Time GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag);
+  /**
+   * \param txVector the transmission parameters used for this packet
+   *
+   * \return the total amount of time this PHY will stay busy for the transmission of the PLCP preamble and PLCP header.
+   */
+  virtual Time CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector);
   /**
    * \param packet the packet to send
    * \param txVector the TXVECTOR that has tx parameters such as mode, the transmission mode to use to send
@@ -560,8 +615,34 @@ private:
    */
   void PrepareForAGC_RX_Reception (uint8_t remainingAgcRxSubields);
 
-  virtual void MeasurementUnitEnded (void);
-  virtual void EndMeasurement (void);
+  /**
+   * End a measurement and report its results.
+   * \param measurementId The observation of the interference made for the measurement.
+   */
+  void EndMeasurement (uint32_t measurementId);
+  /**
+   * Drop the SSW frames of abstracted sector sweeps being received which overlap a transmission of the PHY.
+   * \param duration The duration of the transmission starting now.
+   */
+  void AbortSectorSweepReceptions (Time duration);
+
+  /**
+   * Compute the duration of a DMG payload. The duration only depends on the
+   * size of the payload, on the MCS and on whether TRN fields are appended.
+   *
+   * \param size the number of bytes in the payload
+   * \param txVector the TXVECTOR used for the transmission of the payload
+   *
+   * \return the duration of the payload
+   */
+  static Time ComputePayloadDuration (uint32_t size, WifiTxVector txVector);
+
+  /// Durations indexed by a key built from the parameters they depend on
+  typedef std::unordered_map<uint64_t, Time> DurationCache;
+
+  static const uint32_t MAX_PAYLOAD_DURATIONS = 65536;  //!< Size at which the payload duration cache is flushed
+  static DurationCache m_payloadDurations;              //!< Payload durations indexed by (MCS, TRN fields, size), shared by all the DMG PHYs
+  static DurationCache m_plcpDurations;                 //!< PLCP preamble and header durations indexed by (MCS, preamble, NSS), shared by all the DMG PHYs
 
 private:
   Ptr<DmgWifiChannel> m_channel;        //!< DmgWifiChannel that this DmgWifiPhy is connected to
@@ -577,15 +658,24 @@ private:
   uint8_t m_rdsSector;
   uint8_t m_rdsAntenna;
   /* Channel Measurements Variables */
-  uint16_t m_measurementUnit;
-  uint8_t m_measurementBlocks;
-  ReportMeasurementCallback m_reportMeasurementCallback;
-  TimeBlockMeasurementList m_measurementList;
+  ReportMeasurementCallback m_reportMeasurementCallback;  //!< Callback to report the measurement results.
   /* DMG PHY Layer Parameters */
   bool m_supportOFDM;                   //!< Flag to indicate whether we support OFDM PHY layer.
   bool m_supportLpSc;                   //!< Flag to indicate whether we support LP-SC PHY layer.
   /* Channel measurements */
   uint8_t m_lastRcpiValue;              //!< The Received channel power indicator (RCPI) value of the last received packet.
+  /**
+   * State of the reception of an abstracted sector sweep.
+   */
+  struct SectorSweepReception
+  {
+    uint32_t observation;                 //!< The observation of the interference during the SSW frames.
+    std::vector<std::pair<Time, Time> > frames; //!< The start and end time of each SSW frame.
+    std::vector<double> rxPowerW;         //!< The power of each SSW frame in W.
+    double meanPowerW;                    //!< The power of the signal added for the whole sweep in W.
+    std::vector<bool> lost;               //!< Whether each SSW frame has been dropped.
+  };
+  std::map<Mac48Address, SectorSweepReception> m_sectorSweepReceptions;  //!< Ongoing abstracted sector sweep receptions, by sweeping station.
 
 };
 
@@ -36,6 +36,8 @@ NS_LOG_COMPONENT_DEFINE ("DmgWifiScheduler");
 
 NS_OBJECT_ENSURE_REGISTERED (DmgWifiScheduler);
 
+const uint32_t DmgWifiScheduler::MAX_ALLOCATION_FIELDS;
+
 TypeId
 DmgWifiScheduler::GetTypeId (void)
 {
@@ -48,7 +50,8 @@ DmgWifiScheduler::GetTypeId (void)
 }
 
 DmgWifiScheduler::DmgWifiScheduler ()
-  : m_isAddtsAccepted (false),
+  : m_allocationListVersion (0),
+    m_isAddtsAccepted (false),
     m_isAllocationModified (false),
     m_isNonStaticRemoved (false),
     m_isDeltsReceived (false),
@@ -142,6 +145,7 @@ void
 DmgWifiScheduler::SetAllocationList (const AllocationFieldList &allocationList)
 {
   m_allocationList = allocationList;
+  m_allocationListVersion++;
 }
 
 void
@@ -193,7 +197,9 @@ DmgWifiScheduler::DataTransferIntervalStarted (Mac48Address address, Time dtiDur
 {
   NS_LOG_INFO ("DTI started at " << Simulator::Now ());
   m_currentAccessPeriodStartTime = Simulator::Now ();
-  m_dtiDuration = dtiDuration;
+  /* The BHI time saved by the adaptive BHI of the PCP/AP is not planned, so that the allocations
+   * always fit in the DTI left by the full BHI */
+  m_dtiDuration = dtiDuration - m_mac->GetReclaimedBhiDuration ();
   m_currentAccessPeriod = CHANNEL_ACCESS_DTI;
 }
 
@@ -349,7 +355,11 @@ DmgWifiScheduler::AddBroadcastCbap (void)
        * The entire DTI is allocated as CBAP broadcast (CbapOnly field)
        * The allocation list is emptied
        */
-      m_allocationList.clear ();
+      if (!m_allocationList.empty ())
+        {
+          m_allocationList.clear ();
+          m_allocationListVersion++;
+        }
       m_isNonStaticRemoved = false;
       m_isDeltsReceived = false;
       return;
@@ -362,6 +372,7 @@ DmgWifiScheduler::AddBroadcastCbap (void)
        */
       UpdateStartAndRemainingTime ();
       AddBroadcastCbapAllocations (); 
+      m_allocationListVersion++;
       m_isAddtsAccepted = false;
       m_isAllocationModified = false;
       m_isNonStaticRemoved = false;
@@ -506,6 +517,12 @@ DmgWifiScheduler::GetAllocationListSize (void) const
   return m_allocationList.size ();
 }
 
+uint32_t
+DmgWifiScheduler::GetAllocationListVersion (void) const
+{
+  return m_allocationListVersion;
+}
+
 void
 DmgWifiScheduler::CleanupAllocations (void)
 {
@@ -103,6 +103,8 @@ public:
 protected:
   friend class DmgApWifiMac;
 
+  static const uint32_t MAX_ALLOCATION_FIELDS = 17;   //!< The number of allocation fields that fit in an Extended Schedule element.
+
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
   /**
@@ -227,6 +229,13 @@ protected:
    * \return The size of the current Allocation list.
    */
   uint32_t GetAllocationListSize (void) const;
+  /**
+   * The version is incremented every time the allocation list announced in the
+   * Extended Schedule element changes, i.e. when ADDTS and DELTS requests or
+   * the cleanup of non-static allocations modify the schedule.
+   * \return The version of the current Allocation list.
+   */
+  uint32_t GetAllocationListVersion (void) const;
   /**
    * The allocations have been announced in the DTI. 
    */
@@ -241,6 +250,7 @@ protected:
   /* Access Period Allocations */
   AllocationFieldList m_allocationList;        //!< List of access period allocations in DTI which includes broadcast CBAP allocations.
   AllocationFieldList m_addtsAllocationList;   //!< List of requested (ADDTS received) access period allocations in DTI.
+  uint32_t m_allocationListVersion;            //!< Version of the allocation list.
   /* Allocation */
   typedef struct {
     uint8_t sourceAid;
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dti-available-slots.h"
+#include <algorithm>
+
+namespace ns3 {
+
+DtiAvailableSlots::DtiAvailableSlots ()
+  : m_availableTime (0)
+{
+}
+
+void
+DtiAvailableSlots::Reset (uint32_t dtiDuration)
+{
+  m_slots.clear ();
+  m_availableTime = 0;
+  Release (0, dtiDuration);
+}
+
+void
+DtiAvailableSlots::Reserve (uint32_t start, uint32_t end)
+{
+  if (start >= end)
+    {
+      return;
+    }
+  /* Start from the slot holding the start of the interval, if any */
+  Slots::iterator it = m_slots.upper_bound (start);
+  if (it != m_slots.begin ())
+    {
+      Slots::iterator previous = it;
+      --previous;
+      if (previous->second > start)
+        {
+          it = previous;
+        }
+    }
+  while (it != m_slots.end () && it->first < end)
+    {
+      uint32_t slotStart = it->first;
+      uint32_t slotEnd = it->second;
+      it = m_slots.erase (it);
+      m_availableTime -= std::min (slotEnd, end) - std::max (slotStart, start);
+      if (slotStart < start)
+        {
+          m_slots.insert (it, std::make_pair (slotStart, start));
+        }
+      if (slotEnd > end)
+        {
+          m_slots.insert (it, std::make_pair (end, slotEnd));
+        }
+    }
+}
+
+void
+DtiAvailableSlots::Release (uint32_t start, uint32_t end)
+{
+  if (start >= end)
+    {
+      return;
+    }
+  /* Merge the interval with the slots it overlaps or touches */
+  Slots::iterator it = m_slots.lower_bound (start);
+  if (it != m_slots.begin ())
+    {
+      Slots::iterator previous = it;
+      --previous;
+      if (previous->second >= start)
+        {
+          it = previous;
+        }
+    }
+  while (it != m_slots.end () && it->first <= end)
+    {
+      start = std::min (start, it->first);
+      end = std::max (end, it->second);
+      m_availableTime -= it->second - it->first;
+      it = m_slots.erase (it);
+    }
+  m_slots.insert (it, std::make_pair (start, end));
+  m_availableTime += end - start;
+}
+
+DtiAvailableSlots::SlotsCI
+DtiAvailableSlots::Find (uint32_t time) const
+{
+  SlotsCI it = m_slots.upper_bound (time);
+  if (it == m_slots.begin ())
+    {
+      return m_slots.end ();
+    }
+  --it;
+  return (time < it->second) ? it : m_slots.end ();
+}
+
+bool
+DtiAvailableSlots::FindFirstFit (uint32_t time, uint32_t duration, uint32_t &start) const
+{
+  /* Start from the slot holding the given time, if any */
+  SlotsCI it = m_slots.upper_bound (time);
+  if (it != m_slots.begin ())
+    {
+      SlotsCI previous = it;
+      --previous;
+      if (previous->second > time)
+        {
+          it = previous;
+        }
+    }
+  for (; it != m_slots.end (); ++it)
+    {
+      uint32_t slotStart = std::max (it->first, time);
+      if (it->second - slotStart >= duration)
+        {
+          start = slotStart;
+          return true;
+        }
+    }
+  return false;
+}
+
+uint32_t
+DtiAvailableSlots::GetAvailableTime (void) const
+{
+  return m_availableTime;
+}
+
+bool
+DtiAvailableSlots::IsEmpty (void) const
+{
+  return m_slots.empty ();
+}
+
+DtiAvailableSlots::SlotsCI
+DtiAvailableSlots::Begin (void) const
+{
+  return m_slots.begin ();
+}
+
+DtiAvailableSlots::SlotsCI
+DtiAvailableSlots::End (void) const
+{
+  return m_slots.end ();
+}
+
+void
+DtiAvailableSlots::Print (std::ostream &os) const
+{
+  for (SlotsCI it = m_slots.begin (); it != m_slots.end (); ++it)
+    {
+      os << "[" << it->first << ", " << it->second << ") ";
+    }
+}
+
+std::ostream &
+operator << (std::ostream &os, const DtiAvailableSlots &slots)
+{
+  slots.Print (os);
+  return os;
+}
+
+} //namespace ns3
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DTI_AVAILABLE_SLOTS_H
+#define DTI_AVAILABLE_SLOTS_H
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Index of the time of a DTI that is not allocated yet
+ *
+ * The available time is kept as a set of disjoint slots [start, end) in
+ * microseconds relative to the beginning of the DTI, ordered by their start
+ * time. Adjacent slots are merged, so that a slot is always as large as the
+ * free time around it. Reserving or releasing time and looking up the slot
+ * holding a given instant take a logarithmic time in the number of slots, and
+ * the total available time is kept up-to-date.
+ *
+ * Only the PeriodicDmgWifiScheduler uses this index. The BasicDmgWifiScheduler
+ * packs its allocations back-to-back from the start of the DTI, so that its
+ * available time is always a single slot at the end of the DTI, and the
+ * CbapOnlyDmgWifiScheduler does not allocate any SP.
+ */
+class DtiAvailableSlots
+{
+public:
+  /// Available slots, indexed by their start time and mapped to their end time.
+  typedef std::map<uint32_t, uint32_t> Slots;
+  /// Const iterator over the available slots.
+  typedef Slots::const_iterator SlotsCI;
+
+  DtiAvailableSlots ();
+
+  /**
+   * Make the whole DTI available.
+   * \param dtiDuration The duration of the DTI in microseconds.
+   */
+  void Reset (uint32_t dtiDuration);
+  /**
+   * Remove the interval [start, end) from the available time.
+   * \param start The start time of the interval.
+   * \param end The end time of the interval.
+   */
+  void Reserve (uint32_t start, uint32_t end);
+  /**
+   * Add the interval [start, end) to the available time.
+   * \param start The start time of the interval.
+   * \param end The end time of the interval.
+   */
+  void Release (uint32_t start, uint32_t end);
+  /**
+   * \param time A time in microseconds relative to the beginning of the DTI.
+   * \return the slot holding the given time, or End () if the time is allocated.
+   */
+  SlotsCI Find (uint32_t time) const;
+  /**
+   * Look for the earliest interval of the given duration starting at or after
+   * the given time that is entirely available.
+   * \param time A time in microseconds relative to the beginning of the DTI.
+   * \param duration The duration of the interval in microseconds.
+   * \param start The start time of the interval, if any.
+   * \return true if such an interval exists.
+   */
+  bool FindFirstFit (uint32_t time, uint32_t duration, uint32_t &start) const;
+  /**
+   * \return the total available time in microseconds.
+   */
+  uint32_t GetAvailableTime (void) const;
+  /**
+   * \return true if no time is available.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \return an iterator to the first available slot.
+   */
+  SlotsCI Begin (void) const;
+  /**
+   * \return an iterator past the last available slot.
+   */
+  SlotsCI End (void) const;
+  /**
+   * Print the available slots.
+   * \param os The output stream.
+   */
+  void Print (std::ostream &os) const;
+
+
+private:
+  Slots m_slots;             //!< The available slots.
+  uint32_t m_availableTime;  //!< The total duration of the available slots.
+};
+
+std::ostream &operator << (std::ostream &os, const DtiAvailableSlots &slots);
+
+} //namespace ns3
+
+#endif /* DTI_AVAILABLE_SLOTS_H */
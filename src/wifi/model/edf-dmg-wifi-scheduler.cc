@@ -0,0 +1,580 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <set>
+#include <ns3/assert.h>
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+
+#include "edf-dmg-wifi-scheduler.h"
+#include "dmg-ap-wifi-mac.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EdfDmgWifiScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (EdfDmgWifiScheduler);
+
+TypeId
+EdfDmgWifiScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EdfDmgWifiScheduler")
+      .SetParent<DmgWifiScheduler> ()
+      .SetGroupName ("Wifi")
+      .AddConstructor<EdfDmgWifiScheduler> ()
+
+      .AddAttribute ("SchedulabilityHorizon", "The number of BIs over which the flows must meet all their deadlines "
+                     "for a new request to be accepted. The horizon is extended to the longest service interval.",
+                     UintegerValue (16),
+                     MakeUintegerAccessor (&EdfDmgWifiScheduler::m_horizon),
+                     MakeUintegerChecker<uint32_t> (1, 1024))
+      .AddAttribute ("MinBroadcastCbapDuration", "The minimum duration in microseconds of broadcast CBAP to keep "
+                     "on average in the DTI when accepting new requests",
+                     UintegerValue (4096),
+                     MakeUintegerAccessor (&EdfDmgWifiScheduler::m_minBroadcastCbapDuration),
+                     MakeUintegerChecker<uint32_t> ())
+
+      .AddTraceSource ("JobScheduled", "A job of a flow has been scheduled in the DTI, "
+                       "with the time from its release to the end of its SP.",
+                       MakeTraceSourceAccessor (&EdfDmgWifiScheduler::m_jobScheduled),
+                       "ns3::EdfDmgWifiScheduler::JobScheduledCallback")
+      .AddTraceSource ("DeadlineMissed", "A job of a flow has been dropped because it could not meet its deadline.",
+                       MakeTraceSourceAccessor (&EdfDmgWifiScheduler::m_deadlineMissed),
+                       "ns3::EdfDmgWifiScheduler::DeadlineMissedCallback")
+  ;
+  return tid;
+}
+
+EdfDmgWifiScheduler::EdfDmgWifiScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EdfDmgWifiScheduler::~EdfDmgWifiScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EdfDmgWifiScheduler::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_flows.clear ();
+  DmgWifiScheduler::DoDispose ();
+}
+
+void
+EdfDmgWifiScheduler::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  DmgWifiScheduler::DoInitialize ();
+  bool isConnected;
+  isConnected = m_mac->TraceConnectWithoutContext ("DTIStarted", MakeCallback (&EdfDmgWifiScheduler::DataTransferIntervalStarted, this));
+  NS_ASSERT_MSG (isConnected, "Connection to Trace DTIStarted failed.");
+}
+
+void
+EdfDmgWifiScheduler::DataTransferIntervalStarted (Mac48Address address, Time dtiDuration)
+{
+  NS_LOG_FUNCTION (this << address << dtiDuration);
+  m_lastDtiStart = Simulator::Now ();
+}
+
+int64_t
+EdfDmgWifiScheduler::GetNextDtiStart (void) const
+{
+  return m_lastDtiStart.GetMicroSeconds () + m_biDuration.GetMicroSeconds ();
+}
+
+uint32_t
+EdfDmgWifiScheduler::GetServiceInterval (const DmgTspecElement &dmgTspec) const
+{
+  uint32_t biDuration = m_biDuration.GetMicroSeconds ();
+  uint16_t allocationPeriod = dmgTspec.GetAllocationPeriod ();
+  if (allocationPeriod == 0)
+    {
+      return biDuration;
+    }
+  else if (dmgTspec.IsAllocationPeriodMultipleBI ())
+    {
+      return biDuration * allocationPeriod;
+    }
+  else
+    {
+      return biDuration / allocationPeriod;
+    }
+}
+
+void
+EdfDmgWifiScheduler::BeaconIntervalEnded (void)
+{
+  NS_LOG_INFO ("Beacon Interval ended at " << Simulator::Now ());
+  /* Cleanup non-static allocations */
+  CleanupAllocations ();
+  /* The SPs of the flows move from one BI to the next, so the DTI is planned again every BI */
+  if (m_addtsAllocationList.empty ())
+    {
+      NS_LOG_DEBUG ("No Addts allocations. Entire DTI as CBAP");
+      m_flows.clear ();
+      if (!m_allocationList.empty ())
+        {
+          m_allocationList.clear ();
+          m_allocationListVersion++;
+        }
+    }
+  else
+    {
+      UpdateStartAndRemainingTime ();
+      AddBroadcastCbapAllocations ();
+      m_allocationListVersion++;
+    }
+  m_isAddtsAccepted = false;
+  m_isAllocationModified = false;
+  m_isNonStaticRemoved = false;
+  m_isDeltsReceived = false;
+}
+
+void
+EdfDmgWifiScheduler::UpdateStartAndRemainingTime (void)
+{
+  NS_LOG_FUNCTION (this);
+  /* The requested allocations have no fixed position in the DTI */
+  m_allocationStartTime = 0;
+  m_remainingDtiTime = m_dtiDuration.GetMicroSeconds ();
+}
+
+void
+EdfDmgWifiScheduler::AdjustExistingAllocations (AllocationFieldListI iter, uint32_t duration, bool isToAdd)
+{
+  NS_LOG_FUNCTION (this << duration << isToAdd);
+}
+
+uint32_t
+EdfDmgWifiScheduler::GetAllocationDuration (uint32_t minAllocation, uint32_t maxAllocation)
+{
+  NS_LOG_FUNCTION (this << minAllocation << maxAllocation);
+  /* The minimum allocation is tried next if the maximum one cannot be accepted */
+  return maxAllocation;
+}
+
+TsDelayElement
+EdfDmgWifiScheduler::GetTsDelayElement (void)
+{
+  NS_LOG_FUNCTION (this);
+  /* Non-static allocations release their time after one BI, otherwise retry after the schedulability horizon */
+  uint32_t intervals = m_horizon;
+  for (EdfFlowMapI it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      if (!it->second.field.IsPseudoStatic ())
+        {
+          intervals = 1;
+          break;
+        }
+    }
+  TsDelayElement element;
+  element.SetDelay (std::max<uint32_t> (1, intervals * m_biDuration.GetMicroSeconds () / 1024));
+  return element;
+}
+
+void
+EdfDmgWifiScheduler::RemoveTerminatedFlows (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::set<UniqueIdentifier> allocations;
+  for (AllocationFieldListI iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+    {
+      allocations.insert (UniqueIdentifier (iter->GetAllocationID (), iter->GetSourceAid (), iter->GetDestinationAid ()));
+    }
+  for (EdfFlowMapI it = m_flows.begin (); it != m_flows.end ();)
+    {
+      if (allocations.find (it->first) == allocations.end ())
+        {
+          NS_LOG_DEBUG ("Flow with allocation ID " << +std::get<0> (it->first) << " has been removed");
+          it = m_flows.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+uint32_t
+EdfDmgWifiScheduler::ReserveFixedAllocations (DtiAvailableSlots &slots) const
+{
+  uint32_t fields = 0;
+  for (AllocationFieldList::const_iterator iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+    {
+      if (m_flows.find (UniqueIdentifier (iter->GetAllocationID (), iter->GetSourceAid (),
+                                          iter->GetDestinationAid ())) != m_flows.end ())
+        {
+          continue;
+        }
+      for (uint8_t block = 0; block < iter->GetNumberOfBlocks (); block++)
+        {
+          uint32_t start = iter->GetAllocationStart () + block * iter->GetAllocationBlockPeriod ();
+          slots.Reserve (start, start + iter->GetAllocationBlockDuration () + m_guardTime);
+        }
+      fields++;
+    }
+  return fields;
+}
+
+uint32_t
+EdfDmgWifiScheduler::PlanDataTransferInterval (EdfFlowMap &flows, int64_t dtiStart, DtiAvailableSlots &slots,
+                                               uint32_t maxFields, EdfBlocksList &blocks, bool report)
+{
+  NS_LOG_FUNCTION (this << dtiStart << maxFields);
+  int64_t dtiEnd = dtiStart + m_dtiDuration.GetMicroSeconds ();
+  int64_t nextDtiStart = dtiStart + m_biDuration.GetMicroSeconds ();
+  /* Jobs waiting for their release, ordered by release time, and released jobs, ordered by deadline */
+  typedef std::set<std::pair<int64_t, UniqueIdentifier> > JobQueue;
+  JobQueue pending;
+  JobQueue released;
+  for (EdfFlowMapI it = flows.begin (); it != flows.end (); ++it)
+    {
+      if (it->second.nextRelease < 0)
+        {
+          it->second.nextRelease = dtiStart;
+        }
+      if (it->second.nextRelease < dtiEnd)
+        {
+          pending.insert (std::make_pair (it->second.nextRelease, it->first));
+        }
+    }
+
+  /* Index of the last allocation field of each flow, to announce equally spaced SPs together */
+  std::map<UniqueIdentifier, size_t> lastBlocks;
+  uint32_t misses = 0;
+  int64_t time = dtiStart;
+  while (!pending.empty () || !released.empty ())
+    {
+      while (!pending.empty () && pending.begin ()->first <= time)
+        {
+          const UniqueIdentifier &id = pending.begin ()->second;
+          released.insert (std::make_pair (pending.begin ()->first + flows[id].period, id));
+          pending.erase (pending.begin ());
+        }
+      if (released.empty ())
+        {
+          time = pending.begin ()->first;
+          continue;
+        }
+
+      int64_t deadline = released.begin ()->first;
+      UniqueIdentifier id = released.begin ()->second;
+      released.erase (released.begin ());
+      EdfFlow &flow = flows[id];
+
+      /* Look for the earliest time the SP fits in the DTI, and whether it can be announced */
+      uint32_t start;
+      bool fits = slots.FindFirstFit (time - dtiStart, flow.budget + m_guardTime, start);
+      EdfBlocks *last = 0;
+      std::map<UniqueIdentifier, size_t>::iterator lastIt = lastBlocks.find (id);
+      if (fits && (lastIt != lastBlocks.end ()))
+        {
+          last = &blocks[lastIt->second];
+          uint32_t period = (last->blocks == 1) ? start - last->start : last->period;
+          if ((start != last->start + last->blocks * period) || (period > UINT16_MAX) || (last->blocks == MAX_NUM_BLOCKS))
+            {
+              last = 0;
+            }
+        }
+      fits = fits && ((last != 0) || (blocks.size () < maxFields));
+
+      if (fits && (dtiStart + start + flow.budget <= deadline))
+        {
+          if (last != 0)
+            {
+              last->period = (start - last->start) / last->blocks;
+              last->blocks++;
+            }
+          else
+            {
+              EdfBlocks newBlocks = { id, start, 0, 1 };
+              lastBlocks[id] = blocks.size ();
+              blocks.push_back (newBlocks);
+            }
+          slots.Reserve (start, start + flow.budget + m_guardTime);
+          time = dtiStart + start + flow.budget + m_guardTime;
+          if (report)
+            {
+              m_jobScheduled (std::get<0> (id), std::get<1> (id), std::get<2> (id),
+                              MicroSeconds (dtiStart + start + flow.budget - flow.nextRelease));
+            }
+        }
+      else if (!fits && (nextDtiStart + flow.budget <= deadline))
+        {
+          /* The job can still be served in the next DTI */
+          continue;
+        }
+      else
+        {
+          NS_LOG_DEBUG ("Job of flow with allocation ID " << +std::get<0> (id) << " released at "
+                        << flow.nextRelease << " misses its deadline " << deadline);
+          misses++;
+          if (report)
+            {
+              m_deadlineMissed (std::get<0> (id), std::get<1> (id), std::get<2> (id));
+            }
+        }
+
+      flow.nextRelease += flow.period;
+      if (flow.nextRelease < dtiEnd)
+        {
+          pending.insert (std::make_pair (flow.nextRelease, id));
+        }
+    }
+  return misses;
+}
+
+bool
+EdfDmgWifiScheduler::IsSchedulable (const EdfFlowMap &flows)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t biDuration = m_biDuration.GetMicroSeconds ();
+  uint32_t dtiDuration = m_dtiDuration.GetMicroSeconds ();
+  /* Quick check of the fraction of the DTI requested by the static allocations */
+  double utilization = 0;
+  uint32_t everyBiFlows = 0;
+  uint32_t longestPeriod = biDuration;
+  for (EdfFlowMap::const_iterator it = flows.begin (); it != flows.end (); ++it)
+    {
+      const EdfFlow &flow = it->second;
+      if ((flow.budget == 0) || (flow.budget > MAX_SP_BLOCK_DURATION) || (flow.budget + m_guardTime > flow.period))
+        {
+          return false;
+        }
+      if (flow.field.IsPseudoStatic ())
+        {
+          utilization += static_cast<double> (flow.budget + m_guardTime) / flow.period;
+        }
+      if (flow.period <= biDuration)
+        {
+          everyBiFlows++;
+        }
+      longestPeriod = std::max (longestPeriod, flow.period);
+    }
+  if (utilization * biDuration + m_minBroadcastCbapDuration > dtiDuration)
+    {
+      return false;
+    }
+  /* The flows served in every BI need at least one allocation field each */
+  if (everyBiFlows > MAX_ALLOCATION_FIELDS)
+    {
+      return false;
+    }
+
+  /* Plan the DTIs of the horizon without reporting the jobs */
+  EdfFlowMap candidates = flows;
+  uint32_t intervals = std::max (m_horizon, (longestPeriod + biDuration - 1) / biDuration);
+  int64_t dtiStart = GetNextDtiStart ();
+  DtiAvailableSlots slots;
+  EdfBlocksList blocks;
+  for (uint32_t i = 0; i < intervals; i++)
+    {
+      slots.Reset (dtiDuration);
+      uint32_t fixedFields = ReserveFixedAllocations (slots);
+      uint32_t maxFields = (fixedFields < MAX_ALLOCATION_FIELDS) ? MAX_ALLOCATION_FIELDS - fixedFields : 0;
+      blocks.clear ();
+      if (PlanDataTransferInterval (candidates, dtiStart, slots, maxFields, blocks, false) != 0)
+        {
+          return false;
+        }
+      if (i == 0)
+        {
+          /* Non-static allocations are served in a single BI */
+          for (EdfFlowMapI it = candidates.begin (); it != candidates.end ();)
+            {
+              if (!it->second.field.IsPseudoStatic ())
+                {
+                  it = candidates.erase (it);
+                }
+              else
+                {
+                  ++it;
+                }
+            }
+        }
+      dtiStart += biDuration;
+    }
+  return true;
+}
+
+StatusCode
+EdfDmgWifiScheduler::AddNewAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info)
+{
+  NS_LOG_FUNCTION (this << +sourceAid);
+  uint32_t maxDuration;
+  uint32_t minDuration = dmgTspec.GetMinimumAllocation ();
+  if (info.GetAllocationFormat () == ISOCHRONOUS)
+    {
+      maxDuration = GetAllocationDuration (dmgTspec.GetMinimumAllocation (), dmgTspec.GetMaximumAllocation ());
+    }
+  else if (info.GetAllocationFormat () == ASYNCHRONOUS)
+    {
+      /* for asynchronous allocations, the Maximum Allocation field is reserved (IEEE 802.11ad 8.4.2.136) */
+      maxDuration = minDuration;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Allocation Format not supported");
+    }
+
+  RemoveTerminatedFlows ();
+  UniqueIdentifier id (info.GetAllocationID (), sourceAid, info.GetDestinationAid ());
+  EdfFlowMap candidates = m_flows;
+  EdfFlow &flow = candidates[id];
+  flow.field.SetAsPseudoStatic (info.IsPseudoStatic ());
+  flow.period = GetServiceInterval (dmgTspec);
+  flow.budget = maxDuration;
+  flow.nextRelease = -1;
+  bool schedulable = IsSchedulable (candidates);
+  if (!schedulable && (minDuration < maxDuration))
+    {
+      flow.budget = minDuration;
+      schedulable = IsSchedulable (candidates);
+    }
+
+  StatusCode status;
+  if (schedulable)
+    {
+      NS_LOG_DEBUG ("Accepted flow with period=" << flow.period << " and budget=" << flow.budget);
+      AddAllocationPeriod (info.GetAllocationID (), info.GetAllocationType (), info.IsPseudoStatic (),
+                           sourceAid, info.GetDestinationAid (), 0, flow.budget, 0, 1);
+      flow.field = m_addtsAllocationList.back ();
+      m_flows[id] = flow;
+      status.SetSuccess ();
+    }
+  else
+    {
+      NS_LOG_DEBUG ("The flow would miss its deadlines or make other flows miss theirs");
+      status.SetStatusCodeValue (STATUS_CODE_REJECTED_FOR_DELAY_PERIOD);
+    }
+  return status;
+}
+
+StatusCode
+EdfDmgWifiScheduler::ModifyExistingAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info)
+{
+  NS_LOG_FUNCTION (this << +sourceAid);
+  uint32_t newDuration;
+  if (info.GetAllocationFormat () == ISOCHRONOUS)
+    {
+      newDuration = GetAllocationDuration (dmgTspec.GetMinimumAllocation (), dmgTspec.GetMaximumAllocation ());
+    }
+  else if (info.GetAllocationFormat () == ASYNCHRONOUS)
+    {
+      /* for asynchronous allocations, the Maximum Allocation field is reserved (IEEE 802.11ad 8.4.2.136) */
+      newDuration = dmgTspec.GetMinimumAllocation ();
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Allocation Format not supported");
+    }
+
+  RemoveTerminatedFlows ();
+  UniqueIdentifier id (info.GetAllocationID (), sourceAid, info.GetDestinationAid ());
+  NS_ABORT_MSG_IF (m_flows.find (id) == m_flows.end (), "Required allocation does not exist.");
+  EdfFlowMap candidates = m_flows;
+  EdfFlow &flow = candidates[id];
+  flow.period = GetServiceInterval (dmgTspec);
+  flow.budget = newDuration;
+
+  StatusCode status;
+  if (IsSchedulable (candidates))
+    {
+      NS_LOG_DEBUG ("Modified flow with period=" << flow.period << " and budget=" << flow.budget);
+      for (AllocationFieldListI iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+        {
+          if ((iter->GetAllocationID () == info.GetAllocationID ()) &&
+              (iter->GetSourceAid () == sourceAid) && (iter->GetDestinationAid () == info.GetDestinationAid ()))
+            {
+              iter->SetAllocationBlockDuration (flow.budget);
+              flow.field = *iter;
+              break;
+            }
+        }
+      m_flows[id] = flow;
+      status.SetSuccess ();
+    }
+  else
+    {
+      /* The request cannot be accepted; maintaining old allocation */
+      status.SetFailure ();
+    }
+  return status;
+}
+
+void
+EdfDmgWifiScheduler::AddBroadcastCbapAllocations (void)
+{
+  NS_LOG_FUNCTION (this);
+  RemoveTerminatedFlows ();
+  m_allocationList.clear ();
+
+  /* The allocations that have not been requested with an ADDTS request keep their position */
+  DtiAvailableSlots slots;
+  slots.Reset (m_dtiDuration.GetMicroSeconds ());
+  uint32_t fixedFields = ReserveFixedAllocations (slots);
+  for (AllocationFieldListI iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+    {
+      if (m_flows.find (UniqueIdentifier (iter->GetAllocationID (), iter->GetSourceAid (),
+                                          iter->GetDestinationAid ())) == m_flows.end ())
+        {
+          m_allocationList.push_back (*iter);
+        }
+    }
+
+  /* Place the jobs of the flows */
+  EdfBlocksList blocks;
+  uint32_t maxFields = (fixedFields < MAX_ALLOCATION_FIELDS) ? MAX_ALLOCATION_FIELDS - fixedFields : 0;
+  PlanDataTransferInterval (m_flows, GetNextDtiStart (), slots, maxFields, blocks, true);
+  for (EdfBlocksList::const_iterator it = blocks.begin (); it != blocks.end (); ++it)
+    {
+      const EdfFlow &flow = m_flows[it->flow];
+      AllocationField field = flow.field;
+      field.SetAllocationStart (it->start);
+      field.SetAllocationBlockDuration (flow.budget);
+      field.SetAllocationBlockPeriod (it->period);
+      field.SetNumberOfBlocks (it->blocks);
+      m_allocationList.push_back (field);
+    }
+
+  /* Allocate the time left as broadcast CBAP */
+  for (DtiAvailableSlots::SlotsCI it = slots.Begin (); it != slots.End (); ++it)
+    {
+      AllocationFieldList cbapList = GetBroadcastCbapAllocation (true, it->first, it->second - it->first);
+      for (AllocationFieldListI iter = cbapList.begin (); iter != cbapList.end (); ++iter)
+        {
+          if (m_allocationList.size () < MAX_ALLOCATION_FIELDS)
+            {
+              m_allocationList.push_back (*iter);
+            }
+        }
+    }
+
+  std::sort (m_allocationList.begin (),
+             m_allocationList.end (),
+             [](const AllocationField& lhs, const AllocationField& rhs){
+      return lhs.GetAllocationStart () < rhs.GetAllocationStart ();
+    });
+}
+
+} // namespace ns3
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EDF_DMG_WIFI_SCHEDULER_H
+#define EDF_DMG_WIFI_SCHEDULER_H
+
+#include "dmg-wifi-scheduler.h"
+#include "dti-available-slots.h"
+
+namespace ns3 {
+
+/**
+ * \brief Earliest deadline first scheduling of service periods for IEEE 802.11ad
+ *
+ * Each accepted ADDTS request is handled as a periodic flow: a job is released
+ * at the beginning of every service interval, i.e. every BI / n when the
+ * allocation period of the DMG TSPEC is a fraction n of the BI and every n BIs
+ * when it is a multiple of the BI, and it must be served by a single SP of the
+ * granted duration before the next release (implicit deadline). At the end of
+ * every BI, the pending jobs are placed in the DTI of the next BI in earliest
+ * deadline first order, without preemption, around the allocations that have
+ * not been requested with an ADDTS request (e.g. beamforming SPs). A job that
+ * can no longer meet its deadline is dropped, while a job that does not fit in
+ * the DTI is carried over to the next one. The time left is allocated as
+ * broadcast CBAP.
+ *
+ * A new request is accepted only if the flows, including the new one, still
+ * meet all their deadlines over the schedulability horizon, otherwise it is
+ * rejected with a TS Delay element. The scheduled latency of each job and the
+ * missed deadlines are reported through trace sources.
+ */
+class EdfDmgWifiScheduler : public DmgWifiScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  EdfDmgWifiScheduler ();
+  virtual ~EdfDmgWifiScheduler ();
+
+  /**
+   * TracedCallback signature for a job scheduled in the DTI.
+   *
+   * \param allocationId The ID of the allocation.
+   * \param sourceAid The AID of the source DMG STA.
+   * \param destAid The AID of the destination DMG STA.
+   * \param latency The time from the release of the job to the end of its SP.
+   */
+  typedef void (* JobScheduledCallback)(AllocationID allocationId, uint8_t sourceAid, uint8_t destAid, Time latency);
+  /**
+   * TracedCallback signature for a job that missed its deadline.
+   *
+   * \param allocationId The ID of the allocation.
+   * \param sourceAid The AID of the source DMG STA.
+   * \param destAid The AID of the destination DMG STA.
+   */
+  typedef void (* DeadlineMissedCallback)(AllocationID allocationId, uint8_t sourceAid, uint8_t destAid);
+
+protected:
+  virtual void DoDispose (void);
+  virtual void DoInitialize (void);
+  /**
+   * Handle the end of the BI by planning the DTI of the next BI.
+   */
+  virtual void BeaconIntervalEnded (void);
+  /**
+   * \param minAllocation The minimum acceptable allocation in us for each allocation period.
+   * \param maxAllocation The desired allocation in us for each allocation period.
+   * \return The allocation duration for the allocation period.
+   */
+  virtual uint32_t GetAllocationDuration (uint32_t minAllocation, uint32_t maxAllocation);
+  /**
+   * Implement the policy that accept, reject a new ADDTS request.
+   * \param sourceAid The AID of the requesting STA.
+   * \param dmgTspec The DMG Tspec element of the ADDTS request.
+   * \param info The DMG Allocation Info element of the request.
+   * \return The Status Code to be included in the ADDTS response.
+   */
+  virtual StatusCode AddNewAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info);
+  /**
+   * Implement the policy that accept, reject a modification request.
+   * \param sourceAid The AID of the requesting STA.
+   * \param dmgTspec The DMG Tspec element of the ADDTS request.
+   * \param info The DMG Allocation Info element of the request.
+   * \return The Status Code to be included in the ADDTS response.
+   */
+  virtual StatusCode ModifyExistingAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info);
+  /**
+   * The requested allocations are placed in the DTI at the end of every BI,
+   * so nothing has to be adjusted here.
+   * \param iter The iterator pointing to the next element in the addtsAllocationList.
+   * \param duration The duration of the time to manage.
+   * \param isToAdd Whether the duration is to be added or subtracted.
+   */
+  virtual void AdjustExistingAllocations (AllocationFieldListI iter, uint32_t duration, bool isToAdd);
+  /**
+   * \return The TS Delay element to be included in the ADDTS response.
+   */
+  virtual TsDelayElement GetTsDelayElement (void);
+  /**
+   * Update start time and remaining DTI time for the next request to be evaluated.
+   */
+  virtual void UpdateStartAndRemainingTime (void);
+  /**
+   * Plan the DTI of the next BI and add broadcast CBAP allocations in the time left.
+   */
+  virtual void AddBroadcastCbapAllocations (void);
+
+private:
+  /**
+   * A periodic flow granted with an ADDTS request.
+   */
+  struct EdfFlow
+  {
+    AllocationField field;  //!< The allocation field announced for every job of the flow.
+    uint32_t period;        //!< The service interval in microseconds.
+    uint32_t budget;        //!< The duration of the SP serving a job in microseconds.
+    int64_t nextRelease;    //!< The absolute release time in microseconds of the pending job, or -1 if not released yet.
+  };
+  typedef std::map<UniqueIdentifier, EdfFlow> EdfFlowMap;
+  typedef EdfFlowMap::iterator EdfFlowMapI;
+
+  /**
+   * Equally spaced SPs of a flow placed in the DTI, announced by a single allocation field.
+   */
+  struct EdfBlocks
+  {
+    UniqueIdentifier flow;  //!< The flow served by the SPs.
+    uint32_t start;         //!< The start time of the first SP relative to the beginning of the DTI.
+    uint32_t period;        //!< The time between the start of two consecutive SPs.
+    uint32_t blocks;        //!< The number of SPs.
+  };
+  typedef std::vector<EdfBlocks> EdfBlocksList;
+
+  /**
+   * Handle the start of the DTI.
+   * \param address The MAC address of the PCP/AP.
+   * \param dtiDuration The duration of the current DTI.
+   */
+  void DataTransferIntervalStarted (Mac48Address address, Time dtiDuration);
+  /**
+   * \return The absolute start time in microseconds of the DTI of the next BI.
+   */
+  int64_t GetNextDtiStart (void) const;
+  /**
+   * \param dmgTspec The DMG Tspec element of the ADDTS request.
+   * \return The service interval in microseconds requested by the DMG TSPEC.
+   */
+  uint32_t GetServiceInterval (const DmgTspecElement &dmgTspec) const;
+  /**
+   * Make the allocations that have not been requested with an ADDTS request
+   * unavailable to the flows.
+   * \param slots The available time of the DTI.
+   * \return The number of such allocations.
+   */
+  uint32_t ReserveFixedAllocations (DtiAvailableSlots &slots) const;
+  /**
+   * Place the pending jobs of the flows in a DTI in earliest deadline first order.
+   * The release time of the jobs which are either served or dropped is advanced.
+   * \param flows The flows to schedule.
+   * \param dtiStart The absolute start time in microseconds of the DTI.
+   * \param slots The available time of the DTI, from which the placed SPs are reserved.
+   * \param maxFields The maximum number of allocation fields that can announce the SPs.
+   * \param blocks The SPs placed in the DTI.
+   * \param report Whether to report the scheduled and dropped jobs.
+   * \return The number of jobs which missed their deadline.
+   */
+  uint32_t PlanDataTransferInterval (EdfFlowMap &flows, int64_t dtiStart, DtiAvailableSlots &slots,
+                                     uint32_t maxFields, EdfBlocksList &blocks, bool report);
+  /**
+   * Check whether the given flows meet all their deadlines over the schedulability horizon.
+   * \param flows The flows to check.
+   * \return true if the flows are schedulable.
+   */
+  bool IsSchedulable (const EdfFlowMap &flows);
+  /**
+   * Remove the flows whose allocation has been removed by a DELTS request or by the cleanup
+   * of non-static allocations.
+   */
+  void RemoveTerminatedFlows (void);
+
+  EdfFlowMap m_flows;                           //!< The flows granted with an ADDTS request.
+  Time m_lastDtiStart;                          //!< The start time of the last DTI.
+  uint32_t m_horizon;                           //!< The number of BIs over which the admission of a request is checked.
+  uint32_t m_minBroadcastCbapDuration;          //!< The minimum duration of broadcast CBAP to keep in the DTI.
+
+  TracedCallback<AllocationID, uint8_t, uint8_t, Time> m_jobScheduled;  //!< Trace source for the scheduled jobs.
+  TracedCallback<AllocationID, uint8_t, uint8_t> m_deadlineMissed;      //!< Trace source for the missed deadlines.
+
+};
+
+} // namespace ns3
+
+#endif /* EDF_DMG_WIFI_SCHEDULER_H */
@@ -531,6 +531,13 @@ DMG_SSW_FBCK_Field::GetDMGAntenna (void) const
   return m_antennas;
 }
 
+uint8_t
+DMG_SSW_FBCK_Field::GetSNRReport (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_snr_report;
+}
+
 bool
 DMG_SSW_FBCK_Field::GetPollRequired (void) const
 {
@@ -238,6 +238,7 @@ public:
   void IsPartOfISS (bool value);
   uint16_t GetSector (void) const;
   uint8_t GetDMGAntenna (void) const;
+  uint8_t GetSNRReport (void) const;
   bool GetPollRequired (void) const;
   uint8_t GetReserved (void) const;
 
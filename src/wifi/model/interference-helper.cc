@@ -26,6 +26,7 @@
 #include "wifi-phy.h"
 #include "error-rate-model.h"
 #include "wifi-utils.h"
+#include <limits>
 
 namespace ns3 {
 
@@ -131,7 +132,10 @@ InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_numRxAntennas (1),
     m_firstPower (0),
-    m_rxing (false)
+    m_rxing (false),
+    m_maxNiChanges (std::numeric_limits<uint32_t>::max ()),
+    m_prunedNiChanges (0),
+    m_nextObservation (0)
 {
   // Always have a zero power noise event in the list
   AddNiChangeEvent (Time (0), NiChange (0.0, 0));
@@ -139,6 +143,7 @@ InterferenceHelper::InterferenceHelper ()
 
 InterferenceHelper::~InterferenceHelper ()
 {
+  m_observations.clear ();
   EraseEvents ();
   m_errorRateModel = 0;
 }
@@ -234,6 +239,7 @@ InterferenceHelper::AppendEvent (Ptr<Event> event)
 
   if (!m_rxing)
     {
+      UpdateObservations (event->GetStartTime ());
       m_firstPower = previousPowerStart;
       // Always leave the first zero power noise event in the list
       m_niChanges.erase (++(m_niChanges.begin ()),
@@ -245,6 +251,7 @@ InterferenceHelper::AppendEvent (Ptr<Event> event)
     {
       i->second.AddPower (event->GetRxPowerW ());
     }
+  PruneNiChanges ();
 }
 
 double
@@ -263,7 +270,7 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint1
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiRange *ni) const
 {
   double noiseInterferenceW = m_firstPower;
   auto it = m_niChanges.find (event->GetStartTime ());
@@ -276,14 +283,17 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni
         }
       noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW ();
     }
-  it = m_niChanges.find (event->GetStartTime ());
-  for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
-  while (++it != m_niChanges.end () && it->second.GetEvent () != event)
+  if (ni != 0)
     {
-      ni->insert (*it);
+      /* The NiChanges of the event are walked in place rather than copied */
+      it = m_niChanges.find (event->GetStartTime ());
+      for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
+      NS_ASSERT_MSG (it != m_niChanges.end (), "No NiChange at the start of the event");
+      ni->first = it;
+      while (++it != m_niChanges.end () && it->second.GetEvent () != event);
+      NS_ASSERT_MSG (it != m_niChanges.end (), "No NiChange at the end of the event");
+      ni->second = ++it;
     }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -311,12 +321,12 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
 }
 
 double
-InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const Event> event, const NiRange &ni) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = ni.first;
   Time previous = j->first;
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = txVector.GetPreambleType ();
@@ -326,7 +336,7 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *
   Time plcpPayloadStart = plcpTrainingSymbolsStart + m_wifiPhy->GetPlcpTrainingSymbolDuration (txVector) + m_wifiPhy->GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  while (++j != ni.second)
     {
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -359,12 +369,12 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *
 }
 
 double
-InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const Event> event, const NiRange &ni) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = ni.first;
   Time previous = j->first;
   WifiPreamble preamble = txVector.GetPreambleType ();
   WifiMode mcsHeaderMode;
@@ -390,7 +400,7 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *n
   Time plcpPayloadStart = plcpTrainingSymbolsStart + m_wifiPhy->GetPlcpTrainingSymbolDuration (txVector) + m_wifiPhy->GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  while (++j != ni.second)
     {
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -777,8 +787,7 @@ double
 InterferenceHelper::CalculatePlcpTrnSnr (Ptr<Event> event)
 {
   NS_LOG_FUNCTION (this << event);
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, 0);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -789,7 +798,7 @@ struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<Event> event) const
 {
   NS_LOG_FUNCTION (this << event);
-  NiChanges ni;
+  NiRange ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
@@ -797,7 +806,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<Event> event) const
   /* calculate the SNIR at the start of the packet and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpPayloadPer (event, &ni);
+  double per = CalculatePlcpPayloadPer (event, ni);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -808,7 +817,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<Event> event) const
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
 {
-  NiChanges ni;
+  NiRange ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
@@ -817,7 +826,7 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpHeaderPer (event, &ni);
+  double per = CalculatePlcpHeaderPer (event, ni);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -828,11 +837,176 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<Event> event) const
 void
 InterferenceHelper::EraseEvents (void)
 {
+  if (!m_observations.empty ())
+    {
+      UpdateObservations (Simulator::Now ());
+    }
   m_niChanges.clear ();
   // Always have a zero power noise event in the list
   AddNiChangeEvent (Time (0), NiChange (0.0, 0));
   m_rxing = false;
   m_firstPower = 0;
+  m_prunedNiChanges = 0;
+  if (!m_niChangesSizeCallback.IsNull ())
+    {
+      m_niChangesSizeCallback (m_niChanges.size ());
+    }
+}
+
+void
+InterferenceHelper::SetMaxNiChanges (uint32_t maxSize)
+{
+  NS_LOG_FUNCTION (this << maxSize);
+  NS_ASSERT_MSG (maxSize >= 2, "The timeline needs room for at least two NiChanges");
+  m_maxNiChanges = maxSize;
+}
+
+uint32_t
+InterferenceHelper::GetMaxNiChanges (void) const
+{
+  return m_maxNiChanges;
+}
+
+uint32_t
+InterferenceHelper::GetNiChangesSize (void) const
+{
+  return m_niChanges.size ();
+}
+
+void
+InterferenceHelper::SetNiChangesSizeCallback (Callback<void, uint32_t> callback)
+{
+  m_niChangesSizeCallback = callback;
+}
+
+void
+InterferenceHelper::PruneNiChanges (void)
+{
+  NS_LOG_FUNCTION (this);
+  /* The NiChanges of the ended signals are only pruned once the timeline has
+   * doubled since the previous pruning, or exceeds the cap, so that the scan
+   * below costs a constant amortized time per signal. */
+  if (m_niChanges.size () < 2 * m_prunedNiChanges && m_niChanges.size () <= m_maxNiChanges)
+    {
+      if (!m_niChangesSizeCallback.IsNull ())
+        {
+          m_niChangesSizeCallback (m_niChanges.size ());
+        }
+      return;
+    }
+
+  Time now = Simulator::Now ();
+  if (!m_observations.empty ())
+    {
+      /* Integrate the observations before the NiChanges they need go away */
+      UpdateObservations (now);
+    }
+
+  /* Every signal starts when it is added, so the first NiChange of a signal
+   * that has not ended yet belongs to the longest in-flight signal. */
+  auto inFlight = ++m_niChanges.begin ();
+  while (inFlight != m_niChanges.end () && inFlight->second.GetEvent ()->GetEndTime () < now)
+    {
+      ++inFlight;
+    }
+  /* Keep the last NiChange before it, which holds the current power level */
+  auto level = inFlight;
+  --level;
+  if (level != m_niChanges.begin ())
+    {
+      m_niChanges.erase (++m_niChanges.begin (), level);
+    }
+
+  if (m_niChanges.size () > m_maxNiChanges)
+    {
+      /* Drop the oldest history, but never the NiChanges of the frame being
+       * received, the current power level or the future NiChanges. */
+      Time limit = m_rxing ? std::min (m_rxStart, now) : now;
+      auto it = ++m_niChanges.begin ();
+      while (m_niChanges.size () > m_maxNiChanges && it->first < limit)
+        {
+          auto next = it;
+          ++next;
+          if (next == m_niChanges.end () || next->first > limit)
+            {
+              break;
+            }
+          it = m_niChanges.erase (it);
+        }
+      NS_LOG_DEBUG ("Timeline capped to " << m_niChanges.size () << " NiChanges");
+    }
+  m_prunedNiChanges = m_niChanges.size ();
+
+  if (!m_niChangesSizeCallback.IsNull ())
+    {
+      m_niChangesSizeCallback (m_niChanges.size ());
+    }
+}
+
+uint32_t
+InterferenceHelper::StartObservation (const std::vector<std::pair<Time, Time> > &windows)
+{
+  NS_LOG_FUNCTION (this << windows.size ());
+  NS_ASSERT (!windows.empty () && windows.front ().first >= Simulator::Now ());
+  Observation observation;
+  observation.windows = windows;
+  observation.energy.assign (windows.size (), 0);
+  observation.integrated = Simulator::Now ();
+  m_observations[m_nextObservation] = observation;
+  return m_nextObservation++;
+}
+
+std::vector<double>
+InterferenceHelper::EndObservation (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  std::map<uint32_t, Observation>::iterator it = m_observations.find (id);
+  NS_ASSERT_MSG (it != m_observations.end (), "Unknown observation " << id);
+  NS_ASSERT (it->second.windows.back ().second <= Simulator::Now ());
+  UpdateObservations (Simulator::Now ());
+  std::vector<double> powerW (it->second.windows.size ());
+  for (uint32_t i = 0; i < powerW.size (); i++)
+    {
+      Time duration = it->second.windows[i].second - it->second.windows[i].first;
+      powerW[i] = duration.IsStrictlyPositive () ? it->second.energy[i] / duration.GetSeconds () : 0;
+    }
+  m_observations.erase (it);
+  return powerW;
+}
+
+void
+InterferenceHelper::UpdateObservations (Time moment)
+{
+  for (std::map<uint32_t, Observation>::iterator obs = m_observations.begin (); obs != m_observations.end (); ++obs)
+    {
+      Observation &observation = obs->second;
+      Time end = std::min (moment, observation.windows.back ().second);
+      if (end <= observation.integrated)
+        {
+          continue;
+        }
+      /* The power is constant between two consecutive NiChanges */
+      auto it = GetPreviousPosition (observation.integrated);
+      Time start = observation.integrated;
+      while (start < end)
+        {
+          auto next = it;
+          ++next;
+          Time stop = (next == m_niChanges.end () || next->first > end) ? end : next->first;
+          for (uint32_t i = 0; i < observation.windows.size (); i++)
+            {
+              Time from = std::max (start, observation.windows[i].first);
+              Time to = std::min (stop, observation.windows[i].second);
+              if (to > from)
+                {
+                  observation.energy[i] += it->second.GetPower () * (to - from).GetSeconds ();
+                }
+            }
+          start = stop;
+          it = next;
+        }
+      observation.integrated = end;
+    }
 }
 
 InterferenceHelper::NiChanges::const_iterator
@@ -862,6 +1036,7 @@ InterferenceHelper::NotifyRxStart ()
 {
   NS_LOG_FUNCTION (this);
   m_rxing = true;
+  m_rxStart = Simulator::Now ();
 }
 
 void
@@ -873,6 +1048,7 @@ InterferenceHelper::NotifyRxEnd ()
   auto it = m_niChanges.find (Simulator::Now ());
   it--;
   m_firstPower = it->second.GetPower ();
+  PruneNiChanges ();
 }
 
 } //namespace ns3
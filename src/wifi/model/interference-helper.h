@@ -22,8 +22,10 @@
 #define INTERFERENCE_HELPER_H
 
 #include "ns3/nstime.h"
+#include "ns3/callback.h"
 #include "wifi-tx-vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -236,6 +238,61 @@ public:
    */
   void EraseEvents (void);
 
+  /**
+   * Set the maximum number of NiChanges kept in the timeline. NiChanges
+   * that no in-flight signal refers to are always pruned; this cap
+   * additionally drops the oldest history when many signals overlap, but
+   * never the NiChanges of the frame being received nor future ones.
+   *
+   * \param maxSize the maximum number of NiChanges, at least 2
+   */
+  void SetMaxNiChanges (uint32_t maxSize);
+  /**
+   * \return the maximum number of NiChanges kept in the timeline
+   */
+  uint32_t GetMaxNiChanges (void) const;
+  /**
+   * \return the number of NiChanges currently in the timeline
+   */
+  uint32_t GetNiChangesSize (void) const;
+  /**
+   * Set the callback invoked with the number of NiChanges whenever
+   * the timeline grows or is pruned.
+   *
+   * \param callback the callback
+   */
+  void SetNiChangesSizeCallback (Callback<void, uint32_t> callback);
+
+  /**
+   * Start observing the noise and interference power during a set of time windows
+   * without adding an event for each of them, e.g., for the frames of an abstracted
+   * sector sweep.
+   *
+   * \param windows the start and end time of each window, in increasing order and
+   *        not earlier than now
+   *
+   * \return the identifier of the observation
+   */
+  uint32_t StartObservation (const std::vector<std::pair<Time, Time> > &windows);
+  /**
+   * Stop an observation once all its windows are over.
+   *
+   * \param id the identifier returned by StartObservation
+   *
+   * \return the mean noise and interference power (W) during each window
+   */
+  std::vector<double> EndObservation (uint32_t id);
+  /**
+   * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
+   *
+   * \param signal signal power, W
+   * \param noiseInterference noise and interference power, W
+   * \param channelWidth signal width in MHz
+   *
+   * \return SNR in linear ratio
+   */
+  double CalculateSnr (double signal, double noiseInterference, uint16_t channelWidth) const;
+
 
 private:
   /**
@@ -280,6 +337,11 @@ private:
    * typedef for a multimap of NiChanges
    */
   typedef std::multimap<Time, NiChange> NiChanges;
+  /**
+   * typedef for the NiChanges of an event, from the one at its start time
+   * up to (and including) the one at its end time
+   */
+  typedef std::pair<NiChanges::const_iterator, NiChanges::const_iterator> NiRange;
 
   /**
    * Append the given Event.
@@ -291,21 +353,11 @@ private:
    * Calculate noise and interference power in W.
    *
    * \param event
-   * \param ni
+   * \param ni the NiChanges of the event, or 0 if they are not needed
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
-  /**
-   * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
-   *
-   * \param signal signal power, W
-   * \param noiseInterference noise and interference power, W
-   * \param channelWidth signal width in MHz
-   *
-   * \return SNR in linear ratio
-   */
-  double CalculateSnr (double signal, double noiseInterference, uint16_t channelWidth) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiRange *ni) const;
   /**
    * Calculate the success rate of the chunk given the SINR, duration, and Wi-Fi mode.
    * The duration and mode are used to calculate how many bits are present in the chunk.
@@ -327,7 +379,7 @@ private:
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event, const NiRange &ni) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
@@ -337,7 +389,7 @@ private:
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event, const NiRange &ni) const;
 
   Ptr<WifiPhy> m_wifiPhy;
   double m_noiseFigure; /**< noise figure (linear) */
@@ -347,6 +399,38 @@ private:
   NiChanges m_niChanges;
   double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
+  Time m_rxStart; ///< start time of the frame being received
+  uint32_t m_maxNiChanges; ///< maximum number of NiChanges
+  uint32_t m_prunedNiChanges; ///< number of NiChanges left by the previous pruning
+  Callback<void, uint32_t> m_niChangesSizeCallback; ///< callback notified of the number of NiChanges
+
+  /**
+   * Erase the NiChanges that precede every in-flight signal, keeping the
+   * last of them as the current power level, then enforce the cap on
+   * the number of NiChanges. Nothing is erased until the timeline has
+   * doubled since the previous pruning, unless it exceeds the cap.
+   */
+  void PruneNiChanges (void);
+
+  /**
+   * Noise and interference energy accumulated over the windows of an observation.
+   */
+  struct Observation
+  {
+    std::vector<std::pair<Time, Time> > windows; ///< start and end time of each window
+    std::vector<double> energy; ///< energy accumulated in each window (J)
+    Time integrated; ///< time up to which the energy has been accumulated
+  };
+  std::map<uint32_t, Observation> m_observations; ///< ongoing observations
+  uint32_t m_nextObservation; ///< identifier of the next observation
+
+  /**
+   * Accumulate the noise and interference energy of the ongoing observations up to
+   * the given time, before the NiChanges preceding it are erased.
+   *
+   * \param moment the time up to which to accumulate
+   */
+  void UpdateObservations (Time moment);
 
   /**
    * Returns an iterator to the first nichange that is later than moment
@@ -22,6 +22,7 @@
 #define ORIGINATOR_BLOCK_ACK_AGREEMENT_H
 
 #include "block-ack-agreement.h"
+#include "block-ack-scoreboard.h"
 
 namespace ns3 {
 
@@ -165,6 +166,7 @@ private:
   State m_state; ///< state
   uint16_t m_sentMpdus; ///< sent MPDUs
   bool m_needBlockAckReq; ///< flag whether it needs a Block ACK request
+  BlockAckScoreboard m_retryScoreboard; ///< sequence numbers in the retransmission queue of the BlockAckManager
 };
 
 } //namespace ns3
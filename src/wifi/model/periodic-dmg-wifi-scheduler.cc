@@ -45,6 +45,7 @@ PeriodicDmgWifiScheduler::GetTypeId (void)
 }
 
 PeriodicDmgWifiScheduler::PeriodicDmgWifiScheduler ()
+  : m_availableSlotsOutdated (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -71,18 +72,15 @@ PeriodicDmgWifiScheduler::UpdateStartAndRemainingTime (void)
     {
       // no existing allocations
       m_remainingDtiTime = m_dtiDuration.GetMicroSeconds ();
-      // clear the list of available slots: if no allocations have been scheduled, then the DTI is completely available
-      m_availableSlots.clear ();
-      m_availableSlots.push_back (std::make_pair (0, m_remainingDtiTime));
+      // reset the available slots: if no allocations have been scheduled, then the DTI is completely available
+      m_availableSlots.Reset (m_remainingDtiTime);
+      m_availableSlotsOutdated = false;
     }
   else
     {
       // if there are existing allocations, update DTI time just for consistency
-      m_remainingDtiTime = 0;
-      for (const auto & slot: m_availableSlots)
-        {
-          m_remainingDtiTime += (slot.second - slot.first);
-        }
+      RefreshAvailableSlots ();
+      m_remainingDtiTime = m_availableSlots.GetAvailableTime ();
     }
 }
 
@@ -94,39 +92,43 @@ PeriodicDmgWifiScheduler::AdjustExistingAllocations (AllocationFieldListI iter,
   // This method is called upon a DelTsRequest or after the cleanup of 
   // non-pseudostatic allocations.
   // In this version of the periodic scheduler, existing allocations are not shifted 
-  // to fill the created gaps but only the vector listing the available slots is updated.
+  // to fill the created gaps but only the available slots are updated.
   // For this reason, the current input parameters are useless.
+  // The cleanup removes many allocations in a row, so the available slots are
+  // rebuilt once, the next time they are needed.
+  m_availableSlotsOutdated = true;
+}
 
-  auto addtsListCopy = m_addtsAllocationList;
-
-  // sort the copy to simplify the process of going through the allocation list
-  sort (addtsListCopy.begin (),
-        addtsListCopy.end (),
-        [](const AllocationField& lhs, const AllocationField& rhs){
-      return lhs.GetAllocationStart () < rhs.GetAllocationStart ();
-    });
+void
+PeriodicDmgWifiScheduler::RefreshAvailableSlots (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_availableSlotsOutdated)
+    {
+      return;
+    }
+  m_availableSlotsOutdated = false;
 
   uint32_t startAlloc, endAlloc;
 
-  // reset m_remainingDtiTime
-  m_remainingDtiTime = m_dtiDuration.GetMicroSeconds ();
-  // clear m_availableSlots and refill it based on the updated m_addtsAllocationList
-  m_availableSlots.clear ();
-  m_availableSlots.push_back (std::make_pair (0, m_remainingDtiTime));
+  // make the whole DTI available and reserve the blocks of the remaining allocations
+  m_availableSlots.Reset (m_dtiDuration.GetMicroSeconds ());
 
-  for (const auto & allocation: addtsListCopy)
+  for (const auto & allocation: m_addtsAllocationList)
     {
       startAlloc = allocation.GetAllocationStart ();
       endAlloc = startAlloc + allocation.GetAllocationBlockDuration () + m_guardTime;
       // if the number of blocks allocated is > 1, the allocation is periodic 
       for (uint8_t i = 0; i < allocation.GetNumberOfBlocks (); ++i)
         {
-          UpdateAvailableSlots (startAlloc, endAlloc);
+          m_availableSlots.Reserve (startAlloc, endAlloc);
           startAlloc += allocation.GetAllocationBlockPeriod ();
           endAlloc += allocation.GetAllocationBlockPeriod ();
           // AllocationBlockPeriod represents the time between the start of two consecutive time blocks belonging to the same allocation
         }
     }
+  m_remainingDtiTime = m_availableSlots.GetAvailableTime ();
+  NS_LOG_DEBUG ("Available slots: " << m_availableSlots);
 }
 
 uint32_t
@@ -144,7 +146,8 @@ PeriodicDmgWifiScheduler::AddNewAllocation (uint8_t sourceAid, const DmgTspecEle
   StatusCode status;
   uint32_t allocDuration, minimumAllocation;
 
-  if (m_availableSlots.empty ())
+  RefreshAvailableSlots ();
+  if (m_availableSlots.IsEmpty ())
     {
       NS_LOG_DEBUG ("There are no free available slots in the DTI.");
       status.SetFailure ();
@@ -279,45 +282,24 @@ PeriodicDmgWifiScheduler::GetAvailableBlocks (uint32_t allocDuration, uint32_t s
 {
   NS_LOG_FUNCTION (this << allocDuration << spInterval << +maxBlocksNumber);
 
-  auto it = m_availableSlots.begin ();
-  uint32_t startNextAlloc = it->first;
-  uint32_t remainingSlotDuration = 0;
   std::vector<uint32_t> blocks;
 
-  while (it != m_availableSlots.end ())
+  // go on until eventually find the first available slot that fits this SP
+  // note that this also cover the condition where no slot satisfies the requirement
+  DtiAvailableSlots::SlotsCI it = m_availableSlots.Begin ();
+  while ((it != m_availableSlots.End ()) && (allocDuration + m_guardTime > it->second - it->first))
     {
-      if (startNextAlloc < it->first || startNextAlloc > m_availableSlots.back().second)
-        {
-          // The next periodic SP block is positioned before the beginning of the 
-          // next available slot: this translates in a broken periodicity, and the 
-          // algorithm stops.
-          // Or, if the start of the next allocation is greater than the duration of
-          // the DTI, then the algorithm stops.
-          break;
-        }
-
-      remainingSlotDuration = it->second - startNextAlloc;
-
-      if (allocDuration + m_guardTime > remainingSlotDuration)
-        {
-          if (blocks.size () == 0)
-            {
-              // go on until eventually find the first available slot that fits this SP
-              // note that this also cover the condition where no slot satisfies the requirement
-              ++it;
-              startNextAlloc = it->first;
-              continue;
-            }
-          else
-            {
-              // if one or more periodic SPs already allocated, now the periodicity
-              // is broken and the algorithm stops
-              break;
-            }
-        }
+      ++it;
+    }
+  if (it == m_availableSlots.End ())
+    {
+      return blocks;
+    }
 
+  uint32_t startNextAlloc = it->first;
+  while (true)
+    {
       blocks.push_back (startNextAlloc);
-      startNextAlloc += spInterval;
 
       if (blocks.size () == maxBlocksNumber)
         {
@@ -325,11 +307,14 @@ PeriodicDmgWifiScheduler::GetAvailableBlocks (uint32_t allocDuration, uint32_t s
           break;
         }
 
-      // if next allocation period exceeds the current available slot's boundaries
-      // proceed to the next one
-      if (startNextAlloc > it->second)
+      startNextAlloc += spInterval;
+      it = m_availableSlots.Find (startNextAlloc);
+      if ((it == m_availableSlots.End ()) || (allocDuration + m_guardTime > it->second - startNextAlloc))
         {
-          ++it;
+          // The next periodic SP block does not fit in an available slot, or it
+          // starts after the end of the DTI: the periodicity is broken and the
+          // algorithm stops.
+          break;
         }
     }
 
@@ -341,57 +326,23 @@ PeriodicDmgWifiScheduler::UpdateAvailableSlots (uint32_t startAlloc, uint32_t en
 {
   NS_LOG_FUNCTION (this << startAlloc << endAlloc);
 
-  uint32_t startSlot, endSlot;
-
-  for (auto it = m_availableSlots.begin (); it != m_availableSlots.end (); ++it)
+  DtiAvailableSlots::SlotsCI slot = m_availableSlots.Find (startAlloc);
+  if (slot == m_availableSlots.End ())
     {
-      startSlot = it->first;
-      endSlot = it->second;
-
-      if (startSlot > endAlloc || endSlot < startAlloc)
-        {
-          continue;
-        }
-
-      if (startSlot == startAlloc)
-        {
-          it->first = endAlloc;
-          break;
-        }
-      else if (startSlot < startAlloc)
-        {
-          if (endSlot > endAlloc)
-            {
-              it->first = endAlloc;
-              m_availableSlots.insert (it, std::make_pair (startSlot, startAlloc));
-              break;
-            }
-          else if (endSlot == endAlloc)
-            {
-              it->second = startAlloc;
-              break;
-            }
-          else
-            {
-              // endAlloc could never be greater than endSlot, as this condition is already checked
-              // upon calling GetAvailableBlocks inside AddNewAllocation.
-              NS_FATAL_ERROR ("(endAlloc > endSlot) : by construction, this shouldn't have happened.");
-            }
-        }
-      else 
-        {
-          NS_FATAL_ERROR ("RUNTIME ERROR.");
-        }
-
+      NS_FATAL_ERROR ("RUNTIME ERROR.");
+    }
+  else if (slot->second < endAlloc)
+    {
+      // endAlloc could never be greater than endSlot, as this condition is already checked
+      // upon calling GetAvailableBlocks inside AddNewAllocation.
+      NS_FATAL_ERROR ("(endAlloc > endSlot) : by construction, this shouldn't have happened.");
     }
+  m_availableSlots.Reserve (startAlloc, endAlloc);
 
   // update m_remainingDtiTime for consistency 
-  m_remainingDtiTime -= (endAlloc - startAlloc);
+  m_remainingDtiTime = m_availableSlots.GetAvailableTime ();
 
-  for (const auto & slot : m_availableSlots)
-    {
-      NS_LOG_DEBUG ("Available slot from " << slot.first << " to " << slot.second);
-    }
+  NS_LOG_DEBUG ("Available slots: " << m_availableSlots);
 }
 
 void
@@ -399,58 +350,28 @@ PeriodicDmgWifiScheduler::UpdateAvailableSlots (uint32_t startAlloc, uint32_t ne
 {
   NS_LOG_FUNCTION (this << startAlloc << newEndAlloc << difference);
 
-  uint32_t startSlot;
-
-  // something has changed in the allocation list, need to change the list of 
-  // available slots accordingly
-  bool keepSearching = true;
-  for (auto it = m_availableSlots.begin (); it != m_availableSlots.end (); ++it)
+  // the allocation, before its reduction, must not overlap the available slots
+  uint32_t firstAvailable;
+  if (m_availableSlots.FindFirstFit (startAlloc, 1, firstAvailable))
     {
-      startSlot = it->first;
-
-      if (startSlot < startAlloc)
+      if (firstAvailable <= newEndAlloc)
         {
-          continue;
-        }
-
-      if (newEndAlloc < startSlot)
-        {
-          // the following snippet ensures that the search is carried on until 
-          // we find the empty gap created by the allocation time reduction
-          // and we add it to the list of available slots 
-          if (keepSearching)
-            {
-              if (difference == (startSlot - newEndAlloc))
-                {
-                  // two adjacent available slots are merged 
-                  it->first = newEndAlloc;
-                  keepSearching = false;
-                  break;
-                }
-              else if (difference < (startSlot - newEndAlloc))
-                {
-                  // this condition is verified when there is one or more allocations 
-                  // between the gap and the following available slot
-                  m_availableSlots.insert (it, std::make_pair (newEndAlloc, newEndAlloc + difference));
-                  keepSearching = false;
-                  break;
-                }
-              NS_ASSERT_MSG (difference <= (startSlot - newEndAlloc), "Something broke in runtime, check the update of the available slots.");
-            }
+          NS_FATAL_ERROR ("An increase in SP block duration is not supported yet.");
         }
-      else
+      else if (firstAvailable < newEndAlloc + difference)
         {
-          NS_FATAL_ERROR ("An increase in SP block duration is not supported yet.");
+          NS_FATAL_ERROR ("Something broke in runtime, check the update of the available slots.");
         }
     }
 
-  m_remainingDtiTime += difference;
+  // something has changed in the allocation list: the gap created by the
+  // allocation time reduction is added to the available slots, and merged
+  // with the adjacent ones
+  m_availableSlots.Release (newEndAlloc, newEndAlloc + difference);
 
-  for (const auto & slot : m_availableSlots)
-    {
-      NS_LOG_DEBUG ("Available slot from " << slot.first << " to " << slot.second);
-    }
+  m_remainingDtiTime = m_availableSlots.GetAvailableTime ();
 
+  NS_LOG_DEBUG ("Available slots: " << m_availableSlots);
 }
 
 StatusCode
@@ -460,6 +381,7 @@ PeriodicDmgWifiScheduler::ModifyExistingAllocation (uint8_t sourceAid, const Dmg
 
   StatusCode status;
   uint32_t newDuration;
+  RefreshAvailableSlots ();
   if (info.GetAllocationFormat () == ISOCHRONOUS)
     {
       newDuration = GetAllocationDuration (dmgTspec.GetMinimumAllocation (), dmgTspec.GetMaximumAllocation ());
@@ -539,12 +461,13 @@ PeriodicDmgWifiScheduler::AddBroadcastCbapAllocations (void)
 
   // fill all the remaining available slots with broadcast CBAPs
 
-  for (const auto & slot : m_availableSlots)
+  RefreshAvailableSlots ();
+  for (DtiAvailableSlots::SlotsCI slot = m_availableSlots.Begin (); slot != m_availableSlots.End (); ++slot)
     {
-      broadcastCbapList = GetBroadcastCbapAllocation (true, slot.first, slot.second - slot.first);
-      m_remainingDtiTime -= slot.second - slot.first;
+      broadcastCbapList = GetBroadcastCbapAllocation (true, slot->first, slot->second - slot->first);
+      m_remainingDtiTime -= slot->second - slot->first;
       m_allocationList.insert (m_allocationList.begin (), broadcastCbapList.begin (), broadcastCbapList.end ());
-      NS_LOG_DEBUG ("Added broadcast CBAPs list of size: " << broadcastCbapList.size () << " for a total duration of " << slot.second - slot.first);
+      NS_LOG_DEBUG ("Added broadcast CBAPs list of size: " << broadcastCbapList.size () << " for a total duration of " << slot->second - slot->first);
     }
 
   sort (m_allocationList.begin (),
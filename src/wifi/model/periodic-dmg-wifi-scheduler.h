@@ -23,6 +23,7 @@
 #define PERIODIC_DMG_WIFI_SCHEDULER_H
 
 #include "dmg-wifi-scheduler.h"
+#include "dti-available-slots.h"
 
 namespace ns3 {
 /**
@@ -110,10 +111,14 @@ private:
    * \param difference it represents how much an allocation has been reduced.
    */
   void UpdateAvailableSlots (uint32_t startAlloc, uint32_t newEndAlloc, uint32_t difference);
+  /**
+   * Rebuild the available time slots in the DTI from the list of allocations, if allocations
+   * have been removed since the last update.
+   */
+  void RefreshAvailableSlots (void);
 
-  // std::pair<uint32_t, uint32_t> is a struct used to store the start and 
-  // end time (first and second member of the pair, respectively) of the available time chunks
-  std::list<std::pair<uint32_t, uint32_t> > m_availableSlots;       //!< List of available time chunks in the DTI.
+  DtiAvailableSlots m_availableSlots;           //!< Index of the available time chunks in the DTI.
+  bool m_availableSlotsOutdated;                //!< Flag to indicate whether allocations have been removed since the last update.
 
 };
 
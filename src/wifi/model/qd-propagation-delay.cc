@@ -76,6 +76,8 @@ void
 QdPropagationDelay::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_nodeIds.clear ();
+  m_delays.clear ();
 }
 
 void
@@ -152,16 +154,25 @@ QdPropagationDelay::ReadQDPropagationDelays (uint16_t indexTx, uint16_t indexRx)
   return delayTxRx;
 }
 
+uint32_t
+QdPropagationDelay::GetNodeId (Ptr<MobilityModel> mobility) const
+{
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_nodeIds.find (PeekPointer (mobility));
+  if (it != m_nodeIds.end ())
+    {
+      return it->second;
+    }
+  uint32_t nodeId = mobility->GetObject<Node> ()->GetDevice (0)->GetNode ()->GetId ();
+  m_nodeIds[PeekPointer (mobility)] = nodeId;
+  return nodeId;
+}
+
 Time
 QdPropagationDelay::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this);
-  uint32_t indexTx, indexRx;
-
-  Ptr<NetDevice> txDevice = a->GetObject<Node> ()->GetDevice (0);
-  Ptr<NetDevice> rxDevice = b->GetObject<Node> ()->GetDevice (0);
-  indexTx = txDevice->GetNode ()->GetId ();
-  indexRx = rxDevice->GetNode ()->GetId ();
+  uint32_t indexTx = GetNodeId (a);
+  uint32_t indexRx = GetNodeId (b);
 
   if (m_speed > 0)
     {
@@ -174,11 +185,11 @@ QdPropagationDelay::GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
         }
     }
 
-  CommunicatingPair pair = std::make_pair (indexTx, indexRx);
+  uint64_t pair = (static_cast<uint64_t> (indexTx) << 32) | indexRx;
   PropagationDelays_I it = m_delays.find (pair);
   if (it == m_delays.end ())
     {
-      CommunicatingPair reversePair = std::make_pair (indexRx, indexTx);
+      uint64_t reversePair = (static_cast<uint64_t> (indexRx) << 32) | indexTx;
       doubleVector_t delayValues = ReadQDPropagationDelays (indexTx, indexRx);
       m_delays[pair] = delayValues;
       m_delays[reversePair] = delayValues;
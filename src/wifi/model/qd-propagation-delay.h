@@ -25,12 +25,12 @@
 #include <ns3/propagation-delay-model.h>
 
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
 typedef std::vector<double> doubleVector_t;
-typedef std::pair<uint32_t, uint32_t> CommunicatingPair;
-typedef std::map<CommunicatingPair, doubleVector_t> PropagationDelays;
+typedef std::unordered_map<uint64_t, doubleVector_t> PropagationDelays;
 typedef PropagationDelays::iterator PropagationDelays_I;
 
 class QdPropagationDelay : public PropagationDelayModel
@@ -52,6 +52,12 @@ private:
   doubleVector_t ReadQDPropagationDelays (uint16_t indexTx, uint16_t indexRx) const;
   void SetQdModelFolder (std::string folderName);
   void SetStartDistance (uint16_t startDistance);
+  /**
+   * Get the ID of the node owning a mobility model, resolving it on the first call.
+   * \param mobility The mobility model of the node.
+   * \return The ID of the node.
+   */
+  uint32_t GetNodeId (Ptr<MobilityModel> mobility) const;
 
 private:
   std::string m_qdFolder;
@@ -59,6 +65,7 @@ private:
   uint16_t m_startDistance;
   mutable uint16_t m_currentIndex;
   mutable PropagationDelays m_delays;
+  mutable std::unordered_map<const MobilityModel *, uint32_t> m_nodeIds;
 
 };
 
@@ -103,6 +103,8 @@ QdPropagationLossModel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_uniformRv = 0;
+  m_nodeContexts.clear ();
+  m_linkContexts.clear ();
 }
 
 void
@@ -327,25 +329,81 @@ QdPropagationLossModel::InitializeQDModelParameters (Ptr<const MobilityModel> tx
   rayTraycingFile.close ();
 }
 
-Ptr<SpectrumValue>
-QdPropagationLossModel::GetChannelGain (Ptr<const SpectrumValue> txPsd, uint16_t pathNum,
-                                        uint32_t indexTx, uint32_t indexRx,
-                                        Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook) const
+/**
+ * Computes the channel gain of a link which is not yet in the channel matrix.
+ * The gain is calculated by Run () and stored in the channel matrix by Finish ().
+ */
+class QdPropagationLossModel::ChannelGainJob : public SpectrumPropagationLossJob
+{
+public:
+  ChannelGainJob (ChannelMatrix *channelMatrix, LinkConfiguration key,
+                  Ptr<SpectrumValue> rxPsd, ChannelGainParameters params)
+    : SpectrumPropagationLossJob (rxPsd),
+      m_channelMatrix (channelMatrix),
+      m_key (key),
+      m_params (params)
+  {
+  }
+  virtual bool IsPending (void) const
+  {
+    return true;
+  }
+  virtual void Run (void)
+  {
+    CalculateChannelGain (*m_rxPsd, m_params);
+  }
+  virtual Ptr<SpectrumValue> Finish (void)
+  {
+    (*m_channelMatrix)[m_key] = m_rxPsd;
+    return m_rxPsd;
+  }
+
+private:
+  ChannelMatrix *m_channelMatrix;         //!< The channel matrix of the link.
+  LinkConfiguration m_key;                //!< The antenna configurations whose gain is computed.
+  ChannelGainParameters m_params;         //!< The parameters of the link.
+};
+
+QdPropagationLossModel::ChannelGainParameters
+QdPropagationLossModel::GetChannelGainParameters (uint16_t pathNum, uint32_t indexTx, uint32_t indexRx,
+                                                  Ptr<CodebookParametric> txCodebook,
+                                                  Ptr<CodebookParametric> rxCodebook) const
 {
-  NS_LOG_FUNCTION (this << txPsd << pathNum << indexTx << indexRx << m_currentIndex);
-  double t = Simulator::Now ().GetSeconds ();
-  bool noSpeed = false;
+  NS_LOG_FUNCTION (this << pathNum << indexTx << indexRx << m_currentIndex);
+  ChannelGainParameters params;
   AntennaID txAntennaID = txCodebook->GetActiveAntennaID ();
   AntennaID rxAntennaID = rxCodebook->GetActiveAntennaID ();
 
+  params.pathNum = pathNum;
+  params.time = Simulator::Now ().GetSeconds ();
+  params.noSpeed = false;
   if (m_speed == 0)
     {
-      noSpeed = true;
+      params.noSpeed = true;
+    }
+  params.noSpeed = true;
+
+  params.delay = &delayTxRx[indexTx][indexRx].at (m_currentIndex);
+  params.pathLoss = &pathLossTxRx[indexTx][indexRx].at (m_currentIndex);
+  params.phase = &phaseTxRx[indexTx][indexRx].at (m_currentIndex);
+  params.dopplerShift = 0;
+  if (!params.noSpeed)
+    {
+      params.dopplerShift = &dopplerShiftTxRx[indexTx][indexRx].at (m_currentIndex);
     }
-  noSpeed = true;
+  params.aodAzimuth = &aodAzimuthTxRx[txAntennaID][indexTx][indexRx].at (m_currentIndex);
+  params.aodElevation = &aodElevationTxRx[txAntennaID][indexTx][indexRx].at (m_currentIndex);
+  params.aoaAzimuth = &aoaAzimuthTxRx[rxAntennaID][indexTx][indexRx].at (m_currentIndex);
+  params.aoaElevation = &aoaElevationTxRx[rxAntennaID][indexTx][indexRx].at (m_currentIndex);
+  params.txPattern = txCodebook->GetTxAntennaArrayPattern ();
+  params.rxPattern = rxCodebook->GetRxAntennaArrayPattern ();
+  return params;
+}
 
-  Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
-  Bands::const_iterator fit = tempPsd->ConstBandsBegin ();
+void
+QdPropagationLossModel::CalculateChannelGain (SpectrumValue &psd, const ChannelGainParameters &params)
+{
+  Bands::const_iterator fit = psd.ConstBandsBegin ();
 
   std::complex<double> delay, doppler;
   double temp_delay, f_d, temp_Doppler, pathPowerLinear, phase;
@@ -353,46 +411,46 @@ QdPropagationLossModel::GetChannelGain (Ptr<const SpectrumValue> txPsd, uint16_t
   double azimuthTxAngle, elevationTxAngle, azimuthRxAngle, elevationRxAngle;
   uint indexTxAzimuth, indexRxAzimuth, indexTxElevation, indexRxElevation;
 
-  for (Values::iterator vit = tempPsd->ValuesBegin (); vit != tempPsd->ValuesEnd (); vit++, fit++)
+  for (Values::iterator vit = psd.ValuesBegin (); vit != psd.ValuesEnd (); vit++, fit++)
     {
       if ((*vit) != 0.00)
         {
           std::complex<double> subsbandGain (0.0, 0.0);
-          if (pathNum > 0)
+          if (params.pathNum > 0)
             {
-              for (uint pathIndex = 0; pathIndex < pathNum; pathIndex++)
+              for (uint pathIndex = 0; pathIndex < params.pathNum; pathIndex++)
                 {
-                  temp_delay = -2 * M_PI * fit->fc * delayTxRx[indexTx][indexRx].at (m_currentIndex).at (pathIndex);
+                  temp_delay = -2 * M_PI * fit->fc * (*params.delay)[pathIndex];
                   delay = std::complex<double> (cos (temp_delay), sin (temp_delay));
 
-                  if (noSpeed)
+                  if (params.noSpeed)
                     {
                       doppler = std::complex<double> (1, 0);
                     }
                   else
                     {
                       f_d = 0.8;
-                      temp_Doppler = 2 * M_PI * t * f_d * dopplerShiftTxRx[indexTx][indexRx].at (m_currentIndex).at (pathIndex);
+                      temp_Doppler = 2 * M_PI * params.time * f_d * (*params.dopplerShift)[pathIndex];
                       doppler = std::complex<double> (cos (temp_Doppler), sin (temp_Doppler));
                     }
 
-                  pathPowerLinear = std::pow (10.0, (pathLossTxRx[indexTx][indexRx].at (m_currentIndex).at (pathIndex)) / 10.0);
-                  phase = phaseTxRx[indexTx][indexRx].at (m_currentIndex).at (pathIndex);
+                  pathPowerLinear = std::pow (10.0, ((*params.pathLoss)[pathIndex]) / 10.0);
+                  phase = (*params.phase)[pathIndex];
                   complexPhase = std::complex<double> (cos (phase), sin (phase));
                   smallScaleFading = sqrt (pathPowerLinear) * doppler * delay * complexPhase;
 
-                  azimuthTxAngle = round (aodAzimuthTxRx[txAntennaID][indexTx][indexRx].at (m_currentIndex).at (pathIndex));
-                  elevationTxAngle = round (aodElevationTxRx[txAntennaID][indexTx][indexRx].at (m_currentIndex).at (pathIndex));
+                  azimuthTxAngle = round ((*params.aodAzimuth)[pathIndex]);
+                  elevationTxAngle = round ((*params.aodElevation)[pathIndex]);
                   indexTxAzimuth = azimuthTxAngle;
                   indexTxElevation = elevationTxAngle;
 
-                  txSum = txCodebook->GetTxAntennaArrayPattern ()[indexTxAzimuth][indexTxElevation];
-                  azimuthRxAngle = round (aoaAzimuthTxRx[rxAntennaID][indexTx][indexRx].at (m_currentIndex).at (pathIndex));
-                  elevationRxAngle = round (aoaElevationTxRx[rxAntennaID][indexTx][indexRx].at (m_currentIndex).at (pathIndex));
+                  txSum = params.txPattern[indexTxAzimuth][indexTxElevation];
+                  azimuthRxAngle = round ((*params.aoaAzimuth)[pathIndex]);
+                  elevationRxAngle = round ((*params.aoaElevation)[pathIndex]);
                   indexRxAzimuth = azimuthRxAngle;
                   indexRxElevation = elevationRxAngle;
 
-                  rxSum = rxCodebook->GetRxAntennaArrayPattern ()[indexRxAzimuth][indexRxElevation];
+                  rxSum = params.rxPattern[indexRxAzimuth][indexRxElevation];
 
                   subsbandGain = subsbandGain + rxSum * txSum * smallScaleFading;
                 }
@@ -404,13 +462,13 @@ QdPropagationLossModel::GetChannelGain (Ptr<const SpectrumValue> txPsd, uint16_t
           *vit = (*vit) * (std::norm (subsbandGain));
         }
     }
-  return tempPsd;
 }
 
 void
 QdPropagationLossModel::AddCustomID (const uint32_t nodeID, const uint32_t customID)
 {
   nodeId2QdId[nodeID] = customID;
+  m_nodeContexts.clear ();
 }
 
 uint32_t
@@ -433,21 +491,66 @@ QdPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> t
                                                       Ptr<const MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this);
+  Ptr<SpectrumPropagationLossJob> job = DoPrepareRxPowerSpectralDensity (txPsd, a, b);
+  job->Run ();
+  return job->Finish ();
+}
 
-  uint32_t indexTx, indexRx;
-  Ptr<SpectrumValue> rxPsd = Copy (txPsd);
+const QdPropagationLossModel::NodeContext &
+QdPropagationLossModel::GetNodeContext (Ptr<const MobilityModel> mobility) const
+{
+  NodeContextMap::iterator it = m_nodeContexts.find (PeekPointer (mobility));
+  if (it != m_nodeContexts.end ())
+    {
+      /* Refresh the codebook if it has been replaced since the context was resolved,
+         and drop the channel gains computed with the patterns of the previous one */
+      Ptr<Codebook> codebook = it->second.phy->GetCodebook ();
+      if (codebook != it->second.codebook)
+        {
+          NS_LOG_DEBUG ("Codebook of node " << it->second.qdIndex << " has changed");
+          it->second.codebook = DynamicCast<CodebookParametric> (codebook);
+          for (LinkContextMap::iterator linkIt = m_linkContexts.begin (); linkIt != m_linkContexts.end (); ++linkIt)
+            {
+              if ((linkIt->second.indexTx == it->second.qdIndex) || (linkIt->second.indexRx == it->second.qdIndex))
+                {
+                  linkIt->second.channelMatrix.clear ();
+                }
+            }
+        }
+      return it->second;
+    }
 
-  Ptr<NetDevice> txDevice = a->GetObject<Node> ()->GetDevice (0);
-  Ptr<WifiNetDevice> wifiTxDevice = DynamicCast<WifiNetDevice> (txDevice);
-  Ptr<SpectrumDmgWifiPhy> txSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiTxDevice->GetPhy ());
-  Ptr<CodebookParametric> txCodebook = DynamicCast<CodebookParametric> (txSpectrum->GetCodebook ());
+  NS_LOG_FUNCTION (this << mobility);
+  Ptr<NetDevice> device = mobility->GetObject<Node> ()->GetDevice (0);
+  Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (device);
+  NodeContext &context = m_nodeContexts[PeekPointer (mobility)];
+  context.phy = StaticCast<SpectrumDmgWifiPhy> (wifiDevice->GetPhy ());
+  context.codebook = DynamicCast<CodebookParametric> (context.phy->GetCodebook ());
+  if (m_useCustomIDs)
+    {
+      context.qdIndex = MapID (device->GetNode ()->GetId ());
+    }
+  else
+    {
+      context.qdIndex = device->GetNode ()->GetId ();
+    }
+  return context;
+}
 
-  Ptr<NetDevice> rxDevice = b->GetObject<Node> ()->GetDevice (0);
-  Ptr<WifiNetDevice> wifiRxDevice = DynamicCast<WifiNetDevice> (rxDevice);
-  Ptr<SpectrumDmgWifiPhy> rxSpectrum = StaticCast<SpectrumDmgWifiPhy> (wifiRxDevice->GetPhy ());
-  Ptr<CodebookParametric> rxCodebook = DynamicCast<CodebookParametric> (rxSpectrum->GetCodebook ());
+Ptr<SpectrumPropagationLossJob>
+QdPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                         Ptr<const MobilityModel> a,
+                                                         Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this);
+
+  const NodeContext &txContext = GetNodeContext (a);
+  const NodeContext &rxContext = GetNodeContext (b);
+  Ptr<CodebookParametric> txCodebook = txContext.codebook;
+  Ptr<CodebookParametric> rxCodebook = rxContext.codebook;
+  uint32_t indexTx = txContext.qdIndex;
+  uint32_t indexRx = rxContext.qdIndex;
 
-  Ptr<SpectrumValue> chPsd;
   AntennaConfigTx antennaConfigTx = std::make_tuple (txCodebook->GetActiveAntennaID (),
                                                      txCodebook->IsCustomAWVUsed (),
                                                      txCodebook->GetActiveTxPatternID ());
@@ -455,18 +558,7 @@ QdPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> t
                                                      rxCodebook->IsCustomAWVUsed (),
                                                      rxCodebook->GetActiveRxPatternID ());
 
-  LinkConfiguration key = std::make_tuple (txDevice, rxDevice, antennaConfigTx, antennaConfigRx);
-
-  if (m_useCustomIDs)
-    {
-      indexTx = MapID (txDevice->GetNode ()->GetId ());
-      indexRx = MapID (rxDevice->GetNode ()->GetId ());
-    }
-  else
-    {
-      indexTx = txDevice->GetNode ()->GetId ();
-      indexRx = rxDevice->GetNode ()->GetId ();
-    }
+  LinkConfiguration key = std::make_pair (antennaConfigTx, antennaConfigRx);
 
   if (m_speed > 0)
     {
@@ -477,21 +569,33 @@ QdPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> t
           if (traceIndex != m_currentIndex)
             {
               m_currentIndex = traceIndex;
-              m_channelMatrixMap.clear ();
+              for (LinkContextMap::iterator it = m_linkContexts.begin (); it != m_linkContexts.end (); ++it)
+                {
+                  it->second.channelMatrix.clear ();
+                }
             }
         }
     }
 
-  ChannelMatrix_I it = m_channelMatrixMap.find (key);
+  LinkContextMap::iterator linkIt = m_linkContexts.find ((static_cast<uint64_t> (indexTx) << 32) | indexRx);
+  if (linkIt == m_linkContexts.end ())
+    {
+      LinkContext link;
+      link.indexTx = indexTx;
+      link.indexRx = indexRx;
+      link.initialized = false;
+      linkIt = m_linkContexts.insert (std::make_pair ((static_cast<uint64_t> (indexTx) << 32) | indexRx, link)).first;
+    }
+  LinkContext &link = linkIt->second;
 
-  if (it == m_channelMatrixMap.end ())
+  ChannelMatrix_I it = link.channelMatrix.find (key);
+
+  if (it == link.channelMatrix.end ())
     {
-      CommunicatingPair pair = std::make_pair (indexTx, indexRx);
-      TraceFiles_I trIt = find (m_traceFiles.begin (), m_traceFiles.end (), pair);
-      if (trIt == m_traceFiles.end ())
+      if (!link.initialized)
         {
           InitializeQDModelParameters (a, b, indexTx, indexRx);
-          m_traceFiles.push_back (pair);
+          link.initialized = true;
         }
       uint16_t pathNum = nbMultipathTxRx[indexTx][indexRx].at (m_currentIndex);
       if (m_speed > 0)
@@ -504,15 +608,14 @@ QdPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> t
           dopplerShiftTxRx[indexTx][indexRx].push_back (dopplerShift);
           dopplerShiftTxRx[indexRx][indexTx].push_back (dopplerShift);
         }
-      chPsd = GetChannelGain (rxPsd, pathNum, indexTx, indexRx, txCodebook, rxCodebook);
-      m_channelMatrixMap[key] = chPsd;
+      // Only a channel matrix miss allocates a new PSD, whose gain is computed by the job
+      ChannelGainParameters params = GetChannelGainParameters (pathNum, indexTx, indexRx, txCodebook, rxCodebook);
+      return Create<ChannelGainJob> (&link.channelMatrix, key, Copy<SpectrumValue> (txPsd), params);
     }
   else
     {
-      chPsd = (*it).second;
+      return Create<SpectrumPropagationLossJob> ((*it).second);
     }
-
-  return chPsd;
 }
 
 AnglesTransformed
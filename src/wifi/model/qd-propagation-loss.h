@@ -50,11 +50,14 @@
 #include <complex>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 #include "codebook-parametric.h"
 
 namespace ns3 {
 
+class SpectrumDmgWifiPhy;
+
 typedef std::vector<double> doubleVector_t;
 typedef std::vector<std::complex<double> > complexVector_t;
 typedef std::vector<complexVector_t> complex2DVector_t;
@@ -70,13 +73,10 @@ struct AnglesTransformed {
 typedef std::tuple<AntennaID, bool, uint8_t> AntennaConfig;
 typedef AntennaConfig AntennaConfigTx;
 typedef AntennaConfig AntennaConfigRx;
-typedef std::tuple<Ptr<NetDevice>, Ptr<NetDevice>, AntennaConfigTx, AntennaConfigRx> LinkConfiguration;
+typedef std::pair<AntennaConfigTx, AntennaConfigRx> LinkConfiguration;
 typedef std::map<LinkConfiguration, Ptr<SpectrumValue> > ChannelMatrix;
 typedef ChannelMatrix::iterator ChannelMatrix_I;
 typedef ChannelMatrix::const_iterator ChannelMatrix_CI;
-typedef std::pair<uint32_t, uint32_t> CommunicatingPair;
-typedef std::vector<CommunicatingPair> TraceFiles;
-typedef TraceFiles::iterator TraceFiles_I;
 
 class QdPropagationLossModel : public SpectrumPropagationLossModel
 {
@@ -93,14 +93,78 @@ protected:
   virtual void DoDispose ();
 
 private:
+  /**
+   * Data needed to compute the channel gain of a link. It is resolved on the
+   * simulator thread, so that the computation itself can run concurrently
+   * with the one of other links.
+   */
+  struct ChannelGainParameters
+  {
+    uint16_t pathNum;                     //!< Number of multipath components.
+    double time;                          //!< Current simulation time [s].
+    bool noSpeed;                         //!< Flag to indicate whether the Doppler shift is ignored.
+    const doubleVector_t *delay;          //!< Delay of each path.
+    const doubleVector_t *pathLoss;       //!< Path loss of each path.
+    const doubleVector_t *phase;          //!< Phase of each path.
+    const doubleVector_t *dopplerShift;   //!< Doppler shift of each path.
+    const doubleVector_t *aodAzimuth;     //!< Azimuth angle of departure of each path.
+    const doubleVector_t *aodElevation;   //!< Elevation angle of departure of each path.
+    const doubleVector_t *aoaAzimuth;     //!< Azimuth angle of arrival of each path.
+    const doubleVector_t *aoaElevation;   //!< Elevation angle of arrival of each path.
+    const Complex * const *txPattern;     //!< Array pattern of the transmitter, shared read-only with its codebook.
+    const Complex * const *rxPattern;     //!< Array pattern of the receiver, shared read-only with its codebook.
+  };
+  class ChannelGainJob;
+
+  /**
+   * Objects of a node used by the model, resolved once from its mobility model.
+   * The codebook is refreshed whenever the DMG PHY of the node is given a new one.
+   */
+  struct NodeContext
+  {
+    Ptr<SpectrumDmgWifiPhy> phy;          //!< DMG PHY of the node.
+    Ptr<CodebookParametric> codebook;     //!< Codebook of the DMG PHY of the node.
+    uint32_t qdIndex;                     //!< Index of the node in the Q-D files.
+  };
+  typedef std::unordered_map<const MobilityModel *, NodeContext> NodeContextMap;
+
+  /**
+   * State of the link between a pair of nodes.
+   */
+  struct LinkContext
+  {
+    uint32_t indexTx;                     //!< Index of the transmitter in the Q-D files.
+    uint32_t indexRx;                     //!< Index of the receiver in the Q-D files.
+    bool initialized;                     //!< Flag to indicate whether the Q-D parameters have been loaded.
+    ChannelMatrix channelMatrix;          //!< Channel gain for each pair of antenna configurations.
+  };
+  typedef std::unordered_map<uint64_t, LinkContext> LinkContextMap;
+
+  /**
+   * Get the context of a node, resolving it on the first call.
+   * \param mobility The mobility model of the node.
+   * \return The context of the node.
+   */
+  const NodeContext &GetNodeContext (Ptr<const MobilityModel> mobility) const;
+
   Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
                                                    Ptr<const MobilityModel> a,
                                                    Ptr<const MobilityModel> b) const;
+  Ptr<SpectrumPropagationLossJob> DoPrepareRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                   Ptr<const MobilityModel> a,
+                                                                   Ptr<const MobilityModel> b) const;
   void InitializeQDModelParameters (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b,
                                     uint16_t indexTx, uint16_t indexRx) const;
-  Ptr<SpectrumValue> GetChannelGain (Ptr<const SpectrumValue> txPsd, uint16_t pathNum,
-                                     uint32_t indexTx, uint32_t indexRx,
-                                     Ptr<CodebookParametric> txCodebook, Ptr<CodebookParametric> rxCodebook) const;
+  ChannelGainParameters GetChannelGainParameters (uint16_t pathNum, uint32_t indexTx, uint32_t indexRx,
+                                                  Ptr<CodebookParametric> txCodebook,
+                                                  Ptr<CodebookParametric> rxCodebook) const;
+  /**
+   * Multiply the PSD by the channel gain of a link. This method does not access
+   * any shared state, hence it can be executed on a worker thread.
+   * \param psd The PSD to be updated.
+   * \param params The parameters of the link.
+   */
+  static void CalculateChannelGain (SpectrumValue &psd, const ChannelGainParameters &params);
   void QuaternionTransform (double givenAxix[3], double desiredAxix[3], float2DVector_t& rotmVector) const;
   AnglesTransformed GetTransformedAngles(double elevation, double azimuth, bool isDoa, float2DVector_t& rotmVector) const;
   void SetQdModelFolder (const std::string folderName);
@@ -108,13 +172,13 @@ private:
   uint32_t MapID (const uint32_t nodeID) const;
 
 private:
-  mutable ChannelMatrix m_channelMatrixMap;
+  mutable NodeContextMap m_nodeContexts;
+  mutable LinkContextMap m_linkContexts;
   std::string m_qdFolder;
   Ptr<UniformRandomVariable> m_uniformRv;
   double m_speed;
   uint16_t m_startDistance;
   mutable uint16_t m_currentIndex;
-  mutable TraceFiles m_traceFiles;
   mutable uint16_t m_numTraces;
 
   mutable std::map<uint16_t, std::map<uint16_t, doubleVector_t> >   nbMultipathTxRx;
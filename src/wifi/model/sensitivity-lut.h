@@ -3,7 +3,21 @@
 
 namespace ns3 {
 
-double sensitivity_ber(unsigned int index);
+/** Number of entries of the sensitivity lookup table. */
+constexpr unsigned int SENSITIVITY_LUT_SIZE = 181;
+
+/**
+ * \param index the index of the entry, from 0 (-12 dB) to 180 (+6 dB).
+ * \return the BER of the entry.
+ */
+double sensitivity_ber (unsigned int index);
+
+/**
+ * \param rss_delta the difference in dB between the RSS and the sensitivity of the MCS.
+ * \return the BER linearly interpolated between the two closest entries,
+ *         saturated at the first and last entries.
+ */
+double interpolate_sensitivity_ber (double rss_delta);
 
 }
 
@@ -41,9 +41,67 @@ SensitivityModel60GHz::GetTypeId (void)
 }
 
 SensitivityModel60GHz::SensitivityModel60GHz ()
+  : m_channelWidth (0),
+    m_noiseDbm (0)
 {
 }
 
+namespace {
+
+/* Receiver sensitivity of a DMG mode */
+struct DmgMcsSensitivity
+{
+  const char *name;     //!< The unique name of the mode.
+  double sensitivity;   //!< The receiver sensitivity (dBm).
+};
+
+/* The modes are keyed by name, since DMG_MCS9_1 and DMG_MCS12_x share their MCS value with other modes */
+const DmgMcsSensitivity DMG_MCS_SENSITIVITY[] = {
+  /**** Control PHY ****/
+  {"DMG_MCS0", -78},
+  /**** SC PHY ****/
+  {"DMG_MCS1", -68}, {"DMG_MCS2", -66}, {"DMG_MCS3", -65}, {"DMG_MCS4", -64},
+  {"DMG_MCS5", -62}, {"DMG_MCS6", -63}, {"DMG_MCS7", -62}, {"DMG_MCS8", -61},
+  {"DMG_MCS9", -59}, {"DMG_MCS10", -55}, {"DMG_MCS11", -54}, {"DMG_MCS12", -53},
+  /**** OFDM PHY ****/
+  {"DMG_MCS13", -66}, {"DMG_MCS14", -64}, {"DMG_MCS15", -63}, {"DMG_MCS16", -62},
+  {"DMG_MCS17", -60}, {"DMG_MCS18", -58}, {"DMG_MCS19", -56}, {"DMG_MCS20", -54},
+  {"DMG_MCS21", -53}, {"DMG_MCS22", -51}, {"DMG_MCS23", -49}, {"DMG_MCS24", -47},
+  /**** Low power PHY ****/
+  {"DMG_MCS25", -64}, {"DMG_MCS26", -60}, {"DMG_MCS27", -57}, {"DMG_MCS28", -57},
+  {"DMG_MCS29", -57}, {"DMG_MCS30", -57}, {"DMG_MCS31", -57},
+};
+
+} // anonymous namespace
+
+double
+SensitivityModel60GHz::GetSensitivity (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_sensitivities.size ())
+    {
+      m_sensitivities.resize (uid + 1, 0);
+    }
+  if (m_sensitivities[uid] == 0)
+    {
+      /* Resolve the mode by name the first time only */
+      std::string name = mode.GetUniqueName ();
+      for (uint32_t i = 0; i < sizeof (DMG_MCS_SENSITIVITY) / sizeof (DMG_MCS_SENSITIVITY[0]); i++)
+        {
+          if (name == DMG_MCS_SENSITIVITY[i].name)
+            {
+              m_sensitivities[uid] = DMG_MCS_SENSITIVITY[i].sensitivity;
+              break;
+            }
+        }
+      if (m_sensitivities[uid] == 0)
+        {
+          NS_FATAL_ERROR ("Unrecognized 60 GHz modulation " << name);
+        }
+    }
+  return m_sensitivities[uid];
+}
+
 double
 SensitivityModel60GHz::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
 {
@@ -51,99 +109,24 @@ SensitivityModel60GHz::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector
     mode.GetModulationClass() == WIFI_MOD_CLASS_DMG_SC ||
     mode.GetModulationClass() == WIFI_MOD_CLASS_DMG_OFDM,
                "Expecting 802.11ad DMG CTRL, SC or OFDM modulation");
-  std::string modename = mode.GetUniqueName ();
+  double sensitivity = GetSensitivity (mode);
 
   /* This is kinda silly, but convert from SNR back to RSS (Hardcoding RxNoiseFigure)*/
-  //thermal noise at 290K in J/s = W
-  static const double BOLTZMANN = 1.3803e-23;
-  double noise = BOLTZMANN * 290.0 * txVector.GetChannelWidth () * 1000000 * 10;
+  if (txVector.GetChannelWidth () != m_channelWidth)
+    {
+      //thermal noise at 290K in J/s = W
+      static const double BOLTZMANN = 1.3803e-23;
+      double noise = BOLTZMANN * 290.0 * txVector.GetChannelWidth () * 1000000 * 10;
+      m_channelWidth = txVector.GetChannelWidth ();
+      m_noiseDbm = 10 * log10 (noise) + 30;
+    }
 
   /* Compute RSS in dBm, so add 30 from SNR */
-  double rss = 10 * log10 (snr * noise) + 30;
-  double rss_delta;
-  double ber;
-
-  /**** Control PHY ****/
-  if (modename == "DMG_MCS0")
-    rss_delta = rss - -78;
-
-  /**** SC PHY ****/
-  else if (modename == "DMG_MCS1")
-    rss_delta = rss - -68;
-  else if (modename == "DMG_MCS2")
-    rss_delta = rss - -66;
-  else if (modename == "DMG_MCS3")
-    rss_delta = rss - -65;
-  else if (modename == "DMG_MCS4")
-    rss_delta = rss - -64;
-  else if (modename == "DMG_MCS5")
-    rss_delta = rss - -62;
-  else if (modename == "DMG_MCS6")
-    rss_delta = rss - -63;
-  else if (modename == "DMG_MCS7")
-    rss_delta = rss - -62;
-  else if (modename == "DMG_MCS8")
-    rss_delta = rss - -61;
-  else if (modename == "DMG_MCS9")
-    rss_delta = rss - -59;
-  else if (modename == "DMG_MCS10")
-    rss_delta = rss - -55;
-  else if (modename == "DMG_MCS11")
-    rss_delta = rss - -54;
-  else if (modename == "DMG_MCS12")
-    rss_delta = rss - -53;
-
-  /**** OFDM PHY ****/
-  else if (modename == "DMG_MCS13")
-    rss_delta = rss - -66;
-  else if (modename == "DMG_MCS14")
-    rss_delta = rss - -64;
-  else if (modename == "DMG_MCS15")
-    rss_delta = rss - -63;
-  else if (modename == "DMG_MCS16")
-    rss_delta = rss - -62;
-  else if (modename == "DMG_MCS17")
-    rss_delta = rss - -60;
-  else if (modename == "DMG_MCS18")
-    rss_delta = rss - -58;
-  else if (modename == "DMG_MCS19")
-    rss_delta = rss - -56;
-  else if (modename == "DMG_MCS20")
-    rss_delta = rss - -54;
-  else if (modename == "DMG_MCS21")
-    rss_delta = rss - -53;
-  else if (modename == "DMG_MCS22")
-    rss_delta = rss - -51;
-  else if (modename == "DMG_MCS23")
-    rss_delta = rss - -49;
-  else if (modename == "DMG_MCS24")
-    rss_delta = rss - -47;
-
-  /**** Low power PHY ****/
-  else if (modename == "DMG_MCS25")
-    rss_delta = rss - -64;
-  else if (modename == "DMG_MCS26")
-    rss_delta = rss - -60;
-  else if (modename == "DMG_MCS27")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS28")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS29")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS30")
-    rss_delta = rss - -57;
-  else if (modename == "DMG_MCS31")
-    rss_delta = rss - -57;
-  else
-    NS_FATAL_ERROR("Unrecognized 60 GHz modulation");
+  double rss = 10 * log10 (snr) + m_noiseDbm;
+  double rss_delta = rss - sensitivity;
 
   /* Compute BER in lookup table */
-  if ((rss_delta < -12.0) || (snr < 0))
-    ber = sensitivity_ber (0);
-  else if (rss_delta > 6.0)
-    ber = sensitivity_ber (180);
-  else
-    ber = sensitivity_ber ((int) std::abs((10 * (rss_delta + 12))));
+  double ber = interpolate_sensitivity_ber (rss_delta);
 
   NS_LOG_DEBUG ("SENSITIVITY: ber=" << ber << ", rss_delta=" << rss_delta << ", snr[linear]=" << snr << ", rss[dBm]=" << rss << ", bits=" << nbits);
 
@@ -18,6 +18,7 @@
 #define SENSITIVITY_MODEL_60_GHZ
 
 #include <stdint.h>
+#include <vector>
 #include "wifi-mode.h"
 #include "error-rate-model.h"
 
@@ -31,6 +32,17 @@ public:
   SensitivityModel60GHz ();
 
   virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+private:
+  /**
+   * \param mode the DMG mode
+   * \return the receiver sensitivity of the mode (dBm)
+   */
+  double GetSensitivity (WifiMode mode) const;
+
+  mutable std::vector<double> m_sensitivities;  //!< Sensitivity (dBm) per WifiMode UID, zero until resolved.
+  mutable uint16_t m_channelWidth;  //!< Channel width (MHz) the cached noise was computed for.
+  mutable double m_noiseDbm;        //!< Cached thermal noise plus noise figure (dBm).
 };
 
 } // namespace ns3
@@ -0,0 +1,627 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <set>
+#include <ns3/assert.h>
+#include <ns3/abort.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+
+#include "spatial-sharing-dmg-wifi-scheduler.h"
+#include "dmg-ap-wifi-mac.h"
+#include "dti-available-slots.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialSharingDmgWifiScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (SpatialSharingDmgWifiScheduler);
+
+TypeId
+SpatialSharingDmgWifiScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SpatialSharingDmgWifiScheduler")
+      .SetParent<DmgWifiScheduler> ()
+      .SetGroupName ("Wifi")
+      .AddConstructor<SpatialSharingDmgWifiScheduler> ()
+
+      .AddAttribute ("MinBroadcastCbapDuration", "The minimum duration in microseconds of broadcast CBAP to keep "
+                     "in the DTI when accepting new requests",
+                     UintegerValue (4096),
+                     MakeUintegerAccessor (&SpatialSharingDmgWifiScheduler::m_minBroadcastCbapDuration),
+                     MakeUintegerChecker<uint32_t> ())
+      .AddAttribute ("InterferenceThreshold", "The highest ANIPI in dBm measured by the DMG STAs of an SP during "
+                     "another SP for the two SPs to be scheduled at the same time.",
+                     DoubleValue (-68.0),
+                     MakeDoubleAccessor (&SpatialSharingDmgWifiScheduler::m_interferenceThreshold),
+                     MakeDoubleChecker<double> ())
+      .AddAttribute ("MeasurementLifetime", "The time after which a measurement has to be repeated. A measurement "
+                     "is requested again when half of its lifetime has elapsed.",
+                     TimeValue (Seconds (1)),
+                     MakeTimeAccessor (&SpatialSharingDmgWifiScheduler::m_measurementLifetime),
+                     MakeTimeChecker ())
+      .AddAttribute ("MeasurementBlocks", "The number of time blocks of the requested measurements.",
+                     UintegerValue (4),
+                     MakeUintegerAccessor (&SpatialSharingDmgWifiScheduler::m_measurementBlocks),
+                     MakeUintegerChecker<uint8_t> (1, 255))
+  ;
+  return tid;
+}
+
+SpatialSharingDmgWifiScheduler::SpatialSharingDmgWifiScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SpatialSharingDmgWifiScheduler::~SpatialSharingDmgWifiScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SpatialSharingDmgWifiScheduler::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_requests.clear ();
+  m_measurements.clear ();
+  m_pendingMeasurements.clear ();
+  DmgWifiScheduler::DoDispose ();
+}
+
+void
+SpatialSharingDmgWifiScheduler::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  DmgWifiScheduler::DoInitialize ();
+  bool isConnected;
+  isConnected = m_mac->TraceConnectWithoutContext ("ChannelQualityReportReceived",
+                                                   MakeCallback (&SpatialSharingDmgWifiScheduler::ReceiveChannelQualityReport, this));
+  NS_ASSERT_MSG (isConnected, "Connection to Trace ChannelQualityReportReceived failed.");
+}
+
+DmgWifiScheduler::UniqueIdentifier
+SpatialSharingDmgWifiScheduler::GetIdentifier (const AllocationField &field)
+{
+  return UniqueIdentifier (field.GetAllocationID (), field.GetSourceAid (), field.GetDestinationAid ());
+}
+
+bool
+SpatialSharingDmgWifiScheduler::IsSharable (const AllocationField &field) const
+{
+  return (field.GetAllocationType () == SERVICE_PERIOD_ALLOCATION)
+      && (field.GetSourceAid () != AID_AP) && (field.GetDestinationAid () != AID_AP)
+      && (m_requests.find (GetIdentifier (field)) != m_requests.end ());
+}
+
+bool
+SpatialSharingDmgWifiScheduler::IsInterferenceLow (const MeasurementKey &key) const
+{
+  MeasurementMap::const_iterator it = m_measurements.find (key);
+  return (it != m_measurements.end ())
+      && (it->second.time + m_measurementLifetime > Simulator::Now ())
+      && (it->second.anipi <= m_interferenceThreshold);
+}
+
+bool
+SpatialSharingDmgWifiScheduler::AreCompatible (const AllocationField &first, const AllocationField &second) const
+{
+  /* A DMG STA cannot take part in two SPs at the same time */
+  std::set<uint8_t> stations;
+  stations.insert (first.GetSourceAid ());
+  stations.insert (first.GetDestinationAid ());
+  if ((stations.find (second.GetSourceAid ()) != stations.end ())
+      || (stations.find (second.GetDestinationAid ()) != stations.end ()))
+    {
+      return false;
+    }
+  /* The two receiving DMG STAs must have measured a low interference during the SP of the other link */
+  UniqueIdentifier firstId = GetIdentifier (first);
+  UniqueIdentifier secondId = GetIdentifier (second);
+  return IsInterferenceLow (MeasurementKey (firstId, secondId, first.GetDestinationAid ()))
+      && IsInterferenceLow (MeasurementKey (secondId, firstId, second.GetDestinationAid ()));
+}
+
+void
+SpatialSharingDmgWifiScheduler::ReceiveChannelQualityReport (Mac48Address address,
+                                                             Ptr<DirectionalChannelQualityReportElement> element)
+{
+  NS_LOG_FUNCTION (this << address);
+  PendingMeasurementMap::iterator it =
+      m_pendingMeasurements.find (std::make_pair (m_mac->GetStationAid (address), element->GetMeasurementStartTime ()));
+  if (it == m_pendingMeasurements.end ())
+    {
+      NS_LOG_DEBUG ("Report from " << address << " does not match a valid measurement request");
+      return;
+    }
+  TimeBlockMeasurementList list = element->GetTimeBlockMeasurementList ();
+  if (!list.empty ())
+    {
+      /* Keep the worst time block, the interfering SP may not use the whole allocation */
+      Measurement measurement;
+      measurement.anipi = AnipiToDbm (*std::max_element (list.begin (), list.end ()));
+      measurement.time = Simulator::Now ();
+      m_measurements[it->second.key] = measurement;
+      NS_LOG_DEBUG ("Station " << address << " measured ANIPI=" << measurement.anipi
+                    << " dBm during allocation ID " << +std::get<0> (std::get<1> (it->second.key)));
+    }
+  m_pendingMeasurements.erase (it);
+}
+
+void
+SpatialSharingDmgWifiScheduler::RemoveTerminatedAllocations (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::set<UniqueIdentifier> allocations;
+  for (AllocationFieldListI iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+    {
+      allocations.insert (GetIdentifier (*iter));
+    }
+  for (RequestMap::iterator it = m_requests.begin (); it != m_requests.end ();)
+    {
+      if (allocations.find (it->first) == allocations.end ())
+        {
+          NS_LOG_DEBUG ("Allocation ID " << +std::get<0> (it->first) << " has been removed");
+          it = m_requests.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+  for (MeasurementMap::iterator it = m_measurements.begin (); it != m_measurements.end ();)
+    {
+      if ((m_requests.find (std::get<0> (it->first)) == m_requests.end ())
+          || (m_requests.find (std::get<1> (it->first)) == m_requests.end ()))
+        {
+          it = m_measurements.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+uint32_t
+SpatialSharingDmgWifiScheduler::GetGuaranteedTime (void) const
+{
+  uint32_t guaranteedTime = 0;
+  for (AllocationFieldList::const_iterator iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+    {
+      RequestMap::const_iterator it = m_requests.find (GetIdentifier (*iter));
+      if (it != m_requests.end ())
+        {
+          guaranteedTime += it->second.minDuration + m_guardTime;
+        }
+      else
+        {
+          guaranteedTime += iter->GetNumberOfBlocks () * (iter->GetAllocationBlockDuration () + m_guardTime);
+        }
+    }
+  return guaranteedTime;
+}
+
+bool
+SpatialSharingDmgWifiScheduler::FitsInExtendedSchedule (uint32_t allocations) const
+{
+  uint32_t cbapFields = m_dtiDuration.GetMicroSeconds () / MAX_CBAP_BLOCK_DURATION + 1;
+  return allocations + cbapFields <= MAX_ALLOCATION_FIELDS;
+}
+
+void
+SpatialSharingDmgWifiScheduler::BeaconIntervalEnded (void)
+{
+  NS_LOG_INFO ("Beacon Interval ended at " << Simulator::Now ());
+  NS_ASSERT (m_currentAccessPeriod == CHANNEL_ACCESS_DTI);
+  /* Cleanup non-static allocations */
+  CleanupAllocations ();
+  /* The packing depends on the latest measurements, so the DTI is planned again every BI */
+  AllocationFieldList previousList = m_allocationList;
+  if (m_addtsAllocationList.empty ())
+    {
+      NS_LOG_DEBUG ("No Addts allocations. Entire DTI as CBAP");
+      m_requests.clear ();
+      m_measurements.clear ();
+      m_pendingMeasurements.clear ();
+      m_allocationList.clear ();
+    }
+  else
+    {
+      UpdateStartAndRemainingTime ();
+      AddBroadcastCbapAllocations ();
+      UpdateMeasurements (m_currentAccessPeriodStartTime.GetMicroSeconds () + m_biDuration.GetMicroSeconds ());
+    }
+
+  /* Announce a new schedule only if it differs from the current one */
+  bool isModified = (previousList.size () != m_allocationList.size ());
+  for (uint32_t i = 0; !isModified && (i < m_allocationList.size ()); i++)
+    {
+      const AllocationField &previous = previousList[i];
+      const AllocationField &current = m_allocationList[i];
+      isModified = (GetIdentifier (previous) != GetIdentifier (current))
+          || (previous.GetAllocationType () != current.GetAllocationType ())
+          || (previous.GetAllocationStart () != current.GetAllocationStart ())
+          || (previous.GetAllocationBlockDuration () != current.GetAllocationBlockDuration ())
+          || (previous.GetAllocationBlockPeriod () != current.GetAllocationBlockPeriod ())
+          || (previous.GetNumberOfBlocks () != current.GetNumberOfBlocks ());
+    }
+  if (isModified)
+    {
+      m_allocationListVersion++;
+    }
+  m_isAddtsAccepted = false;
+  m_isAllocationModified = false;
+  m_isNonStaticRemoved = false;
+  m_isDeltsReceived = false;
+}
+
+void
+SpatialSharingDmgWifiScheduler::UpdateStartAndRemainingTime (void)
+{
+  NS_LOG_FUNCTION (this);
+  /* The guaranteed allocations are accounted for one after the other */
+  m_allocationStartTime = GetGuaranteedTime ();
+  uint32_t dtiDuration = m_dtiDuration.GetMicroSeconds ();
+  m_remainingDtiTime = (m_allocationStartTime < dtiDuration) ? dtiDuration - m_allocationStartTime : 0;
+}
+
+void
+SpatialSharingDmgWifiScheduler::AdjustExistingAllocations (AllocationFieldListI iter, uint32_t duration, bool isToAdd)
+{
+  NS_LOG_FUNCTION (this << duration << isToAdd);
+}
+
+uint32_t
+SpatialSharingDmgWifiScheduler::GetAllocationDuration (uint32_t minAllocation, uint32_t maxAllocation)
+{
+  NS_LOG_FUNCTION (this << minAllocation << maxAllocation);
+  /* Only the minimum allocation is guaranteed, the SP is extended towards the maximum one with the time saved by spatial sharing */
+  return minAllocation;
+}
+
+StatusCode
+SpatialSharingDmgWifiScheduler::AddNewAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info)
+{
+  NS_LOG_FUNCTION (this << +sourceAid);
+  Request request;
+  request.minDuration = dmgTspec.GetMinimumAllocation ();
+  if (info.GetAllocationFormat () == ISOCHRONOUS)
+    {
+      request.maxDuration = std::max (dmgTspec.GetMinimumAllocation (), dmgTspec.GetMaximumAllocation ());
+    }
+  else if (info.GetAllocationFormat () == ASYNCHRONOUS)
+    {
+      /* for asynchronous allocations, the Maximum Allocation field is reserved (IEEE 802.11ad 8.4.2.136) */
+      request.maxDuration = request.minDuration;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Allocation Format not supported");
+    }
+  request.maxDuration = std::min<uint32_t> (request.maxDuration, MAX_SP_BLOCK_DURATION);
+
+  RemoveTerminatedAllocations ();
+  UpdateStartAndRemainingTime ();
+  StatusCode status;
+  if ((request.minDuration == 0) || (request.minDuration > MAX_SP_BLOCK_DURATION))
+    {
+      NS_LOG_DEBUG ("Invalid minimum allocation " << request.minDuration);
+      status.SetStatusCodeValue (STATUS_CODE_REJECTED_WITH_SUGGESTED_CHANGES);
+    }
+  else if ((request.minDuration + m_guardTime + m_minBroadcastCbapDuration <= m_remainingDtiTime)
+           && FitsInExtendedSchedule (m_addtsAllocationList.size () + 1))
+    {
+      NS_LOG_DEBUG ("Accepted allocation with min=" << request.minDuration << " and max=" << request.maxDuration);
+      AddAllocationPeriod (info.GetAllocationID (), info.GetAllocationType (), info.IsPseudoStatic (),
+                           sourceAid, info.GetDestinationAid (), 0, GetAllocationDuration (request.minDuration,
+                                                                                          request.maxDuration), 0, 1);
+      m_requests[GetIdentifier (m_addtsAllocationList.back ())] = request;
+      status.SetSuccess ();
+    }
+  else
+    {
+      NS_LOG_DEBUG ("Not enough time in the DTI for the minimum allocation");
+      status.SetStatusCodeValue (STATUS_CODE_REJECTED_WITH_SUGGESTED_CHANGES);
+    }
+  return status;
+}
+
+StatusCode
+SpatialSharingDmgWifiScheduler::ModifyExistingAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info)
+{
+  NS_LOG_FUNCTION (this << +sourceAid);
+  Request request;
+  request.minDuration = dmgTspec.GetMinimumAllocation ();
+  if (info.GetAllocationFormat () == ISOCHRONOUS)
+    {
+      request.maxDuration = std::max (dmgTspec.GetMinimumAllocation (), dmgTspec.GetMaximumAllocation ());
+    }
+  else if (info.GetAllocationFormat () == ASYNCHRONOUS)
+    {
+      /* for asynchronous allocations, the Maximum Allocation field is reserved (IEEE 802.11ad 8.4.2.136) */
+      request.maxDuration = request.minDuration;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Allocation Format not supported");
+    }
+  request.maxDuration = std::min<uint32_t> (request.maxDuration, MAX_SP_BLOCK_DURATION);
+
+  RemoveTerminatedAllocations ();
+  UniqueIdentifier id (info.GetAllocationID (), sourceAid, info.GetDestinationAid ());
+  RequestMap::iterator it = m_requests.find (id);
+  NS_ABORT_MSG_IF (it == m_requests.end (), "Required allocation does not exist.");
+  UpdateStartAndRemainingTime ();
+  uint32_t availableTime = m_remainingDtiTime + it->second.minDuration;
+
+  StatusCode status;
+  if ((request.minDuration != 0) && (request.minDuration <= MAX_SP_BLOCK_DURATION)
+      && (request.minDuration + m_minBroadcastCbapDuration <= availableTime))
+    {
+      NS_LOG_DEBUG ("Modified allocation with min=" << request.minDuration << " and max=" << request.maxDuration);
+      for (AllocationFieldListI iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+        {
+          if (GetIdentifier (*iter) == id)
+            {
+              iter->SetAllocationBlockDuration (GetAllocationDuration (request.minDuration, request.maxDuration));
+              break;
+            }
+        }
+      it->second = request;
+      status.SetSuccess ();
+    }
+  else
+    {
+      /* The request cannot be accepted; maintaining old allocation */
+      status.SetFailure ();
+    }
+  return status;
+}
+
+void
+SpatialSharingDmgWifiScheduler::AddBroadcastCbapAllocations (void)
+{
+  NS_LOG_FUNCTION (this);
+  RemoveTerminatedAllocations ();
+  m_allocationList.clear ();
+
+  /* The allocations that have not been requested with an ADDTS request keep their position */
+  uint32_t dtiDuration = m_dtiDuration.GetMicroSeconds ();
+  DtiAvailableSlots slots;
+  slots.Reset (dtiDuration);
+  std::vector<AllocationField> sharable;
+  for (AllocationFieldListI iter = m_addtsAllocationList.begin (); iter != m_addtsAllocationList.end (); ++iter)
+    {
+      if (m_requests.find (GetIdentifier (*iter)) == m_requests.end ())
+        {
+          for (uint8_t block = 0; block < iter->GetNumberOfBlocks (); block++)
+            {
+              uint32_t start = iter->GetAllocationStart () + block * iter->GetAllocationBlockPeriod ();
+              slots.Reserve (start, start + iter->GetAllocationBlockDuration () + m_guardTime);
+            }
+          m_allocationList.push_back (*iter);
+        }
+      else
+        {
+          sharable.push_back (*iter);
+        }
+    }
+
+  /* Pack the requested SPs in groups of compatible SPs, longest desired allocation first */
+  std::stable_sort (sharable.begin (), sharable.end (),
+                    [this](const AllocationField& lhs, const AllocationField& rhs){
+      return m_requests[GetIdentifier (lhs)].maxDuration > m_requests[GetIdentifier (rhs)].maxDuration;
+    });
+  std::vector<std::vector<AllocationField> > groups;
+  for (std::vector<AllocationField>::const_iterator it = sharable.begin (); it != sharable.end (); ++it)
+    {
+      std::vector<std::vector<AllocationField> >::iterator group = groups.begin ();
+      for (; IsSharable (*it) && (group != groups.end ()); ++group)
+        {
+          bool compatible = true;
+          for (std::vector<AllocationField>::const_iterator member = group->begin ();
+               compatible && (member != group->end ()); ++member)
+            {
+              compatible = IsSharable (*member) && AreCompatible (*member, *it);
+            }
+          if (compatible)
+            {
+              break;
+            }
+        }
+      if (IsSharable (*it) && (group != groups.end ()))
+        {
+          group->push_back (*it);
+        }
+      else
+        {
+          groups.push_back (std::vector<AllocationField> (1, *it));
+        }
+    }
+
+  /* Each group lasts as long as the longest minimum allocation of its SPs, and the DTI time saved
+     by the concurrent SPs extends the groups towards the longest desired allocation of their SPs */
+  std::vector<uint32_t> minDurations (groups.size (), 0);
+  std::vector<uint32_t> maxDurations (groups.size (), 0);
+  uint32_t groupsTime = 0;
+  uint32_t deficit = 0;
+  for (uint32_t i = 0; i < groups.size (); i++)
+    {
+      for (std::vector<AllocationField>::const_iterator member = groups[i].begin (); member != groups[i].end (); ++member)
+        {
+          const Request &request = m_requests[GetIdentifier (*member)];
+          minDurations[i] = std::max (minDurations[i], request.minDuration);
+          maxDurations[i] = std::max (maxDurations[i], request.maxDuration);
+        }
+      groupsTime += minDurations[i] + m_guardTime;
+      deficit += maxDurations[i] - minDurations[i];
+    }
+  uint32_t reservedTime = std::min (dtiDuration, groupsTime + m_minBroadcastCbapDuration);
+  uint32_t extraTime = (slots.GetAvailableTime () > reservedTime) ? slots.GetAvailableTime () - reservedTime : 0;
+
+  uint32_t time = 0;
+  for (uint32_t i = 0; i < groups.size (); i++)
+    {
+      uint32_t duration = maxDurations[i];
+      if (deficit > extraTime)
+        {
+          duration = minDurations[i] + static_cast<uint64_t> (maxDurations[i] - minDurations[i]) * extraTime / deficit;
+        }
+      uint32_t start;
+      if (!slots.FindFirstFit (time, duration + m_guardTime, start)
+          && !slots.FindFirstFit (0, duration + m_guardTime, start))
+        {
+          NS_LOG_DEBUG ("No room left in the DTI for a group of " << groups[i].size () << " SPs");
+          continue;
+        }
+      for (std::vector<AllocationField>::const_iterator member = groups[i].begin (); member != groups[i].end (); ++member)
+        {
+          const Request &request = m_requests[GetIdentifier (*member)];
+          AllocationField field = *member;
+          field.SetAllocationStart (start);
+          field.SetAllocationBlockDuration (std::max (request.minDuration, std::min (duration, request.maxDuration)));
+          field.SetAllocationBlockPeriod (0);
+          field.SetNumberOfBlocks (1);
+          m_allocationList.push_back (field);
+        }
+      NS_LOG_DEBUG ("Scheduled " << groups[i].size () << " concurrent SPs at " << start << " for " << duration);
+      slots.Reserve (start, start + duration + m_guardTime);
+      time = start + duration + m_guardTime;
+    }
+
+  /* Allocate the time left as broadcast CBAP */
+  for (DtiAvailableSlots::SlotsCI it = slots.Begin (); it != slots.End (); ++it)
+    {
+      AllocationFieldList cbapList = GetBroadcastCbapAllocation (true, it->first, it->second - it->first);
+      for (AllocationFieldListI iter = cbapList.begin (); iter != cbapList.end (); ++iter)
+        {
+          if (m_allocationList.size () < MAX_ALLOCATION_FIELDS)
+            {
+              m_allocationList.push_back (*iter);
+            }
+        }
+    }
+
+  std::sort (m_allocationList.begin (),
+             m_allocationList.end (),
+             [](const AllocationField& lhs, const AllocationField& rhs){
+      return lhs.GetAllocationStart () < rhs.GetAllocationStart ();
+    });
+}
+
+void
+SpatialSharingDmgWifiScheduler::UpdateMeasurements (int64_t nextDtiStart)
+{
+  NS_LOG_FUNCTION (this << nextDtiStart);
+  /* Index the SPs of the next BI and the DMG STAs busy during each of them */
+  std::map<UniqueIdentifier, const AllocationField *> fields;
+  std::map<uint32_t, std::set<uint8_t> > busyStations;
+  for (AllocationFieldListCI iter = m_allocationList.begin (); iter != m_allocationList.end (); ++iter)
+    {
+      if (IsSharable (*iter))
+        {
+          fields[GetIdentifier (*iter)] = &(*iter);
+          busyStations[iter->GetAllocationStart ()].insert (iter->GetSourceAid ());
+          busyStations[iter->GetAllocationStart ()].insert (iter->GetDestinationAid ());
+        }
+    }
+
+  /* Drop the requests which have been answered already or whose interfering SP has moved */
+  for (PendingMeasurementMap::iterator it = m_pendingMeasurements.begin (); it != m_pendingMeasurements.end ();)
+    {
+      const PendingMeasurement &pending = it->second;
+      /* The report of a measurement of the last DTI may still be queued at the DMG STA */
+      bool isValid = (pending.dtiStart != nextDtiStart) && (pending.dtiStart + m_biDuration.GetMicroSeconds () >= nextDtiStart);
+      if (pending.dtiStart == nextDtiStart)
+        {
+          std::map<UniqueIdentifier, const AllocationField *>::const_iterator aggressor =
+              fields.find (std::get<1> (pending.key));
+          isValid = (aggressor != fields.end ())
+              && (aggressor->second->GetAllocationStart () == pending.start)
+              && (aggressor->second->GetAllocationBlockDuration () == pending.duration)
+              && (busyStations[pending.start].count (std::get<2> (pending.key)) == 0);
+        }
+      if (isValid)
+        {
+          ++it;
+        }
+      else
+        {
+          it = m_pendingMeasurements.erase (it);
+        }
+    }
+
+  /* Request the measurements of the SPs scheduled one after the other during the BI after the next one,
+     assuming that the allocations do not move in the meantime */
+  int64_t dtiStart = nextDtiStart + m_biDuration.GetMicroSeconds ();
+  for (std::map<UniqueIdentifier, const AllocationField *>::const_iterator victim = fields.begin ();
+       victim != fields.end (); ++victim)
+    {
+      for (std::map<UniqueIdentifier, const AllocationField *>::const_iterator aggressor = fields.begin ();
+           aggressor != fields.end (); ++aggressor)
+        {
+          uint32_t start = aggressor->second->GetAllocationStart ();
+          uint32_t duration = aggressor->second->GetAllocationBlockDuration ();
+          if ((victim == aggressor) || (victim->second->GetAllocationStart () == start))
+            {
+              continue;
+            }
+          uint8_t station = victim->second->GetDestinationAid ();
+          MeasurementKey key (victim->first, aggressor->first, station);
+          MeasurementMap::const_iterator measurement = m_measurements.find (key);
+          std::pair<uint8_t, uint64_t> pendingKey (station, dtiStart + start);
+          if (((measurement != m_measurements.end ())
+               && (measurement->second.time + m_measurementLifetime / 2 > Simulator::Now ()))
+              || (busyStations[start].count (station) != 0)
+              || (m_pendingMeasurements.find (pendingKey) != m_pendingMeasurements.end ()))
+            {
+              continue;
+            }
+          bool isRequested = false;
+          for (PendingMeasurementMap::const_iterator it = m_pendingMeasurements.begin ();
+               !isRequested && (it != m_pendingMeasurements.end ()); ++it)
+            {
+              isRequested = (it->second.key == key);
+            }
+          if (isRequested)
+            {
+              continue;
+            }
+
+          /* The DMG STA measures with its antenna steered towards the source of the measured SP */
+          Ptr<DirectionalChannelQualityRequestElement> element = Create<DirectionalChannelQualityRequestElement> ();
+          element->SetOperatingClass (0);
+          element->SetChannelNumber (0);
+          element->SetAid (victim->second->GetSourceAid ());
+          element->SetMeasurementMethod (ANIPI);
+          element->SetMeasurementStartTime (pendingKey.second);
+          element->SetMeasurementDuration (duration);
+          element->SetNumberOfTimeBlocks (m_measurementBlocks);
+          m_mac->SendDirectionalChannelQualityRequest (m_mac->GetStationAddress (station), 0, element);
+
+          PendingMeasurement pending = { key, dtiStart, start, duration };
+          m_pendingMeasurements[pendingKey] = pending;
+          NS_LOG_DEBUG ("Requested measurement to AID=" << +station << " during allocation ID "
+                        << +std::get<0> (aggressor->first) << " at " << pendingKey.second);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPATIAL_SHARING_DMG_WIFI_SCHEDULER_H
+#define SPATIAL_SHARING_DMG_WIFI_SCHEDULER_H
+
+#include "dmg-wifi-scheduler.h"
+
+namespace ns3 {
+
+/**
+ * \brief Spatial sharing of service periods for IEEE 802.11ad
+ *
+ * This scheduler allocates concurrent SPs to the links which do not interfere
+ * with each other (IEEE 802.11ad 9.35 Spatial sharing and interference mitigation).
+ *
+ * An ADDTS request is accepted if the minimum allocations of all the requests,
+ * scheduled one after the other, leave the minimum broadcast CBAP time in the
+ * DTI, so that the accepted allocations can always be served. At the end of
+ * every BI, the SPs between two non-AP DMG STAs are packed in groups of SPs
+ * which are compatible with each other, and the groups are scheduled one after
+ * the other. The DTI time saved by the concurrent SPs extends each group towards
+ * the maximum allocation of its SPs, and the time left is allocated as broadcast CBAP.
+ *
+ * Two SPs are compatible if the destination DMG STA of each SP, which receives
+ * the data frames, has measured with its antenna steered towards the source
+ * DMG STA a noise plus interference power (ANIPI) below a threshold during the
+ * SP of the other link, as reported in Directional Channel Quality reports.
+ * The PCP/AP requests these measurements for the pairs of SPs which are
+ * scheduled one after the other, during the occurrence of the SPs two BIs
+ * later. The measurements expire after a given lifetime, after which the SPs
+ * are scheduled one after the other again until they are measured again, so
+ * that the packing is re-validated against the latest measurements in every BI.
+ */
+class SpatialSharingDmgWifiScheduler : public DmgWifiScheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  SpatialSharingDmgWifiScheduler ();
+  virtual ~SpatialSharingDmgWifiScheduler ();
+
+protected:
+  virtual void DoDispose (void);
+  virtual void DoInitialize (void);
+  /**
+   * Handle the end of the BI by packing the SPs of the next BI.
+   */
+  virtual void BeaconIntervalEnded (void);
+  /**
+   * \param minAllocation The minimum acceptable allocation in us for each allocation period.
+   * \param maxAllocation The desired allocation in us for each allocation period.
+   * \return The allocation duration for the allocation period.
+   */
+  virtual uint32_t GetAllocationDuration (uint32_t minAllocation, uint32_t maxAllocation);
+  /**
+   * Implement the policy that accept, reject a new ADDTS request.
+   * \param sourceAid The AID of the requesting STA.
+   * \param dmgTspec The DMG Tspec element of the ADDTS request.
+   * \param info The DMG Allocation Info element of the request.
+   * \return The Status Code to be included in the ADDTS response.
+   */
+  virtual StatusCode AddNewAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info);
+  /**
+   * Implement the policy that accept, reject a modification request.
+   * \param sourceAid The AID of the requesting STA.
+   * \param dmgTspec The DMG Tspec element of the ADDTS request.
+   * \param info The DMG Allocation Info element of the request.
+   * \return The Status Code to be included in the ADDTS response.
+   */
+  virtual StatusCode ModifyExistingAllocation (uint8_t sourceAid, const DmgTspecElement &dmgTspec, const DmgAllocationInfo &info);
+  /**
+   * The allocations are placed in the DTI at the end of every BI, so nothing
+   * has to be adjusted here.
+   * \param iter The iterator pointing to the next element in the addtsAllocationList.
+   * \param duration The duration of the time to manage.
+   * \param isToAdd Whether the duration is to be added or subtracted.
+   */
+  virtual void AdjustExistingAllocations (AllocationFieldListI iter, uint32_t duration, bool isToAdd);
+  /**
+   * Update start time and remaining DTI time for the next request to be evaluated.
+   */
+  virtual void UpdateStartAndRemainingTime (void);
+  /**
+   * Pack the SPs in the DTI and add broadcast CBAP allocations in the time left.
+   */
+  virtual void AddBroadcastCbapAllocations (void);
+
+private:
+  /* Measured interference, indexed by the measuring link, the interfering link and the AID of the measuring STA */
+  typedef std::tuple<UniqueIdentifier, UniqueIdentifier, uint8_t> MeasurementKey;
+  /**
+   * The result of a measurement.
+   */
+  struct Measurement
+  {
+    double anipi;   //!< The highest ANIPI in dBm over the time blocks of the measurement.
+    Time time;      //!< The time of the report.
+  };
+  typedef std::map<MeasurementKey, Measurement> MeasurementMap;
+
+  /**
+   * A measurement requested to a DMG STA.
+   */
+  struct PendingMeasurement
+  {
+    MeasurementKey key;     //!< The measuring link, the interfering link and the AID of the measuring STA.
+    int64_t dtiStart;       //!< The absolute start time in microseconds of the DTI of the measurement.
+    uint32_t start;         //!< The start time of the interfering SP relative to the beginning of the DTI.
+    uint32_t duration;      //!< The duration of the interfering SP.
+  };
+  /* Requested measurements, indexed by the AID of the measuring STA and the TSF start time of the measurement */
+  typedef std::map<std::pair<uint8_t, uint64_t>, PendingMeasurement> PendingMeasurementMap;
+
+  /**
+   * The minimum and maximum allocations of an ADDTS request.
+   */
+  struct Request
+  {
+    uint32_t minDuration;   //!< The guaranteed duration of the SP.
+    uint32_t maxDuration;   //!< The desired duration of the SP.
+  };
+  typedef std::map<UniqueIdentifier, Request> RequestMap;
+
+  /**
+   * Handle a Directional Channel Quality report received by the PCP/AP.
+   * \param address The MAC address of the reporting STA.
+   * \param element The Directional Channel Quality report.
+   */
+  void ReceiveChannelQualityReport (Mac48Address address, Ptr<DirectionalChannelQualityReportElement> element);
+  /**
+   * \param field An allocation field.
+   * \return The unique identifier of the allocation.
+   */
+  static UniqueIdentifier GetIdentifier (const AllocationField &field);
+  /**
+   * \param field An allocation field.
+   * \return Whether the allocation is an SP requested by ADDTS between two non-AP DMG STAs.
+   */
+  bool IsSharable (const AllocationField &field) const;
+  /**
+   * \param first The first allocation field.
+   * \param second The second allocation field.
+   * \return Whether the two allocations can be scheduled at the same time.
+   */
+  bool AreCompatible (const AllocationField &first, const AllocationField &second) const;
+  /**
+   * \param key The measuring link, the interfering link and the AID of the measuring STA.
+   * \return Whether a measurement below the threshold has been reported within its lifetime.
+   */
+  bool IsInterferenceLow (const MeasurementKey &key) const;
+  /**
+   * \return The sum of the guaranteed durations of the allocations, scheduled one after the other.
+   */
+  uint32_t GetGuaranteedTime (void) const;
+  /**
+   * \param allocations The number of requested allocations.
+   * \return Whether the allocations and the broadcast CBAPs fit in an Extended Schedule element.
+   */
+  bool FitsInExtendedSchedule (uint32_t allocations) const;
+  /**
+   * Check the pending measurements against the allocations of the next BI,
+   * and request the missing measurements for the BI after.
+   * \param nextDtiStart The absolute start time in microseconds of the DTI of the next BI.
+   */
+  void UpdateMeasurements (int64_t nextDtiStart);
+  /**
+   * Remove the requests and the measurements of the allocations which do not exist anymore.
+   */
+  void RemoveTerminatedAllocations (void);
+
+  RequestMap m_requests;                        //!< The minimum and maximum allocations of the accepted ADDTS requests.
+  MeasurementMap m_measurements;                //!< The reported measurements.
+  PendingMeasurementMap m_pendingMeasurements;  //!< The requested measurements.
+  uint32_t m_minBroadcastCbapDuration;          //!< The minimum duration of broadcast CBAP to keep in the DTI.
+  double m_interferenceThreshold;               //!< The highest ANIPI in dBm allowing the SPs to be concurrent.
+  Time m_measurementLifetime;                   //!< The time after which a measurement expires.
+  uint8_t m_measurementBlocks;                  //!< The number of time blocks of the measurements.
+
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_SHARING_DMG_WIFI_SCHEDULER_H */
@@ -101,6 +101,7 @@ SpectrumDmgWifiPhy::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_channel = 0;
   m_wifiSpectrumPhyInterface = 0;
+  m_rxFilter = 0;
   WifiPhy::DoDispose ();
 }
 
@@ -168,6 +169,7 @@ SpectrumDmgWifiPhy::ResetSpectrumModel (void)
   // Replace existing spectrum model with new one, and must call AddRx ()
   // on the SpectrumChannel to provide this new spectrum model to it
   m_rxSpectrumModel = WifiSpectrumValueHelper::GetSpectrumModel (GetFrequency (), channelWidth, GetBandBandwidth (), GetGuardBandwidth (channelWidth));
+  m_rxFilter = 0;
   m_channel->AddRx (m_wifiSpectrumPhyInterface);
 }
 
@@ -272,12 +274,25 @@ SpectrumDmgWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
   // total energy apparent to the "demodulator".
 
   //TR++ channelWidth must be uint16_t
-  uint16_t channelWidth = GetChannelWidth ();
-  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (GetFrequency (), channelWidth, GetBandBandwidth (), GetGuardBandwidth (channelWidth));
-  SpectrumValue filteredSignal = (*filter) * (*receivedSignalPsd);
+  if (m_rxFilter == 0)
+    {
+      uint16_t channelWidth = GetChannelWidth ();
+      m_rxFilter = WifiSpectrumValueHelper::CreateRfFilter (GetFrequency (), channelWidth, GetBandBandwidth (), GetGuardBandwidth (channelWidth));
+    }
+  // The received PSD may be shared with other receivers, so integrate the
+  // filtered signal in place instead of building a new SpectrumValue.
+  NS_ASSERT (m_rxFilter->GetSpectrumModelUid () == receivedSignalPsd->GetSpectrumModelUid ());
+  double filteredPowerW = 0;
+  Values::const_iterator fit = m_rxFilter->ConstValuesBegin ();
+  Bands::const_iterator bit = receivedSignalPsd->ConstBandsBegin ();
+  for (Values::const_iterator vit = receivedSignalPsd->ConstValuesBegin ();
+       vit != receivedSignalPsd->ConstValuesEnd (); ++vit, ++fit, ++bit)
+    {
+      filteredPowerW += (*fit) * (*vit) * (bit->fh - bit->fl);
+    }
   // Add receiver antenna gain
-  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << Integral (filteredSignal));
-  double rxPowerW = Integral (filteredSignal) * DbToRatio (GetRxGain ());
+  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << filteredPowerW);
+  double rxPowerW = filteredPowerW * DbToRatio (GetRxGain ());
   NS_LOG_DEBUG ("Signal power received after antenna gain: " << rxPowerW << " W (" << WToDbm (rxPowerW) << " dBm)");
 
   Ptr<DmgWifiSpectrumSignalParameters> wifiRxParams = DynamicCast<DmgWifiSpectrumSignalParameters> (rxParams);
@@ -302,6 +317,9 @@ SpectrumDmgWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
   if (wifiRxParams->plcpFieldType == PLCP_80211AD_PREAMBLE_HDR_DATA)
     {
       NS_LOG_INFO ("Received DMG WiFi signal");
+      // The packet is shared by all the receivers of this signal. The receive
+      // path strips the WifiPhyTag and hands the packet to the MAC, hence each
+      // receiver needs its own (copy-on-write) handle.
       Ptr<Packet> packet = wifiRxParams->packet->Copy ();
       StartReceivePreambleAndHeader (packet, rxPowerW, rxDuration);
     }
@@ -153,6 +153,7 @@ private:
   mutable Ptr<const SpectrumModel> m_rxSpectrumModel;           //!< receive spectrum model.
   bool m_disableWifiReception;                                  //!< forces this Phy to fail to sync on any signal.
   TracedCallback<bool, uint32_t, double, Time> m_signalCb;      //!< Signal callback.
+  Ptr<SpectrumValue> m_rxFilter;                                //!< Cached receive RF filter for the current frequency/width pair.
 
 };
 
@@ -58,7 +58,9 @@ WifiMacQueue::GetTypeId (void)
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
+  : m_headOrder (0),
+    m_tailOrder (0),
+    NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
 {
 }
 
@@ -99,6 +101,178 @@ WifiMacQueue::TtlExceeded (ConstIterator &it)
   return false;
 }
 
+bool
+WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  bool front = (pos == Head ());
+  if (!Queue<WifiMacQueueItem>::DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  AddToIndex (std::prev (pos), front);
+  return true;
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeue (ConstIterator pos)
+{
+  RemoveFromIndex (pos);
+  return Queue<WifiMacQueueItem>::DoDequeue (pos);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemove (ConstIterator pos)
+{
+  RemoveFromIndex (pos);
+  return Queue<WifiMacQueueItem>::DoRemove (pos);
+}
+
+uint64_t
+WifiMacQueue::GetAddressKey (Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return key;
+}
+
+void
+WifiMacQueue::AddToIndex (ConstIterator it, bool front)
+{
+  const WifiMacHeader &hdr = (*it)->GetHeader ();
+  uint8_t tid = hdr.IsQosData () ? hdr.GetQosTid () : NON_QOS_TID;
+  uint64_t receiver = GetAddressKey (hdr.GetAddr1 ());
+  SubQueue *queue = &m_receivers[receiver][tid];
+  SubQueue::iterator entry;
+  if (front)
+    {
+      entry = queue->insert (queue->begin (), IndexEntry {it, --m_headOrder});
+    }
+  else
+    {
+      entry = queue->insert (queue->end (), IndexEntry {it, m_tailOrder++});
+    }
+  bool inserted = m_items.insert (std::make_pair (PeekPointer (*it), ItemPosition {receiver, tid, queue, entry})).second;
+  NS_ASSERT_MSG (inserted, "The item is already in the queue");
+}
+
+void
+WifiMacQueue::RemoveFromIndex (ConstIterator it)
+{
+  auto item = m_items.find (PeekPointer (*it));
+  NS_ASSERT (item != m_items.end ());
+  const ItemPosition &position = item->second;
+  position.queue->erase (position.entry);
+  if (position.queue->empty ())
+    {
+      // Do not keep the sub-queues, nor the receivers, that no longer have an item
+      auto receiver = m_receivers.find (position.receiver);
+      receiver->second.erase (position.tid);
+      if (receiver->second.empty ())
+        {
+          m_receivers.erase (receiver);
+        }
+    }
+  m_items.erase (item);
+}
+
+void
+WifiMacQueue::RebuildIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_receivers.clear ();
+  m_items.clear ();
+  m_headOrder = 0;
+  m_tailOrder = 0;
+  for (auto it = Head (); it != Tail (); it++)
+    {
+      AddToIndex (it, false);
+    }
+}
+
+WifiMacQueue::ReceiverQueues *
+WifiMacQueue::GetReceiverQueues (Mac48Address address)
+{
+  auto receiver = m_receivers.find (GetAddressKey (address));
+  if (receiver == m_receivers.end ())
+    {
+      return 0;
+    }
+  return &receiver->second;
+}
+
+WifiMacQueue::SubQueue *
+WifiMacQueue::GetSubQueue (Mac48Address address, uint8_t tid)
+{
+  ReceiverQueues *queues = GetReceiverQueues (address);
+  if (queues == 0)
+    {
+      return 0;
+    }
+  auto queue = queues->find (tid);
+  if (queue == queues->end ())
+    {
+      return 0;
+    }
+  return &queue->second;
+}
+
+WifiMacQueue::SubQueue *
+WifiMacQueue::RemoveStaleHead (Mac48Address address, uint8_t tid)
+{
+  SubQueue *queue;
+  // TtlExceeded removes the item from the sub-queue if it is stale, and the
+  // sub-queue itself once it is empty, hence it is looked up again every time
+  while ((queue = GetSubQueue (address, tid)) != 0)
+    {
+      ConstIterator it = queue->front ().it;
+      if (!TtlExceeded (it))
+        {
+          return queue;
+        }
+    }
+  return 0;
+}
+
+std::vector<uint8_t>
+WifiMacQueue::GetTids (Mac48Address address)
+{
+  std::vector<uint8_t> tids;
+  ReceiverQueues *queues = GetReceiverQueues (address);
+  if (queues != 0)
+    {
+      for (auto &queue : *queues)
+        {
+          tids.push_back (queue.first);
+        }
+    }
+  return tids;
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueue::FindFirstAvailableByReceiver (Mac48Address address,
+                                            const Ptr<QosBlockedDestinations> blockedPackets)
+{
+  // Dropping stale items may erase sub-queues, so iterate over their TIDs
+  std::vector<uint8_t> tids = GetTids (address);
+  const IndexEntry *first = 0;
+  for (uint8_t tid : tids)
+    {
+      SubQueue *queue;
+      if (tid != NON_QOS_TID && !blockedPackets->IsBlocked (address, tid)
+          && (queue = RemoveStaleHead (address, tid)) != 0
+          && (first == 0 || queue->front ().order < first->order))
+        {
+          first = &queue->front ();
+        }
+    }
+  return (first == 0) ? Tail () : first->it;
+}
+
 bool
 WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
 {
@@ -175,6 +349,17 @@ WifiMacQueue::DequeueByTidAndAddress (uint8_t tid,
 {
   NS_LOG_FUNCTION (this << dest);
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *queue = RemoveStaleHead (dest, tid);
+      if (queue != 0)
+        {
+          return DoDequeue (queue->front ().it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -219,6 +404,17 @@ WifiMacQueue::DequeueByAddress (WifiMacHeader::AddressType type, Mac48Address de
 {
   NS_LOG_FUNCTION (this << dest);
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      ConstIterator it = FindFirstAvailableByReceiver (dest, blockedPackets);
+      if (it != Tail ())
+        {
+          return DoDequeue (it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -260,6 +456,17 @@ WifiMacQueue::PeekByTidAndAddress (uint8_t tid,
 {
   NS_LOG_FUNCTION (this << dest);
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *queue = RemoveStaleHead (dest, tid);
+      if (queue != 0)
+        {
+          return DoPeek (queue->front ().it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -305,6 +512,17 @@ WifiMacQueue::PeekFirstAvailableByAddress (WifiMacHeader::AddressType type,
 {
   NS_LOG_FUNCTION (this);
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      ConstIterator it = FindFirstAvailableByReceiver (dest, blockedPackets);
+      if (it != Tail ())
+        {
+          return DoPeek (it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -368,6 +586,29 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
 
   uint32_t nPackets = 0;
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *queue = GetSubQueue (addr, tid);
+      if (queue != 0)
+        {
+          // TtlExceeded may erase the entries, and the sub-queue itself, so copy the positions first
+          std::vector<ConstIterator> items;
+          for (auto &entry : *queue)
+            {
+              items.push_back (entry.it);
+            }
+          for (ConstIterator it : items)
+            {
+              if (!TtlExceeded (it))
+                {
+                  nPackets++;
+                }
+            }
+        }
+      NS_LOG_DEBUG ("returns " << nPackets);
+      return nPackets;
+    }
+
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -414,6 +655,7 @@ WifiMacQueue::TransferPacketsByAddress (Mac48Address addr, Ptr<WifiMacQueue> des
               /* Copy the item to the new Queue */
               Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> ((*it)->GetPacket (), (*it)->GetHeader ());
               destQueue->Enqueue (item);
+              RemoveFromIndex (it);
               it = m_packets.erase (it);
               m_nBytes -= item->GetSize ();
               m_nPackets--;
@@ -436,6 +678,7 @@ WifiMacQueue::QuickTransfer (Ptr<WifiMacQueue> destQueue)
           /* Copy the item to the new Queue */
           Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> ((*it)->GetPacket (), (*it)->GetHeader ());
           destQueue->Enqueue (item);
+          RemoveFromIndex (it);
           it = m_packets.erase (it);
           m_nBytes -= item->GetSize ();
           m_nPackets--;
@@ -446,15 +689,12 @@ WifiMacQueue::QuickTransfer (Ptr<WifiMacQueue> destQueue)
 bool
 WifiMacQueue::HasPacketsForReceiver (Mac48Address addr)
 {
-  for (auto it = Head (); it != Tail (); )
+  // Dropping stale items may erase sub-queues, so iterate over their TIDs
+  for (uint8_t tid : GetTids (addr))
     {
-      if (!TtlExceeded (it))
+      if (RemoveStaleHead (addr, tid) != 0)
         {
-          if ((*it)->GetHeader ().GetAddr1 () == addr)
-            {
-              return true;
-            }
-          it++;
+          return true;
         }
     }
   return false;
@@ -463,6 +703,7 @@ WifiMacQueue::HasPacketsForReceiver (Mac48Address addr)
 void
 WifiMacQueue::ChangePacketsReceiverAddress (Mac48Address OriginalAddress, Mac48Address newAddress)
 {
+  bool changed = false;
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -470,10 +711,15 @@ WifiMacQueue::ChangePacketsReceiverAddress (Mac48Address OriginalAddress, Mac48A
           if (((*it)->GetHeader ().IsData ()) && ((*it)->GetHeader ().GetAddr1 () == OriginalAddress))
             {
               (*it)->SetAddress (WifiMacHeader::ADDR1, newAddress);
+              changed = true;
             }
           it++;
         }
     }
+  if (changed)
+    {
+      RebuildIndex ();
+    }
 }
 
 
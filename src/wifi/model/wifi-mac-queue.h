@@ -26,6 +26,10 @@
 
 #include "ns3/queue.h"
 #include "wifi-mac-queue-item.h"
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 
 namespace ns3 {
@@ -46,6 +50,13 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the FIFO, the queue keeps an index of the items by receiver address
+ * (Address 1) and TID, so that the methods looking for the packets of a given
+ * receiver (with type WifiMacHeader::ADDR1) do not walk the whole queue. These
+ * methods only drop the stale packets of the receiver they look at, the stale
+ * packets of the other receivers are dropped by the next operation walking the
+ * whole queue (or looking at their receiver).
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -266,9 +277,121 @@ private:
    */
   bool TtlExceeded (ConstIterator &it);
 
+  /// Position of an item in the queue, together with its rank in the FIFO order
+  struct IndexEntry
+  {
+    ConstIterator it;   //!< Iterator pointing to the item in the queue
+    int64_t order;      //!< Rank of the item, increasing from the head to the tail of the queue
+  };
+
+  /// The items of a receiver having the same TID, in FIFO order
+  typedef std::list<IndexEntry> SubQueue;
+  /// The sub-queues of a receiver indexed by TID (NON_QOS_TID for non-QoS data frames)
+  typedef std::map<uint8_t, SubQueue> ReceiverQueues;
+
+  /// Position of an item in the index
+  struct ItemPosition
+  {
+    uint64_t receiver;          //!< Key of the receiver of the item
+    uint8_t tid;                //!< TID of the sub-queue of the item
+    SubQueue *queue;            //!< Sub-queue of the item
+    SubQueue::iterator entry;   //!< Entry of the item in the sub-queue
+  };
+
+  static const uint8_t NON_QOS_TID = 0xff;  //!< Index of the items that are not QoS data frames
+
+  /**
+   * Enqueue the item before the given position and add it to the index.
+   * This hides Queue<WifiMacQueueItem>::DoEnqueue so that every insertion
+   * keeps the index up-to-date.
+   *
+   * \param pos the position before which the item is inserted
+   * \param item the item to enqueue
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Remove the item from the index and dequeue it.
+   *
+   * \param pos the position of the item to dequeue
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoDequeue (ConstIterator pos);
+  /**
+   * Remove the item from the index and drop it.
+   *
+   * \param pos the position of the item to drop
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
+
+  /**
+   * \param address a MAC address
+   * \return the key of the address in the index
+   */
+  static uint64_t GetAddressKey (Mac48Address address);
+  /**
+   * Add the item pointed to by <i>it</i> to the index.
+   *
+   * \param it an iterator pointing to the item
+   * \param front whether the item has been inserted at the head of the queue
+   */
+  void AddToIndex (ConstIterator it, bool front);
+  /**
+   * Remove the item pointed to by <i>it</i> from the index, together with its
+   * sub-queue and its receiver if they no longer have any item.
+   *
+   * \param it an iterator pointing to the item
+   */
+  void RemoveFromIndex (ConstIterator it);
+  /**
+   * Rebuild the index from the content of the queue, e.g., after the
+   * receiver address of some items has changed.
+   */
+  void RebuildIndex (void);
+  /**
+   * \param address the receiver address
+   * \return the sub-queues of the receiver, or 0 if the receiver is unknown
+   */
+  ReceiverQueues * GetReceiverQueues (Mac48Address address);
+  /**
+   * \param address the receiver address
+   * \param tid the TID
+   * \return the sub-queue of the receiver and TID, or 0 if it does not exist
+   */
+  SubQueue * GetSubQueue (Mac48Address address, uint8_t tid);
+  /**
+   * \param address the receiver address
+   * \return the TIDs of the sub-queues of the receiver
+   */
+  std::vector<uint8_t> GetTids (Mac48Address address);
+  /**
+   * Drop the stale items at the head of the sub-queue of the given receiver and TID.
+   *
+   * \param address the receiver address
+   * \param tid the TID
+   * \return the sub-queue if it still contains an item, or 0 otherwise
+   */
+  SubQueue * RemoveStaleHead (Mac48Address address, uint8_t tid);
+  /**
+   * Find the first QoS data frame of the receiver that is not blocked,
+   * dropping the stale ones met along the way.
+   *
+   * \param address the receiver address
+   * \param blockedPackets the blocked (receiver, TID) pairs
+   * \return an iterator pointing to the item, or Tail () if there is none
+   */
+  ConstIterator FindFirstAvailableByReceiver (Mac48Address address,
+                                              const Ptr<QosBlockedDestinations> blockedPackets);
+
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
 
+  std::unordered_map<uint64_t, ReceiverQueues> m_receivers;   //!< Index of the items by receiver and TID
+  std::unordered_map<const WifiMacQueueItem *, ItemPosition> m_items;  //!< Position of each item in the index
+  int64_t m_headOrder;                      //!< Rank given to the next item inserted at the head
+  int64_t m_tailOrder;                      //!< Rank given to the next item inserted at the tail
+
   NS_LOG_TEMPLATE_DECLARE;                  //!< redefinition of the log component
 };
 
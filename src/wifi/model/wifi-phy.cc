@@ -32,6 +32,7 @@
 #include "frame-capture-model.h"
 #include "wifi-radio-energy-model.h"
 #include "error-rate-model.h"
+#include <limits>
 
 namespace ns3 {
 
@@ -229,6 +230,15 @@ WifiPhy::GetTypeId (void)
                    MakeDoubleAccessor (&WifiPhy::SetRxNoiseFigure,
                                        &WifiPhy::GetRxNoiseFigure),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxInterferenceTimelineSize",
+                   "The maximum number of noise and interference changes kept by the interference helper. "
+                   "Changes that no in-flight signal refers to are always pruned; this cap additionally "
+                   "drops the oldest history when many signals overlap. The default, the largest value, "
+                   "means no cap.",
+                   UintegerValue (std::numeric_limits<uint32_t>::max ()),
+                   MakeUintegerAccessor (&WifiPhy::SetMaxInterferenceTimelineSize,
+                                         &WifiPhy::GetMaxInterferenceTimelineSize),
+                   MakeUintegerChecker<uint32_t> (2))
     .AddAttribute ("State",
                    "The state of the PHY layer.",
                    PointerValue (),
@@ -351,6 +361,11 @@ WifiPhy::GetTypeId (void)
                      "in monitor mode to sniff all frames being transmitted",
                      MakeTraceSourceAccessor (&WifiPhy::m_phyMonitorSniffTxTrace),
                      "ns3::WifiPhy::MonitorSnifferTxTracedCallback")
+    .AddTraceSource ("InterferenceTimelineSize",
+                     "The number of noise and interference changes kept by the interference helper, "
+                     "reported whenever the timeline grows or is pruned.",
+                     MakeTraceSourceAccessor (&WifiPhy::m_interferenceTimelineSizeTrace),
+                     "ns3::WifiPhy::InterferenceTimelineSizeCallback")
   ;
   return tid;
 }
@@ -378,6 +393,7 @@ WifiPhy::WifiPhy ()
   m_random = CreateObject<UniformRandomVariable> ();
   m_state = CreateObject<WifiPhyStateHelper> ();
   m_interference.SetWifiPhy (this);
+  m_interference.SetNiChangesSizeCallback (MakeCallback (&WifiPhy::NotifyInterferenceTimelineSize, this));
   m_totalBits = 0;
 }
 
@@ -515,6 +531,25 @@ WifiPhy::GetRxNoiseFigure (void) const
   return RatioToDb (m_interference.GetNoiseFigure ());
 }
 
+void
+WifiPhy::SetMaxInterferenceTimelineSize (uint32_t maxSize)
+{
+  NS_LOG_FUNCTION (this << maxSize);
+  m_interference.SetMaxNiChanges (maxSize);
+}
+
+uint32_t
+WifiPhy::GetMaxInterferenceTimelineSize (void) const
+{
+  return m_interference.GetMaxNiChanges ();
+}
+
+void
+WifiPhy::NotifyInterferenceTimelineSize (uint32_t size)
+{
+  m_interferenceTimelineSizeTrace (size);
+}
+
 void
 WifiPhy::SetTxPowerStart (double start)
 {
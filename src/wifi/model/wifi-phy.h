@@ -275,7 +275,7 @@ public:
    *
    * \return the total amount of time this PHY will stay busy for the transmission of the PLCP preamble and PLCP header.
    */
-  Time CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector);
+  virtual Time CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector);
 
   /**
    * \param txVector the transmission parameters used for this packet
@@ -1267,6 +1267,13 @@ public:
                                             WifiTxVector txVector,
                                             MpduInfo aMpdu);
 
+  /**
+   * TracedCallback signature for changes of the interference timeline size.
+   *
+   * \param size the number of noise and interference changes kept
+   */
+  typedef void (* InterferenceTimelineSizeCallback)(uint32_t size);
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model. Return the number of streams (possibly zero) that
@@ -1323,6 +1330,20 @@ public:
    * \return the RX noise figure in dBm
    */
   double GetRxNoiseFigure (void) const;
+  /**
+   * Sets the maximum number of noise and interference changes kept by the
+   * interference helper.
+   *
+   * \param maxSize the maximum number of changes, at least 2
+   */
+  void SetMaxInterferenceTimelineSize (uint32_t maxSize);
+  /**
+   * Return the maximum number of noise and interference changes kept by the
+   * interference helper.
+   *
+   * \return the maximum number of changes
+   */
+  uint32_t GetMaxInterferenceTimelineSize (void) const;
   /**
    * Sets the minimum available transmission power level (dBm).
    *
@@ -1881,6 +1902,18 @@ private:
    */
   TracedCallback<Ptr<const Packet>, uint16_t, WifiTxVector, MpduInfo> m_phyMonitorSniffTxTrace;
 
+  /**
+   * The trace source fired with the number of noise and interference
+   * changes kept by the interference helper.
+   */
+  TracedCallback<uint32_t> m_interferenceTimelineSizeTrace;
+  /**
+   * Fire the interference timeline size trace source.
+   *
+   * \param size the number of noise and interference changes kept
+   */
+  void NotifyInterferenceTimelineSize (uint32_t size);
+
   std::vector<uint8_t> m_bssMembershipSelectorSet; //!< the BSS membership selector set
 
   WifiPhyStandard m_standard;     //!< WifiPhyStandard
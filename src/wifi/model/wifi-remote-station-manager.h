@@ -32,6 +32,7 @@
 #include "he-capabilities.h"
 #include "dmg-capabilities.h"
 #include "wifi-mac-header.h"
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -1478,6 +1479,15 @@ private:
    * \return WifiRemoteStation corresponding to the address
    */
   WifiRemoteStation* Lookup (Mac48Address address, const WifiMacHeader *header) const;
+  /**
+   * Return the key of a station in the hash indexes.
+   *
+   * \param address the address of the station
+   * \param tid the TID
+   *
+   * \return the 48 bits of the address followed by the 8 bits of the TID
+   */
+  static uint64_t GetStationKey (Mac48Address address, uint8_t tid);
 
   /**
    * Return whether the modulation class of the selected mode for the
@@ -1554,6 +1564,10 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  /// Hash index of the states of known stations, keyed by GetStationKey with TID 0
+  std::unordered_map<uint64_t, WifiRemoteStationState *> m_stateIndex;
+  /// Hash index of the information for each known stations, keyed by GetStationKey
+  std::unordered_map<uint64_t, WifiRemoteStation *> m_stationIndex;
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -21,6 +21,7 @@
 #include "wifi-utils.h"
 #include "wifi-mac-header.h"
 #include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -57,6 +58,26 @@ RatioToDb (double ratio)
   return 10.0 * std::log10 (ratio);
 }
 
+uint8_t
+DbmToAnipi (double dbm)
+{
+  if (dbm <= -110)
+    {
+      return 0;
+    }
+  else if (dbm > -0.5)
+    {
+      return 220;
+    }
+  return static_cast<uint8_t> (std::ceil ((dbm + 110) * 2));
+}
+
+double
+AnipiToDbm (uint8_t anipi)
+{
+  return -110 + 0.5 * std::min<uint8_t> (anipi, 220);
+}
+
 bool
 Is2_4Ghz (double frequency)
 {
@@ -71,6 +71,23 @@ double WToDbm (double w);
  * \return dB
  */
 double RatioToDb (double ratio);
+/**
+ * Encode a noise plus interference power as an ANIPI level, in steps of 0.5 dB
+ * from -110 dBm (0) to -0.5 dBm (219), 220 meaning a higher power (IEEE 802.11-2012 10.11.9.4).
+ *
+ * \param dbm the power in dBm
+ *
+ * \return the ANIPI level
+ */
+uint8_t DbmToAnipi (double dbm);
+/**
+ * Decode an ANIPI level.
+ *
+ * \param anipi the ANIPI level
+ *
+ * \return the upper bound in dBm of the noise plus interference power
+ */
+double AnipiToDbm (uint8_t anipi);
 /**
  * \param frequency the frequency to check
  * \return whether frequency is in the 2.4 GHz band
@@ -82,6 +82,8 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
+  std::vector<Simulator::ContextEvent> events;
+  events.reserve (m_phyList.size ());
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
     {
       if (sender != (*i))
@@ -109,11 +111,12 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
               dstNode = dstNetDevice->GetNode ()->GetId ();
             }
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm, duration);
+          Simulator::ContextEvent rx = {dstNode, delay, MakeEvent (&YansWifiChannel::Receive,
+                                                                   (*i), copy, rxPowerDbm, duration)};
+          events.push_back (rx);
         }
     }
+  Simulator::ScheduleWithContextBatch (events);
 }
 
 void
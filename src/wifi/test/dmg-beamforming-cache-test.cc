@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/dmg-beamforming-cache-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "dmg-test-network.h"
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgBeamformingCacheTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Beamforming Cache Round Trip
+ *
+ * A DMG STA trains its transmit sectors with a DMG AP in the DTI, through a
+ * beamforming sector list set for the DMG AP only, and the beamforming state
+ * of both devices is saved in a cache file, once with the seed and the run
+ * number in the entry and once without them. The same scenario is then built
+ * again without any custom sector list, and its beamforming state is restored
+ * from the cache file before the simulation starts. The restored state of each
+ * device should be the saved one. A scenario with another name should not find
+ * any entry in the cache file, and neither should a run with another run number
+ * unless the seed and the run number are ignored.
+ */
+class DmgBeamformingCacheTest : public TestCase
+{
+public:
+  DmgBeamformingCacheTest ();
+  virtual ~DmgBeamformingCacheTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Build the scenario.
+   * \param run the run number of the random number generators
+   * \return the DMG AP and the DMG STA devices
+   */
+  NetDeviceContainer Build (uint32_t run);
+  /**
+   * Callback for the association of the DMG STA.
+   * \param address the address of the DMG AP
+   * \param aid the association identifier
+   */
+  void StationAssociated (Mac48Address address, uint16_t aid);
+  /**
+   * Callback for the completion of an SLS by the DMG STA.
+   * \param address the address of the peer
+   * \param accessPeriod the access period of the SLS
+   * \param direction the role of the DMG STA
+   * \param isInitiatorTxss whether the initiator did a TxSS
+   * \param isResponderTxss whether the responder did a TxSS
+   * \param sectorId the best transmit sector
+   * \param antennaId the best transmit antenna
+   */
+  void SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                     BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                     SectorID sectorId, AntennaID antennaId);
+  /**
+   * \param devices the DMG devices
+   * \param index the index of the device
+   * \return the beamforming state of the device
+   */
+  std::string GetState (NetDeviceContainer devices, uint32_t index) const;
+
+  Ptr<DmgStaWifiMac> m_staMac;  ///< the MAC of the DMG STA
+  uint32_t m_slsCount;          ///< the number of SLS completed by the DMG STA in the DTI
+};
+
+DmgBeamformingCacheTest::DmgBeamformingCacheTest ()
+  : TestCase ("Check that the beamforming state restored from the cache is the saved one"),
+    m_slsCount (0)
+{
+}
+
+DmgBeamformingCacheTest::~DmgBeamformingCacheTest ()
+{
+}
+
+void
+DmgBeamformingCacheTest::StationAssociated (Mac48Address address, uint16_t aid)
+{
+  Simulator::Schedule (MilliSeconds (10), &DmgStaWifiMac::InitiateTxssCbap, m_staMac, address);
+}
+
+void
+DmgBeamformingCacheTest::SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                                       BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                                       SectorID sectorId, AntennaID antennaId)
+{
+  if ((accessPeriod == CHANNEL_ACCESS_DTI) && (direction == BeamformingInitiator))
+    {
+      m_slsCount++;
+    }
+}
+
+std::string
+DmgBeamformingCacheTest::GetState (NetDeviceContainer devices, uint32_t index) const
+{
+  std::ostringstream state;
+  StaticCast<DmgWifiMac> (StaticCast<WifiNetDevice> (devices.Get (index))->GetMac ())->SaveBeamformingState (state);
+  return state.str ();
+}
+
+NetDeviceContainer
+DmgBeamformingCacheTest::Build (uint32_t run)
+{
+  DmgTestNetwork network ("BeamformingCache");
+  network.SetRun (run);
+  network.AddSta (Vector (2.0, 1.0, 0.0));
+  network.Build ();
+  m_staMac = network.GetStaMac ();
+  return network.GetDevices ();
+}
+
+void
+DmgBeamformingCacheTest::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("beamforming.cache");
+
+  /* Train the DMG STA through the sectors facing the DMG AP, and save the beamforming state */
+  NetDeviceContainer devices = Build (1);
+  Antenna2SectorList sectorList;
+  for (SectorID sector = 4; sector <= 7; sector++)
+    {
+      sectorList[1].push_back (sector);
+    }
+  m_staMac->GetCodebook ()->SetBeamformingSectorList (TransmitSectorSweep, Mac48Address ("00:00:00:00:00:01"), sectorList);
+  m_staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&DmgBeamformingCacheTest::StationAssociated, this));
+  m_staMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&DmgBeamformingCacheTest::SlsCompleted, this));
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_slsCount, 1, "The DMG STA did not complete its TxSS");
+  DmgBeamformingCacheHelper cache (fileName, "DmgBeamformingCacheTest");
+  cache.Save (devices);
+  DmgBeamformingCacheHelper sharedCache (fileName, "DmgBeamformingCacheTest");
+  sharedCache.SetIgnoreSeedAndRun (true);
+  sharedCache.Save (devices);
+  std::string apState = GetState (devices, 0);
+  std::string staState = GetState (devices, 1);
+  m_staMac = 0;
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_NE (staState.find ("CONFIG 00:00:00:00:00:01"), std::string::npos,
+                         "The DMG STA has no best antenna configuration towards the DMG AP");
+  NS_TEST_ASSERT_MSG_NE (staState.find ("TXSECTORS 00:00:00:00:00:01 1 4 5 6 7"), std::string::npos,
+                         "The sector list of the DMG STA has not been saved");
+
+  /* Restore the beamforming state in the same run of the scenario */
+  devices = Build (1);
+  NS_TEST_ASSERT_MSG_EQ (DmgBeamformingCacheHelper (fileName, "OtherScenario").Load (devices), false,
+                         "The entry of another scenario has been restored");
+  NS_TEST_ASSERT_MSG_EQ (cache.Load (devices), true, "The beamforming state has not been restored");
+  NS_TEST_ASSERT_MSG_EQ (GetState (devices, 0), apState, "The DMG AP restored a different beamforming state");
+  NS_TEST_ASSERT_MSG_EQ (GetState (devices, 1), staState, "The DMG STA restored a different beamforming state");
+  m_staMac = 0;
+  Simulator::Destroy ();
+
+  /* Restore the beamforming state in the same scenario with another run number */
+  devices = Build (2);
+  NS_TEST_ASSERT_MSG_EQ (cache.Load (devices), false, "The entry of another run has been restored");
+  NS_TEST_ASSERT_MSG_EQ (sharedCache.Load (devices), true, "The beamforming state shared by the runs has not been restored");
+  NS_TEST_ASSERT_MSG_EQ (GetState (devices, 0), apState, "The DMG AP restored a different beamforming state");
+  NS_TEST_ASSERT_MSG_EQ (GetState (devices, 1), staState, "The DMG STA restored a different beamforming state");
+  m_staMac = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Beamforming Cache Test Suite
+ */
+class DmgBeamformingCacheTestSuite : public TestSuite
+{
+public:
+  DmgBeamformingCacheTestSuite ();
+};
+
+DmgBeamformingCacheTestSuite::DmgBeamformingCacheTestSuite ()
+  : TestSuite ("wifi-dmg-beamforming-cache", UNIT)
+{
+  AddTestCase (new DmgBeamformingCacheTest, TestCase::QUICK);
+}
+
+static DmgBeamformingCacheTestSuite g_dmgBeamformingCacheTestSuite; ///< the test suite
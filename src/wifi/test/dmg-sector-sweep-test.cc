@@ -0,0 +1,605 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/codebook-analytical.h"
+#include "dmg-test-network.h"
+#include <sstream>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DmgSectorSweepTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Fast Transmit Sector Sweep
+ *
+ * A DMG STA trains its transmit sectors with a DMG AP in the DTI, once with
+ * every SSW frame simulated and once with the sweep resolved analytically
+ * (FastSectorSweep attribute). Without any other transmitter, both sweeps
+ * should select the same best transmit sector, measured with the same SNR.
+ */
+class FastTransmitSectorSweepTest : public TestCase
+{
+public:
+  FastTransmitSectorSweepTest ();
+  virtual ~FastTransmitSectorSweepTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run a TxSS of the DMG STA with the DMG AP.
+   * \param fastSectorSweep whether the sweep is resolved analytically
+   * \param sector the best transmit sector of the DMG STA
+   * \param snr the SNR of the best transmit sector measured by the DMG AP
+   */
+  void RunTxss (bool fastSectorSweep, SectorID &sector, double &snr);
+  /**
+   * Callback for the association of the DMG STA.
+   * \param address the address of the DMG AP
+   * \param aid the association identifier
+   */
+  void StationAssociated (Mac48Address address, uint16_t aid);
+  /**
+   * Callback for the completion of an SLS by the DMG STA.
+   * \param address the address of the peer
+   * \param accessPeriod the access period of the SLS
+   * \param direction the role of the DMG STA
+   * \param isInitiatorTxss whether the initiator did a TxSS
+   * \param isResponderTxss whether the responder did a TxSS
+   * \param sectorId the best transmit sector
+   * \param antennaId the best transmit antenna
+   */
+  void SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                     BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                     SectorID sectorId, AntennaID antennaId);
+
+  Ptr<DmgApWifiMac> m_apMac;    ///< the MAC of the DMG AP
+  Ptr<DmgStaWifiMac> m_staMac;  ///< the MAC of the DMG STA
+  SectorID m_bestSector;        ///< the best transmit sector found in the DTI
+};
+
+FastTransmitSectorSweepTest::FastTransmitSectorSweepTest ()
+  : TestCase ("Check that the fast and the simulated TxSS select the same sector with the same SNR"),
+    m_bestSector (0)
+{
+}
+
+FastTransmitSectorSweepTest::~FastTransmitSectorSweepTest ()
+{
+}
+
+void
+FastTransmitSectorSweepTest::StationAssociated (Mac48Address address, uint16_t aid)
+{
+  Simulator::Schedule (MilliSeconds (10), &DmgStaWifiMac::InitiateTxssCbap, m_staMac, address);
+}
+
+void
+FastTransmitSectorSweepTest::SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                                           BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                                           SectorID sectorId, AntennaID antennaId)
+{
+  if ((accessPeriod == CHANNEL_ACCESS_DTI) && (direction == BeamformingInitiator))
+    {
+      m_bestSector = sectorId;
+    }
+}
+
+void
+FastTransmitSectorSweepTest::RunTxss (bool fastSectorSweep, SectorID &sector, double &snr)
+{
+  m_bestSector = 0;
+
+  DmgTestNetwork network ("FastSectorSweep");
+  network.SetApAttribute ("FastSectorSweep", BooleanValue (fastSectorSweep));
+  network.SetStaAttribute ("FastSectorSweep", BooleanValue (fastSectorSweep));
+  network.AddSta (Vector (2.0, 1.0, 0.0));
+  network.Build ();
+  m_apMac = network.GetApMac ();
+  m_staMac = network.GetStaMac ();
+
+  m_staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&FastTransmitSectorSweepTest::StationAssociated, this));
+  m_staMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&FastTransmitSectorSweepTest::SlsCompleted, this));
+
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+
+  /* The DMG AP stores the SNR of every transmit sector of the DMG STA it received */
+  std::ostringstream state;
+  m_apMac->SaveBeamformingState (state);
+  std::istringstream records (state.str ());
+  std::ostringstream prefix;
+  prefix << "TXSNR " << m_staMac->GetAddress () << " " << static_cast<uint16_t> (m_bestSector) << " 1 ";
+  std::string line;
+  snr = 0;
+  while (std::getline (records, line))
+    {
+      if (line.compare (0, prefix.str ().size (), prefix.str ()) == 0)
+        {
+          std::istringstream (line.substr (prefix.str ().size ())) >> snr;
+        }
+    }
+  sector = m_bestSector;
+
+  m_apMac = 0;
+  m_staMac = 0;
+  Simulator::Destroy ();
+}
+
+void
+FastTransmitSectorSweepTest::DoRun (void)
+{
+  SectorID legacySector, fastSector;
+  double legacySnr, fastSnr;
+  RunTxss (false, legacySector, legacySnr);
+  RunTxss (true, fastSector, fastSnr);
+
+  NS_TEST_ASSERT_MSG_NE (legacySector, 0, "The simulated TxSS did not complete");
+  NS_TEST_ASSERT_MSG_GT (legacySnr, 0, "No SNR measured for the best sector of the simulated TxSS");
+  NS_TEST_ASSERT_MSG_EQ (fastSector, legacySector, "The fast TxSS selected a different sector");
+  NS_TEST_ASSERT_MSG_EQ_TOL (fastSnr, legacySnr, legacySnr * 1e-6, "The fast TxSS measured a different SNR");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Beam Tracking under Mobility
+ *
+ * A DMG STA moves along a straight line past a DMG AP and trains its transmit
+ * sectors with the DMG AP every 100 ms in the DTI, once with full sweeps only
+ * and once with beam tracking (BeamTracking attribute). The best sector of the
+ * DMG STA drifts slowly from one SLS to the next, so with beam tracking most
+ * of the sweeps should be restricted around the predicted sector, while the
+ * best sector after each training should stay the one found with full sweeps.
+ */
+class BeamTrackingTest : public TestCase
+{
+public:
+  BeamTrackingTest ();
+  virtual ~BeamTrackingTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Train the DMG STA with the DMG AP periodically while the DMG STA moves.
+   * \param beamTracking whether beam tracking is enabled
+   * \param sectors the best transmit sector of the DMG STA after each training
+   */
+  void RunTracking (bool beamTracking, std::map<uint32_t, SectorID> &sectors);
+  /**
+   * Callback for the association of the DMG STA.
+   * \param address the address of the DMG AP
+   * \param aid the association identifier
+   */
+  void StationAssociated (Mac48Address address, uint16_t aid);
+  /**
+   * Start an SLS with the DMG AP and schedule the next one.
+   * \param address the address of the DMG AP
+   */
+  void StartTraining (Mac48Address address);
+  /**
+   * Callback for the completion of an SLS by the DMG STA.
+   * \param address the address of the peer
+   * \param accessPeriod the access period of the SLS
+   * \param direction the role of the DMG STA
+   * \param isInitiatorTxss whether the initiator did a TxSS
+   * \param isResponderTxss whether the responder did a TxSS
+   * \param sectorId the best transmit sector
+   * \param antennaId the best transmit antenna
+   */
+  void SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                     BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                     SectorID sectorId, AntennaID antennaId);
+  /**
+   * Callback for the completion of an SLS initiated by the DMG STA.
+   * \param address the address of the responder
+   * \param partial whether the TxSS swept only part of the sectors
+   * \param sectors the number of sectors of the TxSS
+   * \param duration the duration of the SLS
+   */
+  void BeamTrainingCompleted (Mac48Address address, bool partial, uint8_t sectors, Time duration);
+
+  Ptr<DmgStaWifiMac> m_staMac;                ///< the MAC of the DMG STA
+  uint32_t m_trainings;                       ///< the number of trainings started by the DMG STA
+  std::map<uint32_t, SectorID> m_sectors;     ///< the best transmit sector after each training
+  uint32_t m_fullSweeps;                      ///< the number of full TxSS of the DMG STA
+  uint32_t m_partialSweeps;                   ///< the number of restricted TxSS of the DMG STA
+};
+
+BeamTrackingTest::BeamTrackingTest ()
+  : TestCase ("Check that beam tracking replaces most full TxSS of a moving DMG STA without losing its best sector"),
+    m_trainings (0),
+    m_fullSweeps (0),
+    m_partialSweeps (0)
+{
+}
+
+BeamTrackingTest::~BeamTrackingTest ()
+{
+}
+
+void
+BeamTrackingTest::StationAssociated (Mac48Address address, uint16_t aid)
+{
+  Simulator::Schedule (MilliSeconds (10), &BeamTrackingTest::StartTraining, this, address);
+}
+
+void
+BeamTrackingTest::StartTraining (Mac48Address address)
+{
+  m_trainings++;
+  m_staMac->InitiateTxssCbap (address);
+  Simulator::Schedule (MilliSeconds (100), &BeamTrackingTest::StartTraining, this, address);
+}
+
+void
+BeamTrackingTest::SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                                BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                                SectorID sectorId, AntennaID antennaId)
+{
+  if ((accessPeriod == CHANNEL_ACCESS_DTI) && (direction == BeamformingInitiator))
+    {
+      m_sectors[m_trainings] = sectorId;
+    }
+}
+
+void
+BeamTrackingTest::BeamTrainingCompleted (Mac48Address address, bool partial, uint8_t sectors, Time duration)
+{
+  if (partial)
+    {
+      m_partialSweeps++;
+    }
+  else
+    {
+      m_fullSweeps++;
+    }
+}
+
+void
+BeamTrackingTest::RunTracking (bool beamTracking, std::map<uint32_t, SectorID> &sectors)
+{
+  m_trainings = 0;
+  m_sectors.clear ();
+  m_fullSweeps = 0;
+  m_partialSweeps = 0;
+
+  /* The DMG STA crosses the field of the DMG AP at walking speed */
+  DmgTestNetwork network ("BeamTracking");
+  network.SetApAttribute ("SSFramesPerSlot", UintegerValue (16));
+  network.SetApAttribute ("BeamTracking", BooleanValue (beamTracking));
+  network.SetStaAttribute ("BeamTracking", BooleanValue (beamTracking));
+  network.SetSectors (16);
+  network.SetStaMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  network.AddSta (Vector (-3.0, 1.5, 0.0));
+  network.Build ();
+  m_staMac = network.GetStaMac ();
+  network.GetNodes ().Get (1)->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (Vector (1.5, 0.0, 0.0));
+
+  m_staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&BeamTrackingTest::StationAssociated, this));
+  m_staMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&BeamTrackingTest::SlsCompleted, this));
+  m_staMac->TraceConnectWithoutContext ("BeamTrainingCompleted", MakeCallback (&BeamTrackingTest::BeamTrainingCompleted, this));
+
+  Simulator::Stop (Seconds (4.0));
+  Simulator::Run ();
+
+  sectors = m_sectors;
+  m_staMac = 0;
+  Simulator::Destroy ();
+}
+
+void
+BeamTrackingTest::DoRun (void)
+{
+  std::map<uint32_t, SectorID> fullSectors, trackingSectors;
+  RunTracking (false, fullSectors);
+  uint32_t fullOnly = m_fullSweeps;
+  NS_TEST_ASSERT_MSG_EQ (m_partialSweeps, 0, "A TxSS has been restricted without beam tracking");
+  RunTracking (true, trackingSectors);
+
+  /* A few full TxSS remain, for the first SLS and after an SNR loss */
+  NS_TEST_ASSERT_MSG_GT (fullOnly, 30, "Too few SLS completed without beam tracking");
+  NS_TEST_ASSERT_MSG_GT (m_partialSweeps, fullOnly / 2, "Too few restricted TxSS with beam tracking");
+  NS_TEST_ASSERT_MSG_LT (m_fullSweeps * 4, fullOnly, "Beam tracking did not replace most of the full TxSS");
+  /* The best sector crosses several sectors of the DMG STA during the run */
+  NS_TEST_ASSERT_MSG_EQ (fullSectors.size (), trackingSectors.size (), "Different number of completed trainings");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (fullSectors.begin ()->second - fullSectors.rbegin ()->second, 4,
+                               "The best sector did not drift enough");
+  for (std::map<uint32_t, SectorID>::const_iterator it = fullSectors.begin (); it != fullSectors.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (trackingSectors[it->first], it->second, "Beam tracking lost the best sector of training " << it->first);
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Hierarchical Transmit Sector Sweep
+ *
+ * A DMG STA trains its transmit sectors with a DMG AP every 100 ms in the DTI,
+ * with a codebook of 8 wide sectors split in 4 narrow sectors each. The wide
+ * sectors of the root level are swept in the A-BFT, so the first training
+ * should descend into the children of the best wide sector. The next trainings
+ * should only sweep the siblings of the best narrow sector. When the DMG STA
+ * moves away along the same direction, the SNR of the siblings drops by more
+ * than BeamTrackingSnrLoss, so the DMG STA should sweep the root level and
+ * descend again to the same narrow sector. The outage of the link should last
+ * from the end of the sibling sweep to the end of the root sweep.
+ */
+class HierarchicalSweepTest : public TestCase
+{
+public:
+  HierarchicalSweepTest ();
+  virtual ~HierarchicalSweepTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Build a codebook of wide sectors split in narrow child sectors.
+   * \param codebook the codebook of a DMG device
+   */
+  void BuildCodebook (Ptr<CodebookAnalytical> codebook);
+  /**
+   * Callback for the association of the DMG STA.
+   * \param address the address of the DMG AP
+   * \param aid the association identifier
+   */
+  void StationAssociated (Mac48Address address, uint16_t aid);
+  /**
+   * Start an SLS with the DMG AP and schedule the next one.
+   * \param address the address of the DMG AP
+   */
+  void StartTraining (Mac48Address address);
+  /**
+   * Callback for the completion of an SLS by the DMG STA.
+   * \param address the address of the peer
+   * \param accessPeriod the access period of the SLS
+   * \param direction the role of the DMG STA
+   * \param isInitiatorTxss whether the initiator did a TxSS
+   * \param isResponderTxss whether the responder did a TxSS
+   * \param sectorId the best transmit sector
+   * \param antennaId the best transmit antenna
+   */
+  void SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                     BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                     SectorID sectorId, AntennaID antennaId);
+  /**
+   * Callback for the completion of an SLS initiated by the DMG STA.
+   * \param address the address of the responder
+   * \param partial whether the TxSS swept only part of the sectors
+   * \param sectors the number of sectors of the TxSS
+   * \param duration the duration of the SLS
+   */
+  void BeamTrainingCompleted (Mac48Address address, bool partial, uint8_t sectors, Time duration);
+  /**
+   * Callback for the recovery of the beamformed link of the DMG STA.
+   * \param address the address of the peer
+   * \param outage the duration of the outage
+   */
+  void BeamLinkRecovered (Mac48Address address, Time outage);
+  /**
+   * \param sector a transmit sector of the DMG STA
+   * \return the wide sector of the root level holding the sector
+   */
+  SectorID GetRootSector (SectorID sector) const;
+
+  /// An SLS initiated by the DMG STA
+  struct Sweep
+  {
+    uint32_t training;  ///< the training which started the SLS
+    uint8_t sectors;    ///< the number of sectors swept
+    SectorID best;      ///< the best transmit sector after the SLS
+    Time end;           ///< the end of the SLS
+  };
+
+  static const uint8_t WIDE_SECTORS = 8;    ///< the number of sectors of the root level
+  static const uint8_t CHILD_SECTORS = 4;   ///< the number of children of each wide sector
+
+  Ptr<DmgStaWifiMac> m_staMac;    ///< the MAC of the DMG STA
+  uint32_t m_trainings;           ///< the number of trainings started by the DMG STA
+  SectorID m_abftSector;          ///< the best transmit sector found in the A-BFT
+  SectorID m_bestSector;          ///< the best transmit sector after the last SLS
+  std::vector<Sweep> m_sweeps;    ///< the SLS initiated by the DMG STA
+  std::vector<Time> m_outages;    ///< the outages of the beamformed link
+};
+
+HierarchicalSweepTest::HierarchicalSweepTest ()
+  : TestCase ("Check the descent, the sibling tracking and the root fallback of the hierarchical TxSS"),
+    m_trainings (0),
+    m_abftSector (0),
+    m_bestSector (0)
+{
+}
+
+HierarchicalSweepTest::~HierarchicalSweepTest ()
+{
+}
+
+void
+HierarchicalSweepTest::BuildCodebook (Ptr<CodebookAnalytical> codebook)
+{
+  double wideWidth = 360.0 / WIDE_SECTORS;
+  double narrowWidth = wideWidth / CHILD_SECTORS;
+  codebook->AppendAntenna (1, 0, 0);
+  for (uint8_t i = 0; i < WIDE_SECTORS; i++)
+    {
+      codebook->AppendSector (1, i + 1, i * wideWidth, wideWidth, TX_RX_SECTOR, BHI_SLS_SECTOR);
+    }
+  for (uint8_t i = 0; i < WIDE_SECTORS; i++)
+    {
+      for (uint8_t j = 0; j < CHILD_SECTORS; j++)
+        {
+          SectorID childID = WIDE_SECTORS + i * CHILD_SECTORS + j + 1;
+          double steeringAngle = fmod (i * wideWidth - wideWidth / 2 + (j + 0.5) * narrowWidth + 360.0, 360.0);
+          codebook->AppendSector (1, childID, steeringAngle, narrowWidth, TX_RX_SECTOR, SLS_SECTOR);
+          codebook->AppendChildSector (1, i + 1, childID);
+        }
+    }
+}
+
+SectorID
+HierarchicalSweepTest::GetRootSector (SectorID sector) const
+{
+  if (sector <= WIDE_SECTORS)
+    {
+      return sector;
+    }
+  return (sector - WIDE_SECTORS - 1) / CHILD_SECTORS + 1;
+}
+
+void
+HierarchicalSweepTest::StationAssociated (Mac48Address address, uint16_t aid)
+{
+  Simulator::Schedule (MilliSeconds (10), &HierarchicalSweepTest::StartTraining, this, address);
+}
+
+void
+HierarchicalSweepTest::StartTraining (Mac48Address address)
+{
+  m_trainings++;
+  m_staMac->InitiateTxssCbap (address);
+  Simulator::Schedule (MilliSeconds (100), &HierarchicalSweepTest::StartTraining, this, address);
+}
+
+void
+HierarchicalSweepTest::SlsCompleted (Mac48Address address, ChannelAccessPeriod accessPeriod,
+                                     BeamformingDirection direction, bool isInitiatorTxss, bool isResponderTxss,
+                                     SectorID sectorId, AntennaID antennaId)
+{
+  if ((accessPeriod == CHANNEL_ACCESS_BHI) && (m_abftSector == 0))
+    {
+      m_abftSector = sectorId;
+    }
+  else if ((accessPeriod == CHANNEL_ACCESS_DTI) && (direction == BeamformingInitiator))
+    {
+      m_bestSector = sectorId;
+    }
+}
+
+void
+HierarchicalSweepTest::BeamTrainingCompleted (Mac48Address address, bool partial, uint8_t sectors, Time duration)
+{
+  Sweep sweep;
+  sweep.training = m_trainings;
+  sweep.sectors = sectors;
+  sweep.best = m_bestSector;
+  sweep.end = Simulator::Now ();
+  m_sweeps.push_back (sweep);
+}
+
+void
+HierarchicalSweepTest::BeamLinkRecovered (Mac48Address address, Time outage)
+{
+  m_outages.push_back (outage);
+}
+
+void
+HierarchicalSweepTest::DoRun (void)
+{
+  DmgTestNetwork network ("HierarchicalSweep");
+  network.SetSectors (0);
+  network.SetStaMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  network.AddSta (Vector (2.0, 1.0, 0.0));
+  network.Build ();
+  m_staMac = network.GetStaMac ();
+  BuildCodebook (StaticCast<CodebookAnalytical> (network.GetApMac ()->GetCodebook ()));
+  BuildCodebook (StaticCast<CodebookAnalytical> (m_staMac->GetCodebook ()));
+
+  m_staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&HierarchicalSweepTest::StationAssociated, this));
+  m_staMac->TraceConnectWithoutContext ("SLSCompleted", MakeCallback (&HierarchicalSweepTest::SlsCompleted, this));
+  m_staMac->TraceConnectWithoutContext ("BeamTrainingCompleted", MakeCallback (&HierarchicalSweepTest::BeamTrainingCompleted, this));
+  m_staMac->TraceConnectWithoutContext ("BeamLinkRecovered", MakeCallback (&HierarchicalSweepTest::BeamLinkRecovered, this));
+
+  /* Between two trainings, the DMG STA moves away from the DMG AP along the same direction, losing 9.5 dB */
+  const uint32_t moveTraining = 6;
+  Ptr<MobilityModel> mobility = network.GetNodes ().Get (1)->GetObject<MobilityModel> ();
+  Simulator::Schedule (MilliSeconds (560), &MobilityModel::SetPosition, mobility, Vector (6.0, 3.0, 0.0));
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+
+  /* The root level swept in the A-BFT is followed by the children of the best wide sector */
+  NS_TEST_ASSERT_MSG_NE (m_abftSector, 0, "The DMG STA did not complete the A-BFT");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_abftSector, WIDE_SECTORS, "The A-BFT did not sweep the root level");
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps.size (), m_trainings + 2, "Wrong number of SLS");
+  NS_TEST_ASSERT_MSG_EQ (m_sweeps[0].training, 1, "The first training did not complete");
+  NS_TEST_ASSERT_MSG_EQ (+m_sweeps[0].sectors, +CHILD_SECTORS, "The first training did not sweep the children of the A-BFT sector");
+  NS_TEST_ASSERT_MSG_GT (m_sweeps[0].best, WIDE_SECTORS, "The first training did not select a narrow sector");
+  NS_TEST_ASSERT_MSG_EQ (GetRootSector (m_sweeps[0].best), m_abftSector, "The first training left the A-BFT sector");
+  SectorID leaf = m_sweeps[0].best;
+
+  for (std::vector<Sweep>::const_iterator sweep = m_sweeps.begin () + 1; sweep != m_sweeps.end (); ++sweep)
+    {
+      if (sweep->training == moveTraining + 1)
+        {
+          /* The siblings lose the SNR, so the root level is swept and the hierarchy is descended again */
+          NS_TEST_ASSERT_MSG_GT (m_sweeps.end () - sweep, 2, "The SNR loss was not followed by a descent");
+          NS_TEST_ASSERT_MSG_EQ (+sweep->sectors, +CHILD_SECTORS, "The training after the move did not sweep the siblings");
+          NS_TEST_ASSERT_MSG_EQ (sweep->best, leaf, "The siblings lost the best sector without rotation");
+          Time lost = sweep->end;
+          ++sweep;
+          NS_TEST_ASSERT_MSG_EQ (sweep->training, moveTraining + 1, "The SNR loss did not trigger another SLS");
+          NS_TEST_ASSERT_MSG_EQ (+sweep->sectors, +WIDE_SECTORS, "The SNR loss did not fall back to the root level");
+          NS_TEST_ASSERT_MSG_EQ (m_outages.size (), 1, "The outage of the link has not been reported once");
+          NS_TEST_ASSERT_MSG_EQ (m_outages.front (), sweep->end - lost, "The outage does not end with the root sweep");
+          NS_TEST_ASSERT_MSG_EQ (sweep->best, m_abftSector, "The root level selected another wide sector");
+          ++sweep;
+          NS_TEST_ASSERT_MSG_EQ (sweep->training, moveTraining + 1, "The root level was not refined");
+          NS_TEST_ASSERT_MSG_EQ (+sweep->sectors, +CHILD_SECTORS, "The root level was not followed by its children");
+          NS_TEST_ASSERT_MSG_EQ (sweep->best, leaf, "The descent selected another narrow sector");
+          continue;
+        }
+      /* Otherwise the best narrow sector is tracked among its siblings */
+      NS_TEST_ASSERT_MSG_EQ (+sweep->sectors, +CHILD_SECTORS, "Training " << sweep->training << " did not sweep the siblings only");
+      NS_TEST_ASSERT_MSG_EQ (sweep->best, leaf, "Training " << sweep->training << " lost the best narrow sector");
+    }
+
+  m_staMac = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DMG Sector Sweep Test Suite
+ */
+class DmgSectorSweepTestSuite : public TestSuite
+{
+public:
+  DmgSectorSweepTestSuite ();
+};
+
+DmgSectorSweepTestSuite::DmgSectorSweepTestSuite ()
+  : TestSuite ("wifi-dmg-sector-sweep", UNIT)
+{
+  AddTestCase (new FastTransmitSectorSweepTest, TestCase::QUICK);
+  AddTestCase (new BeamTrackingTest, TestCase::QUICK);
+  AddTestCase (new HierarchicalSweepTest, TestCase::QUICK);
+}
+
+static DmgSectorSweepTestSuite g_dmgSectorSweepTestSuite; ///< the test suite
@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dmg-test-network.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/codebook-analytical.h"
+#include "ns3/dmg-wifi-helper.h"
+#include "ns3/wifi-net-device.h"
+#include <iomanip>
+#include <sstream>
+
+namespace ns3 {
+
+DmgTestNetwork::DmgTestNetwork (std::string ssid)
+  : m_ssid (ssid),
+    m_apMac (DmgWifiMacHelper::Default ()),
+    m_staMac (DmgWifiMacHelper::Default ()),
+    m_scheduler ("ns3::CbapOnlyDmgWifiScheduler"),
+    m_sectors (8),
+    m_run (1),
+    m_staMobilityModel ("ns3::ConstantPositionMobilityModel")
+{
+  m_apMac.SetType ("ns3::DmgApWifiMac",
+                   "Ssid", SsidValue (Ssid (ssid)),
+                   "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                   "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                   "ATIPresent", BooleanValue (false));
+  m_staMac.SetType ("ns3::DmgStaWifiMac",
+                    "Ssid", SsidValue (Ssid (ssid)),
+                    "ActiveProbing", BooleanValue (false));
+}
+
+void
+DmgTestNetwork::SetApAttribute (std::string name, const AttributeValue &value)
+{
+  m_apMac.SetAttribute (name, value);
+}
+
+void
+DmgTestNetwork::SetStaAttribute (std::string name, const AttributeValue &value)
+{
+  m_staMac.SetAttribute (name, value);
+}
+
+void
+DmgTestNetwork::SetScheduler (std::string type)
+{
+  m_scheduler = type;
+}
+
+void
+DmgTestNetwork::SetSectors (uint8_t sectors)
+{
+  m_sectors = sectors;
+}
+
+void
+DmgTestNetwork::SetRun (uint32_t run)
+{
+  m_run = run;
+}
+
+void
+DmgTestNetwork::SetStaMobilityModel (std::string type)
+{
+  m_staMobilityModel = type;
+}
+
+void
+DmgTestNetwork::AddSta (Vector position)
+{
+  m_staPositions.push_back (position);
+}
+
+void
+DmgTestNetwork::Build (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (m_run);
+
+  DmgWifiHelper wifi;
+  DmgWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (60.48e9));
+
+  DmgWifiPhyHelper wifiPhy = DmgWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+  wifiPhy.Set ("ChannelNumber", UintegerValue (2));
+  wifiPhy.Set ("CcaMode1Threshold", DoubleValue (-79));
+  wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue (-79 + 3));
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS12"),
+                                                                "DataMode", StringValue ("DMG_MCS12"));
+  wifi.SetCodebook ("ns3::CodebookAnalytical", "CodebookType", EnumValue (EMPTY_CODEBOOK));
+  wifi.SetDmgScheduler (m_scheduler);
+
+  m_nodes = NodeContainer ();
+  m_nodes.Create (1 + m_staPositions.size ());
+  m_devices = wifi.Install (wifiPhy, m_apMac, m_nodes.Get (0));
+  for (uint32_t i = 0; i < m_staPositions.size (); i++)
+    {
+      m_devices.Add (wifi.Install (wifiPhy, m_staMac, m_nodes.Get (1 + i)));
+    }
+
+  for (uint32_t i = 0; i < m_devices.GetN (); i++)
+    {
+      std::ostringstream address;
+      address << "00:00:00:00:00:" << std::hex << std::setw (2) << std::setfill ('0') << i + 1;
+      m_devices.Get (i)->SetAddress (Mac48Address (address.str ().c_str ()));
+      if (m_sectors == 0)
+        {
+          continue;
+        }
+      Ptr<CodebookAnalytical> codebook
+        = StaticCast<CodebookAnalytical> (StaticCast<DmgWifiMac> (StaticCast<WifiNetDevice> (m_devices.Get (i))->GetMac ())->GetCodebook ());
+      codebook->AppendAntenna (1, 0, 0);
+      for (uint8_t j = 0; j < m_sectors; j++)
+        {
+          codebook->AppendSector (1, j + 1, j * 360.0 / m_sectors, 360.0 / m_sectors, TX_RX_SECTOR, BHI_SLS_SECTOR);
+        }
+    }
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (m_nodes.Get (0));
+  mobility.SetMobilityModel (m_staMobilityModel);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (std::vector<Vector>::const_iterator it = m_staPositions.begin (); it != m_staPositions.end (); ++it)
+    {
+      positionAlloc->Add (*it);
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  for (uint32_t i = 0; i < m_staPositions.size (); i++)
+    {
+      mobility.Install (m_nodes.Get (1 + i));
+    }
+}
+
+NetDeviceContainer
+DmgTestNetwork::GetDevices (void) const
+{
+  return m_devices;
+}
+
+NodeContainer
+DmgTestNetwork::GetNodes (void) const
+{
+  return m_nodes;
+}
+
+Ptr<DmgApWifiMac>
+DmgTestNetwork::GetApMac (void) const
+{
+  return StaticCast<DmgApWifiMac> (StaticCast<WifiNetDevice> (m_devices.Get (0))->GetMac ());
+}
+
+Ptr<DmgStaWifiMac>
+DmgTestNetwork::GetStaMac (uint32_t index) const
+{
+  return StaticCast<DmgStaWifiMac> (StaticCast<WifiNetDevice> (m_devices.Get (1 + index))->GetMac ());
+}
+
+} // namespace ns3
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DMG_TEST_NETWORK_H
+#define DMG_TEST_NETWORK_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/vector.h"
+#include "ns3/dmg-ap-wifi-mac.h"
+#include "ns3/dmg-sta-wifi-mac.h"
+#include "ns3/dmg-wifi-mac-helper.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief A DMG BSS for the DMG tests
+ *
+ * One DMG AP at the origin and DMG STAs at given positions, on channel 2 with
+ * Friis propagation loss, a transmit power of 10 dBm and DMG MCS12 for both
+ * control and data frames. The DMG AP uses 8 A-BFT slots and a BI of 102.4 ms
+ * without ATI. Each device gets a codebook of sectors steered evenly around
+ * it, unless the test fills the codebooks itself, and the devices get the MAC
+ * addresses 00:00:00:00:00:01, 00:00:00:00:00:02 and so on, so that a
+ * scenario built twice is the same.
+ */
+class DmgTestNetwork
+{
+public:
+  /**
+   * \param ssid the SSID of the BSS
+   */
+  DmgTestNetwork (std::string ssid);
+
+  /**
+   * \param name the name of an attribute of the DMG AP
+   * \param value the value of the attribute
+   */
+  void SetApAttribute (std::string name, const AttributeValue &value);
+  /**
+   * \param name the name of an attribute of the DMG STAs
+   * \param value the value of the attribute
+   */
+  void SetStaAttribute (std::string name, const AttributeValue &value);
+  /**
+   * \param type the DMG scheduler of the DMG AP
+   */
+  void SetScheduler (std::string type);
+  /**
+   * \param sectors the number of sectors of the codebook of each device, or 0 to leave the codebooks empty
+   */
+  void SetSectors (uint8_t sectors);
+  /**
+   * \param run the run number of the random number generators
+   */
+  void SetRun (uint32_t run);
+  /**
+   * \param type the mobility model of the DMG STAs, which are otherwise at a constant position
+   */
+  void SetStaMobilityModel (std::string type);
+  /**
+   * Add a DMG STA.
+   * \param position the initial position of the DMG STA
+   */
+  void AddSta (Vector position);
+  /**
+   * Create the nodes and the devices of the BSS.
+   */
+  void Build (void);
+
+  /**
+   * \return the DMG AP device followed by the DMG STA devices
+   */
+  NetDeviceContainer GetDevices (void) const;
+  /**
+   * \return the DMG AP node followed by the DMG STA nodes
+   */
+  NodeContainer GetNodes (void) const;
+  /**
+   * \return the MAC of the DMG AP
+   */
+  Ptr<DmgApWifiMac> GetApMac (void) const;
+  /**
+   * \param index the index of the DMG STA
+   * \return the MAC of the DMG STA
+   */
+  Ptr<DmgStaWifiMac> GetStaMac (uint32_t index = 0) const;
+
+private:
+  std::string m_ssid;                 ///< the SSID of the BSS
+  DmgWifiMacHelper m_apMac;           ///< the MAC helper of the DMG AP
+  DmgWifiMacHelper m_staMac;          ///< the MAC helper of the DMG STAs
+  std::string m_scheduler;            ///< the DMG scheduler of the DMG AP
+  uint8_t m_sectors;                  ///< the number of sectors of each codebook
+  uint32_t m_run;                     ///< the run number of the random number generators
+  std::string m_staMobilityModel;     ///< the mobility model of the DMG STAs
+  std::vector<Vector> m_staPositions; ///< the initial position of each DMG STA
+  NodeContainer m_nodes;              ///< the nodes of the BSS
+  NetDeviceContainer m_devices;       ///< the devices of the BSS
+};
+
+} // namespace ns3
+
+#endif /* DMG_TEST_NETWORK_H */
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/dti-available-slots.h"
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("DtiAvailableSlotsTest");
+
+/**
+ * \param slots the available slots
+ * \return the printed slots
+ */
+static std::string
+ToString (const DtiAvailableSlots &slots)
+{
+  std::ostringstream os;
+  os << slots;
+  return os.str ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Reserve and Release in the DTI Available Slots
+ *
+ * Time is reserved in the middle of a slot, at its edges and across several
+ * slots, then released next to the remaining slots. The slots should be split
+ * where the reserved time falls inside them and merged again as soon as they
+ * touch, with the available time kept up-to-date.
+ */
+class DtiAvailableSlotsReserveReleaseTest : public TestCase
+{
+public:
+  DtiAvailableSlotsReserveReleaseTest ();
+  virtual ~DtiAvailableSlotsReserveReleaseTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+DtiAvailableSlotsReserveReleaseTest::DtiAvailableSlotsReserveReleaseTest ()
+  : TestCase ("Check that the DTI available slots are split and merged at their boundaries")
+{
+}
+
+DtiAvailableSlotsReserveReleaseTest::~DtiAvailableSlotsReserveReleaseTest ()
+{
+}
+
+void
+DtiAvailableSlotsReserveReleaseTest::DoRun (void)
+{
+  DtiAvailableSlots slots;
+  slots.Reset (1000);
+  NS_TEST_ASSERT_MSG_EQ (ToString (slots), "[0, 1000) ", "Wrong slots after a reset");
+
+  /* A reservation inside a slot splits it in two */
+  slots.Reserve (200, 300);
+  NS_TEST_ASSERT_MSG_EQ (ToString (slots), "[0, 200) [300, 1000) ", "The slot has not been split");
+  NS_TEST_ASSERT_MSG_EQ (slots.GetAvailableTime (), 900, "Wrong available time after a split");
+
+  /* Reservations at the edges of a slot shrink it without leaving an empty slot */
+  slots.Reserve (0, 50);
+  slots.Reserve (950, 1000);
+  NS_TEST_ASSERT_MSG_EQ (ToString (slots), "[50, 200) [300, 950) ", "Wrong slots after reserving their edges");
+  NS_TEST_ASSERT_MSG_EQ (slots.GetAvailableTime (), 800, "Wrong available time after reserving the edges");
+
+  /* A reservation across several slots removes the allocated time only */
+  slots.Reserve (100, 400);
+  NS_TEST_ASSERT_MSG_EQ (ToString (slots), "[50, 100) [400, 950) ", "Wrong slots after a reservation across slots");
+  NS_TEST_ASSERT_MSG_EQ (slots.GetAvailableTime (), 600, "Wrong available time after a reservation across slots");
+
+  /* A release touching the end of a slot and the start of the next one merges the three */
+  slots.Release (100, 400);
+  NS_TEST_ASSERT_MSG_EQ (ToString (slots), "[50, 950) ", "Adjacent slots have not been merged");
+  NS_TEST_ASSERT_MSG_EQ (slots.GetAvailableTime (), 900, "Wrong available time after merging adjacent slots");
+
+  /* A release overlapping a slot does not count its time twice */
+  slots.Release (0, 100);
+  slots.Release (900, 1000);
+  NS_TEST_ASSERT_MSG_EQ (ToString (slots), "[0, 1000) ", "Overlapping slots have not been merged");
+  NS_TEST_ASSERT_MSG_EQ (slots.GetAvailableTime (), 1000, "Wrong available time after overlapping releases");
+
+  /* Empty intervals are ignored */
+  slots.Reserve (500, 500);
+  slots.Release (1200, 1100);
+  NS_TEST_ASSERT_MSG_EQ (ToString (slots), "[0, 1000) ", "An empty interval changed the slots");
+
+  /* Reserving the whole DTI leaves no slot */
+  slots.Reserve (0, 1000);
+  NS_TEST_ASSERT_MSG_EQ (slots.IsEmpty (), true, "A slot is left after reserving the whole DTI");
+  NS_TEST_ASSERT_MSG_EQ (slots.GetAvailableTime (), 0, "Time is left after reserving the whole DTI");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Lookups in the DTI Available Slots
+ *
+ * The slot holding a given time is looked up at the boundaries of the slots,
+ * which are closed at their start and open at their end. The first fit should
+ * start within the slot holding the given time when the rest of that slot is
+ * large enough, skip the slots that are too short, and fail when no slot
+ * after the given time is large enough.
+ */
+class DtiAvailableSlotsLookupTest : public TestCase
+{
+public:
+  DtiAvailableSlotsLookupTest ();
+  virtual ~DtiAvailableSlotsLookupTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+DtiAvailableSlotsLookupTest::DtiAvailableSlotsLookupTest ()
+  : TestCase ("Check the lookup of the DTI available slots at their boundaries")
+{
+}
+
+DtiAvailableSlotsLookupTest::~DtiAvailableSlotsLookupTest ()
+{
+}
+
+void
+DtiAvailableSlotsLookupTest::DoRun (void)
+{
+  DtiAvailableSlots slots;
+  slots.Reset (1000);
+  slots.Reserve (100, 200);
+  slots.Reserve (250, 600);
+  /* Available: [0, 100) [200, 250) [600, 1000) */
+
+  NS_TEST_ASSERT_MSG_EQ ((slots.Find (0) == slots.Begin ()), true, "The start of the DTI is not found");
+  NS_TEST_ASSERT_MSG_EQ ((slots.Find (99) == slots.Begin ()), true, "The end of the first slot is not found");
+  NS_TEST_ASSERT_MSG_EQ ((slots.Find (100) == slots.End ()), true, "The end of a slot is available");
+  NS_TEST_ASSERT_MSG_EQ (slots.Find (200)->first, 200, "The start of a slot is not found");
+  NS_TEST_ASSERT_MSG_EQ (slots.Find (200)->second, 250, "Wrong end of the slot found");
+  NS_TEST_ASSERT_MSG_EQ ((slots.Find (400) == slots.End ()), true, "Allocated time is available");
+  NS_TEST_ASSERT_MSG_EQ ((slots.Find (1000) == slots.End ()), true, "The end of the DTI is available");
+
+  uint32_t start = 0;
+  NS_TEST_ASSERT_MSG_EQ (slots.FindFirstFit (20, 80, start), true, "The rest of the first slot does not fit");
+  NS_TEST_ASSERT_MSG_EQ (start, 20, "The fit does not start at the given time");
+  NS_TEST_ASSERT_MSG_EQ (slots.FindFirstFit (21, 80, start), true, "No fit after the first slot");
+  NS_TEST_ASSERT_MSG_EQ (start, 600, "The fit does not skip the slots which are too short");
+  NS_TEST_ASSERT_MSG_EQ (slots.FindFirstFit (100, 50, start), true, "No fit from allocated time");
+  NS_TEST_ASSERT_MSG_EQ (start, 200, "The fit does not start at the next slot");
+  NS_TEST_ASSERT_MSG_EQ (slots.FindFirstFit (0, 400, start), true, "The last slot does not fit");
+  NS_TEST_ASSERT_MSG_EQ (start, 600, "Wrong start of the fit in the last slot");
+
+  start = 12345;
+  NS_TEST_ASSERT_MSG_EQ (slots.FindFirstFit (0, 401, start), false, "An interval larger than any slot fits");
+  NS_TEST_ASSERT_MSG_EQ (slots.FindFirstFit (601, 400, start), false, "An interval past the end of the DTI fits");
+  NS_TEST_ASSERT_MSG_EQ (slots.FindFirstFit (1000, 1, start), false, "An interval at the end of the DTI fits");
+  NS_TEST_ASSERT_MSG_EQ (start, 12345, "A failed fit changed the start time");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief DTI Available Slots Test Suite
+ */
+class DtiAvailableSlotsTestSuite : public TestSuite
+{
+public:
+  DtiAvailableSlotsTestSuite ();
+};
+
+DtiAvailableSlotsTestSuite::DtiAvailableSlotsTestSuite ()
+  : TestSuite ("wifi-dti-available-slots", UNIT)
+{
+  AddTestCase (new DtiAvailableSlotsReserveReleaseTest, TestCase::QUICK);
+  AddTestCase (new DtiAvailableSlotsLookupTest, TestCase::QUICK);
+}
+
+static DtiAvailableSlotsTestSuite g_dtiAvailableSlotsTestSuite; ///< the test suite
@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/edf-dmg-wifi-scheduler.h"
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EdfDmgWifiSchedulerTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief EDF scheduler exposing its admission policy to the tests
+ */
+class EdfDmgWifiSchedulerUnderTest : public EdfDmgWifiScheduler
+{
+public:
+  /**
+   * Start a new beacon interval.
+   * \param biDuration the duration of the BI
+   * \param dtiDuration the duration of the DTI
+   */
+  void StartBeaconInterval (Time biDuration, Time dtiDuration)
+  {
+    m_biDuration = biDuration;
+    m_dtiDuration = dtiDuration;
+    UpdateStartAndRemainingTime ();
+  }
+  /**
+   * \param sourceAid the AID of the requesting STA
+   * \param dmgTspec the DMG TSPEC of the request
+   * \return the status code of the ADDTS response
+   */
+  StatusCode Request (uint8_t sourceAid, const DmgTspecElement &dmgTspec)
+  {
+    return AddNewAllocation (sourceAid, dmgTspec, dmgTspec.GetDmgAllocationInfo ());
+  }
+  /**
+   * \return the TS Delay element of the ADDTS response
+   */
+  TsDelayElement GetTsDelay (void)
+  {
+    return GetTsDelayElement ();
+  }
+  /**
+   * \return the allocations to announce in the next BI
+   */
+  AllocationFieldList GetAllocations (void)
+  {
+    return GetAllocationList ();
+  }
+  /**
+   * End the current beacon interval, which plans the DTI of the next one.
+   */
+  void EndBeaconInterval (void)
+  {
+    SetAllocationsAnnounced ();
+    BeaconIntervalEnded ();
+  }
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Earliest Deadline First Scheduling
+ *
+ * Three pseudo-static flows are requested to the EDF scheduler, from the one
+ * with the latest deadline to the one with the earliest deadline. The first
+ * jobs of the flows, released together at the beginning of the DTI, should be
+ * served in deadline order without missing any deadline. A fourth flow that
+ * does not fit in the DTI with the other ones should then be rejected with a
+ * TS Delay element, without changing the allocations of the accepted flows.
+ */
+class EdfDeadlineOrderTest : public TestCase
+{
+public:
+  EdfDeadlineOrderTest ();
+  virtual ~EdfDeadlineOrderTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the test once the simulation has started.
+   */
+  void Run (void);
+  /**
+   * \param allocationPeriod the number of SPs per BI
+   * \param duration the minimum and maximum allocation in microseconds
+   * \return the DMG TSPEC of a pseudo-static isochronous allocation towards the DMG AP
+   */
+  DmgTspecElement GetDmgTspec (uint16_t allocationPeriod, uint16_t duration) const;
+  /**
+   * Callback for a job scheduled in the DTI.
+   * \param allocationId the ID of the allocation
+   * \param sourceAid the AID of the source DMG STA
+   * \param destAid the AID of the destination DMG STA
+   * \param latency the time from the release of the job to the end of its SP
+   */
+  void JobScheduled (AllocationID allocationId, uint8_t sourceAid, uint8_t destAid, Time latency);
+  /**
+   * Callback for a job that missed its deadline.
+   * \param allocationId the ID of the allocation
+   * \param sourceAid the AID of the source DMG STA
+   * \param destAid the AID of the destination DMG STA
+   */
+  void DeadlineMissed (AllocationID allocationId, uint8_t sourceAid, uint8_t destAid);
+
+  std::vector<uint8_t> m_jobs;      ///< the source AID of the scheduled jobs, in scheduling order
+  std::vector<Time> m_latencies;    ///< the latency of the scheduled jobs
+  uint32_t m_misses;                ///< the number of missed deadlines
+};
+
+EdfDeadlineOrderTest::EdfDeadlineOrderTest ()
+  : TestCase ("Check that the EDF scheduler serves the earliest deadline first and rejects unschedulable flows"),
+    m_misses (0)
+{
+}
+
+EdfDeadlineOrderTest::~EdfDeadlineOrderTest ()
+{
+}
+
+DmgTspecElement
+EdfDeadlineOrderTest::GetDmgTspec (uint16_t allocationPeriod, uint16_t duration) const
+{
+  DmgTspecElement element;
+  DmgAllocationInfo info;
+  info.SetAllocationID (1);
+  info.SetAllocationType (SERVICE_PERIOD_ALLOCATION);
+  info.SetAllocationFormat (ISOCHRONOUS);
+  info.SetAsPseudoStatic (true);
+  info.SetDestinationAid (AID_AP);
+  element.SetDmgAllocationInfo (info);
+  element.SetAllocationPeriod (allocationPeriod, false);
+  element.SetMinimumAllocation (duration);
+  element.SetMaximumAllocation (duration);
+  element.SetMinimumDuration (duration);
+  return element;
+}
+
+void
+EdfDeadlineOrderTest::JobScheduled (AllocationID allocationId, uint8_t sourceAid, uint8_t destAid, Time latency)
+{
+  m_jobs.push_back (sourceAid);
+  m_latencies.push_back (latency);
+}
+
+void
+EdfDeadlineOrderTest::DeadlineMissed (AllocationID allocationId, uint8_t sourceAid, uint8_t destAid)
+{
+  m_misses++;
+}
+
+void
+EdfDeadlineOrderTest::Run (void)
+{
+  const Time biDuration = MilliSeconds (100);
+  const Time dtiDuration = MilliSeconds (99);
+  Ptr<EdfDmgWifiSchedulerUnderTest> scheduler = CreateObject<EdfDmgWifiSchedulerUnderTest> ();
+  scheduler->TraceConnectWithoutContext ("JobScheduled", MakeCallback (&EdfDeadlineOrderTest::JobScheduled, this));
+  scheduler->TraceConnectWithoutContext ("DeadlineMissed", MakeCallback (&EdfDeadlineOrderTest::DeadlineMissed, this));
+
+  /* Service intervals of 100 ms, 50 ms and 25 ms, requested by the STAs with AIDs 1, 2 and 3 */
+  scheduler->StartBeaconInterval (biDuration, dtiDuration);
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Request (1, GetDmgTspec (1, 20000)).IsSuccess (), true, "The first flow has been rejected");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Request (2, GetDmgTspec (2, 5000)).IsSuccess (), true, "The second flow has been rejected");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->Request (3, GetDmgTspec (4, 2000)).IsSuccess (), true, "The third flow has been rejected");
+  scheduler->EndBeaconInterval ();
+
+  /* Every BI, the flows are served 1, 2 and 4 times */
+  NS_TEST_ASSERT_MSG_EQ (m_jobs.size (), 7, "Wrong number of scheduled jobs");
+  NS_TEST_ASSERT_MSG_EQ (m_misses, 0, "A deadline has been missed");
+  NS_TEST_ASSERT_MSG_EQ (+m_jobs[0], 3, "The job with the earliest deadline has not been served first");
+  NS_TEST_ASSERT_MSG_EQ (+m_jobs[1], 2, "The job with the second deadline has not been served second");
+  NS_TEST_ASSERT_MSG_EQ (+m_jobs[2], 1, "The job with the latest deadline has not been served last");
+  const uint32_t periods[] = { 100000, 50000, 25000 };
+  for (uint32_t i = 0; i < m_jobs.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_latencies[i], MicroSeconds (periods[m_jobs[i] - 1]),
+                                   "Job " << i << " has been served after its deadline");
+    }
+
+  /* The allocation of the earliest deadline starts the DTI */
+  AllocationFieldList allocations = scheduler->GetAllocations ();
+  std::vector<uint8_t> sps;
+  for (AllocationFieldList::const_iterator it = allocations.begin (); it != allocations.end (); ++it)
+    {
+      if (it->GetAllocationType () == SERVICE_PERIOD_ALLOCATION)
+        {
+          sps.push_back (it->GetSourceAid ());
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (sps.size (), 3, "Each flow should be announced by at least one allocation field");
+  NS_TEST_ASSERT_MSG_EQ (+sps[0], 3, "The allocation of the earliest deadline does not start the DTI");
+
+  /* A flow asking for 60 % of the BI does not fit with the others and is rejected */
+  StatusCode status = scheduler->Request (4, GetDmgTspec (2, 30000));
+  NS_TEST_ASSERT_MSG_EQ (status.IsSuccess (), false, "An unschedulable flow has been accepted");
+  NS_TEST_ASSERT_MSG_EQ (status.GetStatusCodeValue (), STATUS_CODE_REJECTED_FOR_DELAY_PERIOD, "Wrong status code");
+  /* The accepted flows are pseudo-static, so the STA should retry after the schedulability horizon */
+  NS_TEST_ASSERT_MSG_EQ (scheduler->GetTsDelay ().GetDelay (), 16 * 100000 / 1024, "Wrong TS Delay");
+  NS_TEST_ASSERT_MSG_EQ (scheduler->GetAllocations ().size (), allocations.size (),
+                         "The rejected flow changed the announced allocations");
+
+  scheduler->Dispose ();
+}
+
+void
+EdfDeadlineOrderTest::DoRun (void)
+{
+  /* The scheduler plans the DTIs relative to the current time */
+  Simulator::Schedule (Seconds (0), &EdfDeadlineOrderTest::Run, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief EDF DMG Wifi Scheduler Test Suite
+ */
+class EdfDmgWifiSchedulerTestSuite : public TestSuite
+{
+public:
+  EdfDmgWifiSchedulerTestSuite ();
+};
+
+EdfDmgWifiSchedulerTestSuite::EdfDmgWifiSchedulerTestSuite ()
+  : TestSuite ("wifi-edf-dmg-wifi-scheduler", UNIT)
+{
+  AddTestCase (new EdfDeadlineOrderTest, TestCase::QUICK);
+}
+
+static EdfDmgWifiSchedulerTestSuite g_edfDmgWifiSchedulerTestSuite; ///< the test suite
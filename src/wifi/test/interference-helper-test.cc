@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/interference-helper.h"
+#include "ns3/wifi-tx-vector.h"
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("InterferenceHelperTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Interference Timeline Cap
+ *
+ * Two interference helpers receive the same frames and foreign signals, one
+ * of them with its timeline capped to the smallest size allowed. The noise and
+ * interference power observed during a set of windows, including the frames
+ * being received, should be the same for both helpers.
+ */
+class InterferenceTimelineCapTest : public TestCase
+{
+public:
+  InterferenceTimelineCapTest ();
+  virtual ~InterferenceTimelineCapTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Add a foreign signal to both helpers.
+   * \param duration the duration of the signal
+   * \param rxPowerW the receive power (W)
+   */
+  void AddSignal (Time duration, double rxPowerW);
+  /**
+   * Start receiving a frame on both helpers.
+   * \param duration the duration of the frame
+   * \param rxPowerW the receive power (W)
+   */
+  void StartRx (Time duration, double rxPowerW);
+  /**
+   * End the reception of a frame on both helpers.
+   */
+  void EndRx (void);
+
+  InterferenceHelper m_capped;      ///< the helper with a capped timeline
+  InterferenceHelper m_uncapped;    ///< the helper without a cap
+};
+
+InterferenceTimelineCapTest::InterferenceTimelineCapTest ()
+  : TestCase ("Check that capping the interference timeline does not change the interference power")
+{
+}
+
+InterferenceTimelineCapTest::~InterferenceTimelineCapTest ()
+{
+}
+
+void
+InterferenceTimelineCapTest::AddSignal (Time duration, double rxPowerW)
+{
+  m_capped.AddForeignSignal (duration, rxPowerW);
+  m_uncapped.AddForeignSignal (duration, rxPowerW);
+}
+
+void
+InterferenceTimelineCapTest::StartRx (Time duration, double rxPowerW)
+{
+  m_capped.Add (WifiTxVector (), duration, rxPowerW);
+  m_capped.NotifyRxStart ();
+  m_uncapped.Add (WifiTxVector (), duration, rxPowerW);
+  m_uncapped.NotifyRxStart ();
+}
+
+void
+InterferenceTimelineCapTest::EndRx (void)
+{
+  m_capped.NotifyRxEnd ();
+  m_uncapped.NotifyRxEnd ();
+}
+
+void
+InterferenceTimelineCapTest::DoRun (void)
+{
+  m_capped.SetMaxNiChanges (2);
+
+  /* Two frames received while long foreign signals keep overlapping */
+  Simulator::Schedule (MicroSeconds (300), &InterferenceTimelineCapTest::StartRx, this, MicroSeconds (60), 1e-6);
+  Simulator::Schedule (MicroSeconds (360), &InterferenceTimelineCapTest::EndRx, this);
+  Simulator::Schedule (MicroSeconds (600), &InterferenceTimelineCapTest::StartRx, this, MicroSeconds (50), 2e-6);
+  Simulator::Schedule (MicroSeconds (650), &InterferenceTimelineCapTest::EndRx, this);
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Time start = MicroSeconds (7 * i + 3);
+      Time duration = MicroSeconds (5 + (i * 37) % 150);
+      double rxPowerW = 1e-9 * (1 + (i * 7) % 11);
+      Simulator::Schedule (start, &InterferenceTimelineCapTest::AddSignal, this, duration, rxPowerW);
+    }
+
+  std::vector<std::pair<Time, Time> > windows;
+  windows.push_back (std::make_pair (MicroSeconds (50), MicroSeconds (250)));
+  windows.push_back (std::make_pair (MicroSeconds (300), MicroSeconds (360)));
+  windows.push_back (std::make_pair (MicroSeconds (400), MicroSeconds (550)));
+  windows.push_back (std::make_pair (MicroSeconds (600), MicroSeconds (650)));
+  uint32_t cappedId = m_capped.StartObservation (windows);
+  uint32_t uncappedId = m_uncapped.StartObservation (windows);
+
+  Simulator::Stop (MicroSeconds (900));
+  Simulator::Run ();
+  std::vector<double> capped = m_capped.EndObservation (cappedId);
+  std::vector<double> uncapped = m_uncapped.EndObservation (uncappedId);
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (capped.size (), uncapped.size (), "Different number of windows");
+  for (uint32_t i = 0; i < uncapped.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_GT (uncapped[i], 0, "No power observed in window " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (capped[i], uncapped[i], uncapped[i] * 1e-9,
+                                 "Different interference power in window " << i);
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Interference Helper Test Suite
+ */
+class InterferenceHelperTestSuite : public TestSuite
+{
+public:
+  InterferenceHelperTestSuite ();
+};
+
+InterferenceHelperTestSuite::InterferenceHelperTestSuite ()
+  : TestSuite ("wifi-interference-helper", UNIT)
+{
+  AddTestCase (new InterferenceTimelineCapTest, TestCase::QUICK);
+}
+
+static InterferenceHelperTestSuite g_interferenceHelperTestSuite; ///< the test suite